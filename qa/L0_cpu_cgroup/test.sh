@@ -0,0 +1,153 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Check that a model with CPU settings is loaded into its own cgroup,
+# that thread pools shared by all models are not created inside that
+# cgroup, and that the cgroup is removed when the model is unloaded.
+# Requires a writable cgroup v2 hierarchy with the cpu controller.
+
+DATADIR=/data/inferenceserver
+ISOLATED_MODEL=graphdef_float32_float32_float32
+SHARED_MODEL=graphdef_int32_int32_int32
+
+CLIENT_LOG="./perf_client.log"
+PERF_CLIENT=../clients/perf_client
+
+CGROUP_ROOT=/sys/fs/cgroup/trtis_l0_cpu_cgroup
+MODEL_CGROUP=$CGROUP_ROOT/model_$ISOLATED_MODEL
+
+SERVER=`pwd`/cgroup_server.sh
+SERVER_ARGS="--model-store=`pwd`/models --repository-poll-secs=1 \
+             --exit-timeout-secs=5 --cpu-cgroup-root=$CGROUP_ROOT"
+SERVER_LOG="./inference_server.log"
+source ../common/util.sh
+
+# Run all models on the CPU.
+export CUDA_VISIBLE_DEVICES=
+
+rm -fr *.log models cgroup_server.sh
+mkdir models
+
+if ! grep -qw cpu /sys/fs/cgroup/cgroup.controllers; then
+    echo -e "\n***\n*** cgroup v2 cpu controller not available\n***"
+    exit 1
+fi
+
+rmdir $CGROUP_ROOT/model_* $CGROUP_ROOT 2>/dev/null || true
+echo "+cpu" > /sys/fs/cgroup/cgroup.subtree_control
+mkdir $CGROUP_ROOT
+
+# Start the server in its own cgroup, which becomes the cgroup root.
+cat > cgroup_server.sh <<EOF2
+#!/bin/bash
+echo \$\$ > $CGROUP_ROOT/cgroup.procs
+exec /opt/tensorrtserver/bin/trtserver "\$@"
+EOF2
+chmod +x cgroup_server.sh
+
+cp -r $DATADIR/qa_model_repository/$ISOLATED_MODEL models/.
+cat >> models/$ISOLATED_MODEL/config.pbtxt <<EOF2
+optimization {
+  cpu { weight: 200 }
+}
+EOF2
+
+RET=0
+
+function cpu_usage_usec() {
+    grep "^usage_usec" $MODEL_CGROUP/cpu.stat | awk '{print $2}'
+}
+
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    rmdir $CGROUP_ROOT
+    exit 1
+fi
+
+set +e
+
+if [ ! -d $MODEL_CGROUP ]; then
+    echo -e "\n***\n*** Expected cgroup $MODEL_CGROUP\n***"
+    RET=1
+elif [ `cat $MODEL_CGROUP/cpu.weight` != "200" ]; then
+    echo -e "\n***\n*** Unexpected weight `cat $MODEL_CGROUP/cpu.weight`\n***"
+    RET=1
+elif [ `wc -l < $MODEL_CGROUP/cgroup.threads` -eq 0 ]; then
+    echo -e "\n***\n*** Expected threads in $MODEL_CGROUP\n***"
+    RET=1
+fi
+
+# Load a model without CPU settings after the isolated model. Running
+# it must not use threads in the isolated model's cgroup, which would
+# happen if the isolated model had created the thread pools shared by
+# all models.
+cp -r $DATADIR/qa_model_repository/$SHARED_MODEL models/.
+sleep 5
+
+if [ $RET -eq 0 ]; then
+    USAGE_BEFORE=`cpu_usage_usec`
+    $PERF_CLIENT -v -i grpc -u localhost:8001 -m $SHARED_MODEL -t 4 \
+        -p5000 >$CLIENT_LOG 2>&1
+    if [ $? -ne 0 ]; then
+        cat $CLIENT_LOG
+        echo -e "\n***\n*** perf_client Failed\n***"
+        RET=1
+    fi
+    USAGE_AFTER=`cpu_usage_usec`
+    if [ $((USAGE_AFTER - USAGE_BEFORE)) -gt 200000 ]; then
+        echo -e "\n***\n*** $SHARED_MODEL used CPU in $MODEL_CGROUP:" \
+            "$USAGE_BEFORE -> $USAGE_AFTER usec\n***"
+        RET=1
+    fi
+fi
+
+# Unloading the isolated model removes its cgroup.
+rm -fr models/$ISOLATED_MODEL
+sleep 5
+
+if [ -d $MODEL_CGROUP ]; then
+    echo -e "\n***\n*** Expected $MODEL_CGROUP to be removed\n***"
+    RET=1
+fi
+
+set -e
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+rmdir $CGROUP_ROOT/model_* $CGROUP_ROOT 2>/dev/null || true
+
+if [ $RET -eq 0 ]; then
+    echo -e "\n***\n*** Test Passed\n***"
+else
+    cat $SERVER_LOG
+    echo -e "\n***\n*** Test FAILED\n***"
+fi
+
+exit $RET
@@ -71,8 +71,8 @@ if __name__ == '__main__':
       sys.exit(1);
 
    params = result["OUTPUT"][0]
-   if params.size != 5:
-      print("error: expected 5 output strings, got {}".format(params.size));
+   if params.size != 6:
+      print("error: expected 6 output strings, got {}".format(params.size));
       sys.exit(1);
 
    p0 = params[0].decode("utf-8")
@@ -93,16 +93,21 @@ if __name__ == '__main__':
       print("error: expected model-store to end with L0_custom_backend/models, got {}".format(p2));
       sys.exit(1);
 
-   # configuration param values can be returned in any order.
    p3 = params[3].decode("utf-8")
+   if p3 != "server_2=1":
+      print("error: expected server_2=1 parameter, got {}".format(p3));
+      sys.exit(1);
+
+   # configuration param values can be returned in any order.
    p4 = params[4].decode("utf-8")
-   if p3.startswith("param1"):
-      p3, p4 = p4, p3
+   p5 = params[5].decode("utf-8")
+   if p4.startswith("param1"):
+      p4, p5 = p5, p4
 
-   if p3 != "param0=value0":
-      print("error: expected param0=value0, got {}".format(p3));
+   if p4 != "param0=value0":
+      print("error: expected param0=value0, got {}".format(p4));
       sys.exit(1);
 
-   if p4 != "param1=value1":
-      print("error: expected param1=value1, got {}".format(p4));
+   if p5 != "param1=value1":
+      print("error: expected param1=value1, got {}".format(p5));
       sys.exit(1);
@@ -0,0 +1,169 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import numpy as np
+import unittest
+
+import grpc
+from tensorrtserver.api import grpc_service_pb2
+from tensorrtserver.api import request_status_pb2
+
+# Chunked inference requests on the StreamInfer endpoint. Each
+# request is sent as a header message followed by messages holding
+# chunks of the input tensors, and the response is returned the same
+# way. The messages are serialized here so that invalid messages can
+# be sent too.
+
+MODEL_NAME = "custom_int32_int32_int32"
+STREAM_INFER = "/nvidia.inferenceserver.GRPCService/StreamInfer"
+BATCH_SIZE = 8
+# Smaller than one tensor (8 x 16 int32) and not a multiple of the
+# element size.
+CHUNK_BYTE_SIZE = 22
+
+
+class GrpcChunkingTest(unittest.TestCase):
+    def setUp(self):
+        self.channel_ = grpc.insecure_channel("localhost:8001")
+        self.stream_infer_ = self.channel_.stream_stream(
+            STREAM_INFER, request_serializer=lambda m: m,
+            response_deserializer=grpc_service_pb2.InferResponse.FromString)
+
+        self.input0_ = np.arange(BATCH_SIZE * 16, dtype=np.int32)
+        self.input1_ = np.full(BATCH_SIZE * 16, 7, dtype=np.int32)
+
+    def _header(self, request_id):
+        request = grpc_service_pb2.InferRequest()
+        request.model_name = MODEL_NAME
+        request.model_version = -1
+        request.meta_data.id = request_id
+        request.meta_data.batch_size = BATCH_SIZE
+        request.meta_data.input.add(name="INPUT0")
+        request.meta_data.input.add(name="INPUT1")
+        request.meta_data.output.add(name="OUTPUT0")
+        request.meta_data.output.add(name="OUTPUT1")
+        request.chunk.max_byte_size = CHUNK_BYTE_SIZE
+        return request.SerializeToString()
+
+    def _chunk(self, tensor_index, raw_inputs, last=False):
+        request = grpc_service_pb2.InferRequest()
+        request.chunk.tensor_index = tensor_index
+        request.chunk.last = last
+        request.raw_input.extend(raw_inputs)
+        return request.SerializeToString()
+
+    def _chunked_request(self, request_id):
+        # Each input in chunks of CHUNK_BYTE_SIZE, the first chunk of
+        # INPUT1 sharing a message with the last chunk of INPUT0.
+        in0 = self.input0_.tobytes()
+        in1 = self.input1_.tobytes()
+        in0_chunks = [in0[i:i + CHUNK_BYTE_SIZE]
+                      for i in range(0, len(in0), CHUNK_BYTE_SIZE)]
+        in1_chunks = [in1[i:i + CHUNK_BYTE_SIZE]
+                      for i in range(0, len(in1), CHUNK_BYTE_SIZE)]
+
+        messages = [self._header(request_id)]
+        for c in in0_chunks[:-1]:
+            messages.append(self._chunk(0, [c]))
+        messages.append(self._chunk(0, [in0_chunks[-1], in1_chunks[0]]))
+        for c in in1_chunks[1:]:
+            messages.append(self._chunk(1, [c]))
+        messages.append(self._chunk(0, [], last=True))
+        return messages
+
+    def _stream(self, messages):
+        # Return the responses, each as a (response, raw_outputs) pair
+        # assembled from its messages.
+        responses = []
+        raw_outputs = []
+        for message in self.stream_infer_(iter(messages)):
+            self.assertTrue(message.HasField("chunk"))
+            for raw in message.raw_output:
+                self.assertLessEqual(len(raw), CHUNK_BYTE_SIZE)
+            idx = message.chunk.tensor_index
+            for raw in message.raw_output:
+                while len(raw_outputs) <= idx:
+                    raw_outputs.append(b"")
+                raw_outputs[idx] += raw
+                idx += 1
+            if message.chunk.last:
+                responses.append((message, raw_outputs))
+                raw_outputs = []
+        self.assertEqual(len(raw_outputs), 0)
+        return responses
+
+    def _check_success(self, response, raw_outputs, request_id):
+        self.assertEqual(response.request_status.code,
+                         request_status_pb2.SUCCESS,
+                         response.request_status.msg)
+        self.assertEqual(response.meta_data.id, request_id)
+        self.assertEqual(len(raw_outputs), 2)
+        self.assertEqual(raw_outputs[0],
+                         (self.input0_ + self.input1_).tobytes())
+        self.assertEqual(raw_outputs[1],
+                         (self.input0_ - self.input1_).tobytes())
+
+    def _check_error(self, response, raw_outputs, request_id, msg):
+        self.assertEqual(response.request_status.code,
+                         request_status_pb2.INVALID_ARG)
+        self.assertIn(msg, response.request_status.msg)
+        self.assertEqual(response.meta_data.id, request_id)
+        self.assertEqual(len(raw_outputs), 0)
+
+    def test_chunked(self):
+        responses = self._stream(
+            self._chunked_request(1) + self._chunked_request(2))
+        self.assertEqual(len(responses), 2)
+        self._check_success(responses[0][0], responses[0][1], 1)
+        self._check_success(responses[1][0], responses[1][1], 2)
+
+    def test_tensor_index_out_of_range(self):
+        # The bad chunk fails only its own request, the following
+        # request on the stream still succeeds.
+        bad = self._chunked_request(1)
+        bad.insert(1, self._chunk(2, [b"\x00" * 4]))
+        bad.insert(1, self._chunk(1, [b"\x00" * 4, b"\x00" * 4]))
+        responses = self._stream(bad + self._chunked_request(2))
+        self.assertEqual(len(responses), 2)
+        self._check_error(responses[0][0], responses[0][1], 1,
+                          "unexpected chunk for input 2")
+        self._check_success(responses[1][0], responses[1][1], 2)
+
+    def test_unparseable_chunk(self):
+        # A chunk that can't be parsed does not end the request, the
+        # server keeps reading to the message marked last.
+        bad = self._chunked_request(1)
+        bad.insert(2, b"\xff\xff")
+        responses = self._stream(bad + self._chunked_request(2))
+        self.assertEqual(len(responses), 2)
+        self._check_error(responses[0][0], responses[0][1], 1,
+                          "failed to parse inference request chunk")
+        self._check_success(responses[1][0], responses[1][1], 2)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,96 @@
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import sys
+sys.path.append("../common")
+
+from future.utils import iteritems
+import unittest
+import numpy as np
+import infer_util as iu
+import test_util as tu
+from tensorrtserver.api import *
+import tensorrtserver.api.server_status_pb2 as server_status
+
+class LibTorchOptimizationTest(unittest.TestCase):
+    def setUp(self):
+        self.protocols_ = ((ProtocolType.HTTP, 'localhost:8000'),
+                           (ProtocolType.GRPC, 'localhost:8001'))
+        self.dropout_model_ = "libtorch_dropout_float32"
+
+    def _infer_dropout(self, protocol, url):
+        ctx = InferContext(url, protocol, self.dropout_model_, None, True)
+        in0 = np.ones((16,), dtype=np.float32)
+        results = ctx.run({ 'INPUT__0' : (in0,) },
+                          { 'OUTPUT__0' : InferContext.ResultFormat.RAW },
+                          1)
+        return in0, results['OUTPUT__0'][0]
+
+    def test_exact(self):
+        # The model runs without autograd, outputs must still be the
+        # exact sum and difference of the inputs.
+        for bs in (1, 8):
+            iu.infer_exact(self, 'libtorch', (16,), bs,
+                           np.float32, np.float32, np.float32)
+
+    def test_dropout_train_mode(self):
+        # Without eval_mode the model stays in training mode so dropout
+        # either zeroes or doubles each element.
+        for protocol, url in self.protocols_:
+            in0, out0 = self._infer_dropout(protocol, url)
+            self.assertFalse(np.array_equal(in0, out0),
+                             "expected dropout to change the output")
+            self.assertTrue(np.all((out0 == 0) | (out0 == 2)),
+                            "unexpected dropout output " + str(out0))
+
+    def test_dropout_eval_mode(self):
+        # With eval_mode dropout is disabled so the output must equal
+        # the input.
+        for protocol, url in self.protocols_:
+            in0, out0 = self._infer_dropout(protocol, url)
+            self.assertTrue(np.array_equal(in0, out0),
+                            "expected output to equal input, got " + str(out0))
+
+    def test_cpu_fusion_conflict(self):
+        # The two models request different cpu_fusion settings so
+        # exactly one of them must be loaded.
+        fusion_model = tu.get_model_name('libtorch', np.float32,
+                                         np.float32, np.float32)
+        for protocol, url in self.protocols_:
+            ctx = ServerStatusContext(url, protocol, None, True)
+            ss = ctx.get_server_status()
+            ready_cnt = 0
+            for model_name in (fusion_model, self.dropout_model_):
+                self.assertTrue(model_name in ss.model_status,
+                                "expected status for model " + model_name)
+                for (k, v) in iteritems(ss.model_status[model_name].version_status):
+                    if v.ready_state == server_status.MODEL_READY:
+                        ready_cnt += 1
+            self.assertEqual(ready_cnt, 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
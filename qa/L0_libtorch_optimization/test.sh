@@ -0,0 +1,139 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+LIBTORCH_OPT_TEST=libtorch_optimization_test.py
+CLIENT_LOG_BASE="./client.log"
+
+DATADIR=/data/inferenceserver
+ADDSUB_MODEL=libtorch_float32_float32_float32
+DROPOUT_MODEL=libtorch_dropout_float32
+
+SERVER=/opt/tensorrtserver/bin/trtserver
+SERVER_ARGS=--model-store=`pwd`/models
+SERVER_LOG_BASE="./inference_server.log"
+source ../common/util.sh
+
+rm -f $SERVER_LOG_BASE* $CLIENT_LOG_BASE*
+
+RET=0
+
+# Create the model repository with the LibTorch optimization options
+# given for each model.
+function create_models () {
+    rm -fr models && mkdir models
+    cp -r $DATADIR/qa_model_repository/$ADDSUB_MODEL models/.
+    cp -r $DATADIR/qa_identity_model_repository/$DROPOUT_MODEL models/.
+    if [ "$1" != "" ]; then
+        echo "optimization { libtorch { $1 } }" >> models/$ADDSUB_MODEL/config.pbtxt
+    fi
+    if [ "$2" != "" ]; then
+        echo "optimization { libtorch { $2 } }" >> models/$DROPOUT_MODEL/config.pbtxt
+    fi
+}
+
+# Run the given tests against a server that is ready.
+function run_tests () {
+    local name=$1; shift
+
+    SERVER_LOG=$SERVER_LOG_BASE.$name
+    CLIENT_LOG=$CLIENT_LOG_BASE.$name
+
+    run_server
+    if [ "$SERVER_PID" == "0" ]; then
+        echo -e "\n***\n*** Failed to start $SERVER\n***"
+        cat $SERVER_LOG
+        exit 1
+    fi
+
+    set +e
+    for TEST in $@; do
+        python $LIBTORCH_OPT_TEST LibTorchOptimizationTest.$TEST >>$CLIENT_LOG 2>&1
+        if [ $? -ne 0 ]; then
+            cat $CLIENT_LOG
+            echo -e "\n***\n*** Test $name $TEST Failed\n***"
+            RET=1
+        fi
+    done
+    set -e
+
+    kill $SERVER_PID
+    wait $SERVER_PID
+}
+
+# Default options, models execute without autograd and the dropout
+# model stays in training mode.
+create_models "" ""
+run_tests default test_exact test_dropout_train_mode
+
+# eval_mode switches the dropout model to evaluation mode.
+create_models "eval_mode: true" "eval_mode: true"
+run_tests eval_mode test_exact test_dropout_eval_mode
+
+# CPU fusion enabled for both models must not change the outputs.
+create_models "cpu_fusion: true" "cpu_fusion: true"
+run_tests cpu_fusion test_exact test_dropout_train_mode
+
+# Conflicting cpu_fusion settings, one of the models must fail to load.
+create_models "cpu_fusion: true" ""
+
+SERVER_ARGS="--model-store=`pwd`/models --exit-on-error=false --strict-readiness=false"
+SERVER_LOG=$SERVER_LOG_BASE.cpu_fusion_conflict
+CLIENT_LOG=$CLIENT_LOG_BASE.cpu_fusion_conflict
+run_server_tolive
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+# give plenty of time for the models to load (and fail to load)
+wait_for_model_stable $SERVER_TIMEOUT
+
+set +e
+python $LIBTORCH_OPT_TEST LibTorchOptimizationTest.test_cpu_fusion_conflict >>$CLIENT_LOG 2>&1
+if [ $? -ne 0 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test cpu_fusion_conflict Failed\n***"
+    RET=1
+fi
+
+grep -c "LibTorch only supports one setting per process" $SERVER_LOG
+if [ $? -ne 0 ]; then
+    cat $SERVER_LOG
+    echo -e "\n***\n*** Test cpu_fusion_conflict Failed, expected load error\n***"
+    RET=1
+fi
+set -e
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+if [ $RET -eq 0 ]; then
+  echo -e "\n***\n*** Test Passed\n***"
+fi
+
+exit $RET
@@ -0,0 +1,141 @@
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+import sys
+sys.path.append("../common")
+
+import os
+import threading
+import time
+import unittest
+import numpy as np
+import requests
+from tensorrtserver.api import *
+import tensorrtserver.api.server_status_pb2 as server_status
+
+_model_name = "custom_sequence_int32"
+_url = "localhost:8000"
+
+class LoadTest(unittest.TestCase):
+    def setUp(self):
+        self.errors_ = []
+
+    def _get_load(self, model_name=None):
+        url = "http://" + _url + "/api/load"
+        if model_name is not None:
+            url += "/" + model_name
+        r = requests.get(url, params={ "format" : "binary" })
+        self.assertEqual(r.status_code, 200, r.headers.get("NV-Status"))
+        load = server_status.ServerLoadStatus()
+        load.ParseFromString(r.content)
+        return load
+
+    def _ready(self):
+        r = requests.get("http://" + _url + "/api/health/ready")
+        return r.status_code == 200
+
+    def _infer(self, correlation_id, value, flags):
+        try:
+            ctx = InferContext(_url, ProtocolType.HTTP, _model_name,
+                               correlation_id=correlation_id)
+            results = ctx.run(
+                { "INPUT" : [ np.full((1,), value, dtype=np.int32) ] },
+                { "OUTPUT" : InferContext.ResultFormat.RAW },
+                batch_size=1, flags=flags)
+            self.assertTrue("OUTPUT" in results)
+        except Exception as ex:
+            self.errors_.append(ex)
+
+    def _async_infer(self, correlation_id, value, flags):
+        thread = threading.Thread(target=self._infer,
+                                  args=(correlation_id, value, flags))
+        thread.start()
+        return thread
+
+    def _join(self, threads):
+        for thread in threads:
+            thread.join()
+        if len(self.errors_) > 0:
+            raise self.errors_[0]
+
+    def test_idle(self):
+        # The load of all models and of a single model is available
+        # on the HTTP inference port and is zero while idle.
+        load = self._get_load()
+        self.assertTrue(_model_name in load.model_load)
+
+        load = self._get_load(_model_name)
+        self.assertEqual(len(load.model_load), 1)
+        model_load = load.model_load[_model_name]
+        self.assertEqual(model_load.queue_count, 0)
+        self.assertEqual(model_load.inflight_count, 0)
+        self.assertEqual(model_load.estimated_queue_wait_us, 0)
+        self.assertTrue(self._ready())
+
+    def test_unknown_model(self):
+        r = requests.get("http://" + _url + "/api/load/unknown_model")
+        self.assertEqual(r.status_code, 400)
+
+    def test_padding(self):
+        # Start two sequences so that each holds one of the two batch
+        # slots of the model.
+        start = InferRequestHeader.FLAG_SEQUENCE_START
+        self._join([self._async_infer(1000, 1, start),
+                    self._async_infer(1001, 1, start)])
+
+        # Execute a request of the first sequence. The second sequence
+        # has no request so its slot is filled with padding, which must
+        # not be counted as an executing request.
+        threads = [self._async_infer(1000, 2, 0)]
+        time.sleep(0.5)
+
+        # Queue two more requests behind the executing one.
+        threads.append(self._async_infer(1000, 3, 0))
+        threads.append(self._async_infer(1000, 4, 0))
+        time.sleep(0.5)
+
+        model_load = self._get_load(_model_name).model_load[_model_name]
+        self.assertEqual(model_load.inflight_count, 3)
+        self.assertEqual(model_load.queue_count, 2)
+        self.assertGreater(model_load.estimated_queue_wait_us, 1000000)
+
+        # The estimated wait exceeds --readiness-max-queue-wait-us.
+        self.assertFalse(self._ready())
+
+        self._join(threads)
+
+        end = InferRequestHeader.FLAG_SEQUENCE_END
+        self._join([self._async_infer(1000, 5, end),
+                    self._async_infer(1001, 5, end)])
+
+        model_load = self._get_load(_model_name).model_load[_model_name]
+        self.assertEqual(model_load.queue_count, 0)
+        self.assertEqual(model_load.inflight_count, 0)
+        self.assertTrue(self._ready())
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,194 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Check that load-time quantization passes its settings to the
+# quantizer and reports them in the model status, that the saved
+# quantized model is keyed by the quantizer, and that a quantizer
+# that doesn't finish is killed.
+
+DATADIR=/data/inferenceserver
+MODEL=onnx_float32_float32_float32
+QUANTIZER_LOG="`pwd`/quantizer.log"
+
+SERVER=/opt/tensorrtserver/bin/trtserver
+SERVER_LOG="./inference_server.log"
+source ../common/util.sh
+
+rm -fr *.log models copy_quantizer.sh sleep_quantizer.sh
+mkdir models
+cp -r $DATADIR/qa_model_repository/$MODEL models/.
+cat >> models/$MODEL/config.pbtxt <<EOF2
+optimization {
+  quantization { kind: QUANTIZATION_DYNAMIC_INT8 }
+}
+EOF2
+
+# A quantizer that records its arguments and leaves the model
+# unchanged.
+cat > copy_quantizer.sh <<EOF2
+#!/bin/bash
+echo "\$@" >> $QUANTIZER_LOG
+cp "\$3" "\$4"
+EOF2
+
+# A quantizer that never finishes.
+cat > sleep_quantizer.sh <<EOF2
+#!/bin/bash
+exec sleep 300
+EOF2
+
+chmod +x copy_quantizer.sh sleep_quantizer.sh
+
+RET=0
+
+function quantizer_runs() {
+    if [ -f $QUANTIZER_LOG ]; then
+        wc -l < $QUANTIZER_LOG
+    else
+        echo 0
+    fi
+}
+
+function check_quantizer_runs() {
+    local expected="$1"; shift
+
+    local runs=`quantizer_runs`
+    if [ "$runs" != "$expected" ]; then
+        echo -e "\n***\n*** Expected $expected quantizer runs, got $runs\n***"
+        RET=1
+    fi
+}
+
+SERVER_ARGS="--model-store=`pwd`/models --model-quantizer=`pwd`/copy_quantizer.sh"
+
+# The first load runs the quantizer with the quantization settings.
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+set +e
+
+check_quantizer_runs 1
+grep "^dynamic_int8 onnxruntime_onnx .* weight_type=qint8 per_channel=false reduce_range=false$" \
+    $QUANTIZER_LOG
+if [ $? -ne 0 ]; then
+    echo -e "\n***\n*** Unexpected quantizer arguments\n***"
+    cat $QUANTIZER_LOG
+    RET=1
+fi
+
+curl -s localhost:8000/api/status/$MODEL > status.log
+for SETTING in "quantization dynamic_int8" \
+               "quantization.weight_type qint8" \
+               "quantization.per_channel false" \
+               "quantization.reduce_range false"; do
+    set -- $SETTING
+    grep -A1 "key: \"$1\"" status.log | grep "value: \"$2\""
+    if [ $? -ne 0 ]; then
+        echo -e "\n***\n*** Missing accuracy setting $1: $2\n***"
+        cat status.log
+        RET=1
+    fi
+done
+
+set -e
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+# A second load uses the saved quantized model.
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+check_quantizer_runs 1
+
+# A changed quantizer quantizes the model again.
+echo "# changed" >> copy_quantizer.sh
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+check_quantizer_runs 2
+
+# A quantizer that doesn't finish is killed after the timeout and the
+# model fails to load.
+rm -fr models/$MODEL/1/.optimized
+SERVER_ARGS="--model-store=`pwd`/models --model-quantizer=`pwd`/sleep_quantizer.sh --model-quantizer-timeout-secs=2"
+START=`date +%s`
+run_server
+END=`date +%s`
+if [ "$SERVER_PID" != "0" ]; then
+    echo -e "\n***\n*** Unexpected server start $SERVER\n***"
+    kill $SERVER_PID
+    wait $SERVER_PID
+    RET=1
+fi
+
+set +e
+
+grep "sleep_quantizer.sh' timed out after 2 seconds" $SERVER_LOG
+if [ $? -ne 0 ]; then
+    echo -e "\n***\n*** Expected quantizer timeout\n***"
+    RET=1
+fi
+
+if [ $((END - START)) -ge 60 ]; then
+    echo -e "\n***\n*** Quantizer was not killed\n***"
+    RET=1
+fi
+
+if [ `pgrep -f "sleep 300" | wc -l` -ne 0 ]; then
+    echo -e "\n***\n*** Quantizer is still running\n***"
+    RET=1
+fi
+
+set -e
+
+if [ $RET -eq 0 ]; then
+    echo -e "\n***\n*** Test Passed\n***"
+else
+    cat $SERVER_LOG
+    echo -e "\n***\n*** Test FAILED\n***"
+fi
+
+exit $RET
@@ -59,6 +59,12 @@ if [ $(cat $CLIENT_LOG | grep ": 0 infer/sec\|: 0 usec" | wc -l) -ne 0 ]; then
     echo -e "\n***\n*** Test Failed\n***"
     RET=1
 fi
+# The server reports its timing of each request
+if [ $(cat $CLIENT_LOG | grep "Server compute: p50 " | wc -l) -eq 0 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test Failed\n***"
+    RET=1
+fi
 set -e
 
 # Test perf client behavior on different model with different batch size
@@ -86,6 +92,159 @@ for MODEL in graphdef_nobatch_int32_int32_int32 graphdef_int32_int32_int32; do
     done
 done
 
+# Search for the maximum throughput under a latency limit that every
+# concurrency level meets, so the search must stop at the
+# concurrency limit.
+set +e
+$PERF_CLIENT -v -i grpc -u localhost:8001 -m graphdef_int32_int32_int32 -t 1 -c 4 \
+    -p2000 -b 1 --search -l 5000 --percentile=95 >$CLIENT_LOG 2>&1
+if [ $? -ne 0 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test Failed\n***"
+    RET=1
+fi
+if [ $(cat $CLIENT_LOG | grep "Maximum throughput within latency limit:" | wc -l) -ne 1 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test Failed\n***"
+    RET=1
+fi
+if [ $(cat $CLIENT_LOG | grep "^Concurrency: 4, " | wc -l) -ne 1 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test Failed\n***"
+    RET=1
+fi
+set -e
+
+# Spread requests across two servers. The second server is down when
+# perf_client starts and must be brought into rotation when it comes
+# up, and after it is killed while perf_client runs the run must
+# continue on the first server.
+SERVER0_PID=$SERVER_PID
+MULTI_MODEL=graphdef_int32_int32_int32
+
+# Print the number of successful inference requests for the model
+# reported by the server with metrics port $1.
+function request_count() {
+    local metrics_port="$1"; shift
+
+    curl -s localhost:$metrics_port/metrics | \
+        grep "^nv_inference_request_success{.*model=\"$MULTI_MODEL\"" | \
+        awk '{ sum += $2 } END { printf "%d\n", sum }'
+}
+
+# Start the second server and wait until it is ready. run_server
+# checks readiness on the default port so it can't be used.
+function start_second_server() {
+    SERVER_ARGS="--model-store=$DATADIR --http-port=8010 --grpc-port=8011 --metrics-port=8012"
+    SERVER_LOG="./inference_server_1.log"
+    run_server_nowait
+    if [ "$SERVER_PID" == "0" ]; then
+        echo -e "\n***\n*** Failed to start $SERVER\n***"
+        cat $SERVER_LOG
+        exit 1
+    fi
+    SERVER1_PID=$SERVER_PID
+
+    set +e
+    for (( i=0; i<30; i++ )); do
+        code=`curl -s -o /dev/null -w %{http_code} localhost:8010/api/health/ready`
+        if [ "$code" == "200" ]; then
+            break
+        fi
+        sleep 1
+    done
+    set -e
+    if [ "$code" != "200" ]; then
+        echo -e "\n***\n*** Failed to start second $SERVER\n***"
+        cat $SERVER_LOG
+        exit 1
+    fi
+}
+
+for PROTOCOL in http grpc; do
+    if [ "$PROTOCOL" == "http" ]; then
+        URLS=localhost:8000,localhost:8010
+    else
+        URLS=localhost:8001,localhost:8011
+    fi
+
+    # The second server comes up after perf_client starts. The long
+    # measurement window keeps perf_client running well past the
+    # backoff of the unreachable server.
+    $PERF_CLIENT -v -i $PROTOCOL -u $URLS -m $MULTI_MODEL -t 4 -p10000 -b 1 >$CLIENT_LOG 2>&1 &
+    CLIENT_PID=$!
+    sleep 2
+    start_second_server
+
+    set +e
+    wait $CLIENT_PID
+    if [ $? -ne 0 ]; then
+        cat $CLIENT_LOG
+        echo -e "\n***\n*** Test Failed\n***"
+        RET=1
+    fi
+    if [ `request_count 8012` -eq 0 ]; then
+        echo -e "\n***\n*** $PROTOCOL: second server never received requests\n***"
+        RET=1
+    fi
+    set -e
+
+    # Kill the second server while perf_client runs. The run must
+    # succeed and the first server must keep receiving requests.
+    $PERF_CLIENT -v -i $PROTOCOL -u $URLS -m $MULTI_MODEL -t 4 -p10000 -b 1 >$CLIENT_LOG 2>&1 &
+    CLIENT_PID=$!
+    sleep 10
+
+    set +e
+    if [ `request_count 8012` -eq 0 ]; then
+        echo -e "\n***\n*** $PROTOCOL: second server received no requests\n***"
+        RET=1
+    fi
+    kill -9 $SERVER1_PID
+    wait $SERVER1_PID
+    KILL_COUNT=`request_count 8002`
+
+    wait $CLIENT_PID
+    if [ $? -ne 0 ]; then
+        cat $CLIENT_LOG
+        echo -e "\n***\n*** Test Failed\n***"
+        RET=1
+    fi
+    if [ `request_count 8002` -le $KILL_COUNT ]; then
+        echo -e "\n***\n*** $PROTOCOL: run did not continue on first server\n***"
+        RET=1
+    fi
+    set -e
+done
+
+kill $SERVER0_PID
+wait $SERVER0_PID
+
+# Requests are rejected when they would exceed the in-flight memory
+# budget.
+SERVER_ARGS="--model-store=$DATADIR --inflight-memory-byte-size=64"
+SERVER_LOG="./inference_server_2.log"
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+set +e
+$PERF_CLIENT -v -i grpc -u localhost:8001 -m graphdef_int32_int32_int32 -t 1 -p2000 -b 1 >$CLIENT_LOG 2>&1
+if [ $? -eq 0 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test Failed\n***"
+    RET=1
+fi
+if [ $(cat $CLIENT_LOG | grep "in-flight memory budget exceeded" | wc -l) -eq 0 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test Failed\n***"
+    RET=1
+fi
+set -e
+
 kill $SERVER_PID
 wait $SERVER_PID
 
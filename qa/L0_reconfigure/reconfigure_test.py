@@ -0,0 +1,83 @@
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+import sys
+sys.path.append("../common")
+
+from future.utils import iteritems
+import os
+import time
+import unittest
+import numpy as np
+import test_util as tu
+from tensorrtserver.api import *
+import tensorrtserver.api.server_status_pb2 as server_status
+
+_model_name = tu.get_model_name('graphdef', np.int32, np.int32, np.int32)
+_max_queue_delay_us = int(os.environ['MAX_QUEUE_DELAY_US'])
+
+class ReconfigureTest(unittest.TestCase):
+    def _ready_versions(self):
+        ctx = ServerStatusContext("localhost:8000", ProtocolType.HTTP,
+                                  _model_name, True)
+        ss = ctx.get_server_status()
+        model_status = ss.model_status[_model_name]
+        self.assertEqual(model_status.config.dynamic_batching.max_queue_delay_microseconds,
+                         _max_queue_delay_us)
+        versions = []
+        for (k, v) in iteritems(model_status.version_status):
+            if v.ready_state == server_status.MODEL_READY:
+                versions.append(k)
+        return versions
+
+    def _infer_ms(self, version):
+        ctx = InferContext("localhost:8000", ProtocolType.HTTP, _model_name,
+                           version)
+        in0 = np.arange(16, dtype=np.int32)
+        start = time.time()
+        results = ctx.run({ "INPUT0" : [ in0 ], "INPUT1" : [ in0 ] },
+                          { "OUTPUT0" : InferContext.ResultFormat.RAW }, 1)
+        end = time.time()
+        self.assertTrue("OUTPUT0" in results)
+        return (end - start) * 1000
+
+    def test_queue_delay(self):
+        # A single request never fills the preferred batch size, so it
+        # waits in the queue for the configured delay. Every ready
+        # version must use the current delay.
+        versions = self._ready_versions()
+        self.assertEqual(len(versions), 3)
+        for version in versions:
+            ms = self._infer_ms(version)
+            print("version {}: {} ms".format(version, ms))
+            if _max_queue_delay_us == 0:
+                self.assertLess(ms, 1000)
+            else:
+                self.assertGreaterEqual(ms, (_max_queue_delay_us / 1000) * 0.9)
+
+if __name__ == '__main__':
+    unittest.main()
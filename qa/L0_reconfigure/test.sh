@@ -0,0 +1,107 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Check that a change to only the scheduler settings of a model is
+# applied to every version of the running model without reloading it.
+
+CLIENT_LOG="./client.log"
+RECONFIGURE_TEST=reconfigure_test.py
+
+DATADIR=/data/inferenceserver
+MODEL=graphdef_int32_int32_int32
+
+SERVER=/opt/tensorrtserver/bin/trtserver
+SERVER_ARGS="--model-store=`pwd`/models --repository-poll-secs=1 --exit-timeout-secs=5"
+SERVER_LOG="./inference_server.log"
+source ../common/util.sh
+
+rm -fr *.log models && mkdir models
+cp -r $DATADIR/qa_model_repository/$MODEL models/.
+cp models/$MODEL/config.pbtxt config.pbtxt.base
+
+function set_queue_delay() {
+    export MAX_QUEUE_DELAY_US="$1"
+    cp config.pbtxt.base models/$MODEL/config.pbtxt
+    cat >> models/$MODEL/config.pbtxt <<EOF2
+dynamic_batching {
+  preferred_batch_size: [ 8 ]
+  max_queue_delay_microseconds: $MAX_QUEUE_DELAY_US
+}
+EOF2
+}
+
+RET=0
+
+set_queue_delay 0
+
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+set +e
+
+for delay in 0 3000000 0 ; do
+    if [ "$delay" != "$MAX_QUEUE_DELAY_US" ]; then
+        set_queue_delay $delay
+        sleep 5
+    fi
+
+    echo "Test: max_queue_delay_microseconds $delay" >>$CLIENT_LOG
+    python $RECONFIGURE_TEST ReconfigureTest.test_queue_delay >>$CLIENT_LOG 2>&1
+    if [ $? -ne 0 ]; then
+        echo -e "\n***\n*** Test Failed with delay $delay\n***"
+        RET=1
+    fi
+done
+
+# Both changes must have been applied without reloading the model.
+if [ `grep -c "reconfigured scheduler: $MODEL" $SERVER_LOG` != "2" ]; then
+    echo -e "\n***\n*** Expected two reconfigurations of $MODEL\n***"
+    RET=1
+fi
+if [ `grep -c "successfully unloaded '$MODEL'" $SERVER_LOG` != "0" ]; then
+    echo -e "\n***\n*** Unexpected reload of $MODEL\n***"
+    RET=1
+fi
+
+set -e
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+if [ $RET -eq 0 ]; then
+    echo -e "\n***\n*** Test Passed\n***"
+else
+    cat $CLIENT_LOG
+    cat $SERVER_LOG
+    echo -e "\n***\n*** Test FAILED\n***"
+fi
+
+exit $RET
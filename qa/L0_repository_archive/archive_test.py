@@ -0,0 +1,93 @@
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+import sys
+sys.path.append("../common")
+
+import os
+import unittest
+import numpy as np
+import infer_util as iu
+import test_util as tu
+from tensorrtserver.api import *
+import tensorrtserver.api.server_status_pb2 as server_status
+
+CPU_ONLY = (os.environ.get('TENSORRT_SERVER_CPU_ONLY') is not None)
+
+class ArchiveTest(unittest.TestCase):
+    def _models(self):
+        # The models in the archive, see test.sh. Each model is a
+        # (model name prefix, input shape) pair.
+        input_size = 16
+        models = []
+        if tu.validate_for_c2_model(np.float32, np.float32, np.float32,
+                                    (input_size,), (input_size,), (input_size,)):
+            models.append(('netdef', (input_size,)))
+        if tu.validate_for_onnx_model(np.float32, np.float32, np.float32,
+                                      (input_size,), (input_size,), (input_size,)):
+            models.append(('onnx', (input_size,)))
+        if tu.validate_for_libtorch_model(np.float32, np.float32, np.float32,
+                                          (input_size,), (input_size,), (input_size,)):
+            models.append(('libtorch', (input_size,)))
+        if not CPU_ONLY and tu.validate_for_trt_model(np.float32, np.float32, np.float32,
+                                                      (input_size,1,1), (input_size,1,1),
+                                                      (input_size,1,1)):
+            models.append(('plan', (input_size,1,1)))
+        return models
+
+    def _ready_versions(self, model_name):
+        ctx = ServerStatusContext("localhost:8000", ProtocolType.HTTP,
+                                  model_name, True)
+        ss = ctx.get_server_status()
+        self.assertTrue(model_name in ss.model_status,
+                        "expected status for model " + model_name)
+        vs = ss.model_status[model_name].version_status
+        return [v for v in vs if vs[v].ready_state == server_status.MODEL_READY]
+
+    def test_infer(self):
+        # Every model in the archive is loaded from the archive and
+        # returns correct results for each ready version. Version 1
+        # adds and subtracts the inputs, later versions swap the
+        # outputs.
+        for pf, shape in self._models():
+            for suffix, batch_sizes in (("_nobatch", (1,)), ("", (1, 8))):
+                try:
+                    model_name = tu.get_model_name(pf + suffix, np.float32,
+                                                   np.float32, np.float32)
+                    versions = self._ready_versions(model_name)
+                    self.assertTrue(len(versions) > 0,
+                                    "expected a ready version of " + model_name)
+                    for v in versions:
+                        for bs in batch_sizes:
+                            iu.infer_exact(self, pf + suffix, shape, bs,
+                                           np.float32, np.float32, np.float32,
+                                           model_version=v, swap=(v != 1))
+                except InferenceServerException as ex:
+                    self.assertTrue(False, "unexpected error {}".format(ex))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,108 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Pack a model repository into an archive, remove the original
+# repository and check that the server loads and serves every model
+# from the archive.
+
+CLIENT_LOG="./client.log"
+ARCHIVE_TEST=archive_test.py
+PACK=./pack_repository
+
+DATADIR=/data/inferenceserver
+
+SERVER=/opt/tensorrtserver/bin/trtserver
+SERVER_ARGS="--model-store=`pwd`/models.trtisrep --exit-timeout-secs=120"
+SERVER_LOG="./inference_server.log"
+source ../common/util.sh
+
+rm -f $SERVER_LOG $CLIENT_LOG models.trtisrep
+rm -fr models && mkdir models
+for m in \
+        $DATADIR/qa_model_repository/netdef_float32_float32_float32 \
+        $DATADIR/qa_model_repository/netdef_nobatch_float32_float32_float32 \
+        $DATADIR/qa_model_repository/onnx_float32_float32_float32 \
+        $DATADIR/qa_model_repository/onnx_nobatch_float32_float32_float32 \
+        $DATADIR/qa_model_repository/libtorch_float32_float32_float32 \
+        $DATADIR/qa_model_repository/libtorch_nobatch_float32_float32_float32 ; do
+    cp -r $m models/.
+done
+if [ -z "$TENSORRT_SERVER_CPU_ONLY" ]; then
+    cp -r $DATADIR/qa_model_repository/plan_float32_float32_float32 models/.
+    cp -r $DATADIR/qa_model_repository/plan_nobatch_float32_float32_float32 models/.
+fi
+
+RET=0
+
+$PACK `pwd`/models `pwd`/models.trtisrep
+if [ $? -ne 0 ]; then
+    echo -e "\n***\n*** Failed to pack repository\n***"
+    exit 1
+fi
+
+# The server must not need the original repository.
+rm -fr models
+
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+set +e
+
+python $ARCHIVE_TEST >$CLIENT_LOG 2>&1
+if [ $? -ne 0 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test Failed\n***"
+    RET=1
+fi
+
+# python unittest seems to swallow ImportError and still return 0
+# exit code. So need to explicitly check CLIENT_LOG to make sure
+# we see some running tests
+grep -c "HTTP/1.1 200 OK" $CLIENT_LOG
+if [ $? -ne 0 ]; then
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test Failed To Run\n***"
+    RET=1
+fi
+
+set -e
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+if [ $RET -eq 0 ]; then
+  echo -e "\n***\n*** Test Passed\n***"
+else
+    cat $SERVER_LOG
+    echo -e "\n***\n*** Test FAILED\n***"
+fi
+
+exit $RET
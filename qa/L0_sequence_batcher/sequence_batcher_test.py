@@ -331,6 +331,39 @@ class SequenceBatcherTest(unittest.TestCase):
                             "expected model-inference-count " + str(infer_cnt) + ", got " +
                             str(vs[1].model_inference_count))
 
+    def check_instance_status(self, model_name, active_cnt, executed):
+        ctx = ServerStatusContext("localhost:8000", ProtocolType.HTTP, model_name, True)
+        ss = ctx.get_server_status()
+        self.assertTrue(model_name in ss.model_status,
+                        "expected status for model " + model_name)
+
+        # Ensemble models don't use the sequence batcher so they don't
+        # report instance status.
+        vs = ss.model_status[model_name].version_status
+        if ss.model_status[model_name].config.platform == "ensemble":
+            self.assertEqual(len(vs[1].instance_status), 0)
+            return
+
+        # All model stores have the same total number of batch slots,
+        # split evenly across the model instances (see test.sh).
+        instances = vs[1].instance_status
+        self.assertEqual(len(instances), _model_instances,
+                         "expected " + str(_model_instances) +
+                         " instance status, got " + str(vs[1]))
+        for instance in instances:
+            self.assertEqual(instance.slot_count, 4 // _model_instances)
+            self.assertLessEqual(instance.active_slot_count, instance.slot_count)
+        self.assertEqual(sum(i.active_slot_count for i in instances), active_cnt,
+                         "expected " + str(active_cnt) +
+                         " active slots, got " + str(vs[1]))
+
+        # Only instances that executed have an execution time.
+        recent_ns = [i.recent_execution_time_ns for i in instances]
+        if executed:
+            self.assertGreater(max(recent_ns), 0)
+        else:
+            self.assertEqual(max(recent_ns), 0)
+
     def get_datatype(self, trial):
         # Get the datatype to use based on what models are available (see test.sh)
         if ("plan" in trial) or ("savedmodel" in trial):
@@ -414,6 +447,44 @@ class SequenceBatcherTest(unittest.TestCase):
                 except InferenceServerException as ex:
                     self.assertTrue(False, "unexpected error {}".format(ex))
 
+    def test_instance_status(self):
+        # Start a sequence and check that it occupies one batch slot
+        # in the instance status, then end it and check that the slot
+        # is released and the instance reports its execution time.
+        for trial in _trials:
+            try:
+                dtype = self.get_datatype(trial)
+                model_name = tu.get_sequence_model_name(trial, dtype)
+
+                self.check_setup(model_name)
+                self.assertFalse("TRTSERVER_DELAY_SCHEDULER" in os.environ)
+                self.assertFalse("TRTSERVER_BACKLOG_DELAY_SCHEDULER" in os.environ)
+
+                self.check_instance_status(model_name, 0, False)
+
+                self.check_sequence(trial, model_name, dtype, 7,
+                                    (4000, None),
+                                    # (flag_str, value, (ls_ms, gt_ms), (pre_delay, post_delay))
+                                    (("start", 1, None, None),
+                                     (None, 2, None, None)),
+                                    self.get_expected_result(3, 2, trial, None),
+                                    "http", sequence_name="{}_start".format(
+                                        self._testMethodName))
+                self.check_deferred_exception()
+                self.check_instance_status(model_name, 1, True)
+
+                self.check_sequence(trial, model_name, dtype, 7,
+                                    (4000, None),
+                                    # (flag_str, value, (ls_ms, gt_ms), (pre_delay, post_delay))
+                                    (("end", 3, None, None),),
+                                    self.get_expected_result(6, 3, trial, "end"),
+                                    "http", sequence_name="{}_end".format(
+                                        self._testMethodName))
+                self.check_deferred_exception()
+                self.check_instance_status(model_name, 0, True)
+            except InferenceServerException as ex:
+                self.assertTrue(False, "unexpected error {}".format(ex))
+
     def test_batch_size(self):
         # Send sequence with a batch-size > 1 and check for error.
 
@@ -135,6 +135,7 @@ for model_trial in v 0 1 2 4 ; do
     for i in \
             test_simple_sequence \
             test_length1_sequence \
+            test_instance_status \
             test_batch_size \
             test_no_sequence_start \
             test_no_sequence_start2 \
@@ -0,0 +1,108 @@
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import sys
+sys.path.append("../common")
+
+import unittest
+import numpy as np
+from tensorrtserver.api import *
+
+# The sequences sent by each test, as (correlation ID, flag) pairs in
+# the order they are sent. Each request is sent and completed before
+# the next, so the batch slots are assigned in a known order. With 3
+# sequences started in slots 0, 1 and 2, the executions are padded
+# as follows:
+#
+#   request      no compaction           compaction
+#   1001 start   slot 0, 0 padding       slot 0, 0 padding
+#   1002 start   slot 1, 1 padding       slot 1, 1 padding
+#   1003 start   slot 2, 2 padding       slot 2, 2 padding
+#   1001 end     slot 0, 0 padding       slot 0, 0 padding (1003 -> 0)
+#   1003 end     slot 2, 2 padding       slot 0, 0 padding (1002 -> 0)
+#   1002 end     slot 1, 1 padding       slot 0, 0 padding
+_sequence_steps = ((1001, "start"), (1002, "start"), (1003, "start"),
+                   (1001, "end"), (1003, "end"), (1002, "end"))
+
+class SequenceCompactionTest(unittest.TestCase):
+    def check_sequences(self, model_name):
+        ctxs = dict()
+        for correlation_id, _ in _sequence_steps:
+            if correlation_id not in ctxs:
+                ctxs[correlation_id] = InferContext(
+                    "localhost:8000", ProtocolType.HTTP, model_name,
+                    correlation_id=correlation_id, verbose=True)
+
+        for idx, (correlation_id, flag_str) in enumerate(_sequence_steps):
+            flags = InferRequestHeader.FLAG_SEQUENCE_START
+            if flag_str == "end":
+                flags = InferRequestHeader.FLAG_SEQUENCE_END
+
+            # The identity model returns the input so a request that
+            # ends up in the wrong slot returns the wrong value.
+            in0 = np.full((1,), idx + 1, dtype=np.int32)
+            results = ctxs[correlation_id].run(
+                { "INPUT0" : [ in0 ] },
+                { "OUTPUT0" : InferContext.ResultFormat.RAW },
+                batch_size=1, flags=flags)
+
+            self.assertEqual(len(results), 1)
+            self.assertTrue("OUTPUT0" in results)
+            self.assertEqual(results["OUTPUT0"][0][0], idx + 1)
+
+    def check_status(self, model_name, exec_cnt, infer_cnt, active_cnt):
+        ctx = ServerStatusContext("localhost:8000", ProtocolType.HTTP, model_name, True)
+        ss = ctx.get_server_status()
+        self.assertTrue(model_name in ss.model_status,
+                        "expected status for model " + model_name)
+        vs = ss.model_status[model_name].version_status
+        self.assertTrue(1 in vs, "expected status for version 1")
+
+        # Padding inferences are not counted as inferences, every
+        # request executes by itself.
+        self.assertEqual(vs[1].model_execution_count, exec_cnt,
+                         "expected model-execution-count " + str(exec_cnt) + ", got " +
+                         str(vs[1].model_execution_count))
+        self.assertEqual(vs[1].model_inference_count, infer_cnt,
+                         "expected model-inference-count " + str(infer_cnt) + ", got " +
+                         str(vs[1].model_inference_count))
+
+        instances = vs[1].instance_status
+        self.assertEqual(len(instances), 1)
+        self.assertEqual(sum(i.active_slot_count for i in instances), active_cnt)
+
+    def test_no_compaction(self):
+        model_name = "identity_sequence"
+        self.check_sequences(model_name)
+        self.check_status(model_name, len(_sequence_steps), len(_sequence_steps), 0)
+
+    def test_compaction(self):
+        model_name = "identity_sequence_compact"
+        self.check_sequences(model_name)
+        self.check_status(model_name, len(_sequence_steps), len(_sequence_steps), 0)
+
+if __name__ == '__main__':
+    unittest.main()
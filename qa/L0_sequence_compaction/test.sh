@@ -0,0 +1,157 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+# Check that compact_batch_slots moves active sequences into the
+# lowest free batch slots, and that nv_inference_padding_count
+# reports the idle slots padded in each execution. The same sequences
+# are sent to an identity model with and without compaction. The
+# identity model keeps no state per batch slot so sequences can be
+# moved between slots.
+
+CLIENT_LOG="./client.log"
+COMPACTION_TEST=sequence_compaction_test.py
+
+SERVER=/opt/tensorrtserver/bin/trtserver
+SERVER_ARGS="--model-store=`pwd`/models"
+SERVER_LOG="./inference_server.log"
+source ../common/util.sh
+
+rm -fr *.log models && mkdir models
+for MODEL in identity_sequence identity_sequence_compact ; do
+    mkdir -p models/$MODEL/1 && cp libidentity.so models/$MODEL/1/.
+    cat > models/$MODEL/config.pbtxt <<EOF2
+name: "$MODEL"
+platform: "custom"
+max_batch_size: 4
+default_model_filename: "libidentity.so"
+sequence_batching {
+  max_sequence_idle_microseconds: 5000000
+  control_input [
+    {
+      name: "START"
+      control [
+        {
+          kind: CONTROL_SEQUENCE_START
+          int32_false_true: [ 0, 1 ]
+        }
+      ]
+    },
+    {
+      name: "READY"
+      control [
+        {
+          kind: CONTROL_SEQUENCE_READY
+          int32_false_true: [ 0, 1 ]
+        }
+      ]
+    }
+  ]
+}
+input [
+  {
+    name: "INPUT0"
+    data_type: TYPE_INT32
+    dims: [ 1 ]
+  }
+]
+output [
+  {
+    name: "OUTPUT0"
+    data_type: TYPE_INT32
+    dims: [ 1 ]
+  }
+]
+instance_group [
+  {
+    kind: KIND_CPU
+    count: 1
+  }
+]
+EOF2
+done
+sed -i "s/max_sequence_idle_microseconds:.*/&\\n  compact_batch_slots: true/" \
+    models/identity_sequence_compact/config.pbtxt
+
+# Print the number of padding inferences reported for model $1.
+function padding_count() {
+    local model="$1"; shift
+
+    curl -s localhost:8002/metrics | \
+        grep "^nv_inference_padding_count{.*model=\"$model\"" | \
+        awk '{ sum += $2 } END { printf "%d\n", sum }'
+}
+
+RET=0
+
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+# Each test sends the same sequences, so the expected padding only
+# differs because of compaction (see $COMPACTION_TEST).
+for TEST in \
+        "test_no_compaction identity_sequence 6" \
+        "test_compaction identity_sequence_compact 3" ; do
+    set -- $TEST
+    echo "Test: $1" >>$CLIENT_LOG
+
+    set +e
+    python $COMPACTION_TEST SequenceCompactionTest.$1 >>$CLIENT_LOG 2>&1
+    if [ $? -ne 0 ]; then
+        echo -e "\n***\n*** Test Failed\n***"
+        RET=1
+    fi
+
+    if [ `padding_count $2` -ne $3 ]; then
+        echo -e "\n***\n*** $1: expected $3 padding inferences, got `padding_count $2`\n***"
+        RET=1
+    fi
+    set -e
+done
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+# python unittest seems to swallow ImportError and still return 0 exit
+# code. So need to explicitly check CLIENT_LOG to make sure we see
+# some running tests
+grep -c "HTTP/1.1 200 OK" $CLIENT_LOG
+if [ $? -ne 0 ]; then
+    echo -e "\n***\n*** Test Failed To Run\n***"
+    RET=1
+fi
+
+if [ $RET -eq 0 ]; then
+    echo -e "\n***\n*** Test Passed\n***"
+else
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test FAILED\n***"
+fi
+
+exit $RET
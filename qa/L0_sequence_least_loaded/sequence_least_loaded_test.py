@@ -0,0 +1,109 @@
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+import sys
+sys.path.append("../common")
+
+import time
+import unittest
+import numpy as np
+from tensorrtserver.api import *
+
+_model_name = "custom_sequence_int32"
+
+# Instance status is reported in batcher order, see test.sh.
+_slow_idx = 0
+_fast_idx = 1
+
+class SequenceLeastLoadedTest(unittest.TestCase):
+    def run_async(self, ctx, value, flags):
+        in0 = np.full((1,), value, dtype=np.int32)
+        return ctx.async_run(
+            { "INPUT" : [ in0 ] }, { "OUTPUT" : InferContext.ResultFormat.RAW },
+            batch_size=1, flags=flags)
+
+    def check_result(self, ctx, request_id, expected):
+        results = ctx.get_async_run_results(request_id, True)
+        self.assertEqual(len(results), 1)
+        self.assertTrue("OUTPUT" in results)
+        self.assertEqual(results["OUTPUT"][0][0], expected)
+
+    def check_active_slots(self, slow_cnt, fast_cnt):
+        ctx = ServerStatusContext("localhost:8000", ProtocolType.HTTP, _model_name, True)
+        ss = ctx.get_server_status()
+        self.assertTrue(_model_name in ss.model_status,
+                        "expected status for model " + _model_name)
+        vs = ss.model_status[_model_name].version_status
+        self.assertTrue(1 in vs, "expected status for version 1")
+
+        instances = vs[1].instance_status
+        self.assertEqual(len(instances), 2)
+        self.assertEqual(instances[_slow_idx].active_slot_count, slow_cnt,
+                         "expected " + str(slow_cnt) + " active slots in slow instance, got " +
+                         str(instances[_slow_idx].active_slot_count))
+        self.assertEqual(instances[_fast_idx].active_slot_count, fast_cnt,
+                         "expected " + str(fast_cnt) + " active slots in fast instance, got " +
+                         str(instances[_fast_idx].active_slot_count))
+
+    def test_slow_instance(self):
+        ctxs = dict()
+        for correlation_id in (1001, 1002, 1003):
+            ctxs[correlation_id] = InferContext(
+                "localhost:8000", ProtocolType.HTTP, _model_name,
+                correlation_id=correlation_id, verbose=True)
+
+        start = InferRequestHeader.FLAG_SEQUENCE_START
+        end = InferRequestHeader.FLAG_SEQUENCE_END
+
+        # Both instances are idle so the tie goes to the slow
+        # instance. The next sequence then goes to the fast instance
+        # because the slow instance has more active slots.
+        self.check_result(ctxs[1001], self.run_async(ctxs[1001], 1, start), 1)
+        self.check_active_slots(1, 0)
+        self.check_result(ctxs[1002], self.run_async(ctxs[1002], 10, start), 10)
+        self.check_active_slots(1, 1)
+
+        # Keep the slow instance executing while the next sequence
+        # starts. Each instance has one active slot, so only the
+        # request in the slow instance sends the sequence to the fast
+        # instance.
+        slow_id = self.run_async(ctxs[1001], 2, 0)
+        time.sleep(0.5)
+        self.check_result(ctxs[1003], self.run_async(ctxs[1003], 100, start), 100)
+        self.check_active_slots(1, 2)
+        self.check_result(ctxs[1001], slow_id, 3)
+
+        # End all sequences.
+        for correlation_id, value, expected in (
+                (1001, 3, 6), (1002, 20, 30), (1003, 200, 300)):
+            self.check_result(
+                ctxs[correlation_id],
+                self.run_async(ctxs[correlation_id], value, end), expected)
+        self.check_active_slots(0, 0)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,115 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+
+# Check that SLOT_ASSIGNMENT_LEAST_LOADED sends new sequences away
+# from a model instance that is slow to work through its requests.
+# The sequence model is configured with a slow and a fast instance
+# and one batch slot left free in each, so the slot count alone
+# doesn't decide where the next sequence goes.
+
+CLIENT_LOG="./client.log"
+LEAST_LOADED_TEST=sequence_least_loaded_test.py
+
+SERVER=/opt/tensorrtserver/bin/trtserver
+SERVER_ARGS="--model-store=`pwd`/models"
+SERVER_LOG="./inference_server.log"
+source ../common/util.sh
+
+# The instances are named after their group, so the slow instance is
+# "slow_0_cpu". It is listed first so that it is batcher 0 and wins
+# ties.
+MODEL=custom_sequence_int32
+rm -fr *.log models && mkdir models
+cp -r ../custom_models/$MODEL models/.
+(cd models/$MODEL && \
+    sed -i "s/^max_batch_size:.*/max_batch_size: 2/" config.pbtxt && \
+    sed -i "s/max_sequence_idle_microseconds:.*/&\\n  slot_assignment: SLOT_ASSIGNMENT_LEAST_LOADED/" \
+        config.pbtxt && \
+    sed -i '/^parameters \[/,$d' config.pbtxt && \
+    cat >> config.pbtxt <<EOF2
+parameters [
+  {
+    key: "execute_delay_ms"
+    value: { string_value: "0" }
+  },
+  {
+    key: "execute_delay_ms.slow_0_cpu"
+    value: { string_value: "2000" }
+  }
+]
+instance_group [
+  {
+    name: "slow"
+    kind: KIND_CPU
+    count: 1
+  },
+  {
+    name: "fast"
+    kind: KIND_CPU
+    count: 1
+  }
+]
+EOF2
+)
+
+RET=0
+
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+set +e
+python $LEAST_LOADED_TEST >>$CLIENT_LOG 2>&1
+if [ $? -ne 0 ]; then
+    echo -e "\n***\n*** Test Failed\n***"
+    RET=1
+fi
+set -e
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+# python unittest seems to swallow ImportError and still return 0 exit
+# code. So need to explicitly check CLIENT_LOG to make sure we see
+# some running tests
+grep -c "HTTP/1.1 200 OK" $CLIENT_LOG
+if [ $? -ne 0 ]; then
+    echo -e "\n***\n*** Test Failed To Run\n***"
+    RET=1
+fi
+
+if [ $RET -eq 0 ]; then
+    echo -e "\n***\n*** Test Passed\n***"
+else
+    cat $CLIENT_LOG
+    echo -e "\n***\n*** Test FAILED\n***"
+fi
+
+exit $RET
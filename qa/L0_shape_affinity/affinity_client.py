@@ -0,0 +1,60 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import argparse
+import numpy as np
+import sys
+
+from tensorrtserver.api import *
+
+# Send requests of one input shape, one at a time, to a variable-size
+# addsub model and check the results.
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-m', '--model', type=str, required=True,
+                        help='Name of the model.')
+    parser.add_argument('-s', '--size', type=int, required=True,
+                        help='Number of elements in each input.')
+    parser.add_argument('-c', '--count', type=int, required=False, default=20,
+                        help='Number of requests to send.')
+    FLAGS = parser.parse_args()
+
+    ctx = InferContext("localhost:8000", ProtocolType.HTTP, FLAGS.model)
+    input0 = np.arange(FLAGS.size, dtype=np.int32)
+    input1 = np.ones(FLAGS.size, dtype=np.int32)
+    for _ in range(FLAGS.count):
+        results = ctx.run({ 'INPUT0' : (input0,), 'INPUT1' : (input1,) },
+                          { 'OUTPUT0' : InferContext.ResultFormat.RAW,
+                            'OUTPUT1' : InferContext.ResultFormat.RAW },
+                          1)
+        if not np.array_equal(results['OUTPUT0'][0], input0 + input1):
+            print("error: incorrect sum")
+            sys.exit(1)
+        if not np.array_equal(results['OUTPUT1'][0], input0 - input1):
+            print("error: incorrect difference")
+            sys.exit(1)
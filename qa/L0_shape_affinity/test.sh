@@ -0,0 +1,121 @@
+#!/bin/bash
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Check that the dynamic batcher executes each input shape on the
+# instance that the shape prefers when that instance is idle, and
+# that a shape affinity count that leaves no other instance is
+# rejected.
+
+AFFINITY_CLIENT=affinity_client.py
+CLIENT_LOG="./client.log"
+MODEL=custom_int32_int32_int32
+
+SERVER=/opt/tensorrtserver/bin/trtserver
+SERVER_ARGS="--model-store=`pwd`/models --log-verbose=1"
+SERVER_LOG="./inference_server.log"
+source ../common/util.sh
+
+function create_model() {
+    local affinity_cnt="$1"; shift
+
+    rm -fr models && mkdir models
+    cp -r ../custom_models/$MODEL models/.
+    sed -i "s/dims: \[ 16 \]/dims: [ -1 ]/g" models/$MODEL/config.pbtxt
+    cat >> models/$MODEL/config.pbtxt <<EOF2
+instance_group [ { kind: KIND_CPU count: 4 } ]
+dynamic_batching {
+  preferred_batch_size: [ 1 ]
+  shape_affinity_count: $affinity_cnt
+}
+EOF2
+}
+
+rm -f *.log
+
+RET=0
+
+create_model 1
+run_server
+if [ "$SERVER_PID" == "0" ]; then
+    echo -e "\n***\n*** Failed to start $SERVER\n***"
+    cat $SERVER_LOG
+    exit 1
+fi
+
+set +e
+
+# Requests are sent one at a time so the preferred instance is always
+# idle when a request arrives and every request of a shape must
+# execute on that one instance.
+for SIZE in 16 32 48 64 80; do
+    START=$((`wc -l < $SERVER_LOG` + 1))
+    python $AFFINITY_CLIENT -m $MODEL -s $SIZE >>$CLIENT_LOG 2>&1
+    if [ $? -ne 0 ]; then
+        RET=1
+    fi
+
+    INSTANCES=`tail -n +$START $SERVER_LOG | \
+        grep -o "Running ${MODEL}_[0-9]*_cpu with" | sort -u | wc -l`
+    if [ "$INSTANCES" != "1" ]; then
+        echo -e "\n***\n*** Size $SIZE executed on $INSTANCES instances\n***"
+        RET=1
+    fi
+done
+
+set -e
+
+kill $SERVER_PID
+wait $SERVER_PID
+
+# An affinity count equal to the instance count is invalid.
+create_model 4
+run_server
+if [ "$SERVER_PID" != "0" ]; then
+    echo -e "\n***\n*** Unexpected server start $SERVER\n***"
+    kill $SERVER_PID
+    wait $SERVER_PID
+    RET=1
+fi
+
+set +e
+grep "shape affinity count must be < the number of model instances (4)" \
+    $SERVER_LOG
+if [ $? -ne 0 ]; then
+    echo -e "\n***\n*** Expected shape affinity count error\n***"
+    RET=1
+fi
+set -e
+
+if [ $RET -eq 0 ]; then
+    echo -e "\n***\n*** Test Passed\n***"
+else
+    cat $CLIENT_LOG
+    cat $SERVER_LOG
+    echo -e "\n***\n*** Test FAILED\n***"
+fi
+
+exit $RET
@@ -540,6 +540,64 @@ output [
         cfile.write(config)
 
 
+def create_libtorch_dropout_modelfile(models_dir, model_version):
+    # Model that applies dropout to its input. It is saved in training
+    # mode, so every output element is either 0 or twice the input
+    # element unless the server switches the model to evaluation mode,
+    # in which case the output equals the input.
+    model_name = "libtorch_dropout_float32"
+
+    class DropoutNet(torch.jit.ScriptModule):
+        def __init__(self):
+            super(DropoutNet, self).__init__()
+        @torch.jit.script_method
+        def forward(self, input0):
+            return torch.dropout(input0, 0.5, self.training)
+    dropoutModel = DropoutNet()
+    dropoutModel.train()
+
+    model_version_dir = models_dir + "/" + model_name + "/" + str(model_version)
+
+    try:
+        os.makedirs(model_version_dir)
+    except OSError as ex:
+        pass # ignore existing dir
+
+    dropoutModel.save(model_version_dir + "/model.pt")
+
+
+def create_libtorch_dropout_modelconfig(models_dir, model_version):
+    model_name = "libtorch_dropout_float32"
+    config_dir = models_dir + "/" + model_name
+    config = '''
+name: "{}"
+platform: "pytorch_libtorch"
+max_batch_size: 8
+input [
+  {{
+    name: "INPUT__0"
+    data_type: TYPE_FP32
+    dims: [ 16 ]
+  }}
+]
+output [
+  {{
+    name: "OUTPUT__0"
+    data_type: TYPE_FP32
+    dims: [ 16 ]
+  }}
+]
+'''.format(model_name)
+
+    try:
+        os.makedirs(config_dir)
+    except OSError as ex:
+        pass # ignore existing dir
+
+    with open(config_dir + "/config.pbtxt", "w") as cfile:
+        cfile.write(config)
+
+
 def create_models(models_dir, dtype, shape, io_cnt=1, no_batch=True):
     model_version = 1
 
@@ -626,3 +684,7 @@ if __name__ == '__main__':
     create_models(FLAGS.models_dir, np.float16, [-1,-1], io_cnt=3)
     create_models(FLAGS.models_dir, np_dtype_string, [-1], io_cnt=1)
     create_models(FLAGS.models_dir, np_dtype_string, [-1,-1], io_cnt=3)
+
+    if FLAGS.libtorch:
+        create_libtorch_dropout_modelconfig(FLAGS.models_dir, 1)
+        create_libtorch_dropout_modelfile(FLAGS.models_dir, 1)
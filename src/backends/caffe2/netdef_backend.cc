@@ -359,14 +359,17 @@ NetDefBackend::Run(
     }
   }
 
-  OnCompleteQueuedPayloads(contexts_[runner_idx].Run(this, payloads));
+  Status status = contexts_[runner_idx].Run(this, payloads);
+  compute_timers.clear();
+  OnCompleteQueuedPayloads(status);
 }
 
 Status
 NetDefBackend::Context::SetFixedSizedInputTensor(
-    const std::string& name, const std::vector<int64_t>& shape,
-    const Caffe2Workspace::DataType dtype, const size_t batch1_byte_size,
-    const size_t total_byte_size, std::vector<Scheduler::Payload>* payloads,
+    const int input_idx, const std::string& name,
+    const std::vector<int64_t>& shape, const Caffe2Workspace::DataType dtype,
+    const size_t batch1_byte_size, const size_t total_byte_size,
+    std::vector<Scheduler::Payload>* payloads,
     std::vector<std::unique_ptr<char[]>>* input_buffers)
 {
   // The entire input tensor must be delivered as a single
@@ -380,17 +383,19 @@ NetDefBackend::Context::SetFixedSizedInputTensor(
   // Visit the payloads in order and copy the input tensors to
   // 'buffer'.
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_byte_size =
-        request_header.batch_size() * batch1_byte_size;
+        payload.request_provider_->Descriptor().batch_size_ * batch1_byte_size;
 
     size_t copied_byte_size = 0;
     while (payload.status_.IsOk()) {
       const void* content;
       size_t content_byte_size = expected_byte_size - copied_byte_size;
-      payload.status_ = payload.request_provider_->GetNextInputContent(
-          name, &content, &content_byte_size, false);
+      payload.status_ =
+          (input_idx >= 0)
+              ? payload.request_provider_->GetNextInputContent(
+                    input_idx, &content, &content_byte_size, false)
+              : payload.request_provider_->GetNextInputContent(
+                    name, &content, &content_byte_size, false);
       if (!payload.status_.IsOk()) {
         break;
       }
@@ -485,10 +490,8 @@ NetDefBackend::Context::ReadFixedSizedOutputTensor(
   size_t content_offset = 0;
 
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_byte_size =
-        request_header.batch_size() * batch1_byte_size;
+        payload.request_provider_->Descriptor().batch_size_ * batch1_byte_size;
 
     // If 'payload' requested this output then copy it from
     // 'content'. If it did not request this output then just
@@ -515,8 +518,9 @@ NetDefBackend::Context::ReadFixedSizedOutputTensor(
 
 Status
 NetDefBackend::Context::SetInput(
-    const std::string& name, const DataType datatype, const DimsList& dims,
-    const size_t total_batch_size, std::vector<Scheduler::Payload>* payloads,
+    const int input_idx, const std::string& name, const DataType datatype,
+    const DimsList& dims, const size_t total_batch_size,
+    std::vector<Scheduler::Payload>* payloads,
     std::vector<std::unique_ptr<char[]>>* input_buffers)
 {
   // Get the shape of the input. The provider has already checked that
@@ -543,8 +547,8 @@ NetDefBackend::Context::SetInput(
   const size_t total_byte_size = total_batch_size * batch1_byte_size;
 
   return SetFixedSizedInputTensor(
-      name, shape, dtype, batch1_byte_size, total_byte_size, payloads,
-      input_buffers);
+      input_idx, name, shape, dtype, batch1_byte_size, total_byte_size,
+      payloads, input_buffers);
 }
 
 Status
@@ -569,7 +573,7 @@ NetDefBackend::Context::Run(
               name_ + "'");
     }
 
-    total_batch_size += payload.request_provider_->RequestHeader().batch_size();
+    total_batch_size += payload.request_provider_->Descriptor().batch_size_;
 
     // All payloads must have equally-sized input tensors so use any
     // payload as the representative for the input tensors.
@@ -601,15 +605,17 @@ NetDefBackend::Context::Run(
   // into the corresponding tensor.
 
   // Inputs from the request...
-  for (const auto& input : input_request_provider->RequestHeader().input()) {
-    const std::string& name = input.name();
-
-    const ModelInput* input_config;
-    RETURN_IF_ERROR(base->GetInput(name, &input_config));
+  const InferRequestDescriptor& descriptor =
+      input_request_provider->Descriptor();
+  for (size_t idx = 0; idx < descriptor.inputs_.size(); ++idx) {
+    const ModelInput& input_config = base->Config().input(idx);
+    const InferRequestHeader::Input& input =
+        input_request_provider->RequestHeader().input(
+            descriptor.inputs_[idx].request_index_);
 
     RETURN_IF_ERROR(SetInput(
-        name, input_config->data_type(), input.dims(), total_batch_size,
-        payloads, &input_buffers));
+        idx, input_config.name(), input_config.data_type(), input.dims(),
+        total_batch_size, payloads, &input_buffers));
   }
 
   // Additional inputs added to the provider...
@@ -621,8 +627,8 @@ NetDefBackend::Context::Run(
       const std::shared_ptr<InferRequestProvider::InputOverride>& override =
           pr.second;
       RETURN_IF_ERROR(SetInput(
-          name, override->datatype_, override->dims_, total_batch_size,
-          payloads, &input_buffers));
+          -1 /* input_idx */, name, override->datatype_, override->dims_,
+          total_batch_size, payloads, &input_buffers));
     }
   }
 
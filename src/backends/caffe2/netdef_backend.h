@@ -85,10 +85,12 @@ class NetDefBackend : public InferenceBackend {
     Status ValidateOutputs(
         const ::google::protobuf::RepeatedPtrField<ModelOutput>& ios);
 
-    // Set an input tensor data from payloads.
+    // Set an input tensor data from payloads. 'input_idx' is the
+    // index of the input in the request descriptor, or -1 for an
+    // override input that is only known by 'name'.
     Status SetInput(
-        const std::string& name, const DataType datatype, const DimsList& dims,
-        const size_t total_batch_size,
+        const int input_idx, const std::string& name, const DataType datatype,
+        const DimsList& dims, const size_t total_batch_size,
         std::vector<Scheduler::Payload>* payloads,
         std::vector<std::unique_ptr<char[]>>* input_buffers);
 
@@ -103,7 +105,8 @@ class NetDefBackend : public InferenceBackend {
 
     // Set an input tensor from one or more payloads.
     Status SetFixedSizedInputTensor(
-        const std::string& input_name, const std::vector<int64_t>& shape,
+        const int input_idx, const std::string& input_name,
+        const std::vector<int64_t>& shape,
         const Caffe2Workspace::DataType dtype, const size_t batch1_byte_size,
         const size_t total_byte_size, std::vector<Scheduler::Payload>* payloads,
         std::vector<std::unique_ptr<char[]>>* input_buffers);
@@ -49,7 +49,11 @@ extern "C" {
 /// The number of server parameters provided to custom backend for
 /// initialization. This must keep aligned with CustomServerParameter
 /// enum values.
-#define CUSTOM_SERVER_PARAMETER_CNT 2
+#define CUSTOM_SERVER_PARAMETER_CNT 3
+
+/// The version of CustomInitializeData provided by this server, given
+/// to custom backends as the INITDATA_VERSION server parameter.
+#define CUSTOM_INITDATA_VERSION 1
 
 /// The server parameter values provided to custom backends. New
 /// values must be added using the next greater integer value and
@@ -59,9 +63,93 @@ typedef enum custom_serverparamkind_enum {
   INFERENCE_SERVER_VERSION = 0,
 
   /// The absolute path to the root directory of the model repository.
-  MODEL_REPOSITORY_PATH = 1
+  MODEL_REPOSITORY_PATH = 1,
+
+  /// The version of CustomInitializeData, see
+  /// CUSTOM_INITDATA_VERSION. Servers that don't provide this
+  /// parameter don't provide 'struct_size' or any later field of
+  /// CustomInitializeData.
+  INITDATA_VERSION = 2
 } CustomServerParameter;
 
+/// Type for a task run by the server thread pool using the
+/// CustomSubmitTask callback function.
+///
+/// \param task_context The context given when the task was submitted.
+typedef void (*CustomTaskFn_t)(void* task_context);
+
+/// Type for a range of work run by the server thread pool using the
+/// CustomParallelFor callback function.
+///
+/// \param task_context The context given to CustomParallelFor.
+/// \param begin The first index of the range.
+/// \param end One past the last index of the range.
+typedef void (*CustomRangeTaskFn_t)(
+    void* task_context, size_t begin, size_t end);
+
+/// Type for the CustomSubmitTask callback function.
+///
+/// This callback function is provided in CustomInitializeData and
+/// runs 'task_fn' asynchronously on the server thread pool. The
+/// function returns as soon as the task is queued. The custom backend
+/// is responsible for waiting for the task to complete before
+/// 'task_context' is freed or the backend is finalized.
+///
+/// \param thread_pool The 'thread_pool' from CustomInitializeData.
+/// \param task_fn The function to run.
+/// \param task_context The context to pass to 'task_fn'.
+/// \return false if error, true if success.
+typedef bool (*CustomSubmitTaskFn_t)(
+    void* thread_pool, CustomTaskFn_t task_fn, void* task_context);
+
+/// Type for the CustomParallelFor callback function.
+///
+/// This callback function is provided in CustomInitializeData and
+/// splits the indices [0, 'count') into ranges of 'grain' indices
+/// that are run by 'task_fn' in parallel on the server thread
+/// pool. The calling thread also runs ranges, and the function
+/// returns once all ranges are complete. It may be called from
+/// within a task running on the thread pool.
+///
+/// \param thread_pool The 'thread_pool' from CustomInitializeData.
+/// \param count The number of indices.
+/// \param grain The number of indices in each range. The last range
+/// may have fewer.
+/// \param task_fn The function to run for each range.
+/// \param task_context The context to pass to 'task_fn'.
+/// \return false if error, true if success.
+typedef bool (*CustomParallelForFn_t)(
+    void* thread_pool, size_t count, size_t grain, CustomRangeTaskFn_t task_fn,
+    void* task_context);
+
+/// Type for the CustomAlloc callback function.
+///
+/// This callback function is provided in CustomInitializeData and
+/// allocates host memory for use by the custom backend, for example
+/// for scratch or intermediate buffers. The memory comes from a pool
+/// owned by the server that reuses buffers across executions, and is
+/// reported as memory used by the model. The memory must be freed
+/// with the CustomFree callback function.
+///
+/// \param allocator The 'allocator' from CustomInitializeData.
+/// \param byte_size The size of the memory to allocate, in bytes.
+/// \param buffer Returns the allocated memory. The memory is aligned
+/// to at least 64 bytes.
+/// \return false if error, true if success.
+typedef bool (*CustomAllocFn_t)(
+    void* allocator, uint64_t byte_size, void** buffer);
+
+/// Type for the CustomFree callback function.
+///
+/// This callback function is provided in CustomInitializeData and
+/// frees memory allocated with the CustomAlloc callback function.
+///
+/// \param allocator The 'allocator' from CustomInitializeData.
+/// \param buffer The memory to free. It must have been allocated
+/// from the same 'allocator'.
+/// \return false if error, true if success.
+typedef bool (*CustomFreeFn_t)(void* allocator, void* buffer);
+
 // The initialization information provided to a custom backend when it
 // is created.
 typedef struct custom_initdata_struct {
@@ -90,8 +178,56 @@ typedef struct custom_initdata_struct {
   /// and must be copied if a persistent copy of required by the
   /// custom backend.
   const char** server_parameters;
+
+  /// The size of this structure, in bytes, as provided by the
+  /// server. 'struct_size' and the fields after it were added in later
+  /// server versions and are not provided by servers that don't
+  /// provide the INITDATA_VERSION server parameter. A custom backend
+  /// must check that a field is provided, using
+  /// CUSTOM_INITDATA_HAS_FIELD, before using it.
+  size_t struct_size;
+
+  /// Opaque handle to the thread pool owned by the server. The pool
+  /// is shared by all custom backends and sized to the CPUs
+  /// available to the server, so custom backends should run parallel
+  /// work on it instead of creating their own threads.
+  void* thread_pool;
+
+  /// The number of threads in 'thread_pool'.
+  size_t thread_pool_thread_cnt;
+
+  /// The callback function to submit a task to 'thread_pool' (see
+  /// CustomSubmitTaskFn_t).
+  CustomSubmitTaskFn_t submit_task_fn;
+
+  /// The callback function to run a parallel loop on 'thread_pool'
+  /// (see CustomParallelForFn_t).
+  CustomParallelForFn_t parallel_for_fn;
+
+  /// Opaque handle to the server allocator for this model. All
+  /// memory allocated from it must be freed before CustomFinalize
+  /// returns.
+  void* allocator;
+
+  /// The callback function to allocate memory from 'allocator' (see
+  /// CustomAllocFn_t).
+  CustomAllocFn_t alloc_fn;
+
+  /// The callback function to free memory allocated from 'allocator'
+  /// (see CustomFreeFn_t).
+  CustomFreeFn_t free_fn;
 } CustomInitializeData;
 
+/// True if the CustomInitializeData pointed to by 'data' includes
+/// 'field', that is if the server that provided it knows about
+/// 'field'. 'struct_size' is only read if the server provides the
+/// INITDATA_VERSION server parameter, older servers don't provide
+/// 'struct_size' at all.
+#define CUSTOM_INITDATA_HAS_FIELD(data, field)                         \
+  (((data)->server_parameter_cnt > INITDATA_VERSION) &&                \
+   ((data)->struct_size >=                                             \
+    (offsetof(CustomInitializeData, field) + sizeof((data)->field))))
+
 /// A payload represents the input tensors and the required output
 /// needed for execution in the backend.
 typedef struct custom_payload_struct {
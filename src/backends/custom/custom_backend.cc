@@ -32,6 +32,7 @@
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/object_pool.h"
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
 
@@ -67,15 +68,34 @@ CustomBackend::Context::~Context()
   library_handle_ = nullptr;
 }
 
+CustomBackend::Allocator::~Allocator()
+{
+  if (byte_size_ != 0) {
+    LOG_ERROR << "custom backend did not free " << byte_size_
+              << " bytes allocated through the server";
+  }
+}
+
 Status
 CustomBackend::Init(
     const std::string& path, const std::vector<std::string>& server_params,
+    const std::shared_ptr<ThreadPool>& thread_pool,
+    const std::shared_ptr<HostMemoryPool>& memory_pool,
     const ModelConfig& config)
 {
   RETURN_IF_ERROR(ValidateModelConfig(config, kCustomPlatform));
   RETURN_IF_ERROR(SetModelConfig(path, config));
 
   server_params_ = server_params;
+  thread_pool_ = thread_pool;
+
+  allocator_.reset(new Allocator);
+  allocator_->pool_ = memory_pool;
+  allocator_->byte_size_ = 0;
+#ifdef TRTIS_ENABLE_METRICS
+  allocator_->metric_byte_size_ =
+      &MetricReporter()->MetricInferenceScratchMemory(-1 /* gpu_device */);
+#endif  // TRTIS_ENABLE_METRICS
 
   return Status::Success;
 }
@@ -225,6 +245,15 @@ CustomBackend::InitBackend(uint32_t runner_idx)
     init_data.server_parameters = nullptr;
   }
 
+  init_data.struct_size = sizeof(init_data);
+  init_data.thread_pool = thread_pool_.get();
+  init_data.thread_pool_thread_cnt = thread_pool_->ThreadCount();
+  init_data.submit_task_fn = CustomSubmitTask;
+  init_data.parallel_for_fn = CustomParallelFor;
+  init_data.allocator = allocator_.get();
+  init_data.alloc_fn = CustomAlloc;
+  init_data.free_fn = CustomFree;
+
   int err =
       context->InitializeFn_(&init_data, &(context->library_context_handle_));
   if (err != 0) {
@@ -251,7 +280,10 @@ CustomBackend::RunBackend(
     return;
   }
 
-  std::vector<ModelInferStats::ScopedTimer> compute_timers;
+  std::vector<
+      ModelInferStats::ScopedTimer, PoolAllocator<ModelInferStats::ScopedTimer>>
+      compute_timers;
+  compute_timers.reserve(payloads->size());
   for (auto& payload : *payloads) {
     // Stop queue timer when the payload is scheduled to run
     if (payload.queue_timer_ != nullptr) {
@@ -265,7 +297,9 @@ CustomBackend::RunBackend(
     }
   }
 
-  OnCompleteQueuedPayloads(contexts_[runner_idx]->Run(this, payloads));
+  Status status = contexts_[runner_idx]->Run(this, payloads);
+  compute_timers.clear();
+  OnCompleteQueuedPayloads(status);
 }
 
 Status
@@ -275,28 +309,6 @@ CustomBackend::Context::Run(
   LOG_VERBOSE(1) << "Running " << name_ << " with " << payloads->size()
                  << " request payloads";
 
-  // Each payload will have the same number and shape for inputs. Get
-  // the shape for each input into a vector suitable to passing via
-  // the custom backend interface. As a performance improvement for
-  // models that don't have any variable-size input tensors we could
-  // calculate the input tensor shapes once during backend
-  // initialization.
-  std::unordered_map<std::string, std::unique_ptr<std::vector<int64_t>>>
-      input_shapes;
-
-  if (!payloads->empty()) {
-    const InferRequestHeader& request_header =
-        payloads->front().request_provider_->RequestHeader();
-
-    for (const auto& input : request_header.input()) {
-      std::unique_ptr<std::vector<int64_t>> shape(new std::vector<int64_t>());
-      for (auto d : input.dims()) {
-        shape->push_back(d);
-      }
-      input_shapes.emplace(std::make_pair(input.name(), std::move(shape)));
-    }
-  }
-
   // For each request in 'payloads' collect the total batch size for
   // this inference execution. The batch-size, number of inputs, and
   // size of each input has already been checked by each payload's
@@ -312,12 +324,13 @@ CustomBackend::Context::Run(
               name_ + "'");
     }
 
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
+    const InferRequestDescriptor& descriptor =
+        payload.request_provider_->Descriptor();
 
-    total_batch_size += request_header.batch_size();
-    total_inputs += request_header.input_size();
-    total_requested_outputs += request_header.output_size();
+    total_batch_size += descriptor.batch_size_;
+    total_inputs += descriptor.inputs_.size();
+    total_requested_outputs +=
+        payload.request_provider_->RequestHeader().output_size();
   }
 
   // If there are no valid payloads then no need to run the
@@ -340,58 +353,56 @@ CustomBackend::Context::Run(
   // We use the following to hold pointers to all the input and output
   // names of the payloads. We don't want this to resize as that will
   // invalidate the pointers so set the capacity big enough to hold
-  // all the pointers for all the payloads.
-  std::vector<const char*> work_input_name_ptrs;
+  // all the pointers for all the payloads. The work vectors are
+  // needed for every execution so they are taken from the pool.
+  std::vector<const char*, PoolAllocator<const char*>> work_input_name_ptrs;
   work_input_name_ptrs.reserve(total_inputs);
-  std::vector<const char*> work_output_name_ptrs;
+  std::vector<const char*, PoolAllocator<const char*>> work_output_name_ptrs;
   work_output_name_ptrs.reserve(total_requested_outputs);
 
   // Similarly for input dim sizes and the dimension values.
-  std::vector<size_t> work_input_dim_cnts;
+  std::vector<size_t, PoolAllocator<size_t>> work_input_dim_cnts;
   work_input_dim_cnts.reserve(total_inputs);
-  std::vector<const int64_t*> work_input_dims_ptrs;
+  std::vector<const int64_t*, PoolAllocator<const int64_t*>>
+      work_input_dims_ptrs;
   work_input_dims_ptrs.reserve(total_inputs);
 
   // We use the following to hold contexts needed for the input and
   // output callbacks. We don't want this to resize as that will
   // invalidate the pointers so set the capacity big enough to hold
   // the contexts for all the payloads.
-  std::vector<GetInputOutputContext> work_io_contexts;
+  std::vector<GetInputOutputContext, PoolAllocator<GetInputOutputContext>>
+      work_io_contexts;
   work_io_contexts.reserve(payloads->size());
 
   // Collect the payload information into a array of custom::Payload
   // structs that can be passed to the backend. Every payload must
   // have an OK status (checked above) so we don't bother to check
   // that here.
-  std::vector<CustomPayload> custom_payloads;
+  std::vector<CustomPayload, PoolAllocator<CustomPayload>> custom_payloads;
+  custom_payloads.reserve(payloads->size());
   for (auto& payload : *payloads) {
     const InferRequestHeader& request_header =
         payload.request_provider_->RequestHeader();
+    const InferRequestDescriptor& descriptor =
+        payload.request_provider_->Descriptor();
 
     custom_payloads.emplace_back();
     CustomPayload& custom_payload = custom_payloads.back();
-    custom_payload.batch_size = request_header.batch_size();
+    custom_payload.batch_size = descriptor.batch_size_;
 
-    // Inputs
-    custom_payload.input_cnt = request_header.input_size();
+    // Inputs. The shapes are passed directly from the request
+    // descriptor, which lives as long as the payload.
+    custom_payload.input_cnt = descriptor.inputs_.size();
     custom_payload.input_names = nullptr;
     custom_payload.input_shape_dim_cnts = nullptr;
     custom_payload.input_shape_dims = nullptr;
-    for (const auto& input : request_header.input()) {
-      auto itr = input_shapes.find(input.name());
-      if (itr == input_shapes.end()) {
-        return Status(
-            RequestStatusCode::INTERNAL, "unable to find shape for input '" +
-                                             input.name() + "' for '" + name_ +
-                                             "'");
-      }
-
-      std::unique_ptr<std::vector<int64_t>>& shape = itr->second;
-
-      work_input_name_ptrs.push_back(input.name().c_str());
-      work_input_dim_cnts.push_back(shape->size());
+    for (const auto& input : descriptor.inputs_) {
+      work_input_name_ptrs.push_back(
+          request_header.input(input.request_index_).name().c_str());
+      work_input_dim_cnts.push_back(input.DimsCount());
       work_input_dims_ptrs.push_back(
-          (shape->size() == 0) ? nullptr : &(shape->at(0)));
+          (input.DimsCount() == 0) ? nullptr : input.Dims());
       if (custom_payload.input_names == nullptr) {
         custom_payload.input_names = &work_input_name_ptrs.back();
         custom_payload.input_shape_dim_cnts = &work_input_dim_cnts.back();
@@ -409,7 +420,8 @@ CustomBackend::Context::Run(
       }
     }
 
-    work_io_contexts.emplace_back(this, &payload);
+    work_io_contexts.emplace_back(
+        this, &payload, custom_payload.input_names, custom_payload.input_cnt);
     custom_payload.input_context = &work_io_contexts.back();
     custom_payload.output_context = custom_payload.input_context;
     custom_payload.error_code = 0;
@@ -447,9 +459,21 @@ CustomBackend::Context::GetNextInput(
     GetInputOutputContext* input_context, const char* cname,
     const void** content, uint64_t* content_byte_size)
 {
-  const std::string name(cname);
   Scheduler::Payload* payload = input_context->payload_;
 
+  // Libraries normally pass back the name pointers they were given
+  // in the payload, so match on those to find the input by index
+  // without comparing strings. Any other name, for example a
+  // sequence control input, is looked up by name.
+  for (uint32_t idx = 0; idx < input_context->input_cnt_; ++idx) {
+    if (input_context->input_names_[idx] == cname) {
+      Status status = payload->request_provider_->GetNextInputContent(
+          idx, content, content_byte_size, false);
+      return status.IsOk();
+    }
+  }
+
+  const std::string name(cname);
   Status status = payload->request_provider_->GetNextInputContent(
       name, content, content_byte_size, false);
   return status.IsOk();
@@ -535,4 +559,83 @@ CustomGetOutput(
       ocontext, name, shape_dim_cnt, shape_dims, content_byte_size, content);
 }
 
+bool
+CustomAlloc(void* allocator, uint64_t byte_size, void** buffer)
+{
+  if ((allocator == nullptr) || (buffer == nullptr)) {
+    return false;
+  }
+
+  CustomBackend::Allocator* alloc =
+      static_cast<CustomBackend::Allocator*>(allocator);
+  size_t block_byte_size;
+  *buffer = alloc->pool_->Allocate(alloc, byte_size, &block_byte_size);
+  if (*buffer == nullptr) {
+    return false;
+  }
+
+  alloc->byte_size_ += block_byte_size;
+#ifdef TRTIS_ENABLE_METRICS
+  alloc->metric_byte_size_->Increment(block_byte_size);
+#endif  // TRTIS_ENABLE_METRICS
+  return true;
+}
+
+bool
+CustomFree(void* allocator, void* buffer)
+{
+  if (allocator == nullptr) {
+    return false;
+  }
+
+  if (buffer == nullptr) {
+    return true;
+  }
+
+  CustomBackend::Allocator* alloc =
+      static_cast<CustomBackend::Allocator*>(allocator);
+  // The pool is shared by all models, so only accept blocks that
+  // were allocated through this allocator. Otherwise the block would
+  // be accounted to the wrong model.
+  const size_t block_byte_size = alloc->pool_->Free(alloc, buffer);
+  if (block_byte_size == 0) {
+    return false;
+  }
+
+  alloc->byte_size_ -= block_byte_size;
+#ifdef TRTIS_ENABLE_METRICS
+  alloc->metric_byte_size_->Decrement(block_byte_size);
+#endif  // TRTIS_ENABLE_METRICS
+  return true;
+}
+
+bool
+CustomSubmitTask(void* thread_pool, CustomTaskFn_t task_fn, void* task_context)
+{
+  if ((thread_pool == nullptr) || (task_fn == nullptr)) {
+    return false;
+  }
+
+  static_cast<ThreadPool*>(thread_pool)->Submit([task_fn, task_context]() {
+    task_fn(task_context);
+  });
+  return true;
+}
+
+bool
+CustomParallelFor(
+    void* thread_pool, size_t count, size_t grain, CustomRangeTaskFn_t task_fn,
+    void* task_context)
+{
+  if ((thread_pool == nullptr) || (task_fn == nullptr)) {
+    return false;
+  }
+
+  static_cast<ThreadPool*>(thread_pool)
+      ->ParallelFor(count, grain, [task_fn, task_context](size_t b, size_t e) {
+        task_fn(task_context, b, e);
+      });
+  return true;
+}
+
 }}  // namespace nvidia::inferenceserver
@@ -25,11 +25,15 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
 #include "src/backends/custom/custom.h"
 #include "src/core/backend.h"
+#include "src/core/memory_pool.h"
+#include "src/core/metric_model_reporter.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
+#include "src/core/thread_pool.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -40,6 +44,8 @@ class CustomBackend : public InferenceBackend {
 
   Status Init(
       const std::string& path, const std::vector<std::string>& server_params,
+      const std::shared_ptr<ThreadPool>& thread_pool,
+      const std::shared_ptr<HostMemoryPool>& memory_pool,
       const ModelConfig& config);
 
   // Create a context for execution for each instance for the custom
@@ -64,6 +70,8 @@ class CustomBackend : public InferenceBackend {
   DISALLOW_COPY_AND_ASSIGN(CustomBackend);
   friend std::ostream& operator<<(std::ostream&, const CustomBackend&);
   friend bool CustomGetNextInput(void*, const char*, const void**, uint64_t*);
+  friend bool CustomAlloc(void*, uint64_t, void**);
+  friend bool CustomFree(void*, void*);
   friend bool CustomGetOutput(
       void*, const char*, size_t, int64_t*, uint64_t, void**);
 
@@ -99,12 +107,19 @@ class CustomBackend : public InferenceBackend {
 
     struct GetInputOutputContext {
       GetInputOutputContext(
-          CustomBackend::Context* context, Scheduler::Payload* payload)
-          : context_(context), payload_(payload)
+          CustomBackend::Context* context, Scheduler::Payload* payload,
+          const char** input_names, uint32_t input_cnt)
+          : context_(context), payload_(payload), input_names_(input_names),
+            input_cnt_(input_cnt)
       {
       }
       CustomBackend::Context* context_;
       Scheduler::Payload* payload_;
+
+      // The input names given to the custom library for the payload,
+      // in the order of the inputs of the request descriptor.
+      const char** input_names_;
+      uint32_t input_cnt_;
     };
 
     // Callback used by custom backends to get the next block of input
@@ -144,7 +159,22 @@ class CustomBackend : public InferenceBackend {
     CustomExecuteFn_t ExecuteFn_;
   };
 
+  // Memory allocated by the custom library through the server. The
+  // memory comes from the server memory pool and is accounted to
+  // this model.
+  struct Allocator {
+    ~Allocator();
+
+    std::shared_ptr<HostMemoryPool> pool_;
+    std::atomic<uint64_t> byte_size_;
+#ifdef TRTIS_ENABLE_METRICS
+    prometheus::Gauge* metric_byte_size_;
+#endif  // TRTIS_ENABLE_METRICS
+  };
+
   std::vector<std::string> server_params_;
+  std::shared_ptr<ThreadPool> thread_pool_;
+  std::unique_ptr<Allocator> allocator_;
   std::vector<std::unique_ptr<Context>> contexts_;
 };
 
@@ -162,4 +192,20 @@ bool CustomGetOutput(
     void* output_context, const char* name, size_t shape_dim_cnt,
     int64_t* shape_dims, uint64_t content_byte_size, void** content);
 
+// Callbacks used by custom backends to allocate and free memory
+// from the server memory pool.
+bool CustomAlloc(void* allocator, uint64_t byte_size, void** buffer);
+bool CustomFree(void* allocator, void* buffer);
+
+// Callback used by custom backends to run a task on the server
+// thread pool.
+bool CustomSubmitTask(
+    void* thread_pool, CustomTaskFn_t task_fn, void* task_context);
+
+// Callback used by custom backends to run a parallel loop on the
+// server thread pool.
+bool CustomParallelFor(
+    void* thread_pool, size_t count, size_t grain, CustomRangeTaskFn_t task_fn,
+    void* task_context);
+
 }}  // namespace nvidia::inferenceserver
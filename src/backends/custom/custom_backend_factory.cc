@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "src/core/constants.h"
+#include "src/core/cpu_cgroup.h"
 #include "src/core/filesystem.h"
 #include "src/core/logging.h"
 #include "src/core/model_config.pb.h"
@@ -38,6 +39,26 @@
 
 namespace nvidia { namespace inferenceserver {
 
+CustomBackendFactory::CustomBackendFactory(
+    const std::shared_ptr<Config>& backend_config)
+    : backend_config_(backend_config),
+      memory_pool_(std::make_shared<HostMemoryPool>(
+          backend_config->memory_pool_cache_byte_size,
+          backend_config->memory_pool_huge_pages))
+{
+  // The pool threads are started by the first custom backend that
+  // uses the pool, which may be running in the CPU cgroup of its
+  // model. The pool is shared by all models so its threads move
+  // themselves out of that cgroup.
+  thread_pool_ = std::make_shared<ThreadPool>(
+      backend_config->thread_pool_thread_cnt, []() {
+        Status status = LeaveCpuCgroups();
+        if (!status.IsOk()) {
+          LOG_ERROR << "custom backend thread pool: " << status.AsString();
+        }
+      });
+}
+
 Status
 CustomBackendFactory::Create(
     const std::shared_ptr<BackendConfig>& backend_config,
@@ -75,11 +96,15 @@ CustomBackendFactory::CreateBackend(
       backend_config_->inference_server_version;
   server_params[CustomServerParameter::MODEL_REPOSITORY_PATH] =
       backend_config_->model_repository_path;
+  server_params[CustomServerParameter::INITDATA_VERSION] =
+      std::to_string(CUSTOM_INITDATA_VERSION);
 
   // Create the backend for the model and all the execution contexts
   // requested for this model.
   std::unique_ptr<CustomBackend> local_backend(new CustomBackend);
-  RETURN_IF_ERROR(local_backend->Init(path, server_params, model_config));
+  RETURN_IF_ERROR(
+      local_backend->Init(
+          path, server_params, thread_pool_, memory_pool_, model_config));
   RETURN_IF_ERROR(local_backend->CreateExecutionContexts(custom_paths));
 
   *backend = std::move(local_backend);
@@ -26,8 +26,10 @@
 #pragma once
 
 #include "src/backends/custom/custom_backend.h"
+#include "src/core/memory_pool.h"
 #include "src/core/model_config.h"
 #include "src/core/status.h"
+#include "src/core/thread_pool.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -41,6 +43,18 @@ class CustomBackendFactory {
 
     // The absolute path to the model repository root.
     std::string model_repository_path;
+
+    // The number of threads in the thread pool shared by all custom
+    // backends. 0 indicates one thread for each available CPU.
+    size_t thread_pool_thread_cnt;
+
+    // The maximum size, in bytes, of freed memory that the memory
+    // pool shared by all custom backends keeps for reuse.
+    size_t memory_pool_cache_byte_size;
+
+    // Whether large allocations from the memory pool should use huge
+    // pages.
+    bool memory_pool_huge_pages;
   };
 
   static Status Create(
@@ -56,12 +70,17 @@ class CustomBackendFactory {
  private:
   DISALLOW_COPY_AND_ASSIGN(CustomBackendFactory);
 
-  CustomBackendFactory(const std::shared_ptr<Config>& backend_config)
-      : backend_config_(backend_config)
-  {
-  }
+  CustomBackendFactory(const std::shared_ptr<Config>& backend_config);
 
   const std::shared_ptr<Config> backend_config_;
+
+  // The thread pool shared by all custom backends created by this
+  // factory. Its threads are started when it is first used.
+  std::shared_ptr<ThreadPool> thread_pool_;
+
+  // The memory pool used by all custom backends created by this
+  // factory.
+  std::shared_ptr<HostMemoryPool> memory_pool_;
 };
 
 }}  // namespace nvidia::inferenceserver
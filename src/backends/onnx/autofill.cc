@@ -26,8 +26,6 @@
 
 #include "src/backends/onnx/autofill.h"
 
-#include <NvInfer.h>
-#include "src/backends/onnx/loader.h"
 #include "src/backends/onnx/onnx_utils.h"
 #include "src/core/autofill.h"
 #include "src/core/constants.h"
@@ -98,7 +96,7 @@ class AutoFillOnnxImpl : public AutoFill {
 
   Status Fix(ModelConfig* config) override;
 
-  Status SetConfigFromOrtSession(OrtSession* session, OrtAllocator* allocator);
+  Status SetConfigFromModelData(const FileContents& model_data);
 
  private:
   Status FixBatchingSupport(ModelConfig* config);
@@ -255,11 +253,10 @@ AutoFillOnnxImpl::FixOutputConfig(ModelConfig* config)
 }
 
 Status
-AutoFillOnnxImpl::SetConfigFromOrtSession(
-    OrtSession* session, OrtAllocator* allocator)
+AutoFillOnnxImpl::SetConfigFromModelData(const FileContents& model_data)
 {
-  RETURN_IF_ERROR(InputInfos(session, allocator, input_infos_));
-  RETURN_IF_ERROR(OutputInfos(session, allocator, output_infos_));
+  RETURN_IF_ERROR(ModelInfos(
+      model_data.Data(), model_data.ByteSize(), input_infos_, output_infos_));
 
   RETURN_IF_ERROR(SetBatchingSupport());
   return Status::Success;
@@ -305,24 +302,12 @@ AutoFillOnnx::Create(
                                          "' due to no version directories");
   }
 
-  // Create resource wrapper to manage release of resource
-  OrtSessionOptions* session_options;
-
-  RETURN_IF_ORT_ERROR(OrtCreateSessionOptions(&session_options));
-
-  OrtResourceWrapper<OrtSessionOptions*> options_wrapper(
-      session_options, &OrtReleaseSessionOptions);
-  RETURN_IF_ORT_ERROR(OrtSetSessionThreadPoolSize(session_options, 1));
-  RETURN_IF_ORT_ERROR(OrtSetSessionGraphOptimizationLevel(session_options, 0));
-
-  OrtSession* session;
-
   // All versions should share the same model configuration, thus use the first
-  // one that can be loaded successfully.
+  // one that can be parsed successfully. The model inputs and outputs are
+  // read directly from the model protobuf instead of creating an ONNX
+  // Runtime session, which for large models can take as long as loading
+  // the model itself.
   Status status;
-  bool unsupported_opset = false;
-  const std::string opset_error(
-      "onnx runtime error " + std::to_string(ORT_NOT_IMPLEMENTED));
   for (const auto& version : version_dirs) {
     const auto version_path = JoinPath({model_path, version});
 
@@ -338,45 +323,17 @@ AutoFillOnnx::Create(
     const std::string onnx_file = *(onnx_files.begin());
     const auto onnx_path = JoinPath({version_path, onnx_file});
 
-    // Load session
-    std::string onnx_file_content;
-    RETURN_IF_ERROR(ReadTextFile(onnx_path, &onnx_file_content));
-    status =
-        OnnxLoader::LoadSession(onnx_file_content, session_options, &session);
+    FileContents onnx_file_content;
+    RETURN_IF_ERROR(ReadFileContents(onnx_path, &onnx_file_content));
 
+    local_autofill.reset(new AutoFillOnnxImpl(model_name, onnx_file));
+    status = local_autofill->SetConfigFromModelData(onnx_file_content);
     if (status.IsOk()) {
-      local_autofill.reset(new AutoFillOnnxImpl(model_name, onnx_file));
       break;
-    } else if (
-        (status.Message().compare(0, opset_error.size(), opset_error)) == 0) {
-      local_autofill.reset(new AutoFillOnnxImpl(model_name, onnx_file));
-      unsupported_opset = true;
-      // no break in case there is a valid version
     }
   }
 
-  // If it is due to unsupported opset, return success with limited autofill
-  // capability
-  if (!status.IsOk() && unsupported_opset) {
-    *autofill = std::move(local_autofill);
-    return Status::Success;
-  }
-
-  // Return if none of the version can be loaded successfully
-  // due to reasons other than unsupported opset
-  RETURN_IF_ERROR(status);
-
-  OrtAllocator* allocator;
-  OrtStatus* ort_status = OrtCreateDefaultAllocator(&allocator);
-  OrtResourceWrapper<OrtAllocator*> allocator_wrapper(
-      allocator, &OrtReleaseAllocator);
-
-  if (ort_status == nullptr) {
-    status = local_autofill->SetConfigFromOrtSession(session, allocator);
-  }
-  OnnxLoader::UnloadSession(session);
-
-  RETURN_IF_ORT_ERROR(ort_status);
+  // Return if none of the version can be parsed successfully
   RETURN_IF_ERROR(status);
 
   *autofill = std::move(local_autofill);
@@ -26,16 +26,23 @@
 
 #include "src/backends/onnx/onnx_backend.h"
 
+#include <errno.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <mutex>
 #include "src/backends/onnx/loader.h"
 #include "src/backends/onnx/onnx_utils.h"
 #include "src/core/constants.h"
+#include "src/core/filesystem.h"
 #include "src/core/logging.h"
 #include "src/core/model_config_cuda.h"
 #include "src/core/model_config_utils.h"
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
+#include "src/core/sha256.h"
 
 #ifdef TRTIS_ENABLE_GPU
 #include <core/providers/cuda/cuda_provider_factory.h>
@@ -44,6 +51,34 @@
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// The highest graph optimization level supported by Onnx Runtime.
+constexpr uint32_t kMaxGraphOptimizationLevel = 2;
+
+// The Onnx Runtime version that saved optimized models are keyed by,
+// empty if not known at build time.
+#ifdef TRTIS_ONNXRUNTIME_VERSION
+constexpr char kOnnxRuntimeVersion[] = TRTIS_ONNXRUNTIME_VERSION;
+#else
+constexpr char kOnnxRuntimeVersion[] = "";
+#endif  // TRTIS_ONNXRUNTIME_VERSION
+
+#ifdef TRTIS_ONNXRUNTIME_OPTIMIZED_MODEL_FILE
+std::string
+OptimizedModelFilename(
+    const std::string& optimized_key, const uint32_t level,
+    const std::string& model_digest)
+{
+  // Key the optimized model by everything that affects the
+  // optimization so that a stale model is never used.
+  return optimized_key + "_ort" + kOnnxRuntimeVersion + "_level" +
+         std::to_string(level) + "_" + model_digest + ".onnx";
+}
+#endif  // TRTIS_ONNXRUNTIME_OPTIMIZED_MODEL_FILE
+
+}  // namespace
+
 OnnxBackend::Context::Context(
     const std::string& name, const int gpu_device, const int max_batch_size)
     : name_(name), gpu_device_(gpu_device), max_batch_size_(max_batch_size),
@@ -70,6 +105,8 @@ OnnxBackend::Init(const std::string& path, const ModelConfig& config)
   RETURN_IF_ERROR(ValidateModelConfig(config, kOnnxRuntimeOnnxPlatform));
   RETURN_IF_ERROR(SetModelConfig(path, config));
 
+  path_ = path;
+
   return Status::Success;
 }
 
@@ -77,7 +114,6 @@ Status
 OnnxBackend::CreateExecutionContexts(
     const std::unordered_map<std::string, std::string>& models)
 {
-  // [TODO] configurable like optimization policy in Tensorflow models
   // Create a "prototype" session option, which will be cloned and set
   // context-specific option on context creation.
   OrtSessionOptions* session_options;
@@ -86,11 +122,43 @@ OnnxBackend::CreateExecutionContexts(
   OrtResourceWrapper<OrtSessionOptions*> options_wrapper(
       session_options, &OrtReleaseSessionOptions);
   RETURN_IF_ORT_ERROR(OrtSetSessionThreadPoolSize(session_options, 1));
-  // disable graph optimization
-  RETURN_IF_ORT_ERROR(OrtSetSessionGraphOptimizationLevel(session_options, 0));
+
+  // Graph optimization is disabled unless a positive level is
+  // requested by the model's optimization policy.
+  graph_optimization_level_ = 0;
+  if (Config().optimization().has_graph() &&
+      (Config().optimization().graph().level() > 0)) {
+    graph_optimization_level_ = std::min(
+        (uint32_t)Config().optimization().graph().level(),
+        kMaxGraphOptimizationLevel);
+  }
+  RETURN_IF_ORT_ERROR(OrtSetSessionGraphOptimizationLevel(
+      session_options, graph_optimization_level_));
+
+  // Saved optimized models must be keyed by the Onnx Runtime version
+  // that produced them, so they are only saved if that version is
+  // known.
+  persist_optimized_model_ = Config().optimization().persist_optimized_model();
+  if (persist_optimized_model_) {
+#ifdef TRTIS_ONNXRUNTIME_OPTIMIZED_MODEL_FILE
+    if (strlen(kOnnxRuntimeVersion) == 0) {
+      LOG_WARNING << "not saving optimized model for " << Name()
+                  << ", the Onnx Runtime version is unknown";
+      persist_optimized_model_ = false;
+    }
+#else
+    LOG_WARNING << "not saving optimized model for " << Name()
+                << ", not supported by this Onnx Runtime";
+    persist_optimized_model_ = false;
+#endif  // TRTIS_ONNXRUNTIME_OPTIMIZED_MODEL_FILE
+  }
 
   Status status = CreateExecutionContextsHelper(session_options, models);
 
+  // The optimized models are only needed while creating the sessions.
+  optimized_models_.clear();
+  model_digests_.clear();
+
   RETURN_IF_ERROR(status);
 
   LOG_VERBOSE(1) << "onnx backend for " << Name() << std::endl << *this;
@@ -213,9 +281,20 @@ OnnxBackend::CreateExecutionContext(
 #endif  // TRTIS_ENABLE_GPU
   }
 
-  // Create Onnx session
-  RETURN_IF_ERROR(OnnxLoader::LoadSession(
-      op_itr->second, session_options, &context->session_));
+  // Create Onnx session. Optimized models are specific to the
+  // execution provider so they are kept separately for CPU and for
+  // each GPU compute capability.
+  if (graph_optimization_level_ == 0) {
+    RETURN_IF_ERROR(OnnxLoader::LoadSession(
+        op_itr->second, session_options, &context->session_));
+  } else {
+    const std::string optimized_key =
+        cc_model_filename +
+        ((gpu_device == Context::NO_GPU_DEVICE) ? "_cpu" : "_gpu" + cc);
+    RETURN_IF_ERROR(LoadOptimizedSession(
+        cc_model_filename, optimized_key, op_itr->second, session_options,
+        &context->session_));
+  }
   RETURN_IF_ORT_ERROR(OrtCreateDefaultAllocator(&context->allocator_));
 
   // If this is a sequence model then make sure that the required
@@ -239,6 +318,123 @@ OnnxBackend::CreateExecutionContext(
   return Status::Success;
 }
 
+Status
+OnnxBackend::LoadOptimizedSession(
+    const std::string& model_filename, const std::string& optimized_key,
+    const std::string& model_data, OrtSessionOptions* session_options,
+    OrtSession** session)
+{
+#ifndef TRTIS_ONNXRUNTIME_OPTIMIZED_MODEL_FILE
+  // This Onnx Runtime can't write out the optimized model so each
+  // session optimizes the model itself.
+  return OnnxLoader::LoadSession(model_data, session_options, session);
+#else
+  // The saved optimized model is keyed by the digest of the model
+  // file, which is computed once for each file.
+  std::string optimized_dir;
+  std::string optimized_path;
+  auto itr = optimized_models_.find(optimized_key);
+  if ((itr == optimized_models_.end()) && persist_optimized_model_) {
+    auto digest_itr = model_digests_.find(model_filename);
+    if (digest_itr == model_digests_.end()) {
+      digest_itr =
+          model_digests_.emplace(model_filename, Sha256Hex(model_data)).first;
+    }
+
+    optimized_dir = JoinPath({path_, kOptimizedModelDirectory});
+    optimized_path = JoinPath(
+        {optimized_dir,
+         OptimizedModelFilename(
+             optimized_key, graph_optimization_level_, digest_itr->second)});
+
+    bool exists = false;
+    if (FileExists(optimized_path, &exists).IsOk() && exists) {
+      std::string optimized_data;
+      RETURN_IF_ERROR(ReadTextFile(optimized_path, &optimized_data));
+      LOG_VERBOSE(1) << "Using saved optimized model " << optimized_path;
+      itr = optimized_models_
+                .emplace(optimized_key, std::move(optimized_data))
+                .first;
+    }
+  }
+
+  // The model is already optimized so create the session without
+  // optimizing it again.
+  if (itr != optimized_models_.end()) {
+    OrtSessionOptions* optimized_options;
+    RETURN_IF_ORT_ERROR(
+        OrtCloneSessionOptions(session_options, &optimized_options));
+    OrtResourceWrapper<OrtSessionOptions*> options_wrapper(
+        optimized_options, &OrtReleaseSessionOptions);
+    RETURN_IF_ORT_ERROR(
+        OrtSetSessionGraphOptimizationLevel(optimized_options, 0));
+    return OnnxLoader::LoadSession(itr->second, optimized_options, session);
+  }
+
+  // Have Onnx Runtime write the optimized model while creating the
+  // session. When persisting, the model is written to a temporary
+  // file in the model directory that is then renamed, so that
+  // concurrent loads never see a partial model. Otherwise, or if the
+  // model directory is not writable, the model is only kept for the
+  // remaining sessions.
+  std::string write_path;
+  bool write_persist = false;
+  if (persist_optimized_model_) {
+    if ((mkdir(
+             optimized_dir.c_str(),
+             S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) == 0) ||
+        (errno == EEXIST)) {
+      write_path = optimized_path + ".tmp" + std::to_string(getpid());
+      write_persist = (access(optimized_dir.c_str(), W_OK) == 0);
+    }
+    if (!write_persist) {
+      LOG_WARNING << "unable to save optimized model for " << Name()
+                  << ", model directory '" << path_ << "' is not writable";
+    }
+  }
+  if (!write_persist) {
+    const char* tmp_dir = getenv("TMPDIR");
+    std::string tmp_path = JoinPath(
+        {(tmp_dir == nullptr) ? "/tmp" : tmp_dir, "trtis_onnx_XXXXXX"});
+    const int fd = mkstemp(&tmp_path[0]);
+    if (fd == -1) {
+      return Status(
+          RequestStatusCode::INTERNAL,
+          "failed to create temporary file for optimized model for " +
+              Name() + ": " + strerror(errno));
+    }
+    close(fd);
+    write_path = tmp_path;
+  }
+
+  OrtSessionOptions* optimize_options;
+  RETURN_IF_ORT_ERROR(
+      OrtCloneSessionOptions(session_options, &optimize_options));
+  OrtResourceWrapper<OrtSessionOptions*> options_wrapper(
+      optimize_options, &OrtReleaseSessionOptions);
+  RETURN_IF_ORT_ERROR(
+      OrtSetOptimizedModelFilePath(optimize_options, write_path.c_str()));
+
+  Status status =
+      OnnxLoader::LoadSession(model_data, optimize_options, session);
+  std::string optimized_data;
+  if (status.IsOk()) {
+    status = ReadTextFile(write_path, &optimized_data);
+  }
+  if (status.IsOk() && write_persist &&
+      (rename(write_path.c_str(), optimized_path.c_str()) == 0)) {
+    LOG_INFO << "Saved optimized model " << optimized_path;
+  } else {
+    unlink(write_path.c_str());
+  }
+  RETURN_IF_ERROR(status);
+
+  optimized_models_.emplace(optimized_key, std::move(optimized_data));
+
+  return Status::Success;
+#endif  // TRTIS_ONNXRUNTIME_OPTIMIZED_MODEL_FILE
+}
+
 Status
 OnnxBackend::Context::ValidateSequenceControl(
     const std::string& model_name, const ModelSequenceBatching& batcher,
@@ -416,6 +612,7 @@ OnnxBackend::Run(
   Status status = contexts_[runner_idx]->Run(this, payloads);
   // Release all run related resources regardless of the run status
   contexts_[runner_idx]->ReleaseOrtRunResources();
+  compute_timers.clear();
   OnCompleteQueuedPayloads(status);
 }
 
@@ -441,7 +638,7 @@ OnnxBackend::Context::Run(
               name_ + "'");
     }
 
-    total_batch_size += payload.request_provider_->RequestHeader().batch_size();
+    total_batch_size += payload.request_provider_->Descriptor().batch_size_;
 
     // All payloads must have equally-sized input tensors so use any
     // payload as the representative for the input tensors.
@@ -470,18 +667,21 @@ OnnxBackend::Context::Run(
 
   std::vector<const char*> input_names;
 
-  for (const auto& input : input_request_provider->RequestHeader().input()) {
-    const std::string& name = input.name();
-
-    const ModelInput* input_config;
-    RETURN_IF_ERROR(base->GetInput(name, &input_config));
+  const InferRequestHeader& request_header =
+      input_request_provider->RequestHeader();
+  const InferRequestDescriptor& descriptor =
+      input_request_provider->Descriptor();
+  for (size_t idx = 0; idx < descriptor.inputs_.size(); ++idx) {
+    const InferRequestHeader::Input& input =
+        request_header.input(descriptor.inputs_[idx].request_index_);
+    const ModelInput& input_config = base->Config().input(idx);
 
     // Create a tensor for each input sized correctly for the total
     // payload batch size. Concatenate input values from each payload
     // into the corresponding tensor.
     RETURN_IF_ERROR(SetInputTensor(
-        name, input_config->data_type(), input.dims(), total_batch_size,
-        payloads, &input_buffers, &input_names));
+        idx, input.name(), input_config.data_type(), input.dims(),
+        total_batch_size, payloads, &input_buffers, &input_names));
   }
 
   // Additional inputs added to the provider...
@@ -494,8 +694,8 @@ OnnxBackend::Context::Run(
           pr.second;
 
       RETURN_IF_ERROR(SetInputTensor(
-          name, override->datatype_, override->dims_, total_batch_size,
-          payloads, &input_buffers, &input_names));
+          -1 /* input_idx */, name, override->datatype_, override->dims_,
+          total_batch_size, payloads, &input_buffers, &input_names));
     }
   }
 
@@ -520,8 +720,9 @@ OnnxBackend::Context::Run(
 
 Status
 OnnxBackend::Context::SetInputTensor(
-    const std::string& name, const DataType data_type, const DimsList& dims,
-    size_t total_batch_size, std::vector<Scheduler::Payload>* payloads,
+    const int input_idx, const std::string& name, const DataType data_type,
+    const DimsList& dims, size_t total_batch_size,
+    std::vector<Scheduler::Payload>* payloads,
     std::vector<std::unique_ptr<char[]>>* input_buffers,
     std::vector<const char*>* input_names)
 {
@@ -545,19 +746,18 @@ OnnxBackend::Context::SetInputTensor(
   std::vector<size_t> expected_byte_sizes;
   std::vector<size_t> expected_element_cnts;
   for (auto& payload : *payloads) {
-    const auto& request_header = payload.request_provider_->RequestHeader();
+    const InferRequestDescriptor& descriptor =
+        payload.request_provider_->Descriptor();
 
     expected_element_cnts.push_back(
-        request_header.batch_size() * batch1_element_cnt);
+        descriptor.batch_size_ * batch1_element_cnt);
 
     if (data_type == TYPE_STRING) {
       // For String data byte, obtain expected byte size from 'batch_byte_size'
       // The provider has already checked that batch_byte_size is set
-      for (const auto& in : request_header.input()) {
-        if (in.name() == name) {
-          expected_byte_sizes.push_back(in.batch_byte_size());
-          break;
-        }
+      if (input_idx >= 0) {
+        expected_byte_sizes.push_back(
+            descriptor.inputs_[input_idx].batch_byte_size_);
       }
     } else {
       // Otherwise calculate expected byte size from 'expected_element_cnts',
@@ -577,7 +777,7 @@ OnnxBackend::Context::SetInputTensor(
   char* buffer = input_buffers->back().get();
 
   // Store data into input buffer
-  SetInputBuffer(name, expected_byte_sizes, payloads, buffer);
+  SetInputBuffer(input_idx, name, expected_byte_sizes, payloads, buffer);
 
   if (data_type != TYPE_STRING) {
     const OrtAllocatorInfo* allocator_info;
@@ -608,7 +808,8 @@ OnnxBackend::Context::SetInputTensor(
 
 void
 OnnxBackend::Context::SetInputBuffer(
-    const std::string& name, const std::vector<size_t>& expected_byte_sizes,
+    const int input_idx, const std::string& name,
+    const std::vector<size_t>& expected_byte_sizes,
     std::vector<Scheduler::Payload>* payloads, char* input_buffer)
 {
   // Visit the payloads in order and copy the input tensors to
@@ -622,8 +823,12 @@ OnnxBackend::Context::SetInputBuffer(
     while (payload.status_.IsOk()) {
       const void* content;
       size_t content_byte_size = expected_byte_size - copied_byte_size;
-      payload.status_ = payload.request_provider_->GetNextInputContent(
-          name, &content, &content_byte_size, false);
+      payload.status_ =
+          (input_idx >= 0)
+              ? payload.request_provider_->GetNextInputContent(
+                    input_idx, &content, &content_byte_size, false)
+              : payload.request_provider_->GetNextInputContent(
+                    name, &content, &content_byte_size, false);
       if (!payload.status_.IsOk()) {
         break;
       }
@@ -821,10 +1026,8 @@ OnnxBackend::Context::SetFixedSizeOutputBuffer(
 {
   size_t content_offset = 0;
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_byte_size =
-        request_header.batch_size() * batch1_byte_size;
+        payload.request_provider_->Descriptor().batch_size_ * batch1_byte_size;
 
     // If 'payload' requested this output then copy it from
     // 'content'. If it did not request this output then just
@@ -853,10 +1056,9 @@ OnnxBackend::Context::SetStringOutputBuffer(
 {
   size_t element_idx = 0;
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_element_cnt =
-        request_header.batch_size() * batch1_element_cnt;
+        payload.request_provider_->Descriptor().batch_size_ *
+        batch1_element_cnt;
 
     // If 'payload' requested this output then copy it from
     // 'content'. If it did not request this output then just
@@ -56,6 +56,17 @@ class OnnxBackend : public InferenceBackend {
       OrtSessionOptions* session_options,
       const std::unordered_map<std::string, std::string>& paths);
 
+  // Create a session for 'model_data', read from 'model_filename',
+  // with graph optimization enabled. The model is optimized only for
+  // the first session of each 'optimized_key', or not at all if it
+  // was saved by a previous load, and the remaining sessions use the
+  // optimized model. If Onnx Runtime can't write out the optimized
+  // model then every session optimizes the model.
+  Status LoadOptimizedSession(
+      const std::string& model_filename, const std::string& optimized_key,
+      const std::string& model_data, OrtSessionOptions* session_options,
+      OrtSession** session);
+
   // Run model on the context associated with 'runner_idx' to
   // execute for one or more requests.
   void Run(
@@ -104,16 +115,20 @@ class OnnxBackend : public InferenceBackend {
     Status Run(
         const OnnxBackend* base, std::vector<Scheduler::Payload>* payloads);
 
-    // Set an input tensor from one or more payloads.
+    // Set an input tensor from one or more payloads. 'input_idx' is
+    // the index of the input in the request descriptor, or -1 for an
+    // override input that is only known by 'name'.
     Status SetInputTensor(
-        const std::string& name, const DataType data_type, const DimsList& dims,
-        size_t total_batch_size, std::vector<Scheduler::Payload>* payloads,
+        const int input_idx, const std::string& name, const DataType data_type,
+        const DimsList& dims, size_t total_batch_size,
+        std::vector<Scheduler::Payload>* payloads,
         std::vector<std::unique_ptr<char[]>>* input_buffers,
         std::vector<const char*>* input_names);
 
     // Helper function to batch input data from payloads into one 'input_buffer'
     void SetInputBuffer(
-        const std::string& name, const std::vector<size_t>& expected_byte_sizes,
+        const int input_idx, const std::string& name,
+        const std::vector<size_t>& expected_byte_sizes,
         std::vector<Scheduler::Payload>* payloads, char* input_buffer);
 
     // Helper function to modify 'input_buffer' into format needed for creating
@@ -169,6 +184,23 @@ class OnnxBackend : public InferenceBackend {
   };
 
   std::vector<std::unique_ptr<Context>> contexts_;
+
+  // The path of the model version directory.
+  std::string path_;
+
+  // The Onnx Runtime graph optimization level for the sessions.
+  uint32_t graph_optimization_level_ = 0;
+
+  // Whether optimized models are saved in the model version
+  // directory.
+  bool persist_optimized_model_ = false;
+
+  // The optimized model for each model file and device kind.
+  std::unordered_map<std::string, std::string> optimized_models_;
+
+  // The SHA-256 digest of each model file that keys a saved
+  // optimized model.
+  std::unordered_map<std::string, std::string> model_digests_;
 };
 
 std::ostream& operator<<(std::ostream& out, const OnnxBackend& pb);
@@ -37,6 +37,7 @@
 #include "src/core/logging.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/model_quantizer.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -81,6 +82,8 @@ OnnxBackendFactory::CreateBackend(
         std::make_tuple(std::move(model_data_str)));
   }
 
+  RETURN_IF_ERROR(QuantizeModels(model_config, path, &models));
+
   // Create the backend for the model and all the execution contexts
   // requested for this model.
   std::unique_ptr<OnnxBackend> local_backend(new OnnxBackend);
@@ -26,6 +26,11 @@
 
 #include "src/backends/onnx/onnx_utils.h"
 
+#include <google/protobuf/io/coded_stream.h>
+#include <limits.h>
+#include <set>
+#include "src/backends/onnx/onnx.pb.h"
+
 namespace nvidia { namespace inferenceserver {
 
 namespace {
@@ -118,6 +123,29 @@ InputOutputInfos(
   return Status::Success;
 }
 
+// Get the information of a graph input or output. A value that is not
+// a tensor is reported with undefined data-type. Dimensions that
+// don't have a fixed value (symbolic or unknown) are reported as -1,
+// matching what ONNX Runtime reports for a session.
+OnnxTensorInfo
+ValueInfo(const onnx::ValueInfoProto& value_info)
+{
+  ONNXTensorElementDataType type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+  std::vector<int64_t> dims;
+  if (value_info.type().has_tensor_type()) {
+    const auto& tensor_type = value_info.type().tensor_type();
+
+    // ONNX TensorProto::DataType and ONNXTensorElementDataType share
+    // the same values.
+    type = static_cast<ONNXTensorElementDataType>(tensor_type.elem_type());
+    for (const auto& dim : tensor_type.shape().dim()) {
+      dims.push_back(dim.has_dim_value() ? dim.dim_value() : -1);
+    }
+  }
+
+  return OnnxTensorInfo(type, dims);
+}
+
 }  // namespace
 
 std::string
@@ -272,6 +300,47 @@ OutputInfos(
   return InputOutputInfos(session, allocator, false, infos);
 }
 
+Status
+ModelInfos(
+    const char* model_data, const size_t model_byte_size,
+    OnnxTensorInfoMap& input_infos, OnnxTensorInfoMap& output_infos)
+{
+  input_infos.clear();
+  output_infos.clear();
+
+  // 'ir_version' must be present for the data to be considered an
+  // ONNX model.
+  onnx::ModelProto model;
+  google::protobuf::io::CodedInputStream coded_stream(
+      reinterpret_cast<const uint8_t*>(model_data), model_byte_size);
+  coded_stream.SetTotalBytesLimit(INT_MAX, INT_MAX);
+  if (!model.ParseFromCodedStream(&coded_stream) ||
+      !model.has_ir_version() || !model.has_graph() ||
+      (model.graph().output_size() == 0)) {
+    return Status(
+        RequestStatusCode::INTERNAL, "unable to parse ONNX model protobuf");
+  }
+
+  // Graph inputs that are also initializers are not required to be
+  // provided and so are not reported as inputs, matching what ONNX
+  // Runtime reports for a session.
+  std::set<std::string> initializer_names;
+  for (const auto& initializer : model.graph().initializer()) {
+    initializer_names.insert(initializer.name());
+  }
+
+  for (const auto& input : model.graph().input()) {
+    if (initializer_names.find(input.name()) == initializer_names.end()) {
+      input_infos.emplace(input.name(), ValueInfo(input));
+    }
+  }
+  for (const auto& output : model.graph().output()) {
+    output_infos.emplace(output.name(), ValueInfo(output));
+  }
+
+  return Status::Success;
+}
+
 Status
 CompareDimsSupported(
     const std::string& model_name, const std::string& tensor_name,
@@ -89,6 +89,12 @@ Status InputInfos(
 Status OutputInfos(
     OrtSession* session, OrtAllocator* allocator, OnnxTensorInfoMap& infos);
 
+// Get the input and output information by reading the serialized
+// ONNX model directly, without the cost of creating a session.
+Status ModelInfos(
+    const char* model_data, const size_t model_byte_size,
+    OnnxTensorInfoMap& input_infos, OnnxTensorInfoMap& output_infos);
+
 Status CompareDimsSupported(
     const std::string& model_name, const std::string& tensor_name,
     const std::vector<int64_t>& model_shape, const DimsList& dims,
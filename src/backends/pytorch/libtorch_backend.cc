@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <exception>
+#include <mutex>
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/model_config_cuda.h"
@@ -41,6 +42,17 @@
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// LibTorch only allows CPU fusion to be enabled for the entire
+// process, so loaded models must agree on whether it is enabled. The
+// number of loaded models that have it enabled and disabled.
+std::mutex cpu_fusion_mu_;
+size_t cpu_fusion_enabled_cnt_ = 0;
+size_t cpu_fusion_disabled_cnt_ = 0;
+
+}  // namespace
+
 LibTorchBackend::Context::Context(
     const std::string& name, const int gpu_device, const int max_batch_size)
     : name_(name), gpu_device_(gpu_device), max_batch_size_(max_batch_size),
@@ -123,6 +135,21 @@ ConvertTorchTypeToDataType(const torch::ScalarType& ttype)
   }
 }
 
+LibTorchBackend::~LibTorchBackend()
+{
+  if (holds_cpu_fusion_) {
+    std::lock_guard<std::mutex> lock(cpu_fusion_mu_);
+    if (Config().optimization().libtorch().cpu_fusion()) {
+      cpu_fusion_enabled_cnt_--;
+      if (cpu_fusion_enabled_cnt_ == 0) {
+        torch::jit::overrideCanFuseOnCPU(false);
+      }
+    } else {
+      cpu_fusion_disabled_cnt_--;
+    }
+  }
+}
+
 Status
 LibTorchBackend::Init(const std::string& path, const ModelConfig& config)
 {
@@ -132,12 +159,46 @@ LibTorchBackend::Init(const std::string& path, const ModelConfig& config)
   return Status::Success;
 }
 
+Status
+LibTorchBackend::AcquireCpuFusion()
+{
+  std::lock_guard<std::mutex> lock(cpu_fusion_mu_);
+  const bool cpu_fusion = Config().optimization().libtorch().cpu_fusion();
+  const size_t conflict_cnt =
+      cpu_fusion ? cpu_fusion_disabled_cnt_ : cpu_fusion_enabled_cnt_;
+  if (conflict_cnt != 0) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "unable to load model '" + Name() + "' with cpu_fusion " +
+            (cpu_fusion ? "enabled" : "disabled") + ", " +
+            std::to_string(conflict_cnt) +
+            " loaded LibTorch model(s) have it " +
+            (cpu_fusion ? "disabled" : "enabled") +
+            " and LibTorch only supports one setting per process");
+  }
+
+  if (cpu_fusion) {
+    if (cpu_fusion_enabled_cnt_ == 0) {
+      LOG_INFO << "Enabling LibTorch CPU fusion for " << Name();
+      torch::jit::overrideCanFuseOnCPU(true);
+    }
+    cpu_fusion_enabled_cnt_++;
+  } else {
+    cpu_fusion_disabled_cnt_++;
+  }
+
+  holds_cpu_fusion_ = true;
+  return Status::Success;
+}
+
 Status
 LibTorchBackend::CreateExecutionContexts(
     const std::unordered_map<std::string, std::string>& models)
 {
   uint32_t total_context_cnt = 0;
 
+  RETURN_IF_ERROR(AcquireCpuFusion());
+
   // Create a context for each instance.
   for (const auto& group : Config().instance_group()) {
     for (int c = 0; c < group.count(); c++) {
@@ -238,6 +299,9 @@ LibTorchBackend::CreateExecutionContext(
     // lp_itr->second is the torch model serialized to string
     std::istringstream model_stream(lp_itr->second);
     context->torch_model_ = torch::jit::load(model_stream, context->device_);
+    if (Config().optimization().libtorch().eval_mode()) {
+      context->torch_model_->eval();
+    }
   }
   catch (const std::exception& ex) {
     return Status(
@@ -355,15 +419,18 @@ LibTorchBackend::Run(
     }
   }
 
-  OnCompleteQueuedPayloads(contexts_[runner_idx]->Run(this, payloads));
+  Status status = contexts_[runner_idx]->Run(this, payloads);
+  compute_timers.clear();
+  OnCompleteQueuedPayloads(status);
 }
 
 Status
 LibTorchBackend::Context::SetFixedSizedInputTensor(
-    std::vector<torch::jit::IValue>* inputs_, const std::string& name,
-    const int& ip_index, const std::vector<int64_t>& shape,
-    const DataType dtype, const size_t batch1_byte_size,
-    const size_t total_byte_size, std::vector<Scheduler::Payload>* payloads,
+    std::vector<torch::jit::IValue>* inputs_, const int input_idx,
+    const std::string& name, const int& ip_index,
+    const std::vector<int64_t>& shape, const DataType dtype,
+    const size_t batch1_byte_size, const size_t total_byte_size,
+    std::vector<Scheduler::Payload>* payloads,
     std::vector<std::unique_ptr<char[]>>* input_buffers)
 {
   // The entire input tensor must be delivered as a single
@@ -376,17 +443,19 @@ LibTorchBackend::Context::SetFixedSizedInputTensor(
 
   // Visit the payloads in order and copy the input tensors to 'buffer'.
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_byte_size =
-        request_header.batch_size() * batch1_byte_size;
+        payload.request_provider_->Descriptor().batch_size_ * batch1_byte_size;
 
     size_t copied_byte_size = 0;
     while (payload.status_.IsOk()) {
       const void* content;
       size_t content_byte_size = expected_byte_size - copied_byte_size;
-      payload.status_ = payload.request_provider_->GetNextInputContent(
-          name, &content, &content_byte_size, false);
+      payload.status_ =
+          (input_idx >= 0)
+              ? payload.request_provider_->GetNextInputContent(
+                    input_idx, &content, &content_byte_size, false)
+              : payload.request_provider_->GetNextInputContent(
+                    name, &content, &content_byte_size, false);
       if (!payload.status_.IsOk()) {
         break;
       }
@@ -505,10 +574,8 @@ LibTorchBackend::Context::ReadFixedSizedOutputTensor(
   size_t content_offset = 0;
 
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_byte_size =
-        request_header.batch_size() * batch1_byte_size;
+        payload.request_provider_->Descriptor().batch_size_ * batch1_byte_size;
 
     // If 'payload' requested this output then copy it from 'content'. If it
     // did not request this output then just skip it in the 'content'.
@@ -582,9 +649,10 @@ LibTorchBackend::Context::GetOutputTensor(
 
 Status
 LibTorchBackend::Context::SetInput(
-    std::vector<torch::jit::IValue>* inputs_, const std::string& name,
-    const int& ip_index, const DataType datatype, const DimsList& dims,
-    const size_t total_batch_size, std::vector<Scheduler::Payload>* payloads,
+    std::vector<torch::jit::IValue>* inputs_, const int input_idx,
+    const std::string& name, const int& ip_index, const DataType datatype,
+    const DimsList& dims, const size_t total_batch_size,
+    std::vector<Scheduler::Payload>* payloads,
     std::vector<std::unique_ptr<char[]>>* input_buffers)
 {
   // Get the shape of the input. The provider has already checked that
@@ -610,7 +678,7 @@ LibTorchBackend::Context::SetInput(
   const size_t total_byte_size = total_batch_size * batch1_byte_size;
 
   return SetFixedSizedInputTensor(
-      inputs_, name, ip_index, shape, datatype, batch1_byte_size,
+      inputs_, input_idx, name, ip_index, shape, datatype, batch1_byte_size,
       total_byte_size, payloads, input_buffers);
 }
 
@@ -636,7 +704,7 @@ LibTorchBackend::Context::Run(
               name_ + "'");
     }
 
-    total_batch_size += payload.request_provider_->RequestHeader().batch_size();
+    total_batch_size += payload.request_provider_->Descriptor().batch_size_;
 
     // All payloads must have equally-sized input tensors so use any
     // payload as the representative for the input tensors.
@@ -673,19 +741,23 @@ LibTorchBackend::Context::Run(
   }
 
   // Store input and output tensors
+  const InferRequestDescriptor& descriptor =
+      input_request_provider->Descriptor();
   std::vector<torch::jit::IValue> inputs_(
-      input_request_provider->RequestHeader().input().size() + overide_inputs);
+      descriptor.inputs_.size() + overide_inputs);
   std::vector<torch::Tensor> outputs_;
 
-  // Inputs from the request...
-  for (const auto& input : input_request_provider->RequestHeader().input()) {
-    const std::string& name = input.name();
+  // Inputs from the request, in model configuration order...
+  for (size_t idx = 0; idx < descriptor.inputs_.size(); ++idx) {
+    const ModelInput& input_config = base->Config().input(idx);
+    const InferRequestHeader::Input& input =
+        input_request_provider->RequestHeader().input(
+            descriptor.inputs_[idx].request_index_);
+    const std::string& name = input_config.name();
     int ip_index = input_index_map_[name];
-    const ModelInput* input_config;
-    RETURN_IF_ERROR(base->GetInput(name, &input_config));
 
     RETURN_IF_ERROR(SetInput(
-        &inputs_, name, ip_index, input_config->data_type(), input.dims(),
+        &inputs_, idx, name, ip_index, input_config.data_type(), input.dims(),
         total_batch_size, payloads, &input_buffers));
   }
 
@@ -715,8 +787,8 @@ LibTorchBackend::Context::Run(
       }
       input_index_map_[name] = ip_index;
       RETURN_IF_ERROR(SetInput(
-          &inputs_, name, ip_index, override->datatype_, override->dims_,
-          total_batch_size, payloads, &input_buffers));
+          &inputs_, -1 /* input_idx */, name, ip_index, override->datatype_,
+          override->dims_, total_batch_size, payloads, &input_buffers));
     }
   }
 
@@ -779,6 +851,10 @@ LibTorchBackend::Context::Execute(
 {
   torch::jit::IValue model_outputs_;
 
+  // Gradients are never needed for inference so don't let autograd
+  // record the operations.
+  torch::autograd::AutoGradMode no_grad(false);
+
   try {
     model_outputs_ = torch_model_->forward(*inputs_);
     auto model_outputs_tuple = model_outputs_.toTuple();
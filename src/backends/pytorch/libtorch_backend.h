@@ -25,6 +25,8 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/jit/fuser/interface.h>
 #include <torch/script.h>  // One-stop header.
 #include <set>
 #include <string>
@@ -42,6 +44,7 @@ class LibTorchBackend : public InferenceBackend {
  public:
   LibTorchBackend() = default;
   LibTorchBackend(LibTorchBackend&&) = default;
+  ~LibTorchBackend();
 
   Status Init(const std::string& path, const ModelConfig& config);
 
@@ -64,6 +67,15 @@ class LibTorchBackend : public InferenceBackend {
   DISALLOW_COPY_AND_ASSIGN(LibTorchBackend);
   friend std::ostream& operator<<(std::ostream&, const LibTorchBackend&);
 
+  // Check that the CPU fusion setting of this model agrees with the
+  // other loaded LibTorch models and apply it. Released when the
+  // backend is destroyed.
+  Status AcquireCpuFusion();
+
+  // True if the backend holds a CPU fusion setting that must be
+  // released when it is destroyed.
+  bool holds_cpu_fusion_ = false;
+
   // For each model instance there is a context.
   struct Context {
     // GPU device number that indicates that no gpu is available for a
@@ -86,11 +98,13 @@ class LibTorchBackend : public InferenceBackend {
     Status ValidateOutputs(
         const ::google::protobuf::RepeatedPtrField<ModelOutput>& ios);
 
-    // Set an input tensor data from payloads.
+    // Set an input tensor data from payloads. 'input_idx' is the
+    // index of the input in the request descriptor, or -1 for an
+    // override input that is only known by 'name'.
     Status SetInput(
-        std::vector<torch::jit::IValue>* inputs_, const std::string& name,
-        const int& ip_index, const DataType datatype, const DimsList& dims,
-        const size_t total_batch_size,
+        std::vector<torch::jit::IValue>* inputs_, const int input_idx,
+        const std::string& name, const int& ip_index, const DataType datatype,
+        const DimsList& dims, const size_t total_batch_size,
         std::vector<Scheduler::Payload>* payloads,
         std::vector<std::unique_ptr<char[]>>* input_buffers);
 
@@ -105,10 +119,11 @@ class LibTorchBackend : public InferenceBackend {
 
     // Set an input tensor from one or more payloads.
     Status SetFixedSizedInputTensor(
-        std::vector<torch::jit::IValue>* inputs_, const std::string& name,
-        const int& ip_index, const std::vector<int64_t>& shape,
-        const DataType dtype, const size_t batch1_byte_size,
-        const size_t total_byte_size, std::vector<Scheduler::Payload>* payloads,
+        std::vector<torch::jit::IValue>* inputs_, const int input_idx,
+        const std::string& name, const int& ip_index,
+        const std::vector<int64_t>& shape, const DataType dtype,
+        const size_t batch1_byte_size, const size_t total_byte_size,
+        std::vector<Scheduler::Payload>* payloads,
         std::vector<std::unique_ptr<char[]>>* input_buffers);
 
     // Read an output tensor into one or more payloads.
@@ -35,6 +35,7 @@
 #include "src/core/logging.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/model_quantizer.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -68,6 +69,8 @@ LibTorchBackendFactory::CreateBackend(
     torch_models.emplace(filename, std::move(model_data_str));
   }
 
+  RETURN_IF_ERROR(QuantizeModels(model_config, path, &torch_models));
+
   // Create the backend for the model and all the execution contexts
   // requested for this model.
   std::unique_ptr<LibTorchBackend> local_backend(new LibTorchBackend);
@@ -281,16 +281,12 @@ AutoFillSavedModel::Create(
   const std::string savedmodel_dir = *(savedmodel_dirs.begin());
   const auto savedmodel_path = JoinPath({version_path, savedmodel_dir});
 
-  auto graphdef_backend_config =
-      std::static_pointer_cast<GraphDefBackendFactory::Config>(backend_config);
-
+  // Only the signature is needed so avoid creating a session and
+  // restoring the variables, which for large models takes as long as
+  // loading the model itself.
   TRTISTF_Model* trtistf_model = nullptr;
-  RETURN_IF_TRTISTF_ERROR(TRTISTF_ModelCreateFromSavedModel(
-      &trtistf_model, model_name.c_str(), savedmodel_path.c_str(),
-      TRTISTF_NO_GPU_DEVICE, false /* have_graph */, 0 /* graph_level */,
-      graphdef_backend_config->allow_gpu_memory_growth,
-      graphdef_backend_config->per_process_gpu_memory_fraction,
-      graphdef_backend_config->allow_soft_placement));
+  RETURN_IF_TRTISTF_ERROR(TRTISTF_ModelCreateFromSavedModelMetaGraph(
+      &trtistf_model, model_name.c_str(), savedmodel_path.c_str()));
 
   autofill->reset(
       new AutoFillSavedModelImpl(model_name, savedmodel_dir, trtistf_model));
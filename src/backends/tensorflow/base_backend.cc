@@ -242,14 +242,37 @@ BaseBackend::Run(
     }
   }
 
-  OnCompleteQueuedPayloads(contexts_[runner_idx]->Run(this, payloads));
+  Status status = contexts_[runner_idx]->Run(this, payloads);
+
+  // Stop the compute timers before completing the payloads so that the
+  // compute duration is known when the responses are finalized.
+  compute_timers.clear();
+  OnCompleteQueuedPayloads(status);
 }
 
 namespace {
 
+// Get the next content of an input of a payload. 'input_idx' is the
+// index of the input in the request descriptor, or -1 for an override
+// input that is only known by 'input_name'.
+Status
+GetNextInputContent(
+    Scheduler::Payload& payload, const int input_idx,
+    const std::string& input_name, const void** content,
+    size_t* content_byte_size, bool force_contiguous)
+{
+  if (input_idx >= 0) {
+    return payload.request_provider_->GetNextInputContent(
+        input_idx, content, content_byte_size, force_contiguous);
+  }
+
+  return payload.request_provider_->GetNextInputContent(
+      input_name, content, content_byte_size, force_contiguous);
+}
+
 void
 SetFixedSizedInputTensor(
-    TRTISTF_Tensor* tensor, const std::string& input_name,
+    TRTISTF_Tensor* tensor, const int input_idx, const std::string& input_name,
     const size_t batch1_byte_size, std::vector<Scheduler::Payload>* payloads)
 {
   size_t tensor_copy_offset = 0;
@@ -258,17 +281,15 @@ SetFixedSizedInputTensor(
   // input tensor. Skip payloads that had errors since they are not
   // included in the dynamic batch.
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_byte_size =
-        request_header.batch_size() * batch1_byte_size;
+        payload.request_provider_->Descriptor().batch_size_ * batch1_byte_size;
 
     size_t copied_byte_size = 0;
     while (payload.status_.IsOk()) {
       const void* content;
       size_t content_byte_size = expected_byte_size - copied_byte_size;
-      payload.status_ = payload.request_provider_->GetNextInputContent(
-          input_name, &content, &content_byte_size, false);
+      payload.status_ = GetNextInputContent(
+          payload, input_idx, input_name, &content, &content_byte_size, false);
       if (!payload.status_.IsOk()) {
         break;
       }
@@ -318,7 +339,7 @@ FillStringTensor(TRTISTF_Tensor* tensor, const size_t idx, const size_t cnt)
 
 void
 SetStringInputTensor(
-    TRTISTF_Tensor* tensor, const std::string& input_name,
+    TRTISTF_Tensor* tensor, const int input_idx, const std::string& input_name,
     const size_t batch1_element_cnt, std::vector<Scheduler::Payload>* payloads)
 {
   size_t tensor_element_idx = 0;
@@ -327,16 +348,15 @@ SetStringInputTensor(
   // input tensor. Skip payloads that had errors since they are not
   // included in the dynamic batch.
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_element_cnt =
-        request_header.batch_size() * batch1_element_cnt;
+        payload.request_provider_->Descriptor().batch_size_ *
+        batch1_element_cnt;
     size_t element_idx = 0;
 
     const void* vcontent;
     size_t content_byte_size = expected_element_cnt * sizeof(uint32_t);
-    payload.status_ = payload.request_provider_->GetNextInputContent(
-        input_name, &vcontent, &content_byte_size, true);
+    payload.status_ = GetNextInputContent(
+        payload, input_idx, input_name, &vcontent, &content_byte_size, true);
     if (!payload.status_.IsOk()) {
       FillStringTensor(
           tensor, tensor_element_idx + element_idx,
@@ -413,10 +433,8 @@ ReadFixedSizedOutputTensor(
   size_t tensor_copy_offset = 0;
 
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_byte_size =
-        request_header.batch_size() * batch1_byte_size;
+        payload.request_provider_->Descriptor().batch_size_ * batch1_byte_size;
 
     // If 'payload' requested this output then copy it from the
     // GPU. If it did not request this output then just skip it in
@@ -458,10 +476,9 @@ ReadStringOutputTensor(
   size_t tensor_element_idx = 0;
 
   for (auto& payload : *payloads) {
-    const InferRequestHeader& request_header =
-        payload.request_provider_->RequestHeader();
     const size_t expected_element_cnt =
-        request_header.batch_size() * batch1_element_cnt;
+        payload.request_provider_->Descriptor().batch_size_ *
+        batch1_element_cnt;
 
     // If 'payload' requested this output then copy it from the
     // GPU. If it did not request this output then just skip it in
@@ -502,8 +519,9 @@ ReadStringOutputTensor(
 
 Status
 BaseBackend::Context::SetInput(
-    const std::string& name, const DataType datatype, const DimsList& dims,
-    const size_t total_batch_size, std::vector<Scheduler::Payload>* payloads,
+    const int input_idx, const std::string& name, const DataType datatype,
+    const DimsList& dims, const size_t total_batch_size,
+    std::vector<Scheduler::Payload>* payloads,
     TRTISTF_TensorList** input_tensors)
 {
   // Get the shape of the input. The provider has already checked
@@ -546,9 +564,11 @@ BaseBackend::Context::SetInput(
   if (dtype != TRTISTF_DataType::TRTISTF_TYPE_STRING) {
     const size_t batch1_byte_size =
         batch1_element_cnt * TRTISTF_TensorDataTypeByteSize(tensor);
-    SetFixedSizedInputTensor(tensor, name, batch1_byte_size, payloads);
+    SetFixedSizedInputTensor(
+        tensor, input_idx, name, batch1_byte_size, payloads);
   } else {
-    SetStringInputTensor(tensor, name, batch1_element_cnt, payloads);
+    SetStringInputTensor(
+        tensor, input_idx, name, batch1_element_cnt, payloads);
   }
 
   return Status::Success;
@@ -576,7 +596,7 @@ BaseBackend::Context::Run(
               name_ + "'");
     }
 
-    total_batch_size += payload.request_provider_->RequestHeader().batch_size();
+    total_batch_size += payload.request_provider_->Descriptor().batch_size_;
 
     // All payloads must have equally-sized input tensors so use any
     // payload as the representative for the input tensors.
@@ -614,16 +634,19 @@ BaseBackend::Context::Run(
   std::unique_ptr<TRTISTF_TensorList*, decltype(input_deleter)> input_tensors(
       &input_head_ptr, input_deleter);
 
-  // Inputs from the request...
-  for (const auto& input : input_request_provider->RequestHeader().input()) {
-    const std::string& name = input.name();
-
-    const ModelInput* input_config;
-    RETURN_IF_ERROR(base->GetInput(name, &input_config));
+  // Inputs from the request. The descriptor orders the inputs the
+  // same as the model configuration so no lookup by name is needed.
+  const InferRequestDescriptor& descriptor =
+      input_request_provider->Descriptor();
+  for (size_t idx = 0; idx < descriptor.inputs_.size(); ++idx) {
+    const ModelInput& input_config = base->Config().input(idx);
+    const InferRequestHeader::Input& input =
+        input_request_provider->RequestHeader().input(
+            descriptor.inputs_[idx].request_index_);
 
     RETURN_IF_ERROR(SetInput(
-        name, input_config->data_type(), input.dims(), total_batch_size,
-        payloads, input_tensors.get()));
+        idx, input_config.name(), input_config.data_type(), input.dims(),
+        total_batch_size, payloads, input_tensors.get()));
   }
 
   // Additional inputs added to the provider...
@@ -635,8 +658,8 @@ BaseBackend::Context::Run(
       const std::shared_ptr<InferRequestProvider::InputOverride>& override =
           pr.second;
       RETURN_IF_ERROR(SetInput(
-          name, override->datatype_, override->dims_, total_batch_size,
-          payloads, input_tensors.get()));
+          -1 /* input_idx */, name, override->datatype_, override->dims_,
+          total_batch_size, payloads, input_tensors.get()));
     }
   }
 
@@ -87,10 +87,12 @@ class BaseBackend : public InferenceBackend {
     Status ValidateOutputs(
         const ::google::protobuf::RepeatedPtrField<ModelOutput>& ios);
 
-    // Set an input tensor data from payloads.
+    // Set an input tensor data from payloads. 'input_idx' is the
+    // index of the input in the request descriptor, or -1 for an
+    // override input that is only known by 'name'.
     Status SetInput(
-        const std::string& name, const DataType datatype, const DimsList& dims,
-        const size_t total_batch_size,
+        const int input_idx, const std::string& name, const DataType datatype,
+        const DimsList& dims, const size_t total_batch_size,
         std::vector<Scheduler::Payload>* payloads,
         TRTISTF_TensorList** input_tensors);
 
@@ -30,6 +30,7 @@
 #include "src/backends/tensorflow/tensorflow_backend_tf.h"
 #include "src/backends/tensorflow/tf_utils.h"
 #include "src/core/constants.h"
+#include "src/core/cpu_cgroup.h"
 #include "src/core/filesystem.h"
 #include "src/core/model_config.h"
 #include "src/core/model_config_utils.h"
@@ -56,7 +57,7 @@ GraphDefBackend::CreateTRTISTFModel(
       &model, model_path.c_str(), model_path.c_str(), gpu_device,
       has_graph_level, graph_level, backend_config->allow_gpu_memory_growth,
       backend_config->per_process_gpu_memory_fraction,
-      backend_config->allow_soft_placement));
+      backend_config->allow_soft_placement, UsesModelCpuCgroup(Config())));
 
   trtistf_model->reset(model);
 
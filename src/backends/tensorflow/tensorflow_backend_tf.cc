@@ -26,6 +26,7 @@
 
 #include "tensorflow/tensorflow_backend_tf.h"
 
+#include "tensorflow/cc/saved_model/constants.h"
 #include "tensorflow/cc/saved_model/loader.h"
 #include "tensorflow/cc/saved_model/tag_constants.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -33,8 +34,10 @@
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/default_device.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
+#include "tensorflow/core/protobuf/saved_model.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -164,7 +167,7 @@ NewSessionOptions(
     const bool has_graph_level, const int graph_level,
     const bool allow_gpu_memory_growth,
     const float per_process_gpu_memory_fraction,
-    const bool allow_soft_placement,
+    const bool allow_soft_placement, const bool use_per_session_threads,
     tensorflow::SessionOptions* session_options)
 {
   session_options->config.mutable_gpu_options()->set_allow_growth(
@@ -173,6 +176,12 @@ NewSessionOptions(
       ->set_per_process_gpu_memory_fraction(per_process_gpu_memory_fraction);
   session_options->config.set_allow_soft_placement(allow_soft_placement);
 
+  // By default sessions share thread pools that are created along
+  // with the first session. A session that must not create or use
+  // the shared pools gets its own.
+  session_options->config.set_use_per_session_threads(
+      use_per_session_threads);
+
   // Enable/disable XLA based on the model config optimization
   // setting.
   tensorflow::OptimizerOptions::GlobalJitLevel xla =
@@ -358,6 +367,12 @@ ModelImpl::Run(
 
   TRTISTF_TensorListDelete(input_tensors);
 
+  if (session_ == nullptr) {
+    return TRTISTF_ErrorNew(
+        "unable to run model '" + model_name_ +
+        "', model was created without a session");
+  }
+
   std::vector<tensorflow::Tensor> tfoutputs;
   RETURN_IF_TF_ERROR(session_->Run(tfinputs, output_names, {}, &tfoutputs));
 
@@ -582,6 +597,117 @@ TRTISTF_TensorSetString(TRTISTF_Tensor* tensor, size_t idx, const char* cstr)
   t->SetString(idx, str);
 }
 
+//
+// SavedModel signature
+//
+namespace {
+
+// Collect the inputs and outputs of the serving signature of a
+// SavedModel meta graph. On error the caller owns any partially
+// collected 'inputs' and 'outputs'.
+TRTISTF_Error*
+SignatureIOLists(
+    const char* model_name, const tensorflow::MetaGraphDef& meta_graph_def,
+    TRTISTF_IOList** inputs, TRTISTF_IOList** outputs)
+{
+  // Verify that the meta graph has the "serve" tag
+  bool found_serve_tag = false;
+  for (const auto& tag : meta_graph_def.meta_info_def().tags()) {
+    if (tag == tensorflow::kSavedModelTagServe) {
+      found_serve_tag = true;
+      break;
+    }
+  }
+  if (!found_serve_tag) {
+    return TRTISTF_ErrorNew(
+        "unable to load model '" + std::string(model_name) + "', expected '" +
+        tensorflow::kSavedModelTagServe + "' tag");
+  }
+
+  // Verify that a "serving_default" signature exists, that is what
+  // will be used to verify the inputs and outputs.
+  static const std::string DEFAULT_SERVING_SIGNATURE_DEF_KEY("serving_default");
+  static const std::string INIT_OP_SIGNATURE_DEF_KEY("__saved_model_init_op");
+  static const std::string TRAIN_OP_SIGNATURE_DEF_KEY("__saved_model_train_op");
+  auto sig_itr = meta_graph_def.signature_def().find(
+      DEFAULT_SERVING_SIGNATURE_DEF_KEY);
+  if (sig_itr == meta_graph_def.signature_def().end()) {
+    // If default serving signature_def key is not found, maybe it is named
+    // something else, use one that is neither init_op key nor train_op key
+    for (sig_itr = meta_graph_def.signature_def().begin();
+         sig_itr != meta_graph_def.signature_def().end(); sig_itr++) {
+      if ((sig_itr->first != INIT_OP_SIGNATURE_DEF_KEY) &&
+          (sig_itr->first != TRAIN_OP_SIGNATURE_DEF_KEY)) {
+        LOG(WARNING) << "unable to find default serving signature '"
+                     << DEFAULT_SERVING_SIGNATURE_DEF_KEY
+                     << "', using signature '" << sig_itr->first << "'";
+        break;
+      }
+    }
+    if (sig_itr == meta_graph_def.signature_def().end()) {
+      return TRTISTF_ErrorNew(
+          "unable to load model '" + std::string(model_name) + "', expected '" +
+          DEFAULT_SERVING_SIGNATURE_DEF_KEY + "' signature");
+    }
+  }
+
+  const tensorflow::SignatureDef& def = sig_itr->second;
+
+  // Collect the inputs...
+  for (const auto& sin : def.inputs()) {
+    *inputs = TRTISTF_IOListNew(
+        sin.first.c_str(), sin.second.name().c_str(), *inputs);
+    TRTISTF_IO* io = (*inputs)->io_;
+
+    const TRTISTF_DataType dt = ConvertDataType(sin.second.dtype());
+    if (dt == TRTISTF_DataType::TRTISTF_TYPE_INVALID) {
+      return TRTISTF_ErrorNew(
+          "unable to process input '" + std::string(io->name_) + "' for '" +
+          std::string(model_name) + "', unsupported datatype '" +
+          tensorflow::DataType_Name(sin.second.dtype()) + "'");
+    }
+
+    io->data_type_ = dt;
+
+    const tensorflow::TensorShapeProto& shape = sin.second.tensor_shape();
+    int64_t shape_dims[shape.dim().size()];
+    for (int i = 0; i < shape.dim().size(); ++i) {
+      shape_dims[i] = shape.dim(i).size();
+    }
+
+    io->shape_ = TRTISTF_ShapeNew(shape.dim().size(), shape_dims);
+  }
+
+  // Collect the outputs...
+  for (const auto& sout : def.outputs()) {
+    *outputs = TRTISTF_IOListNew(
+        sout.first.c_str(), sout.second.name().c_str(), *outputs);
+    TRTISTF_IO* io = (*outputs)->io_;
+
+    const TRTISTF_DataType dt = ConvertDataType(sout.second.dtype());
+    if (dt == TRTISTF_DataType::TRTISTF_TYPE_INVALID) {
+      return TRTISTF_ErrorNew(
+          "unable to process output '" + std::string(io->name_) + "' for '" +
+          std::string(model_name) + "', unsupported datatype '" +
+          tensorflow::DataType_Name(sout.second.dtype()) + "'");
+    }
+
+    io->data_type_ = dt;
+
+    const tensorflow::TensorShapeProto& shape = sout.second.tensor_shape();
+    int64_t shape_dims[shape.dim().size()];
+    for (int i = 0; i < shape.dim().size(); ++i) {
+      shape_dims[i] = shape.dim(i).size();
+    }
+
+    io->shape_ = TRTISTF_ShapeNew(shape.dim().size(), shape_dims);
+  }
+
+  return nullptr;
+}
+
+}  // namespace
+
 //
 // TRTISTF_Model
 //
@@ -591,12 +717,13 @@ TRTISTF_ModelCreateFromGraphDef(
     const char* model_path, const int gpu_device, const bool has_graph_level,
     const int graph_level, const bool allow_gpu_memory_growth,
     const float per_process_gpu_memory_fraction,
-    const bool allow_soft_placement)
+    const bool allow_soft_placement, const bool use_per_session_threads)
 {
   tensorflow::SessionOptions session_options;
   NewSessionOptions(
       has_graph_level, graph_level, allow_gpu_memory_growth,
-      per_process_gpu_memory_fraction, allow_soft_placement, &session_options);
+      per_process_gpu_memory_fraction, allow_soft_placement,
+      use_per_session_threads, &session_options);
 
   tensorflow::Session* session;
   RETURN_IF_TF_ERROR(tensorflow::NewSession(session_options, &session));
@@ -653,12 +780,13 @@ TRTISTF_ModelCreateFromSavedModel(
     const char* model_path, const int gpu_device, const bool has_graph_level,
     const int graph_level, const bool allow_gpu_memory_growth,
     const float per_process_gpu_memory_fraction,
-    const bool allow_soft_placement)
+    const bool allow_soft_placement, const bool use_per_session_threads)
 {
   tensorflow::SessionOptions session_options;
   NewSessionOptions(
       has_graph_level, graph_level, allow_gpu_memory_growth,
-      per_process_gpu_memory_fraction, allow_soft_placement, &session_options);
+      per_process_gpu_memory_fraction, allow_soft_placement,
+      use_per_session_threads, &session_options);
 
   // Set the default device to control the CPU/GPU that the graph runs
   // on. This isn't foolproof since individual operations in the graph
@@ -690,103 +818,77 @@ TRTISTF_ModelCreateFromSavedModel(
       session_options, run_options, model_path, saved_model_tags,
       bundle.get()));
 
-  // Verify that the bundle has the "serve" tag
-  bool found_serve_tag = false;
-  for (const auto& tag : bundle->meta_graph_def.meta_info_def().tags()) {
-    if (tag == tensorflow::kSavedModelTagServe) {
-      found_serve_tag = true;
-      break;
-    }
-  }
-  if (!found_serve_tag) {
-    return TRTISTF_ErrorNew(
-        "unable to load model '" + std::string(model_name) + "', expected '" +
-        tensorflow::kSavedModelTagServe + "' tag");
-  }
-
-  // Verify that a "serving_default" signature exists, that is what
-  // will be used to verify the inputs and outputs.
-  static const std::string DEFAULT_SERVING_SIGNATURE_DEF_KEY("serving_default");
-  static const std::string INIT_OP_SIGNATURE_DEF_KEY("__saved_model_init_op");
-  static const std::string TRAIN_OP_SIGNATURE_DEF_KEY("__saved_model_train_op");
-  auto sig_itr = bundle->meta_graph_def.signature_def().find(
-      DEFAULT_SERVING_SIGNATURE_DEF_KEY);
-  if (sig_itr == bundle->meta_graph_def.signature_def().end()) {
-    // If default serving signature_def key is not found, maybe it is named
-    // something else, use one that is neither init_op key nor train_op key
-    for (sig_itr = bundle->meta_graph_def.signature_def().begin();
-         sig_itr != bundle->meta_graph_def.signature_def().end(); sig_itr++) {
-      if ((sig_itr->first != INIT_OP_SIGNATURE_DEF_KEY) &&
-          (sig_itr->first != TRAIN_OP_SIGNATURE_DEF_KEY)) {
-        LOG(WARNING) << "unable to find default serving signature '"
-                     << DEFAULT_SERVING_SIGNATURE_DEF_KEY
-                     << "', using signature '" << sig_itr->first << "'";
-        break;
-      }
-    }
-    if (sig_itr == bundle->meta_graph_def.signature_def().end()) {
-      return TRTISTF_ErrorNew(
-          "unable to load model '" + std::string(model_name) + "', expected '" +
-          DEFAULT_SERVING_SIGNATURE_DEF_KEY + "' signature");
-    }
+  TRTISTF_IOList* inputs = nullptr;
+  TRTISTF_IOList* outputs = nullptr;
+  TRTISTF_Error* err = SignatureIOLists(
+      model_name, bundle->meta_graph_def, &inputs, &outputs);
+  if (err != nullptr) {
+    TRTISTF_IOListDelete(inputs);
+    TRTISTF_IOListDelete(outputs);
+    return err;
   }
 
-  const tensorflow::SignatureDef& def = sig_itr->second;
-
-  // Collect the inputs...
-  TRTISTF_IOList* inputs = nullptr;
-  for (const auto& sin : def.inputs()) {
-    inputs =
-        TRTISTF_IOListNew(sin.first.c_str(), sin.second.name().c_str(), inputs);
-    TRTISTF_IO* io = inputs->io_;
+  ModelImpl* model =
+      new ModelImpl(model_name, std::move(bundle), inputs, outputs);
+  *trtistf_model = reinterpret_cast<TRTISTF_Model*>(model);
 
-    const TRTISTF_DataType dt = ConvertDataType(sin.second.dtype());
-    if (dt == TRTISTF_DataType::TRTISTF_TYPE_INVALID) {
-      return TRTISTF_ErrorNew(
-          "unable to process input '" + std::string(io->name_) + "' for '" +
-          std::string(model_name) + "', unsupported datatype '" +
-          tensorflow::DataType_Name(sin.second.dtype()) + "'");
-    }
+  return nullptr;
+}
 
-    io->data_type_ = dt;
+TRTISTF_Error*
+TRTISTF_ModelCreateFromSavedModelMetaGraph(
+    TRTISTF_Model** trtistf_model, const char* model_name,
+    const char* model_path)
+{
+  // Read the SavedModel protobuf directly instead of using
+  // LoadSavedModel(), which would also create a session and restore
+  // all the variables.
+  tensorflow::SavedModel saved_model;
+  const std::string pb_path =
+      tensorflow::io::JoinPath(model_path, tensorflow::kSavedModelFilenamePb);
+  if (tensorflow::Env::Default()->FileExists(pb_path).ok()) {
+    RETURN_IF_TF_ERROR(tensorflow::ReadBinaryProto(
+        tensorflow::Env::Default(), pb_path, &saved_model));
+  } else {
+    const std::string pbtxt_path = tensorflow::io::JoinPath(
+        model_path, tensorflow::kSavedModelFilenamePbTxt);
+    RETURN_IF_TF_ERROR(tensorflow::ReadTextProto(
+        tensorflow::Env::Default(), pbtxt_path, &saved_model));
+  }
 
-    const tensorflow::TensorShapeProto& shape = sin.second.tensor_shape();
-    int64_t shape_dims[shape.dim().size()];
-    for (int i = 0; i < shape.dim().size(); ++i) {
-      shape_dims[i] = shape.dim(i).size();
+  // Use the meta graph that TRTISTF_ModelCreateFromSavedModel()
+  // loads. LoadSavedModel() selects the meta graph whose tag set is
+  // exactly the requested set, so a meta graph that has the "serve"
+  // tag among others is not used.
+  const std::unordered_set<std::string> saved_model_tags{
+      tensorflow::kSavedModelTagServe};
+  const tensorflow::MetaGraphDef* meta_graph_def = nullptr;
+  for (const auto& mgd : saved_model.meta_graphs()) {
+    const std::unordered_set<std::string> tags(
+        mgd.meta_info_def().tags().begin(), mgd.meta_info_def().tags().end());
+    if (tags == saved_model_tags) {
+      meta_graph_def = &mgd;
+      break;
     }
-
-    io->shape_ = TRTISTF_ShapeNew(shape.dim().size(), shape_dims);
+  }
+  if (meta_graph_def == nullptr) {
+    return TRTISTF_ErrorNew(
+        "unable to load model '" + std::string(model_name) +
+        "', expected a meta graph with only the '" +
+        tensorflow::kSavedModelTagServe + "' tag");
   }
 
-  // Collect the outputs...
+  TRTISTF_IOList* inputs = nullptr;
   TRTISTF_IOList* outputs = nullptr;
-  for (const auto& sout : def.outputs()) {
-    outputs = TRTISTF_IOListNew(
-        sout.first.c_str(), sout.second.name().c_str(), outputs);
-    TRTISTF_IO* io = outputs->io_;
-
-    const TRTISTF_DataType dt = ConvertDataType(sout.second.dtype());
-    if (dt == TRTISTF_DataType::TRTISTF_TYPE_INVALID) {
-      return TRTISTF_ErrorNew(
-          "unable to process output '" + std::string(io->name_) + "' for '" +
-          std::string(model_name) + "', unsupported datatype '" +
-          tensorflow::DataType_Name(sout.second.dtype()) + "'");
-    }
-
-    io->data_type_ = dt;
-
-    const tensorflow::TensorShapeProto& shape = sout.second.tensor_shape();
-    int64_t shape_dims[shape.dim().size()];
-    for (int i = 0; i < shape.dim().size(); ++i) {
-      shape_dims[i] = shape.dim(i).size();
-    }
-
-    io->shape_ = TRTISTF_ShapeNew(shape.dim().size(), shape_dims);
+  TRTISTF_Error* err =
+      SignatureIOLists(model_name, *meta_graph_def, &inputs, &outputs);
+  if (err != nullptr) {
+    TRTISTF_IOListDelete(inputs);
+    TRTISTF_IOListDelete(outputs);
+    return err;
   }
 
-  ModelImpl* model =
-      new ModelImpl(model_name, std::move(bundle), inputs, outputs);
+  ModelImpl* model = new ModelImpl(model_name, nullptr, inputs, outputs);
   *trtistf_model = reinterpret_cast<TRTISTF_Model*>(model);
 
   return nullptr;
@@ -190,7 +190,7 @@ TRTISTF_EXPORT TRTISTF_Error* TRTISTF_ModelCreateFromGraphDef(
     const char* model_path, const int gpu_device, const bool has_graph_level,
     const int graph_level, const bool allow_gpu_memory_growth,
     const float per_process_gpu_memory_fraction,
-    const bool allow_soft_placement);
+    const bool allow_soft_placement, const bool use_per_session_threads);
 
 // Create a SavedModel model.
 TRTISTF_EXPORT TRTISTF_Error* TRTISTF_ModelCreateFromSavedModel(
@@ -198,7 +198,14 @@ TRTISTF_EXPORT TRTISTF_Error* TRTISTF_ModelCreateFromSavedModel(
     const char* model_path, const int gpu_device, const bool has_graph_level,
     const int graph_level, const bool allow_gpu_memory_growth,
     const float per_process_gpu_memory_fraction,
-    const bool allow_soft_placement);
+    const bool allow_soft_placement, const bool use_per_session_threads);
+
+// Create a SavedModel model from only the serving signature of the
+// SavedModel, without creating a session or restoring variables. The
+// model provides its inputs and outputs but cannot be run.
+TRTISTF_EXPORT TRTISTF_Error* TRTISTF_ModelCreateFromSavedModelMetaGraph(
+    TRTISTF_Model** trtistf_model, const char* model_name,
+    const char* model_path);
 
 // Delete a model.
 TRTISTF_EXPORT void TRTISTF_ModelDelete(TRTISTF_Model* model);
@@ -157,9 +157,10 @@ AutoFillPlan::Create(
   const std::string plan_file = *(plan_files.begin());
   const auto plan_path = JoinPath({version_path, plan_file});
 
-  std::string plan_data_str;
-  RETURN_IF_ERROR(ReadTextFile(plan_path, &plan_data_str));
-  std::vector<char> plan_data(plan_data_str.begin(), plan_data_str.end());
+  FileContents plan_contents;
+  RETURN_IF_ERROR(ReadFileContents(plan_path, &plan_contents));
+  std::vector<char> plan_data(
+      plan_contents.Data(), plan_contents.Data() + plan_contents.ByteSize());
 
   nvinfer1::IRuntime* runtime = nullptr;
   nvinfer1::ICudaEngine* engine = nullptr;
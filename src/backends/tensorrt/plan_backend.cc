@@ -264,6 +264,7 @@ PlanBackend::CreateExecutionContext(
   // possible batch size: min(engine maximum, config maximum)
   context->byte_sizes_ = new uint64_t[num_expected_bindings];
   context->buffers_ = new void*[num_expected_bindings]();  // init to nullptr
+  context->input_indices_.assign(num_expected_bindings, -1);
 
   RETURN_IF_ERROR(context->InitializeConfigInputBindings(Config().input()));
   RETURN_IF_ERROR(context->InitializeSequenceControlInputBindings(Config()));
@@ -460,11 +461,13 @@ Status
 PlanBackend::Context::InitializeConfigInputBindings(
     const ::google::protobuf::RepeatedPtrField<ModelInput>& ios)
 {
-  for (const auto& io : ios) {
+  for (int idx = 0; idx < ios.size(); ++idx) {
+    const ModelInput& io = ios.Get(idx);
     const DimsList& model_config_dims =
         (io.has_reshape()) ? io.reshape().shape() : io.dims();
     RETURN_IF_ERROR(
         InitializeInputBinding(io.name(), io.data_type(), model_config_dims));
+    input_indices_[engine_->getBindingIndex(io.name().c_str())] = idx;
   }
 
   return Status::Success;
@@ -573,7 +576,9 @@ PlanBackend::Run(
     }
   }
 
-  OnCompleteQueuedPayloads(contexts_[runner_idx]->Run(payloads));
+  Status status = contexts_[runner_idx]->Run(payloads);
+  compute_timers.clear();
+  OnCompleteQueuedPayloads(status);
 }
 
 bool
@@ -639,7 +644,7 @@ PlanBackend::Context::Run(std::vector<Scheduler::Payload>* payloads)
               name_ + "'");
     }
 
-    total_batch_size += payload.request_provider_->RequestHeader().batch_size();
+    total_batch_size += payload.request_provider_->Descriptor().batch_size_;
   }
 
   // If there are no valid payloads then no need to run the
@@ -666,6 +671,7 @@ PlanBackend::Context::Run(std::vector<Scheduler::Payload>* payloads)
     }
 
     const std::string& name = engine_->getBindingName(bindex);
+    const int input_idx = input_indices_[bindex];
     const size_t batch1_byte_size =
         byte_sizes_[bindex] / std::max(1, max_batch_size_);
     size_t binding_copy_offset = 0;
@@ -674,17 +680,20 @@ PlanBackend::Context::Run(std::vector<Scheduler::Payload>* payloads)
     // GPU. Skip payloads that had errors since they are not included
     // in the dynamic batch.
     for (auto& payload : *payloads) {
-      const InferRequestHeader& request_header =
-          payload.request_provider_->RequestHeader();
       const size_t expected_byte_size =
-          request_header.batch_size() * batch1_byte_size;
+          payload.request_provider_->Descriptor().batch_size_ *
+          batch1_byte_size;
 
       size_t copied_byte_size = 0;
       while (payload.status_.IsOk()) {
         const void* content;
         size_t content_byte_size = expected_byte_size - copied_byte_size;
-        payload.status_ = payload.request_provider_->GetNextInputContent(
-            name, &content, &content_byte_size, false);
+        payload.status_ =
+            (input_idx >= 0)
+                ? payload.request_provider_->GetNextInputContent(
+                      input_idx, &content, &content_byte_size, false)
+                : payload.request_provider_->GetNextInputContent(
+                      name, &content, &content_byte_size, false);
         if (!payload.status_.IsOk()) {
           break;
         }
@@ -783,10 +792,9 @@ PlanBackend::Context::Run(std::vector<Scheduler::Payload>* payloads)
         continue;
       }
 
-      const InferRequestHeader& request_header =
-          payload.request_provider_->RequestHeader();
       const size_t expected_byte_size =
-          request_header.batch_size() * batch1_byte_size;
+          payload.request_provider_->Descriptor().batch_size_ *
+          batch1_byte_size;
 
       // If 'payload' requested this output then copy it from the
       // GPU. If it did not request this output then just skip it in
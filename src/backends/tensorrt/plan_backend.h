@@ -123,6 +123,11 @@ class PlanBackend : public InferenceBackend {
     uint64_t* byte_sizes_;
     void** buffers_;
 
+    // For each binding index of the TensorRT engine, the index of the
+    // input in the model configuration, or -1 if the binding is an
+    // output or a sequence control input.
+    std::vector<int> input_indices_;
+
     // The stream where operations are executed.
     cudaStream_t stream_;
 
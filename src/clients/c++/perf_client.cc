@@ -26,10 +26,13 @@
 
 #include <getopt.h>
 #include <math.h>
+#include <sched.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <time.h>
 #include <unistd.h>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <csignal>
@@ -41,13 +44,17 @@
 #include <thread>
 #include "src/clients/c++/request_grpc.h"
 #include "src/clients/c++/request_http.h"
+#include "src/clients/c++/request_multi.h"
 #include "src/core/constants.h"
 
 namespace ni = nvidia::inferenceserver;
 namespace nic = nvidia::inferenceserver::client;
 
-using TimestampVector =
-    std::vector<std::tuple<struct timespec, struct timespec, uint32_t>>;
+// Start time, end time, flags and client library timing of a request
+using Timestamp = std::tuple<
+    struct timespec, struct timespec, uint32_t,
+    nic::InferContext::RequestTiming>;
+using TimestampVector = std::vector<Timestamp>;
 
 // [TODO] move this to more general place
 // If status is non-OK, return the Error.
@@ -121,12 +128,29 @@ using TimestampVector =
 //     of "throughput, latency, concurrent request count" tuples will be
 //     reported in increasing load level order.
 //
+// - Maximum throughput search mode:
+//     In this setting, the client searches for the concurrency that gives
+//     the highest throughput while the latency stays below the latency
+//     threshold (see -l and --search option):
+//       1. Follows the procedure in fixed concurrent request mode using
+//          k concurrent requests (k starts at -t).
+//       2. Doubles k and repeats step 1 until the latency exceeds the
+//          latency threshold or k reaches the maximum concurrency (see -c).
+//       3. Bisects between the highest k that meets the threshold and the
+//          lowest k that doesn't until the two are adjacent.
+//     The measurement with the highest throughput that meets the threshold
+//     is reported along with the lowest and highest throughput of the
+//     measurement windows it is based on, and the distribution of the batch
+//     sizes executed by the server during the measurement.
+//
 // Options:
 // -b: batch size for each request sent.
 // -t: number of concurrent requests sent. If -d is set, -t indicate the number
 //     of concurrent requests to start with ("starting concurrency" level).
 // -d: enable dynamic concurrent request mode.
-// -l: latency threshold in msec, will have no effect if -d is not set.
+// -l: latency threshold in msec, will have no effect if neither -d nor
+//     --search is set.
+// --search: enable maximum throughput search mode.
 // -p: time interval for each measurement window in msec.
 //
 // For detail of the options not listed, please refer to the usage.
@@ -162,6 +186,21 @@ typedef struct PerformanceStatusStruct {
   uint64_t client_avg_latency_ns;
   // a ordered map of percentiles to be reported (<percentile, value> pair)
   std::map<size_t, uint64_t> client_percentile_latency_ns;
+  // Decomposition of the request latency using the same percentiles:
+  // time spent by the client library to send the request, time spent
+  // waiting for the response (network and server) and time spent by the
+  // client library to receive the response
+  std::map<size_t, uint64_t> client_send_percentile_ns;
+  std::map<size_t, uint64_t> client_wait_percentile_ns;
+  std::map<size_t, uint64_t> client_receive_percentile_ns;
+  // Decomposition of the response wait using the timing reported by the
+  // server for each request: network time (response wait minus the
+  // server request time), server overhead, queue and compute time. Only
+  // set if the server reported the timing of every request.
+  std::map<size_t, uint64_t> network_percentile_ns;
+  std::map<size_t, uint64_t> server_overhead_percentile_ns;
+  std::map<size_t, uint64_t> server_queue_percentile_ns;
+  std::map<size_t, uint64_t> server_compute_percentile_ns;
   // Using usec to avoid square of large number (large in nsec)
   uint64_t std_us;
   uint64_t client_avg_request_time_ns;
@@ -174,11 +213,48 @@ typedef struct PerformanceStatusStruct {
 
   // placeholder for the latency value that is used for conditional checking
   uint64_t stabilizing_latency_ns;
+
+  // The lowest and highest values among the measurement windows that
+  // the measurement is based on
+  int client_min_infer_per_sec;
+  int client_max_infer_per_sec;
+  uint64_t min_stabilizing_latency_ns;
+  uint64_t max_stabilizing_latency_ns;
+
+  // Number of model executions performed by the server for each
+  // execution batch size
+  std::map<uint32_t, uint64_t> server_execution_batch_count;
+
+  // CPU time used by perf_client as a fraction of the elapsed time (1.0
+  // is one fully used core), and the number of cores available to it
+  double client_cpu_utilization;
+  long client_cpu_count;
+
+  // Number of request timestamps dropped during the measurement
+  // because a worker thread's timestamp buffer was full
+  size_t client_dropped_timestamp_count;
 } PerfStatus;
 
 
 enum ProtocolType { HTTP = 0, GRPC = 1 };
 
+// Return the number of CPUs perf_client is allowed to run on, which
+// respects any affinity mask (e.g. from taskset or a cpuset).
+long
+AvailableCpuCount()
+{
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if (sched_getaffinity(0, sizeof(cpuset), &cpuset) == 0) {
+    const int cnt = CPU_COUNT(&cpuset);
+    if (cnt > 0) {
+      return cnt;
+    }
+  }
+
+  return sysconf(_SC_NPROCESSORS_ONLN);
+}
+
 nic::Error
 ReadFile(const std::string& path, std::vector<char>* contents)
 {
@@ -221,11 +297,17 @@ class ContextFactory {
  public:
   /// Create a context factory that is responsible to create different types of
   /// contexts that is directly related to the specified model.
-  /// \param url The inference server name and port.
+  /// \param url The inference server name and port. Multiple servers
+  /// may be given as a comma-separated list, in which case inference
+  /// requests are spread across the servers and other requests are
+  /// sent to the first server.
   /// \param protocol The protocol type used.
   /// \param http_headers Map of HTTP headers. The map key/value
   /// indicates the header name/value.
   /// \param streaming Whether to use streaming API.
+  /// \param chunk_byte_size If non-zero, streaming requests and
+  /// responses are sent in chunks of at most this many bytes of
+  /// tensor data.
   /// \param model_name The name of the model.
   /// \param model_version The version of the model to use for inference,
   /// or -1 to indicate that the latest (i.e. highest version number)
@@ -235,8 +317,9 @@ class ContextFactory {
   static nic::Error Create(
       const std::string& url, const ProtocolType protocol,
       const std::map<std::string, std::string>& http_headers,
-      const bool streaming, const std::string& model_name,
-      const int64_t model_version, std::shared_ptr<ContextFactory>* factory);
+      const bool streaming, const size_t chunk_byte_size,
+      const std::string& model_name, const int64_t model_version,
+      std::shared_ptr<ContextFactory>* factory);
 
   /// Create a ProfileContext.
   /// \param ctx Returns a new ProfileContext object.
@@ -251,6 +334,9 @@ class ContextFactory {
   /// \param ctx Returns a new InferContext object.
   nic::Error CreateInferContext(std::unique_ptr<nic::InferContext>* ctx);
 
+  /// \return The protocol used to communicate with the server.
+  ProtocolType Protocol() const { return protocol_; }
+
   /// \return The model name.
   const std::string& ModelName() const { return model_name_; }
 
@@ -264,18 +350,34 @@ class ContextFactory {
   ContextFactory(
       const std::string& url, const ProtocolType protocol,
       const std::map<std::string, std::string>& http_headers,
-      const bool streaming, const std::string& model_name,
-      const int64_t model_version)
-      : url_(url), protocol_(protocol), http_headers_(http_headers),
-        streaming_(streaming), model_name_(model_name),
-        model_version_(model_version), current_correlation_id_(0)
+      const bool streaming, const size_t chunk_byte_size,
+      const std::string& model_name, const int64_t model_version)
+      : protocol_(protocol), http_headers_(http_headers),
+        streaming_(streaming), chunk_byte_size_(chunk_byte_size),
+        model_name_(model_name), model_version_(model_version),
+        current_correlation_id_(0)
   {
+    size_t pos = 0;
+    while (true) {
+      const size_t end = url.find(',', pos);
+      urls_.push_back(url.substr(pos, end - pos));
+      if (end == std::string::npos) {
+        break;
+      }
+      pos = end + 1;
+    }
   }
 
-  const std::string url_;
+  // Create a InferContext for the server at 'url'.
+  nic::Error CreateServerInferContext(
+      const std::string& url, const ni::CorrelationID correlation_id,
+      std::unique_ptr<nic::InferContext>* ctx);
+
+  std::vector<std::string> urls_;
   const ProtocolType protocol_;
   const std::map<std::string, std::string> http_headers_;
   const bool streaming_;
+  const size_t chunk_byte_size_;
   const std::string model_name_;
   const int64_t model_version_;
 
@@ -288,11 +390,13 @@ nic::Error
 ContextFactory::Create(
     const std::string& url, const ProtocolType protocol,
     const std::map<std::string, std::string>& http_headers,
-    const bool streaming, const std::string& model_name,
-    const int64_t model_version, std::shared_ptr<ContextFactory>* factory)
+    const bool streaming, const size_t chunk_byte_size,
+    const std::string& model_name, const int64_t model_version,
+    std::shared_ptr<ContextFactory>* factory)
 {
   factory->reset(new ContextFactory(
-      url, protocol, http_headers, streaming, model_name, model_version));
+      url, protocol, http_headers, streaming, chunk_byte_size, model_name,
+      model_version));
 
   ni::ServerStatus server_status;
   std::unique_ptr<nic::ServerStatusContext> ctx;
@@ -314,9 +418,10 @@ ContextFactory::CreateProfileContext(std::unique_ptr<nic::ProfileContext>* ctx)
 {
   nic::Error err;
   if (protocol_ == ProtocolType::HTTP) {
-    err = nic::ProfileHttpContext::Create(ctx, url_, http_headers_, false);
+    err =
+        nic::ProfileHttpContext::Create(ctx, urls_[0], http_headers_, false);
   } else {
-    err = nic::ProfileGrpcContext::Create(ctx, url_, false);
+    err = nic::ProfileGrpcContext::Create(ctx, urls_[0], false);
   }
   return err;
 }
@@ -328,9 +433,10 @@ ContextFactory::CreateServerStatusContext(
   nic::Error err;
   if (protocol_ == ProtocolType::HTTP) {
     err = nic::ServerStatusHttpContext::Create(
-        ctx, url_, http_headers_, model_name_, false);
+        ctx, urls_[0], http_headers_, model_name_, false);
   } else {
-    err = nic::ServerStatusGrpcContext::Create(ctx, url_, model_name_, false);
+    err = nic::ServerStatusGrpcContext::Create(
+        ctx, urls_[0], model_name_, false);
   }
   return err;
 }
@@ -349,16 +455,57 @@ ContextFactory::CreateInferContext(std::unique_ptr<nic::InferContext>* ctx)
     correlation_id = current_correlation_id_;
   }
 
+  if (urls_.size() == 1) {
+    return CreateServerInferContext(urls_[0], correlation_id, ctx);
+  }
+
+  // Spread the inference requests across the servers, using the load
+  // reported by each server. The load is served on the same port as
+  // inference. A server that can't be reached yet is skipped until it
+  // comes up.
+  std::vector<nic::InferMultiContext::CreateContextFn> create_fns;
+  std::vector<std::unique_ptr<nic::ServerLoadContext>> load_ctxs;
+  for (const auto& url : urls_) {
+    create_fns.emplace_back(
+        [this, url, correlation_id](std::unique_ptr<nic::InferContext>* c) {
+          return CreateServerInferContext(url, correlation_id, c);
+        });
+
+    load_ctxs.emplace_back();
+    if (protocol_ == ProtocolType::HTTP) {
+      err = nic::ServerLoadHttpContext::Create(
+          &load_ctxs.back(), url, model_name_, false);
+    } else {
+      err = nic::ServerLoadGrpcContext::Create(
+          &load_ctxs.back(), url, model_name_, false);
+    }
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  return nic::InferMultiContext::Create(
+      ctx, std::move(create_fns), std::move(load_ctxs),
+      nic::InferMultiContext::LEAST_OUTSTANDING);
+}
+
+nic::Error
+ContextFactory::CreateServerInferContext(
+    const std::string& url, const ni::CorrelationID correlation_id,
+    std::unique_ptr<nic::InferContext>* ctx)
+{
+  nic::Error err;
   if (streaming_) {
     err = nic::InferGrpcStreamContext::Create(
-        ctx, correlation_id, url_, model_name_, model_version_, false);
+        ctx, correlation_id, url, model_name_, model_version_, false,
+        chunk_byte_size_);
   } else if (protocol_ == ProtocolType::HTTP) {
     err = nic::InferHttpContext::Create(
-        ctx, correlation_id, url_, http_headers_, model_name_, model_version_,
+        ctx, correlation_id, url, http_headers_, model_name_, model_version_,
         false);
   } else {
     err = nic::InferGrpcContext::Create(
-        ctx, correlation_id, url_, model_name_, model_version_, false);
+        ctx, correlation_id, url, model_name_, model_version_, false);
   }
   return err;
 }
@@ -376,7 +523,8 @@ ContextFactory::CreateInferContext(std::unique_ptr<nic::InferContext>* ctx)
 /// Concurrency Manager will maintain the number of concurrent requests by
 /// spawning worker threads that keep sending randomly generated requests to the
 /// server. The worker threads will record the start time and end
-/// time of each request into a shared vector.
+/// time of each request into a per-thread timestamp buffer, which is
+/// collected by the profiler without locking.
 ///
 class ConcurrencyManager {
  public:
@@ -386,6 +534,8 @@ class ConcurrencyManager {
   /// load on inference server.
   /// \param batch_size The batch size used for each request.
   /// \param max_threads The maximum number of working threads to be spawned.
+  /// \param max_contexts_per_thread The maximum number of InferContexts
+  /// that each working thread uses for a non-sequence model.
   /// \param sequence_length The base length of each sequence.
   /// \param zero_input Whether to fill the input tensors with zero.
   /// \param factory The ContextFactory object used to create InferContext.
@@ -393,7 +543,8 @@ class ConcurrencyManager {
   /// \return Error object indicating success or failure.
   static nic::Error Create(
       const int32_t batch_size, const size_t max_threads,
-      const size_t sequence_length, const bool zero_input,
+      const size_t max_contexts_per_thread, const size_t sequence_length,
+      const bool zero_input,
       const std::string& data_directory,
       const std::shared_ptr<ContextFactory>& factory,
       std::unique_ptr<ConcurrencyManager>* manager);
@@ -410,6 +561,18 @@ class ConcurrencyManager {
   /// returned if concurrency manager can't produce the requested concurrency.
   nic::Error CheckHealth();
 
+  /// Move the timestamps recorded by the worker threads since the last
+  /// collection into the timestamp vector of the concurrency manager. Must
+  /// be called periodically, otherwise the worker threads drop timestamps
+  /// once their timestamp buffers are full. Must only be called from the
+  /// thread that changes the concurrency level.
+  void CollectTimestamps();
+
+  /// \return the total number of timestamps the worker threads have
+  /// dropped because their timestamp buffers were full. Must only be
+  /// called from the thread that changes the concurrency level.
+  size_t DroppedTimestampCount();
+
   /// Swap the content of the timestamp vector recorded by the concurrency
   /// manager with a new timestamp vector
   /// \param new_timestamps The timestamp vector to be swapped.
@@ -451,19 +614,86 @@ class ConcurrencyManager {
     std::vector<RequestMetaData> completed_requests_;
   };
 
+  /// A fixed-size buffer of request timestamps that is written by one
+  /// worker thread and read by the profiler thread. The two sides only
+  /// synchronize through the atomic 'head_' and 'tail_' positions.
+  class TimestampBuffer {
+   public:
+    explicit TimestampBuffer(size_t capacity)
+        : timestamps_(capacity), head_(0), tail_(0), dropped_(0)
+    {
+    }
+
+    /// Called by the worker thread. If the buffer is full the
+    /// timestamp is dropped and counted, so that the worker never
+    /// waits for the profiler.
+    /// \return false if the buffer is full.
+    bool Push(const Timestamp& timestamp)
+    {
+      const size_t head = head_.load(std::memory_order_relaxed);
+      if ((head - tail_.load(std::memory_order_acquire)) ==
+          timestamps_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      timestamps_[head % timestamps_.size()] = timestamp;
+      head_.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// Called by the profiler thread. Appends all buffered timestamps
+    /// to 'timestamps'.
+    void Drain(TimestampVector* timestamps)
+    {
+      size_t tail = tail_.load(std::memory_order_relaxed);
+      const size_t head = head_.load(std::memory_order_acquire);
+      for (; tail != head; tail++) {
+        timestamps->push_back(timestamps_[tail % timestamps_.size()]);
+      }
+      tail_.store(tail, std::memory_order_release);
+    }
+
+    /// \return the number of timestamps dropped because the buffer
+    /// was full.
+    size_t DroppedCount() const
+    {
+      return dropped_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::vector<Timestamp> timestamps_;
+    std::atomic<size_t> head_;
+    std::atomic<size_t> tail_;
+    std::atomic<size_t> dropped_;
+  };
+
+  struct ThreadStat {
+    ThreadStat() : timestamps_(kTimestampBufferSize) {}
+
+    TimestampBuffer timestamps_;
+    // mutex to guard 'contexts_stat_' which will be accessed by both
+    // the worker thread and the profiler thread
+    std::mutex mu_;
+    std::vector<nic::InferContext::Stat> contexts_stat_;
+  };
+
+  // The number of request timestamps each worker thread can buffer
+  // between two collections.
+  static const size_t kTimestampBufferSize = 64 * 1024;
+
  private:
   ConcurrencyManager(
       const int32_t batch_size, const size_t max_threads,
-      const size_t sequence_length, const bool zero_input,
-      const std::shared_ptr<ContextFactory>& factory);
+      const size_t max_contexts_per_thread, const size_t sequence_length,
+      const bool zero_input, const std::shared_ptr<ContextFactory>& factory);
 
   /// Function for worker that sends async inference requests.
   /// \param err Returns the status of the worker
-  /// \param stats Returns the statistic of the InferContexts
+  /// \param stat Returns the request timestamps and the statistic of the
+  /// InferContexts
   /// \param concurrency The concurrency level that the worker should produce.
   void AsyncInfer(
-      std::shared_ptr<nic::Error> err,
-      std::shared_ptr<std::vector<nic::InferContext::Stat>> stats,
+      std::shared_ptr<nic::Error> err, std::shared_ptr<ThreadStat> stat,
       std::shared_ptr<size_t> concurrency);
 
   /// Helper function to prepare the InferContext for sending inference request.
@@ -483,6 +713,7 @@ class ConcurrencyManager {
 
   size_t batch_size_;
   size_t max_threads_;
+  size_t max_contexts_per_thread_;
   size_t sequence_length_;
   bool zero_input_;
 
@@ -496,8 +727,7 @@ class ConcurrencyManager {
   // Note: early_exit signal is kept global
   std::vector<std::thread> threads_;
   std::vector<std::shared_ptr<nic::Error>> threads_status_;
-  std::vector<std::shared_ptr<std::vector<nic::InferContext::Stat>>>
-      threads_contexts_stat_;
+  std::vector<std::shared_ptr<ThreadStat>> threads_stat_;
   std::vector<std::shared_ptr<size_t>> threads_concurrency_;
 
   // Use condition variable to pause/continue worker threads
@@ -505,11 +735,9 @@ class ConcurrencyManager {
   std::mutex wake_mutex_;
 
   // Pointer to a vector of request timestamps <start_time, end_time>
-  // Request latency will be end_time - start_time
+  // collected from the worker threads. Request latency will be
+  // end_time - start_time
   std::shared_ptr<TimestampVector> request_timestamps_;
-  // Mutex to avoid race condition on adding elements into the timestamp vector
-  // and on updating context statistic.
-  std::mutex status_report_mutex_;
 };
 
 ConcurrencyManager::~ConcurrencyManager()
@@ -532,13 +760,14 @@ ConcurrencyManager::~ConcurrencyManager()
 nic::Error
 ConcurrencyManager::Create(
     const int32_t batch_size, const size_t max_threads,
-    const size_t sequence_length, const bool zero_input,
-    const std::string& data_directory,
+    const size_t max_contexts_per_thread, const size_t sequence_length,
+    const bool zero_input, const std::string& data_directory,
     const std::shared_ptr<ContextFactory>& factory,
     std::unique_ptr<ConcurrencyManager>* manager)
 {
   manager->reset(new ConcurrencyManager(
-      batch_size, max_threads, sequence_length, zero_input, factory));
+      batch_size, max_threads, max_contexts_per_thread, sequence_length,
+      zero_input, factory));
 
   // Read provided data
   if (!data_directory.empty()) {
@@ -559,9 +788,10 @@ ConcurrencyManager::Create(
 
 ConcurrencyManager::ConcurrencyManager(
     const int32_t batch_size, const size_t max_threads,
-    const size_t sequence_length, const bool zero_input,
-    const std::shared_ptr<ContextFactory>& factory)
+    const size_t max_contexts_per_thread, const size_t sequence_length,
+    const bool zero_input, const std::shared_ptr<ContextFactory>& factory)
     : batch_size_(batch_size), max_threads_(max_threads),
+      max_contexts_per_thread_(max_contexts_per_thread),
       sequence_length_(sequence_length), zero_input_(zero_input),
       factory_(factory)
 {
@@ -579,19 +809,18 @@ ConcurrencyManager::ChangeConcurrencyLevel(
     // Launch new thread for inferencing
     threads_status_.emplace_back(
         new nic::Error(ni::RequestStatusCode::SUCCESS));
-    threads_contexts_stat_.emplace_back(
-        new std::vector<nic::InferContext::Stat>());
+    threads_stat_.emplace_back(new ThreadStat());
     threads_concurrency_.emplace_back(new size_t(0));
 
     // Worker maintians concurrency in different ways.
     // For sequence models, multiple contexts must be created for multiple
     // concurrent sequences.
     // For non-sequence models, one context can send out multiple requests
-    // at the same time. Thus it uses one single context as every infer context
-    // creates a worker thread implicitly.
+    // at the same time. Thus it uses up to 'max_contexts_per_thread_'
+    // contexts as every infer context creates a worker thread implicitly.
     threads_.emplace_back(
         &ConcurrencyManager::AsyncInfer, this, threads_status_.back(),
-        threads_contexts_stat_.back(), threads_concurrency_.back());
+        threads_stat_.back(), threads_concurrency_.back());
   }
 
   // Compute the new concurrency level for each thread (take floor)
@@ -629,11 +858,28 @@ ConcurrencyManager::CheckHealth()
   return nic::Error::Success;
 }
 
+void
+ConcurrencyManager::CollectTimestamps()
+{
+  for (auto& thread_stat : threads_stat_) {
+    thread_stat->timestamps_.Drain(request_timestamps_.get());
+  }
+}
+
+size_t
+ConcurrencyManager::DroppedTimestampCount()
+{
+  size_t cnt = 0;
+  for (auto& thread_stat : threads_stat_) {
+    cnt += thread_stat->timestamps_.DroppedCount();
+  }
+  return cnt;
+}
+
 nic::Error
 ConcurrencyManager::SwapTimestamps(TimestampVector& new_timestamps)
 {
-  // Get the requests in the shared vector
-  std::lock_guard<std::mutex> lock(status_report_mutex_);
+  CollectTimestamps();
   request_timestamps_->swap(new_timestamps);
   return nic::Error::Success;
 }
@@ -674,6 +920,7 @@ ConcurrencyManager::PrepareInfer(
     RETURN_IF_ERROR(nic::InferContext::Options::Create(options));
 
     (*options)->SetBatchSize(batch_size_);
+    (*options)->SetFlag(ni::InferRequestHeader::FLAG_REPORT_TIMING, true);
     for (const auto& output : (*ctx)->Outputs()) {
       (*options)->AddRawResult(output);
     }
@@ -740,9 +987,9 @@ nic::Error
 ConcurrencyManager::GetAccumulatedContextStat(
     nic::InferContext::Stat* contexts_stat)
 {
-  std::lock_guard<std::mutex> lk(status_report_mutex_);
-  for (auto& thread_contexts_stat : threads_contexts_stat_) {
-    for (auto& context_stat : (*thread_contexts_stat)) {
+  for (auto& thread_stat : threads_stat_) {
+    std::lock_guard<std::mutex> lk(thread_stat->mu_);
+    for (auto& context_stat : thread_stat->contexts_stat_) {
       contexts_stat->completed_request_count +=
           context_stat.completed_request_count;
       contexts_stat->cumulative_total_request_time_ns +=
@@ -757,14 +1004,13 @@ ConcurrencyManager::GetAccumulatedContextStat(
 }
 
 // Function for worker threads.
-// If the model is non-sequence model, each worker uses only one context
-// to maintain concurrency assigned to worker.
+// If the model is non-sequence model, each worker spreads the concurrency
+// assigned to worker across up to 'max_contexts_per_thread_' contexts.
 // If the model is sequence model, each worker has to use multiples contexts
 // to maintain (sequence) concurrency assigned to worker.
 void
 ConcurrencyManager::AsyncInfer(
-    std::shared_ptr<nic::Error> err,
-    std::shared_ptr<std::vector<nic::InferContext::Stat>> stats,
+    std::shared_ptr<nic::Error> err, std::shared_ptr<ThreadStat> stat,
     std::shared_ptr<size_t> concurrency)
 {
   std::vector<std::unique_ptr<InferContextMetaData>> ctxs;
@@ -789,14 +1035,24 @@ ConcurrencyManager::AsyncInfer(
           lock, [concurrency]() { return early_exit || (*concurrency > 0); });
     }
 
-    size_t num_reqs = *concurrency;
-    // If the model is non-sequence model, use one InferContext to maintain
-    // concurrency for this thread
-    size_t active_ctx_cnt = on_sequence_model_ ? num_reqs : 1;
+    const size_t concurrency_level = *concurrency;
+    size_t num_reqs = concurrency_level;
+    // If the model is non-sequence model, use up to
+    // 'max_contexts_per_thread_' InferContexts to maintain concurrency
+    // for this thread
+    size_t active_ctx_cnt =
+        on_sequence_model_
+            ? concurrency_level
+            : std::max(
+                  (size_t)1,
+                  std::min(concurrency_level, max_contexts_per_thread_));
     // Create the context for inference of the specified model.
     while (active_ctx_cnt > ctxs.size()) {
       ctxs.emplace_back(new InferContextMetaData());
-      stats->emplace_back();
+      {
+        std::lock_guard<std::mutex> lk(stat->mu_);
+        stat->contexts_stat_.emplace_back();
+      }
       *err = PrepareInfer(&(ctxs.back()->ctx_), &options, input_buf);
       if (!err->IsOk()) {
         return;
@@ -805,7 +1061,7 @@ ConcurrencyManager::AsyncInfer(
 
     // Create async requests such that the number of ongoing requests
     // matches the concurrency level
-    // Non-sequence model is 'num_reqs' * 1 ctx
+    // Non-sequence model is 'num_reqs' spread across 'active_ctx_cnt' ctxs
     // Sequence model is 1 sequence (n requests) * 'active_ctx_cnt' ctxs
     for (size_t idx = 0; idx < active_ctx_cnt; idx++) {
       // for sequence model, only starts new sequence
@@ -813,6 +1069,9 @@ ConcurrencyManager::AsyncInfer(
       if (on_sequence_model_) {
         num_reqs =
             ctxs[idx]->inflight_request_cnt_ == 0 ? GetRandomLength(0.2) : 0;
+      } else {
+        num_reqs = (concurrency_level / active_ctx_cnt) +
+                   ((idx < (concurrency_level % active_ctx_cnt)) ? 1 : 0);
       }
       for (size_t& i = ctxs[idx]->inflight_request_cnt_; i < num_reqs; i++) {
         uint32_t flags = 0;
@@ -880,6 +1139,9 @@ ConcurrencyManager::AsyncInfer(
           std::lock_guard<std::mutex> lk(ctxs[idx]->mtx_);
           swap_vector.swap(ctxs[idx]->completed_requests_);
         }
+        if (swap_vector.empty()) {
+          continue;
+        }
         for (const auto& request : swap_vector) {
           *err = ctxs[idx]->ctx_->GetAsyncRunResults(
               &results, &is_ready, request.request_, true);
@@ -898,16 +1160,24 @@ ConcurrencyManager::AsyncInfer(
           struct timespec start_time = request.start_time_;
           uint32_t flags = request.flags_;
 
+          nic::InferContext::RequestTiming timing;
+          *err = request.request_->GetTiming(&timing);
+          if (!err->IsOk()) {
+            return;
+          }
+
           ctxs[idx]->inflight_request_cnt_--;
 
-          {
-            // Add the request timestamp to shared vector with proper locking
-            std::lock_guard<std::mutex> lk(status_report_mutex_);
-            request_timestamps_->emplace_back(
-                std::make_tuple(start_time, end_time, flags));
-            ctxs[idx]->ctx_->GetStat(&((*stats)[idx]));
-          }
+          // Hand the request timestamp to the profiler. The buffer is
+          // only full if the profiler has fallen behind, in which case
+          // the timestamp is dropped rather than stalling the callback,
+          // and the profiler reports the drop.
+          stat->timestamps_.Push(
+              Timestamp(start_time, end_time, flags, timing));
         }
+
+        std::lock_guard<std::mutex> lk(stat->mu_);
+        ctxs[idx]->ctx_->GetStat(&(stat->contexts_stat_[idx]));
       }
     }
 
@@ -1002,14 +1272,12 @@ class InferenceProfiler {
       const size_t concurrent_request_count, PerfStatus& status_summary);
 
  private:
-  using TimestampVector =
-      std::vector<std::tuple<struct timespec, struct timespec, uint32_t>>;
-
   InferenceProfiler(
       const bool verbose, const bool profile, const double stable_offset,
       const int32_t measurement_window_ms, const size_t max_measurement_count,
       const bool extra_percentile, const size_t percentile,
-      const bool on_sequence_model, const std::string& model_name,
+      const ProtocolType protocol, const bool on_sequence_model,
+      const std::string& model_name,
       const int64_t model_version,
       std::unique_ptr<nic::ProfileContext> profile_ctx,
       std::unique_ptr<nic::ServerStatusContext> status_ctx,
@@ -1054,12 +1322,22 @@ class InferenceProfiler {
   /// \param valid_sequence_count Returns the number of completed sequences
   /// during the measurement. A sequence is a set of correlated requests sent to
   /// sequence model.
+  /// \param valid_timings Returns the client library timings of the requests
+  /// completed within the measurement window.
   /// \return the vector of request latencies where the requests are completed
   /// within the measurement window.
   std::vector<uint64_t> ValidLatencyMeasurement(
       const TimestampVector& timestamps,
       const std::pair<uint64_t, uint64_t>& valid_range,
-      size_t& valid_sequence_count);
+      size_t& valid_sequence_count,
+      std::vector<nic::InferContext::RequestTiming>* valid_timings);
+
+  /// \param sorted_values The values to take the percentiles of, in
+  /// ascending order.
+  /// \param percentile_values Returns the value at each reported percentile.
+  void Percentiles(
+      const std::vector<uint64_t>& sorted_values,
+      std::map<size_t, uint64_t>* percentile_values);
 
   /// \param latencies The vector of request latencies collected.
   /// \param summary Returns the summary that the latency related fields are
@@ -1068,6 +1346,14 @@ class InferenceProfiler {
   nic::Error SummarizeLatency(
       const std::vector<uint64_t>& latencies, PerfStatus& summary);
 
+  /// \param timings The client library timings of the requests collected.
+  /// \param summary Returns the summary that the latency decomposition
+  /// fields are set.
+  /// \return Error object indicating success or failure.
+  nic::Error SummarizeLatencyBreakdown(
+      const std::vector<nic::InferContext::RequestTiming>& timings,
+      PerfStatus& summary);
+
   /// \param start_stat The accumulated context status at the start.
   /// \param end_stat The accumulated context status at the end.
   /// \param duration_ns The duration of the measurement in nsec.
@@ -1098,6 +1384,7 @@ class InferenceProfiler {
   size_t max_measurement_count_;
   bool extra_percentile_;
   size_t percentile_;
+  ProtocolType protocol_;
 
   bool on_sequence_model_;
   std::string model_name_;
@@ -1124,8 +1411,9 @@ InferenceProfiler::Create(
   profiler->reset(new InferenceProfiler(
       verbose, profile, stable_offset, measurement_window_ms,
       max_measurement_count, (percentile != -1), percentile,
-      factory->IsSequenceModel(), factory->ModelName(), factory->ModelVersion(),
-      std::move(profile_ctx), std::move(status_ctx), std::move(manager)));
+      factory->Protocol(), factory->IsSequenceModel(), factory->ModelName(),
+      factory->ModelVersion(), std::move(profile_ctx), std::move(status_ctx),
+      std::move(manager)));
   return nic::Error::Success;
 }
 
@@ -1133,8 +1421,8 @@ InferenceProfiler::InferenceProfiler(
     const bool verbose, const bool profile, const double stable_offset,
     const int32_t measurement_window_ms, const size_t max_measurement_count,
     const bool extra_percentile, const size_t percentile,
-    const bool on_sequence_model, const std::string& model_name,
-    const int64_t model_version,
+    const ProtocolType protocol, const bool on_sequence_model,
+    const std::string& model_name, const int64_t model_version,
     std::unique_ptr<nic::ProfileContext> profile_ctx,
     std::unique_ptr<nic::ServerStatusContext> status_ctx,
     std::unique_ptr<ConcurrencyManager> manager)
@@ -1142,9 +1430,10 @@ InferenceProfiler::InferenceProfiler(
       measurement_window_ms_(measurement_window_ms),
       max_measurement_count_(max_measurement_count),
       extra_percentile_(extra_percentile), percentile_(percentile),
-      on_sequence_model_(on_sequence_model), model_name_(model_name),
-      model_version_(model_version), profile_ctx_(std::move(profile_ctx)),
-      status_ctx_(std::move(status_ctx)), manager_(std::move(manager))
+      protocol_(protocol), on_sequence_model_(on_sequence_model),
+      model_name_(model_name), model_version_(model_version),
+      profile_ctx_(std::move(profile_ctx)), status_ctx_(std::move(status_ctx)),
+      manager_(std::move(manager))
 {
 }
 
@@ -1218,6 +1507,19 @@ InferenceProfiler::Profile(
       }
     }
   } while ((!early_exit) && (infer_per_sec.size() < max_measurement_count_));
+
+  // Record the spread of the measurement windows that 'status_summary'
+  // is judged against.
+  size_t window_cnt = std::min(recent_k, infer_per_sec.size());
+  const auto ips_range = std::minmax_element(
+      infer_per_sec.end() - window_cnt, infer_per_sec.end());
+  const auto latency_range =
+      std::minmax_element(latencies.end() - window_cnt, latencies.end());
+  status_summary.client_min_infer_per_sec = *ips_range.first;
+  status_summary.client_max_infer_per_sec = *ips_range.second;
+  status_summary.min_stabilizing_latency_ns = *latency_range.first;
+  status_summary.max_stabilizing_latency_ns = *latency_range.second;
+
   if (early_exit) {
     return nic::Error(ni::RequestStatusCode::INTERNAL, "Received exit signal.");
   } else if (!stable) {
@@ -1264,12 +1566,44 @@ InferenceProfiler::Measure(PerfStatus& status_summary)
 
   RETURN_IF_ERROR(manager_->GetAccumulatedContextStat(&start_stat));
 
-  // Wait for specified time interval in msec
-  std::this_thread::sleep_for(
-      std::chrono::milliseconds((uint64_t)(measurement_window_ms_ * 1.2)));
+  const size_t start_dropped = manager_->DroppedTimestampCount();
+  struct rusage start_usage;
+  getrusage(RUSAGE_SELF, &start_usage);
+  const auto start_time = std::chrono::steady_clock::now();
+
+  // Wait for specified time interval in msec, collecting the request
+  // timestamps periodically so that the worker threads never have to
+  // wait for buffer space
+  const auto end_time =
+      start_time +
+      std::chrono::milliseconds((uint64_t)(measurement_window_ms_ * 1.2));
+  for (auto now = start_time; now < end_time;
+       now = std::chrono::steady_clock::now()) {
+    std::this_thread::sleep_for(
+        std::min<std::chrono::steady_clock::duration>(
+            end_time - now, std::chrono::milliseconds(100)));
+    manager_->CollectTimestamps();
+  }
+
+  struct rusage end_usage;
+  getrusage(RUSAGE_SELF, &end_usage);
+  const auto elapsed_time = std::chrono::steady_clock::now() - start_time;
 
   RETURN_IF_ERROR(manager_->GetAccumulatedContextStat(&end_stat));
 
+  const auto UsageNs = [](const struct rusage& usage) -> uint64_t {
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) *
+               ni::NANOS_PER_SECOND +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000;
+  };
+  status_summary.client_cpu_utilization =
+      (double)(UsageNs(end_usage) - UsageNs(start_usage)) /
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed_time)
+          .count();
+  status_summary.client_cpu_count = AvailableCpuCount();
+  status_summary.client_dropped_timestamp_count =
+      manager_->DroppedTimestampCount() - start_dropped;
+
   // Stop profiling on the server if requested.
   if (profile_) {
     RETURN_IF_ERROR(StopProfile());
@@ -1297,13 +1631,15 @@ InferenceProfiler::Summarize(
     const nic::InferContext::Stat& end_stat, PerfStatus& summary)
 {
   size_t valid_sequence_count = 0;
+  std::vector<nic::InferContext::RequestTiming> timings;
 
   // Get measurement from requests that fall within the time interval
   std::pair<uint64_t, uint64_t> valid_range = MeasurementTimestamp(timestamps);
-  std::vector<uint64_t> latencies =
-      ValidLatencyMeasurement(timestamps, valid_range, valid_sequence_count);
+  std::vector<uint64_t> latencies = ValidLatencyMeasurement(
+      timestamps, valid_range, valid_sequence_count, &timings);
 
   RETURN_IF_ERROR(SummarizeLatency(latencies, summary));
+  RETURN_IF_ERROR(SummarizeLatencyBreakdown(timings, summary));
   RETURN_IF_ERROR(SummarizeClientStat(
       start_stat, end_stat, valid_range.second - valid_range.first,
       latencies.size(), valid_sequence_count, summary));
@@ -1353,10 +1689,12 @@ std::vector<uint64_t>
 InferenceProfiler::ValidLatencyMeasurement(
     const TimestampVector& timestamps,
     const std::pair<uint64_t, uint64_t>& valid_range,
-    size_t& valid_sequence_count)
+    size_t& valid_sequence_count,
+    std::vector<nic::InferContext::RequestTiming>* valid_timings)
 {
   std::vector<uint64_t> valid_latencies;
   valid_sequence_count = 0;
+  valid_timings->clear();
   for (auto& timestamp : timestamps) {
     uint64_t request_start_ns =
         std::get<0>(timestamp).tv_sec * ni::NANOS_PER_SECOND +
@@ -1370,6 +1708,7 @@ InferenceProfiler::ValidLatencyMeasurement(
       if ((request_end_ns >= valid_range.first) &&
           (request_end_ns <= valid_range.second)) {
         valid_latencies.push_back(request_end_ns - request_start_ns);
+        valid_timings->push_back(std::get<3>(timestamp));
         if (std::get<2>(timestamp) & ni::InferRequestHeader::FLAG_SEQUENCE_END)
           valid_sequence_count++;
       }
@@ -1382,6 +1721,27 @@ InferenceProfiler::ValidLatencyMeasurement(
   return valid_latencies;
 }
 
+void
+InferenceProfiler::Percentiles(
+    const std::vector<uint64_t>& sorted_values,
+    std::map<size_t, uint64_t>* percentile_values)
+{
+  percentile_values->clear();
+  if (sorted_values.empty()) {
+    return;
+  }
+
+  std::set<size_t> percentiles{50, 90, 95, 99};
+  if (extra_percentile_) {
+    percentiles.emplace(percentile_);
+  }
+
+  for (const auto percentile : percentiles) {
+    size_t index = (percentile / 100.0) * (sorted_values.size() - 1) + 0.5;
+    percentile_values->emplace(percentile, sorted_values[index]);
+  }
+}
+
 nic::Error
 InferenceProfiler::SummarizeLatency(
     const std::vector<uint64_t>& latencies, PerfStatus& summary)
@@ -1404,16 +1764,7 @@ InferenceProfiler::SummarizeLatency(
   summary.client_avg_latency_ns = tol_latency_ns / latencies.size();
 
   // retrieve other interesting percentile
-  summary.client_percentile_latency_ns.clear();
-  std::set<size_t> percentiles{50, 90, 95, 99};
-  if (extra_percentile_) {
-    percentiles.emplace(percentile_);
-  }
-
-  for (const auto percentile : percentiles) {
-    size_t index = (percentile / 100.0) * (latencies.size() - 1) + 0.5;
-    summary.client_percentile_latency_ns.emplace(percentile, latencies[index]);
-  }
+  Percentiles(latencies, &summary.client_percentile_latency_ns);
 
   if (extra_percentile_) {
     summary.stabilizing_latency_ns =
@@ -1436,6 +1787,77 @@ InferenceProfiler::SummarizeLatency(
   return nic::Error::Success;
 }
 
+nic::Error
+InferenceProfiler::SummarizeLatencyBreakdown(
+    const std::vector<nic::InferContext::RequestTiming>& timings,
+    PerfStatus& summary)
+{
+  std::vector<uint64_t> send_ns, wait_ns, receive_ns;
+  std::vector<uint64_t> network_ns, overhead_ns, queue_ns, compute_ns;
+  send_ns.reserve(timings.size());
+  wait_ns.reserve(timings.size());
+  receive_ns.reserve(timings.size());
+
+  bool has_server_timing = true;
+  for (const auto& timing : timings) {
+    send_ns.push_back(timing.send_time_ns);
+    receive_ns.push_back(timing.receive_time_ns);
+
+    // For gRPC the request time only covers waiting for the response,
+    // for HTTP it covers the whole request including sending and
+    // receiving.
+    uint64_t request_wait_ns = timing.total_request_time_ns;
+    if (protocol_ == ProtocolType::HTTP) {
+      const uint64_t io_ns = timing.send_time_ns + timing.receive_time_ns;
+      request_wait_ns =
+          (request_wait_ns > io_ns) ? (request_wait_ns - io_ns) : 0;
+    }
+    wait_ns.push_back(request_wait_ns);
+
+    has_server_timing &= timing.has_server_timing;
+    if (has_server_timing) {
+      const uint64_t server_ns = timing.server_request_time_ns;
+      const uint64_t queue_compute_ns =
+          timing.server_queue_time_ns + timing.server_compute_time_ns;
+      network_ns.push_back(
+          (request_wait_ns > server_ns) ? (request_wait_ns - server_ns) : 0);
+      overhead_ns.push_back(
+          (server_ns > queue_compute_ns) ? (server_ns - queue_compute_ns) : 0);
+      queue_ns.push_back(timing.server_queue_time_ns);
+      compute_ns.push_back(timing.server_compute_time_ns);
+    }
+  }
+
+  if (!has_server_timing) {
+    network_ns.clear();
+    overhead_ns.clear();
+    queue_ns.clear();
+    compute_ns.clear();
+  }
+
+  // Each stage is sorted on its own so the percentiles of the stages
+  // are not necessarily from the same request.
+  std::sort(send_ns.begin(), send_ns.end());
+  std::sort(wait_ns.begin(), wait_ns.end());
+  std::sort(receive_ns.begin(), receive_ns.end());
+
+  Percentiles(send_ns, &summary.client_send_percentile_ns);
+  Percentiles(wait_ns, &summary.client_wait_percentile_ns);
+  Percentiles(receive_ns, &summary.client_receive_percentile_ns);
+
+  std::sort(network_ns.begin(), network_ns.end());
+  std::sort(overhead_ns.begin(), overhead_ns.end());
+  std::sort(queue_ns.begin(), queue_ns.end());
+  std::sort(compute_ns.begin(), compute_ns.end());
+
+  Percentiles(network_ns, &summary.network_percentile_ns);
+  Percentiles(overhead_ns, &summary.server_overhead_percentile_ns);
+  Percentiles(queue_ns, &summary.server_queue_percentile_ns);
+  Percentiles(compute_ns, &summary.server_compute_percentile_ns);
+
+  return nic::Error::Success;
+}
+
 nic::Error
 InferenceProfiler::SummarizeClientStat(
     const nic::InferContext::Stat& start_stat,
@@ -1526,11 +1948,50 @@ InferenceProfiler::SummarizeServerStat(
       summary.server_compute_time_ns =
           end_itr->second.compute().total_time_ns() - start_compute_time_ns;
     }
+
+    // Executions are counted across all request batch sizes.
+    summary.server_execution_batch_count.clear();
+    const auto& vstart_itr =
+        start_status.version_status().find(status_model_version);
+    for (const auto& ebs : vend_itr->second.execution_batch_stats()) {
+      uint64_t start_cnt = 0;
+      if (vstart_itr != start_status.version_status().end()) {
+        const auto& start_itr =
+            vstart_itr->second.execution_batch_stats().find(ebs.first);
+        if (start_itr != vstart_itr->second.execution_batch_stats().end()) {
+          start_cnt = start_itr->second;
+        }
+      }
+      if (ebs.second > start_cnt) {
+        summary.server_execution_batch_count[ebs.first] =
+            ebs.second - start_cnt;
+      }
+    }
   }
 
   return nic::Error::Success;
 }
 
+std::string
+ExecutionBatchDistribution(const PerfStatus& summary)
+{
+  uint64_t total_cnt = 0;
+  for (const auto& ebs : summary.server_execution_batch_count) {
+    total_cnt += ebs.second;
+  }
+
+  std::string distribution;
+  for (const auto& ebs : summary.server_execution_batch_count) {
+    if (!distribution.empty()) {
+      distribution += ", ";
+    }
+    distribution += std::to_string(ebs.first) + " (" +
+                    std::to_string((ebs.second * 100) / total_cnt) + "%)";
+  }
+
+  return distribution;
+}
+
 ProtocolType
 ParseProtocol(const std::string& str)
 {
@@ -1634,18 +2095,136 @@ Report(
               << " latency: " << (percentile.second / 1000) << " usec"
               << std::endl;
   }
-  std::cout << client_library_detail << std::endl
-            << "  Server: " << std::endl
+  std::cout << client_library_detail << std::endl;
+
+  // Percentiles of each stage of the request as seen by the client
+  // library, to tell whether tail latency comes from the client or from
+  // waiting for the network and the server.
+  auto PrintBreakdown = [](const std::string& stage,
+                           const std::map<size_t, uint64_t>& values) {
+    if (values.empty()) {
+      return;
+    }
+    std::cout << "      " << stage << ":";
+    for (const auto& value : values) {
+      std::cout << " p" << value.first << " " << (value.second / 1000)
+                << " usec";
+    }
+    std::cout << std::endl;
+  };
+  std::cout << "    Latency breakdown:" << std::endl;
+  PrintBreakdown(
+      (protocol == ProtocolType::GRPC) ? "Marshal" : "Send",
+      summary.client_send_percentile_ns);
+  PrintBreakdown("Response wait", summary.client_wait_percentile_ns);
+  PrintBreakdown("  Network", summary.network_percentile_ns);
+  PrintBreakdown("  Server overhead", summary.server_overhead_percentile_ns);
+  PrintBreakdown("  Server queue", summary.server_queue_percentile_ns);
+  PrintBreakdown("  Server compute", summary.server_compute_percentile_ns);
+  PrintBreakdown(
+      (protocol == ProtocolType::GRPC) ? "Unmarshal" : "Receive",
+      summary.client_receive_percentile_ns);
+
+  std::cout << "    CPU utilization: "
+            << (int)(summary.client_cpu_utilization * 100) << "% ("
+            << summary.client_cpu_count << " cores available)" << std::endl;
+  if (summary.client_cpu_utilization > (summary.client_cpu_count * 0.9)) {
+    std::cerr << "WARNING: perf_client is using almost all of the available"
+              << " CPU, the measurement may be limited by the client rather"
+              << " than by the server." << std::endl;
+  }
+  if (summary.client_dropped_timestamp_count > 0) {
+    std::cerr << "WARNING: perf_client dropped "
+              << summary.client_dropped_timestamp_count
+              << " request timestamps because it could not collect them"
+              << " fast enough, the latency and throughput are based on"
+              << " the remaining requests." << std::endl;
+  }
+  std::cout << "  Server: " << std::endl
             << "    Request count: " << cnt << std::endl
             << "    Avg request latency: " << cumm_avg_us << " usec"
             << " (overhead " << overhead << " usec + "
             << "queue " << queue_avg_us << " usec + "
-            << "compute " << compute_avg_us << " usec)" << std::endl
-            << std::endl;
+            << "compute " << compute_avg_us << " usec)" << std::endl;
+  if (!summary.server_execution_batch_count.empty()) {
+    std::cout << "    Execution batch sizes: "
+              << ExecutionBatchDistribution(summary) << std::endl;
+  }
+  std::cout << std::endl;
 
   return nic::Error(ni::RequestStatusCode::SUCCESS);
 }
 
+// Search for the concurrency that gives the highest throughput while
+// the stabilizing latency stays below 'latency_threshold_ms'. The
+// concurrency is doubled starting from 'start_concurrency' until the
+// latency threshold is exceeded (or 'max_concurrency' is reached), and
+// then the boundary is located by bisection. Every measurement taken is
+// appended to 'summary' and the best one is returned in 'best'.
+nic::Error
+SearchMaxThroughput(
+    InferenceProfiler& profiler, const size_t start_concurrency,
+    const size_t max_concurrency, const uint64_t latency_threshold_ms,
+    const int64_t percentile, const ProtocolType protocol, const bool verbose,
+    std::vector<PerfStatus>* summary, PerfStatus* best)
+{
+  const uint64_t latency_threshold_ns = latency_threshold_ms * 1000 * 1000;
+
+  // The highest concurrency known to meet the latency threshold and
+  // the lowest concurrency known to exceed it, 0 if not known.
+  size_t meet_concurrency = 0;
+  size_t exceed_concurrency = 0;
+  bool found = false;
+
+  auto Measure = [&](const size_t concurrency) -> nic::Error {
+    PerfStatus status_summary;
+    RETURN_IF_ERROR(profiler.Profile(concurrency, status_summary));
+    RETURN_IF_ERROR(
+        Report(status_summary, concurrency, percentile, protocol, verbose));
+    summary->push_back(status_summary);
+
+    if (status_summary.stabilizing_latency_ns < latency_threshold_ns) {
+      meet_concurrency = std::max(meet_concurrency, concurrency);
+      if (!found ||
+          (status_summary.client_infer_per_sec > best->client_infer_per_sec)) {
+        *best = status_summary;
+        found = true;
+      }
+    } else if (
+        (exceed_concurrency == 0) || (concurrency < exceed_concurrency)) {
+      exceed_concurrency = concurrency;
+    }
+
+    return nic::Error::Success;
+  };
+
+  size_t concurrency = start_concurrency;
+  while (true) {
+    RETURN_IF_ERROR(Measure(concurrency));
+    if ((exceed_concurrency != 0) || (concurrency == max_concurrency)) {
+      break;
+    }
+    concurrency *= 2;
+    if ((max_concurrency != 0) && (concurrency > max_concurrency)) {
+      concurrency = max_concurrency;
+    }
+  }
+
+  while ((exceed_concurrency != 0) &&
+         (exceed_concurrency - meet_concurrency > 1)) {
+    RETURN_IF_ERROR(Measure((meet_concurrency + exceed_concurrency) / 2));
+  }
+
+  if (!found) {
+    return nic::Error(
+        ni::RequestStatusCode::NOT_FOUND,
+        "no concurrency meets the latency threshold of " +
+            std::to_string(latency_threshold_ms) + " msec");
+  }
+
+  return nic::Error::Success;
+}
+
 void
 Usage(char** argv, const std::string& msg = std::string())
 {
@@ -1659,10 +2238,13 @@ Usage(char** argv, const std::string& msg = std::string())
   std::cerr << "\t-b <batch size>" << std::endl;
   std::cerr << "\t-t <number of concurrent requests>" << std::endl;
   std::cerr << "\t-d" << std::endl;
+  std::cerr << "\t--search" << std::endl;
   std::cerr << "\t-a" << std::endl;
   std::cerr << "\t-z" << std::endl;
   std::cerr << "\t--streaming" << std::endl;
+  std::cerr << "\t--chunk-byte-size <bytes>" << std::endl;
   std::cerr << "\t--max-threads <thread counts>" << std::endl;
+  std::cerr << "\t--max-contexts-per-thread <context counts>" << std::endl;
   std::cerr << "\t-l <latency threshold (in msec)>" << std::endl;
   std::cerr << "\t-c <maximum concurrency>" << std::endl;
   std::cerr << "\t-s <deviation threshold for stable measurement"
@@ -1685,16 +2267,33 @@ Usage(char** argv, const std::string& msg = std::string())
       << "The -d flag enables dynamic concurrent request count where the number"
       << " of concurrent requests will increase linearly until the request"
       << " latency is above the threshold set (see -l)." << std::endl;
+  std::cerr
+      << "The --search flag enables maximum throughput search where the"
+      << " number of concurrent requests is doubled, starting from -t, until"
+      << " the request latency is above the threshold set (see -l) and then"
+      << " bisected to find the highest throughput that stays below the"
+      << " threshold." << std::endl;
   std::cerr << "The -a flag is deprecated. Enable it will not change"
             << "perf client behaviors." << std::endl;
   std::cerr << "The --streaming flag is only valid with gRPC protocol."
             << std::endl;
+  std::cerr
+      << "The --chunk-byte-size flag sends each streaming request and"
+      << " response as a sequence of messages holding at most that many bytes"
+      << " of tensor data. Only valid with --streaming. Default is 0 to"
+      << " indicate that requests and responses are not chunked." << std::endl;
   std::cerr << "The --max-threads flag sets the maximum number of threads that"
             << " will be created for providing desired concurrency."
             << " Default is 16." << std::endl;
+  std::cerr
+      << "The --max-contexts-per-thread flag sets the maximum number of"
+      << " inference contexts that each thread spreads its concurrent requests"
+      << " across for a non-sequence model. Use more than one context per"
+      << " thread when a single context limits the request rate. Default is 1."
+      << std::endl;
   std::cerr
       << "For -t, it indicates the number of starting concurrent requests if -d"
-      << " flag is set." << std::endl;
+      << " or --search flag is set." << std::endl;
   std::cerr
       << "For -s, it indicates the deviation threshold for the measurements. "
          "The measurement is considered as stable if the recent 3 measurements "
@@ -1703,10 +2302,10 @@ Usage(char** argv, const std::string& msg = std::string())
       << std::endl;
   std::cerr
       << "For -c, it indicates the maximum number of concurrent requests "
-         "allowed if -d flag is set. Once the number of concurrent requests "
-         "exceeds the maximum, the perf client will stop and exit regardless "
-         "of the latency threshold. Default is 0 to indicate that no limit is "
-         "set on the number of concurrent requests."
+         "allowed if -d or --search flag is set. Once the number of "
+         "concurrent requests exceeds the maximum, the perf client will stop "
+         "and exit regardless of the latency threshold. Default is 0 to "
+         "indicate that no limit is set on the number of concurrent requests."
       << std::endl;
   std::cerr
       << "For -p, it indicates the time interval used for each measurement."
@@ -1719,7 +2318,8 @@ Usage(char** argv, const std::string& msg = std::string())
                "The perf client will abort if the measurement is still "
                "unstable after the maximum number of measuremnts."
             << std::endl;
-  std::cerr << "For -l, it has no effect unless -d flag is set." << std::endl;
+  std::cerr << "For -l, it has no effect unless -d or --search flag is set."
+            << std::endl;
   std::cerr << "The -n flag enables profiling for the duration of the run"
             << std::endl;
   std::cerr
@@ -1727,6 +2327,15 @@ Usage(char** argv, const std::string& msg = std::string())
       << "numbered version) of the model will be used." << std::endl;
   std::cerr << "For -i, available protocols are gRPC and HTTP. Default is HTTP."
             << std::endl;
+  std::cerr
+      << "For -u, multiple servers serving the same model may be specified as"
+      << " a comma-separated list. Inference requests are spread across the"
+      << " servers, preferring the server with the fewest outstanding requests"
+      << " and the lowest estimated queue wait. A server that fails, or"
+      << " can't be reached when perf_client starts, is taken out of rotation"
+      << " and tried again later, and its failed requests are sent to another"
+      << " server. The server-side statistics are reported for the first"
+      << " server only." << std::endl;
   std::cerr
       << "For -H, the header will be added to HTTP requests (ignored for GRPC "
          "requests). The header must be specified as 'Header:Value'. -H may be "
@@ -1765,9 +2374,12 @@ main(int argc, char** argv)
   bool verbose = false;
   bool profile = false;
   bool dynamic_concurrency_mode = false;
+  bool search_mode = false;
   bool streaming = false;
+  size_t chunk_byte_size = 0;
   bool zero_input = false;
   size_t max_threads = 16;
+  size_t max_contexts_per_thread = 1;
   // average length of a sentence
   size_t sequence_length = 20;
   int32_t percentile = -1;
@@ -1790,7 +2402,10 @@ main(int argc, char** argv)
   static struct option long_options[] = {
       {"streaming", 0, 0, 0},       {"max-threads", 1, 0, 1},
       {"sequence-length", 1, 0, 2}, {"percentile", 1, 0, 3},
-      {"data-directory", 1, 0, 4},  {0, 0, 0, 0}};
+      {"data-directory", 1, 0, 4},  {"search", 0, 0, 5},
+      {"max-contexts-per-thread", 1, 0, 6},
+      {"chunk-byte-size", 1, 0, 7},
+      {0, 0, 0, 0}};
 
   // Parse commandline...
   int opt;
@@ -1813,6 +2428,15 @@ main(int argc, char** argv)
       case 4:
         data_directory = optarg;
         break;
+      case 5:
+        search_mode = true;
+        break;
+      case 6:
+        max_contexts_per_thread = std::atoi(optarg);
+        break;
+      case 7:
+        chunk_byte_size = std::atoll(optarg);
+        break;
       case 'v':
         verbose = true;
         break;
@@ -1892,6 +2516,9 @@ main(int argc, char** argv)
   if (streaming && (protocol != ProtocolType::GRPC)) {
     Usage(argv, "streaming is only allowed with gRPC protocol");
   }
+  if ((chunk_byte_size != 0) && !streaming) {
+    Usage(argv, "chunk byte size is only allowed with streaming");
+  }
   if (!http_headers.empty() && (protocol != ProtocolType::HTTP)) {
     std::cerr << "WARNING: HTTP headers specified with -H are ignored when "
                  "using non-HTTP protocol."
@@ -1900,6 +2527,9 @@ main(int argc, char** argv)
   if (max_threads == 0) {
     Usage(argv, "maximum number of threads must be > 0");
   }
+  if (max_contexts_per_thread == 0) {
+    Usage(argv, "maximum number of contexts per thread must be > 0");
+  }
   if (sequence_length == 0) {
     sequence_length = 20;
     std::cerr << "WARNING: using an invalid sequence length. Perf client will"
@@ -1912,6 +2542,16 @@ main(int argc, char** argv)
   if (zero_input && !data_directory.empty()) {
     Usage(argv, "zero input can't be set when data directory is provided");
   }
+  if (search_mode && dynamic_concurrency_mode) {
+    Usage(argv, "search can't be set when -d is set");
+  }
+  if (search_mode && (latency_threshold_ms == 0)) {
+    Usage(argv, "search requires latency threshold to be > 0 in msec");
+  }
+  if (search_mode && (max_concurrency != 0) &&
+      (max_concurrency < (size_t)concurrent_request_count)) {
+    Usage(argv, "maximum concurrency must be >= concurrent request count");
+  }
 
   // trap SIGINT to allow threads to exit gracefully
   signal(SIGINT, SignalHandler);
@@ -1921,15 +2561,15 @@ main(int argc, char** argv)
   std::unique_ptr<ConcurrencyManager> manager;
   std::unique_ptr<InferenceProfiler> profiler;
   err = ContextFactory::Create(
-      url, protocol, http_headers, streaming, model_name, model_version,
-      &factory);
+      url, protocol, http_headers, streaming, chunk_byte_size, model_name,
+      model_version, &factory);
   if (!err.IsOk()) {
     std::cerr << err << std::endl;
     return 1;
   }
   err = ConcurrencyManager::Create(
-      batch_size, max_threads, sequence_length, zero_input, data_directory,
-      factory, &manager);
+      batch_size, max_threads, max_contexts_per_thread, sequence_length,
+      zero_input, data_directory, factory, &manager);
   if (!err.IsOk()) {
     std::cerr << err << std::endl;
     return 1;
@@ -1948,7 +2588,7 @@ main(int argc, char** argv)
             << "  Batch size: " << batch_size << std::endl
             << "  Measurement window: " << measurement_window_ms << " msec"
             << std::endl;
-  if (dynamic_concurrency_mode) {
+  if (dynamic_concurrency_mode || search_mode) {
     std::cout << "  Latency limit: " << latency_threshold_ms << " msec"
               << std::endl;
     if (max_concurrency != 0) {
@@ -1966,7 +2606,17 @@ main(int argc, char** argv)
 
   PerfStatus status_summary;
   std::vector<PerfStatus> summary;
-  if (!dynamic_concurrency_mode) {
+  if (search_mode) {
+    err = SearchMaxThroughput(
+        *profiler, concurrent_request_count, max_concurrency,
+        latency_threshold_ms, percentile, protocol, verbose, &summary,
+        &status_summary);
+    std::sort(
+        summary.begin(), summary.end(),
+        [](const PerfStatus& a, const PerfStatus& b) -> bool {
+          return a.concurrency < b.concurrency;
+        });
+  } else if (!dynamic_concurrency_mode) {
     err = profiler->Profile(concurrent_request_count, status_summary);
     if (err.IsOk()) {
       err = Report(
@@ -2011,6 +2661,24 @@ main(int argc, char** argv)
                 << std::endl;
     }
 
+    if (search_mode) {
+      std::cout << std::endl
+                << "Maximum throughput within latency limit: "
+                << status_summary.client_infer_per_sec << " infer/sec ("
+                << status_summary.client_min_infer_per_sec << " - "
+                << status_summary.client_max_infer_per_sec
+                << " infer/sec) at concurrency "
+                << status_summary.concurrency << ", latency "
+                << (status_summary.stabilizing_latency_ns / 1000) << " usec ("
+                << (status_summary.min_stabilizing_latency_ns / 1000) << " - "
+                << (status_summary.max_stabilizing_latency_ns / 1000)
+                << " usec)" << std::endl;
+      if (!status_summary.server_execution_batch_count.empty()) {
+        std::cout << "Server execution batch sizes: "
+                  << ExecutionBatchDistribution(status_summary) << std::endl;
+      }
+    }
+
     if (!filename.empty()) {
       std::ofstream ofs(filename, std::ofstream::out);
 
@@ -187,6 +187,39 @@ class ServerStatusContext {
   virtual Error GetServerStatus(ServerStatus* status) = 0;
 };
 
+//==============================================================================
+/// A ServerLoadContext object is used to query an inference server
+/// for the current load of the models available on that server. Once
+/// created a ServerLoadContext object can be used repeatedly to get
+/// the load from the server. A ServerLoadContext object can use
+/// either HTTP protocol or GRPC protocol depending on the Create
+/// function (ServerLoadHttpContext::Create or
+/// ServerLoadGrpcContext::Create). For example:
+///
+/// \code
+///   std::unique_ptr<ServerLoadContext> ctx;
+///   ServerLoadHttpContext::Create(&ctx, "localhost:8000");
+///   ServerLoadStatus load;
+///   ctx->GetServerLoad(&load);
+///   ...
+/// \endcode
+///
+/// \note
+///   ServerLoadContext::Create methods are thread-safe.
+///   GetServerLoad() is not thread-safe. For a given
+///   ServerLoadContext, calls to GetServerLoad() must be
+///   serialized.
+///
+class ServerLoadContext {
+ public:
+  virtual ~ServerLoadContext() = 0;
+
+  /// Contact the inference server and get the load.
+  /// \param load Returns the load.
+  /// \return Error object indicating success or failure of the request.
+  virtual Error GetServerLoad(ServerLoadStatus* load) = 0;
+};
+
 //==============================================================================
 /// An InferContext object is used to run inference on an inference
 /// server for a specific model. Once created an InferContext object
@@ -517,6 +550,46 @@ class InferContext {
         const std::shared_ptr<InferContext::Output>& output, uint64_t k) = 0;
   };
 
+  //==============
+  /// Timing of a single request as measured by the client. The
+  /// durations have the same meaning as the cumulative durations in
+  /// Stat.
+  struct RequestTiming {
+    /// Time from the request start until the response is completely
+    /// received.
+    uint64_t total_request_time_ns;
+
+    /// Time from the request start until the last byte is sent.
+    uint64_t send_time_ns;
+
+    /// Time from receiving first byte of the response until the
+    /// response is completely received.
+    uint64_t receive_time_ns;
+
+    /// True if the server reported its timing of the request, which
+    /// it only does for requests with the
+    /// InferRequestHeader::FLAG_REPORT_TIMING flag set.
+    bool has_server_timing;
+
+    /// Time from the server receiving the request until the response
+    /// was ready, as measured by the server.
+    uint64_t server_request_time_ns;
+
+    /// Time the request waited in the server's scheduler queue.
+    uint64_t server_queue_time_ns;
+
+    /// Time the server spent executing the model for the request.
+    uint64_t server_compute_time_ns;
+
+    /// Create a new RequestTiming object with zero-ed durations.
+    RequestTiming()
+        : total_request_time_ns(0), send_time_ns(0), receive_time_ns(0),
+          has_server_timing(false), server_request_time_ns(0),
+          server_queue_time_ns(0), server_compute_time_ns(0)
+    {
+    }
+  };
+
   //==============
   /// Handle to a inference request. The request handle is used to get
   /// request results if the request is sent by AsyncRun().
@@ -526,6 +599,12 @@ class InferContext {
 
     /// \return The unique identifier of the request.
     virtual uint64_t Id() const = 0;
+
+    /// Get the timing of the request. The timing is only valid once
+    /// the request has completed.
+    /// \param timing Returns the timing of the request.
+    /// \return Error object indicating success or failure.
+    virtual Error GetTiming(RequestTiming* timing) const = 0;
   };
 
   //==============
@@ -71,6 +71,38 @@ RequestTimers::Record(Kind kind)
   return Error::Success;
 }
 
+Error
+RequestTimers::Validate() const
+{
+  if ((request_start_ > request_end_) || (send_start_ > send_end_) ||
+      (receive_start_ > receive_end_)) {
+    auto zero_time_point = TimePoint();
+    auto request_start_ns = Duration(request_start_, zero_time_point);
+    auto request_end_ns = Duration(request_end_, zero_time_point);
+    auto send_start_ns = Duration(send_start_, zero_time_point);
+    auto send_end_ns = Duration(send_end_, zero_time_point);
+    auto receive_start_ns = Duration(receive_start_, zero_time_point);
+    auto receive_end_ns = Duration(receive_end_, zero_time_point);
+    return Error(
+        RequestStatusCode::INVALID_ARG,
+        "Timer not set correctly." +
+            ((request_start_ns > request_end_ns)
+                 ? (" Request time from " + std::to_string(request_start_ns) +
+                    " to " + std::to_string(request_end_ns) + ".")
+                 : "") +
+            ((send_start_ns > send_end_ns)
+                 ? (" Send time from " + std::to_string(send_start_ns) +
+                    " to " + std::to_string(send_end_ns) + ".")
+                 : "") +
+            ((receive_start_ns > receive_end_ns)
+                 ? (" Receive time from " + std::to_string(receive_start_ns) +
+                    " to " + std::to_string(receive_end_ns) + ".")
+                 : ""));
+  }
+
+  return Error::Success;
+}
+
 //==============================================================================
 
 bool
@@ -702,11 +734,36 @@ ResultImpl::SetNextRawResult(
 
 //==============================================================================
 
+Error
+RequestImpl::GetTiming(InferContext::RequestTiming* timing) const
+{
+  Error err = timer_.Validate();
+  if (!err.IsOk()) {
+    return err;
+  }
+
+  timing->total_request_time_ns =
+      RequestTimers::Duration(timer_.request_start_, timer_.request_end_);
+  timing->send_time_ns =
+      RequestTimers::Duration(timer_.send_start_, timer_.send_end_);
+  timing->receive_time_ns =
+      RequestTimers::Duration(timer_.receive_start_, timer_.receive_end_);
+
+  timing->has_server_timing = has_server_timing_;
+  timing->server_request_time_ns = server_timing_.request_time_ns();
+  timing->server_queue_time_ns = server_timing_.queue_time_ns();
+  timing->server_compute_time_ns = server_timing_.compute_time_ns();
+  return Error::Success;
+}
+
 Error
 RequestImpl::PostRunProcessing(
     const InferResponseHeader& infer_response,
-    InferContext::ResultMap* results) const
+    InferContext::ResultMap* results)
 {
+  has_server_timing_ = infer_response.has_timing();
+  server_timing_ = infer_response.timing();
+
   // At this point, the RAW requested results have their result values
   // set. Now need to initialize non-RAW results.
   for (auto& pr : *results) {
@@ -869,37 +926,9 @@ InferContextImpl::GetStat(Stat* stat) const
 Error
 InferContextImpl::UpdateStat(const RequestTimers& timer)
 {
-  if ((timer.request_start_ > timer.request_end_) ||
-      (timer.send_start_ > timer.send_end_) ||
-      (timer.receive_start_ > timer.receive_end_)) {
-    auto zero_time_point = RequestTimers::TimePoint();
-    auto request_start_ns =
-        RequestTimers::Duration(timer.request_start_, zero_time_point);
-    auto request_end_ns =
-        RequestTimers::Duration(timer.request_end_, zero_time_point);
-    auto send_start_ns =
-        RequestTimers::Duration(timer.send_start_, zero_time_point);
-    auto send_end_ns =
-        RequestTimers::Duration(timer.send_end_, zero_time_point);
-    auto receive_start_ns =
-        RequestTimers::Duration(timer.receive_start_, zero_time_point);
-    auto receive_end_ns =
-        RequestTimers::Duration(timer.receive_end_, zero_time_point);
-    return Error(
-        RequestStatusCode::INVALID_ARG,
-        "Timer not set correctly." +
-            ((request_start_ns > request_end_ns)
-                 ? (" Request time from " + std::to_string(request_start_ns) +
-                    " to " + std::to_string(request_end_ns) + ".")
-                 : "") +
-            ((send_start_ns > send_end_ns)
-                 ? (" Send time from " + std::to_string(send_start_ns) +
-                    " to " + std::to_string(send_end_ns) + ".")
-                 : "") +
-            ((receive_start_ns > receive_end_ns)
-                 ? (" Receive time from " + std::to_string(receive_start_ns) +
-                    " to " + std::to_string(receive_end_ns) + ".")
-                 : ""));
+  Error err = timer.Validate();
+  if (!err.IsOk()) {
+    return err;
   }
 
   uint64_t request_time_ns =
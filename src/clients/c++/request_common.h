@@ -89,6 +89,10 @@ class RequestTimers {
   /// \return Error object indicating success or failure.
   Error Record(Kind kind);
 
+  /// Check that each recorded stage ends no earlier than it starts.
+  /// \return Error object indicating success or failure.
+  Error Validate() const;
+
   TimePoint request_start_;
   TimePoint request_end_;
   TimePoint send_start_;
@@ -335,7 +339,8 @@ class ResultImpl : public InferContext::Result {
 class RequestImpl : public InferContext::Request {
  public:
   RequestImpl(const uint64_t id, InferContext::OnCompleteFn callback = nullptr)
-      : callback_(std::move(callback)), id_(id), ready_(false)
+      : callback_(std::move(callback)), id_(id), ready_(false),
+        has_server_timing_(false)
   {
   }
   virtual ~RequestImpl() = default;
@@ -343,6 +348,8 @@ class RequestImpl : public InferContext::Request {
   uint64_t Id() const override { return id_; };
   void SetId(uint64_t id) { id_ = id; }
 
+  Error GetTiming(InferContext::RequestTiming* timing) const override;
+
   uintptr_t RunIndex() const { return run_index_; }
   void SetRunIndex(uintptr_t idx) { run_index_ = idx; }
 
@@ -353,10 +360,11 @@ class RequestImpl : public InferContext::Request {
 
   RequestTimers& Timer() { return timer_; }
 
-  // Set non-RAW results from the inference response
+  // Set non-RAW results and the server timing from the inference
+  // response
   Error PostRunProcessing(
       const InferResponseHeader& infer_response,
-      InferContext::ResultMap* results) const;
+      InferContext::ResultMap* results);
 
  protected:
   // Callback function to be called once the request is completed.
@@ -374,6 +382,10 @@ class RequestImpl : public InferContext::Request {
 
   // The timer for infer request.
   RequestTimers timer_;
+
+  // The server timing of the request, if returned in the response.
+  bool has_server_timing_;
+  InferResponseHeader::Timing server_timing_;
 };
 
 //==============================================================================
@@ -28,10 +28,12 @@
 
 #include "src/clients/c++/request_grpc.h"
 
+#include <grpcpp/generic/generic_stub.h>
 #include <grpcpp/grpcpp.h>
 #include <cstdint>
 #include <iostream>
 #include "src/clients/c++/request_common.h"
+#include "src/core/grpc_wire.h"
 #include "src/core/grpc_service.grpc.pb.h"
 #include "src/core/grpc_service.pb.h"
 #include "src/core/model_config.pb.h"
@@ -64,10 +66,117 @@ GetChannel(const std::string& url)
   }
 }
 
+// The inference methods are called through a generic stub so that
+// requests and responses can be (de)serialized without copying the
+// tensor data.
+const char* kInferMethod = "/nvidia.inferenceserver.GRPCService/Infer";
+const char* kStreamInferMethod =
+    "/nvidia.inferenceserver.GRPCService/StreamInfer";
+
 }  // namespace
 
 //==============================================================================
 
+// An InferResponse received as a gRPC ByteBuffer. The raw output
+// tensors are not copied, instead they reference the received
+// slices.
+class GrpcInferResponse {
+ public:
+  using Chunks = std::vector<std::pair<const uint8_t*, size_t>>;
+
+  // Parse the response from 'buffer'. Return false if 'buffer' does
+  // not hold a valid response.
+  bool Parse(grpc::ByteBuffer* buffer);
+
+  // The response. 'raw_output' is always empty, use RawOutputs() to
+  // access the raw output tensors.
+  const InferResponse& Response() const { return response_; }
+
+  // The chunks holding each raw output tensor, in the order they
+  // appear in the response.
+  const std::vector<Chunks>& RawOutputs() const { return raw_outputs_; }
+
+  // Add 'message', one of the messages of a chunked response, to
+  // this response. Return true if 'message' is the last message of
+  // the response.
+  bool AddChunk(const std::shared_ptr<GrpcInferResponse>& message);
+
+ private:
+  InferResponse response_;
+  std::vector<Chunks> raw_outputs_;
+
+  // The received slices. Not modified after parsing so the chunks,
+  // which may point to data held inline in a slice, remain valid.
+  std::vector<grpc::Slice> slices_;
+
+  // The messages that a chunked response is assembled from. The raw
+  // output chunks reference the slices of these messages.
+  std::vector<std::shared_ptr<GrpcInferResponse>> messages_;
+};
+
+bool
+GrpcInferResponse::Parse(grpc::ByteBuffer* buffer)
+{
+  response_.Clear();
+  raw_outputs_.clear();
+  slices_.clear();
+
+  if (!buffer->Dump(&slices_).ok()) {
+    return false;
+  }
+
+  // The raw outputs are referenced in place and all other fields are
+  // collected and parsed as a regular protobuf message.
+  std::string fields;
+  std::vector<std::vector<SliceBlock>> raw_fields;
+  bool ok = SplitRawFields(
+      slices_, InferResponse::kRawOutputFieldNumber, &fields, &raw_fields);
+  for (const auto& blocks : raw_fields) {
+    raw_outputs_.emplace_back();
+    for (const auto& block : blocks) {
+      raw_outputs_.back().emplace_back(
+          slices_[block.slice_idx].begin() + block.offset, block.byte_size);
+    }
+  }
+
+  if (!ok || !response_.ParseFromString(fields)) {
+    response_.Clear();
+    raw_outputs_.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool
+GrpcInferResponse::AddChunk(const std::shared_ptr<GrpcInferResponse>& message)
+{
+  const InferChunk& chunk = message->Response().chunk();
+
+  size_t idx = chunk.tensor_index();
+  for (const auto& raw : message->RawOutputs()) {
+    if (raw_outputs_.size() <= idx) {
+      raw_outputs_.resize(idx + 1);
+    }
+    raw_outputs_[idx].insert(raw_outputs_[idx].end(), raw.begin(), raw.end());
+    idx++;
+  }
+  messages_.push_back(message);
+
+  // The last message holds the rest of the response.
+  if (chunk.last()) {
+    response_ = message->Response();
+    const size_t output_cnt = response_.meta_data().output_size();
+    if (raw_outputs_.size() < output_cnt) {
+      raw_outputs_.resize(output_cnt);
+    }
+  }
+
+  return chunk.last();
+}
+
+//==============================================================================
+
 class ServerHealthGrpcContextImpl : public ServerHealthContext {
  public:
   ServerHealthGrpcContextImpl(const std::string& url, bool verbose);
@@ -229,6 +338,83 @@ ServerStatusGrpcContext::Create(
 
 //==============================================================================
 
+class ServerLoadGrpcContextImpl : public ServerLoadContext {
+ public:
+  ServerLoadGrpcContextImpl(
+      const std::string& url, const std::string& model_name, bool verbose);
+  Error GetServerLoad(ServerLoadStatus* load) override;
+
+ private:
+  // Model name
+  const std::string model_name_;
+
+  // GRPC end point.
+  std::unique_ptr<GRPCService::Stub> stub_;
+
+  // Enable verbose output
+  const bool verbose_;
+};
+
+ServerLoadGrpcContextImpl::ServerLoadGrpcContextImpl(
+    const std::string& url, const std::string& model_name, bool verbose)
+    : model_name_(model_name), stub_(GRPCService::NewStub(GetChannel(url))),
+      verbose_(verbose)
+{
+}
+
+Error
+ServerLoadGrpcContextImpl::GetServerLoad(ServerLoadStatus* load)
+{
+  load->Clear();
+
+  Error grpc_status;
+
+  LoadRequest request;
+  LoadResponse response;
+  grpc::ClientContext context;
+
+  request.set_model_name(model_name_);
+  grpc::Status status = stub_->Load(&context, request, &response);
+  if (status.ok()) {
+    load->Swap(response.mutable_load_status());
+    grpc_status = Error(response.request_status());
+  } else {
+    // Something wrong with the GRPC conncection
+    grpc_status = Error(
+        RequestStatusCode::INTERNAL,
+        "GRPC client failed: " + std::to_string(status.error_code()) + ": " +
+            status.error_message());
+  }
+
+  // Log server load if request is SUCCESS and verbose is true.
+  if (grpc_status.IsOk() && verbose_) {
+    std::cout << load->DebugString() << std::endl;
+  }
+  return grpc_status;
+}
+
+Error
+ServerLoadGrpcContext::Create(
+    std::unique_ptr<ServerLoadContext>* ctx, const std::string& server_url,
+    bool verbose)
+{
+  ctx->reset(static_cast<ServerLoadContext*>(
+      new ServerLoadGrpcContextImpl(server_url, "", verbose)));
+  return Error::Success;
+}
+
+Error
+ServerLoadGrpcContext::Create(
+    std::unique_ptr<ServerLoadContext>* ctx, const std::string& server_url,
+    const std::string& model_name, bool verbose)
+{
+  ctx->reset(static_cast<ServerLoadContext*>(
+      new ServerLoadGrpcContextImpl(server_url, model_name, verbose)));
+  return Error::Success;
+}
+
+//==============================================================================
+
 class ProfileGrpcContextImpl : public ProfileContext {
  public:
   ProfileGrpcContextImpl(const std::string& url, bool verbose);
@@ -297,20 +483,20 @@ ProfileGrpcContext::Create(
 class GrpcResultImpl : public ResultImpl {
  public:
   GrpcResultImpl(
-      const std::shared_ptr<InferResponse>& response,
+      const std::shared_ptr<GrpcInferResponse>& response,
       const std::shared_ptr<InferContext::Output>& output);
   ~GrpcResultImpl() = default;
 
  private:
   // Result tensor data is used in-place from the GRPC response
   // object so we must hold a reference to it.
-  std::shared_ptr<InferResponse> response_;
+  std::shared_ptr<GrpcInferResponse> response_;
 };
 
 GrpcResultImpl::GrpcResultImpl(
-    const std::shared_ptr<InferResponse>& response,
+    const std::shared_ptr<GrpcInferResponse>& response,
     const std::shared_ptr<InferContext::Output>& output)
-    : ResultImpl(output, response->meta_data().batch_size()),
+    : ResultImpl(output, response->Response().meta_data().batch_size()),
       response_(response)
 {
 }
@@ -323,7 +509,7 @@ class GrpcRequestImpl : public RequestImpl {
       const uint64_t id, InferContext::OnCompleteFn callback = nullptr);
 
   Error GetResults(
-      const InferGrpcContextImpl& ctx, InferContext::ResultMap* results) const;
+      const InferGrpcContextImpl& ctx, InferContext::ResultMap* results);
 
  private:
   Error InitResult(
@@ -334,10 +520,14 @@ class GrpcRequestImpl : public RequestImpl {
   friend class InferGrpcContextImpl;
   friend class InferGrpcStreamContextImpl;
 
+  // Parse the received 'grpc_buffer_' into 'grpc_response_'.
+  void ParseResponse();
+
   // Variables for GRPC call
   grpc::ClientContext grpc_context_;
   grpc::Status grpc_status_;
-  std::shared_ptr<InferResponse> grpc_response_;
+  grpc::ByteBuffer grpc_buffer_;
+  std::shared_ptr<GrpcInferResponse> grpc_response_;
 };
 
 class InferGrpcContextImpl : public InferContextImpl {
@@ -361,16 +551,26 @@ class InferGrpcContextImpl : public InferContextImpl {
   virtual void AsyncTransfer();
   Error PreRunProcessing(std::shared_ptr<Request>& request);
 
+  // Set 'request_' to the request for 'request', without the raw
+  // input tensors.
+  void PrepareRequest(std::shared_ptr<Request>& request);
+
   // The producer-consumer queue used to communicate asynchronously with
   // the GRPC runtime.
   grpc::CompletionQueue async_request_completion_queue_;
 
+  // The completion queue used by Run().
+  grpc::CompletionQueue sync_request_completion_queue_;
+
   // GRPC end point.
-  std::unique_ptr<GRPCService::Stub> stub_;
+  std::unique_ptr<grpc::GenericStub> stub_;
 
   // request for GRPC call, one request object can be used for multiple calls
-  // since it can be overwritten as soon as the GRPC send finishes.
+  // since it can be overwritten as soon as the GRPC send finishes. The
+  // raw input tensors are not held in 'request_', they are referenced
+  // directly from the inputs by the slices of 'request_buffer_'.
   InferRequest request_;
+  grpc::ByteBuffer request_buffer_;
 };
 
 //==============================================================================
@@ -378,11 +578,22 @@ class InferGrpcContextImpl : public InferContextImpl {
 GrpcRequestImpl::GrpcRequestImpl(
     const uint64_t id, InferContext::OnCompleteFn callback)
     : RequestImpl(id, std::move(callback)), grpc_status_(),
-      grpc_response_(std::make_shared<InferResponse>())
+      grpc_response_(std::make_shared<GrpcInferResponse>())
 {
   SetRunIndex(id);
 }
 
+void
+GrpcRequestImpl::ParseResponse()
+{
+  if (grpc_status_.ok() && !grpc_response_->Parse(&grpc_buffer_)) {
+    grpc_status_ = grpc::Status(
+        grpc::StatusCode::INTERNAL, "failed to parse inference response");
+  }
+
+  grpc_buffer_.Clear();
+}
+
 Error
 GrpcRequestImpl::InitResult(
     const std::shared_ptr<InferContext::Output>& infer_output,
@@ -395,21 +606,37 @@ GrpcRequestImpl::InitResult(
   }
 
   if (result->ResultFormat() == InferContext::Result::ResultFormat::RAW) {
-    if (grpc_response_->raw_output_size() <= (int)idx) {
+    if (grpc_response_->RawOutputs().size() <= idx) {
       return Error(
           RequestStatusCode::INVALID,
           "Expected RAW output for result '" + output.name() + "'");
     }
 
-    const std::string& raw_output = grpc_response_->raw_output(idx);
-    const uint8_t* buf = reinterpret_cast<const uint8_t*>(&raw_output[0]);
-    size_t size = raw_output.size();
+    // The result can be used in-place if it was received in a single
+    // slice, otherwise it is gathered from the slices holding it.
+    const GrpcInferResponse::Chunks& chunks = grpc_response_->RawOutputs()[idx];
+    const bool inplace = (chunks.size() <= 1);
+    size_t size = 0;
     size_t result_bytes = 0;
 
-    Error err =
-        result->SetNextRawResult(buf, size, true /* inplace */, &result_bytes);
-    if (!err.IsOk()) {
-      return err;
+    if (chunks.empty()) {
+      Error err = result->SetNextRawResult(
+          nullptr, 0, true /* inplace */, &result_bytes);
+      if (!err.IsOk()) {
+        return err;
+      }
+    }
+
+    for (const auto& chunk : chunks) {
+      size_t chunk_result_bytes = 0;
+      Error err = result->SetNextRawResult(
+          chunk.first, chunk.second, inplace, &chunk_result_bytes);
+      if (!err.IsOk()) {
+        return err;
+      }
+
+      size += chunk.second;
+      result_bytes += chunk_result_bytes;
     }
 
     if (result_bytes != size) {
@@ -425,7 +652,7 @@ GrpcRequestImpl::InitResult(
 
 Error
 GrpcRequestImpl::GetResults(
-    const InferGrpcContextImpl& ctx, InferContext::ResultMap* results) const
+    const InferGrpcContextImpl& ctx, InferContext::ResultMap* results)
 {
   results->clear();
 
@@ -437,12 +664,14 @@ GrpcRequestImpl::GetResults(
             ": " + grpc_status_.error_message());
   }
 
+  const InferResponse& response = grpc_response_->Response();
+
   // Request failed...
-  if (grpc_response_->request_status().code() != RequestStatusCode::SUCCESS) {
-    return Error(grpc_response_->request_status());
+  if (response.request_status().code() != RequestStatusCode::SUCCESS) {
+    return Error(response.request_status());
   }
 
-  const InferResponseHeader& response_header = grpc_response_->meta_data();
+  const InferResponseHeader& response_header = response.meta_data();
 
   // Create a Result for each output. Each result holds
   // grpc_response_ (shared_ptr) so it can use its specific result
@@ -474,7 +703,7 @@ GrpcRequestImpl::GetResults(
     return err;
   }
 
-  return Error(grpc_response_->request_status());
+  return Error(response.request_status());
 }
 
 //==============================================================================
@@ -501,7 +730,7 @@ InferGrpcContextImpl::InferGrpcContextImpl(
     const std::string& server_url, const std::string& model_name,
     int64_t model_version, CorrelationID correlation_id, bool verbose)
     : InferContextImpl(model_name, model_version, correlation_id, verbose),
-      stub_(GRPCService::NewStub(GetChannel(server_url)))
+      stub_(new grpc::GenericStub(GetChannel(server_url)))
 {
 }
 
@@ -515,7 +744,7 @@ InferGrpcContextImpl::~InferGrpcContextImpl()
     worker_.join();
   }
 
-  // Close complete queue and drain its content
+  // Close complete queues and drain their content
   async_request_completion_queue_.Shutdown();
   bool has_next = true;
   void* tag;
@@ -523,6 +752,11 @@ InferGrpcContextImpl::~InferGrpcContextImpl()
   do {
     has_next = async_request_completion_queue_.Next(&tag, &ok);
   } while (has_next);
+
+  sync_request_completion_queue_.Shutdown();
+  do {
+    has_next = sync_request_completion_queue_.Next(&tag, &ok);
+  } while (has_next);
 }
 
 Error
@@ -543,12 +777,22 @@ InferGrpcContextImpl::Run(ResultMap* results)
   sync_request->Timer().Record(RequestTimers::Kind::SEND_END);
 
   sync_request->Timer().Record(RequestTimers::Kind::REQUEST_START);
-  sync_request->grpc_response_->Clear();
-  sync_request->grpc_status_ =
-      stub_->Infer(&context, request_, sync_request->grpc_response_.get());
+  std::unique_ptr<grpc::GenericClientAsyncResponseReader> rpc(
+      stub_->PrepareUnaryCall(
+          &context, kInferMethod, request_buffer_,
+          &sync_request_completion_queue_));
+  rpc->StartCall();
+  rpc->Finish(
+      &sync_request->grpc_buffer_, &sync_request->grpc_status_,
+      (void*)sync_request.get());
+
+  void* tag;
+  bool ok;
+  sync_request_completion_queue_.Next(&tag, &ok);
   sync_request->Timer().Record(RequestTimers::Kind::REQUEST_END);
 
   sync_request->Timer().Record(RequestTimers::Kind::RECEIVE_START);
+  sync_request->ParseResponse();
   Error request_status = sync_request->GetResults(*this, results);
   sync_request->Timer().Record(RequestTimers::Kind::RECEIVE_END);
 
@@ -610,15 +854,15 @@ InferGrpcContextImpl::AsyncRun(
   current_context->Timer().Record(RequestTimers::Kind::SEND_END);
 
   current_context->Timer().Record(RequestTimers::Kind::REQUEST_START);
-  std::unique_ptr<grpc::ClientAsyncResponseReader<InferResponse>> rpc(
-      stub_->PrepareAsyncInfer(
-          &current_context->grpc_context_, request_,
+  std::unique_ptr<grpc::GenericClientAsyncResponseReader> rpc(
+      stub_->PrepareUnaryCall(
+          &current_context->grpc_context_, kInferMethod, request_buffer_,
           &async_request_completion_queue_));
 
   rpc->StartCall();
 
   rpc->Finish(
-      current_context->grpc_response_.get(), &current_context->grpc_status_,
+      &current_context->grpc_buffer_, &current_context->grpc_status_,
       (void*)run_index);
 
   cv_.notify_all();
@@ -652,8 +896,8 @@ InferGrpcContextImpl::GetAsyncRunResults(
   return request_status;
 }
 
-Error
-InferGrpcContextImpl::PreRunProcessing(std::shared_ptr<Request>& request)
+void
+InferGrpcContextImpl::PrepareRequest(std::shared_ptr<Request>& request)
 {
   // Create the input metadata for the request now that all input
   // sizes are known. For non-fixed-sized datatypes the
@@ -680,26 +924,68 @@ InferGrpcContextImpl::PreRunProcessing(std::shared_ptr<Request>& request)
   request_.set_model_name(model_name_);
   request_.set_model_version(model_version_);
   request_.mutable_meta_data()->MergeFrom(infer_request_);
+}
 
-  size_t input_pos_idx = 0;
-  while (input_pos_idx < inputs_.size()) {
-    InputImpl* io = reinterpret_cast<InputImpl*>(inputs_[input_pos_idx].get());
-    std::string* new_input = request_.add_raw_input();
+Error
+InferGrpcContextImpl::PreRunProcessing(std::shared_ptr<Request>& request)
+{
+  PrepareRequest(request);
+
+  // Serialize everything except the raw inputs normally and then
+  // append each raw input as a tag and length followed by slices
+  // referencing the input data. The input data must not be modified
+  // until the request completes (see InferContext::Input::SetRaw()),
+  // so it is not copied. STRING inputs may be held by the input
+  // itself and can be reset while the request is in flight, so they
+  // are copied.
+  std::vector<grpc::Slice> slices;
+  std::string fields;
+  request_.SerializeToString(&fields);
+  slices.emplace_back(fields.data(), fields.size());
+  size_t request_size = fields.size();
+
+  for (const auto& input : inputs_) {
+    InputImpl* io = reinterpret_cast<InputImpl*>(input.get());
+    const bool copy = (io->DType() == DataType::TYPE_STRING);
 
     // Append all batches of one input together
+    size_t input_byte_size = 0;
+    for (size_t batch_idx = 0; batch_idx < batch_size_; batch_idx++) {
+      const uint8_t* data_ptr;
+      size_t data_byte_size;
+      io->GetRaw(batch_idx, &data_ptr, &data_byte_size);
+      input_byte_size += data_byte_size;
+    }
+
+    std::string prefix;
+    AppendVarint(
+        (InferRequest::kRawInputFieldNumber << 3) | kWireTypeLengthDelimited,
+        &prefix);
+    AppendVarint(input_byte_size, &prefix);
+    slices.emplace_back(prefix.data(), prefix.size());
+    request_size += prefix.size() + input_byte_size;
+
     for (size_t batch_idx = 0; batch_idx < batch_size_; batch_idx++) {
       const uint8_t* data_ptr;
       size_t data_byte_size;
       io->GetRaw(batch_idx, &data_ptr, &data_byte_size);
-      new_input->append(
-          reinterpret_cast<const char*>(data_ptr), data_byte_size);
+      if (data_byte_size == 0) {
+        continue;
+      }
+
+      if (copy) {
+        slices.emplace_back(data_ptr, data_byte_size);
+      } else {
+        slices.emplace_back(
+            const_cast<uint8_t*>(data_ptr), data_byte_size,
+            grpc::Slice::STATIC_SLICE);
+      }
     }
-    input_pos_idx++;
   }
 
-  if (request_.ByteSizeLong() > INT_MAX) {
-    size_t request_size = request_.ByteSizeLong();
+  if (request_size > INT_MAX) {
     request_.Clear();
+    request_buffer_.Clear();
     return Error(
         RequestStatusCode::INVALID_ARG,
         "Request has byte size " + std::to_string(request_size) +
@@ -707,6 +993,9 @@ InferGrpcContextImpl::PreRunProcessing(std::shared_ptr<Request>& request)
             ".");
   }
 
+  grpc::ByteBuffer request_buffer(&slices[0], slices.size());
+  request_buffer_.Swap(&request_buffer);
+
   return Error::Success;
 }
 
@@ -757,6 +1046,7 @@ InferGrpcContextImpl::AsyncTransfer()
         std::shared_ptr<GrpcRequestImpl> grpc_request =
             std::static_pointer_cast<GrpcRequestImpl>(itr->second);
         grpc_request->Timer().Record(RequestTimers::Kind::REQUEST_END);
+        grpc_request->ParseResponse();
         grpc_request->SetIsReady(true);
         if (grpc_request->HasCallback()) {
           request_with_callback = itr->second;
@@ -808,29 +1098,68 @@ class InferGrpcStreamContextImpl : public InferGrpcContextImpl {
   using InferGrpcContextImpl::AsyncRun;
 
   InferGrpcStreamContextImpl(
-      const std::string&, const std::string&, int64_t, CorrelationID, bool);
+      const std::string&, const std::string&, int64_t, CorrelationID, bool,
+      size_t);
   virtual ~InferGrpcStreamContextImpl();
 
   Error Run(ResultMap* results) override;
 
  private:
+  // Tags identifying the operations on the stream.
+  enum StreamOp : uintptr_t { START = 1, READ, WRITE, WRITES_DONE, FINISH };
+
   Error AsyncRun(
       std::shared_ptr<Request>* async_request, OnCompleteFn callback) override;
   void AsyncTransfer() override;
 
+  // Serialize 'request' into 'buffers' as the messages of a chunked
+  // request.
+  Error PreRunProcessingChunked(
+      std::shared_ptr<Request>& request,
+      std::vector<grpc::ByteBuffer>* buffers);
+
+  // Write 'buffer' to the stream, or close the stream for writing if
+  // 'buffer' is nullptr, and wait for the write to complete. Return
+  // false if the stream is closed.
+  bool Write(const grpc::ByteBuffer* buffer);
+
+  // Handle a response read from the stream.
+  void ProcessResponse(grpc::ByteBuffer* buffer);
+
   // gRPC objects for using the streaming API
   grpc::ClientContext context_;
-  std::shared_ptr<grpc::ClientReaderWriter<InferRequest, InferResponse>>
-      stream_;
+  grpc::CompletionQueue stream_completion_queue_;
+  std::unique_ptr<grpc::GenericClientAsyncReaderWriter> stream_;
+  grpc::Status stream_status_;
+
+  // If non-zero, requests and responses are sent as messages holding
+  // at most this many bytes of tensor data.
+  const size_t chunk_byte_size_;
+
+  // The response being assembled from the messages of a chunked
+  // response. Only used by the reader thread.
+  std::shared_ptr<GrpcInferResponse> chunked_response_;
+
+  // Only one write can be outstanding on the stream at a time.
+  std::mutex write_mutex_;
+  std::condition_variable write_cv_;
+  bool write_pending_;
+  bool write_ok_;
+  bool stream_closed_;
 };
 
 InferGrpcStreamContextImpl::InferGrpcStreamContextImpl(
     const std::string& server_url, const std::string& model_name,
-    int64_t model_version, CorrelationID correlation_id, bool verbose)
+    int64_t model_version, CorrelationID correlation_id, bool verbose,
+    size_t chunk_byte_size)
     : InferGrpcContextImpl(
-          server_url, model_name, model_version, correlation_id, verbose)
+          server_url, model_name, model_version, correlation_id, verbose),
+      chunk_byte_size_(chunk_byte_size), write_pending_(false),
+      write_ok_(true), stream_closed_(false)
 {
-  stream_ = stub_->StreamInfer(&context_);
+  stream_ = stub_->PrepareCall(
+      &context_, kStreamInferMethod, &stream_completion_queue_);
+  stream_->StartCall((void*)StreamOp::START);
   // Initiate worker thread to read constantly
   worker_ = std::thread(&InferGrpcStreamContextImpl::AsyncTransfer, this);
 }
@@ -838,7 +1167,7 @@ InferGrpcStreamContextImpl::InferGrpcStreamContextImpl(
 InferGrpcStreamContextImpl::~InferGrpcStreamContextImpl()
 {
   exiting_ = true;
-  stream_->WritesDone();
+  Write(nullptr);
   // The reader thread will drain the stream properly
   worker_.join();
 }
@@ -879,7 +1208,10 @@ InferGrpcStreamContextImpl::AsyncRun(
 
   current_context->Timer().Reset();
   current_context->Timer().Record(RequestTimers::Kind::SEND_START);
-  Error err = PreRunProcessing(*async_request);
+  std::vector<grpc::ByteBuffer> chunk_buffers;
+  Error err = (chunk_byte_size_ == 0)
+                  ? PreRunProcessing(*async_request)
+                  : PreRunProcessingChunked(*async_request, &chunk_buffers);
   if (!err.IsOk()) {
     ongoing_async_requests_.erase(current_context->Id());
     return err;
@@ -887,7 +1219,17 @@ InferGrpcStreamContextImpl::AsyncRun(
   current_context->Timer().Record(RequestTimers::Kind::SEND_END);
 
   current_context->Timer().Record(RequestTimers::Kind::REQUEST_START);
-  bool ok = stream_->Write(request_);
+  bool ok = true;
+  if (chunk_byte_size_ == 0) {
+    ok = Write(&request_buffer_);
+  } else {
+    for (const auto& buffer : chunk_buffers) {
+      ok = Write(&buffer);
+      if (!ok) {
+        break;
+      }
+    }
+  }
 
   if (ok) {
     return Error::Success;
@@ -896,68 +1238,230 @@ InferGrpcStreamContextImpl::AsyncRun(
   }
 }
 
+Error
+InferGrpcStreamContextImpl::PreRunProcessingChunked(
+    std::shared_ptr<Request>& request, std::vector<grpc::ByteBuffer>* buffers)
+{
+  PrepareRequest(request);
+  buffers->clear();
+
+  // Split the raw inputs into chunks. The input data is referenced
+  // or copied in the same way as in PreRunProcessing().
+  struct Chunk {
+    uint32_t tensor_index_;
+    size_t byte_size_;
+    std::vector<grpc::Slice> slices_;
+  };
+
+  std::vector<Chunk> chunks;
+  uint32_t tensor_index = 0;
+  for (const auto& input : inputs_) {
+    InputImpl* io = reinterpret_cast<InputImpl*>(input.get());
+    const bool copy = (io->DType() == DataType::TYPE_STRING);
+
+    for (size_t batch_idx = 0; batch_idx < batch_size_; batch_idx++) {
+      const uint8_t* data_ptr;
+      size_t data_byte_size;
+      io->GetRaw(batch_idx, &data_ptr, &data_byte_size);
+      while (data_byte_size > 0) {
+        if (chunks.empty() || (chunks.back().tensor_index_ != tensor_index) ||
+            (chunks.back().byte_size_ == chunk_byte_size_)) {
+          chunks.emplace_back();
+          chunks.back().tensor_index_ = tensor_index;
+          chunks.back().byte_size_ = 0;
+        }
+
+        Chunk& chunk = chunks.back();
+        const size_t cnt =
+            std::min(data_byte_size, chunk_byte_size_ - chunk.byte_size_);
+        if (copy) {
+          chunk.slices_.emplace_back(data_ptr, cnt);
+        } else {
+          chunk.slices_.emplace_back(
+              const_cast<uint8_t*>(data_ptr), cnt, grpc::Slice::STATIC_SLICE);
+        }
+
+        chunk.byte_size_ += cnt;
+        data_ptr += cnt;
+        data_byte_size -= cnt;
+      }
+    }
+
+    tensor_index++;
+  }
+
+  // The first message holds the request without any raw input data,
+  // each following message holds one chunk.
+  InferChunk* request_chunk = request_.mutable_chunk();
+  request_chunk->set_max_byte_size(chunk_byte_size_);
+  request_chunk->set_last(chunks.empty());
+
+  std::string fields;
+  request_.SerializeToString(&fields);
+  grpc::Slice slice(fields.data(), fields.size());
+  buffers->emplace_back(&slice, 1);
+
+  for (size_t idx = 0; idx < chunks.size(); ++idx) {
+    Chunk& chunk = chunks[idx];
+
+    InferRequest chunk_request;
+    chunk_request.mutable_chunk()->set_tensor_index(chunk.tensor_index_);
+    chunk_request.mutable_chunk()->set_last((idx + 1) == chunks.size());
+
+    std::string prefix;
+    chunk_request.SerializeToString(&prefix);
+    AppendVarint(
+        (InferRequest::kRawInputFieldNumber << 3) | kWireTypeLengthDelimited,
+        &prefix);
+    AppendVarint(chunk.byte_size_, &prefix);
+    chunk.slices_.insert(
+        chunk.slices_.begin(), grpc::Slice(prefix.data(), prefix.size()));
+
+    buffers->emplace_back(&chunk.slices_[0], chunk.slices_.size());
+  }
+
+  return Error::Success;
+}
+
+bool
+InferGrpcStreamContextImpl::Write(const grpc::ByteBuffer* buffer)
+{
+  std::unique_lock<std::mutex> lock(write_mutex_);
+  write_cv_.wait(lock, [this] { return !write_pending_; });
+  if (stream_closed_) {
+    return false;
+  }
+
+  write_pending_ = true;
+  if (buffer != nullptr) {
+    stream_->Write(*buffer, (void*)StreamOp::WRITE);
+  } else {
+    stream_->WritesDone((void*)StreamOp::WRITES_DONE);
+  }
+
+  write_cv_.wait(lock, [this] { return !write_pending_; });
+  return write_ok_;
+}
+
 void
-InferGrpcStreamContextImpl::AsyncTransfer()
+InferGrpcStreamContextImpl::ProcessResponse(grpc::ByteBuffer* buffer)
 {
-  InferResponse response;
-  // End loop if Read() returns false
-  // (stream ended and all responses are drained)
-  while (stream_->Read(&response)) {
-    if (exiting_) {
-      continue;
+  auto response = std::make_shared<GrpcInferResponse>();
+  if (!response->Parse(buffer)) {
+    fprintf(stderr, "Unexpected error: failed to parse response.\n");
+    return;
+  }
+
+  // The messages of a chunked response are collected until the last
+  // one, which identifies the request.
+  if (response->Response().has_chunk()) {
+    if (chunked_response_ == nullptr) {
+      chunked_response_ = std::make_shared<GrpcInferResponse>();
+    }
+    if (!chunked_response_->AddChunk(response)) {
+      return;
+    }
+    response = std::move(chunked_response_);
+    chunked_response_.reset();
+  }
+
+  std::shared_ptr<Request> request_with_callback;
+  uintptr_t run_index = response->Response().meta_data().id();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto itr = ongoing_async_requests_.find(run_index);
+    if (itr == ongoing_async_requests_.end()) {
+      fprintf(
+          stderr,
+          "Unexpected error: received completed request that"
+          " is not in the list of asynchronous requests.\n");
+      return;
     }
 
-    std::shared_ptr<Request> request_with_callback;
-    uintptr_t run_index = response.meta_data().id();
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      auto itr = ongoing_async_requests_.find(run_index);
-      if (itr == ongoing_async_requests_.end()) {
-        fprintf(
-            stderr,
-            "Unexpected error: received completed request that"
-            " is not in the list of asynchronous requests.\n");
-        continue;
-      }
+    std::shared_ptr<GrpcRequestImpl> grpc_request =
+        std::static_pointer_cast<GrpcRequestImpl>(itr->second);
+    grpc_request->grpc_response_ = std::move(response);
+    grpc_request->Timer().Record(RequestTimers::Kind::REQUEST_END);
+    grpc_request->SetIsReady(true);
+    if (grpc_request->HasCallback()) {
+      request_with_callback = itr->second;
+    }
+  }
+  // send signal in case the main thread is waiting for response
+  cv_.notify_all();
+  if (request_with_callback != nullptr) {
+    GrpcRequestImpl* request =
+        static_cast<GrpcRequestImpl*>(request_with_callback.get());
+    request->callback_(this, std::move(request_with_callback));
+  }
+}
+
+void
+InferGrpcStreamContextImpl::AsyncTransfer()
+{
+  grpc::ByteBuffer response_buffer;
+  stream_->Read(&response_buffer, (void*)StreamOp::READ);
 
-      std::shared_ptr<GrpcRequestImpl> grpc_request =
-          std::static_pointer_cast<GrpcRequestImpl>(itr->second);
-      grpc_request->grpc_response_->Swap(&response);
-      grpc_request->Timer().Record(RequestTimers::Kind::REQUEST_END);
-      grpc_request->SetIsReady(true);
-      if (grpc_request->HasCallback()) {
-        request_with_callback = itr->second;
+  // End loop when the completion queue is shutdown after the stream
+  // has finished and all operations are drained.
+  void* tag;
+  bool ok;
+  while (stream_completion_queue_.Next(&tag, &ok)) {
+    switch ((StreamOp)(uintptr_t)tag) {
+      case StreamOp::START:
+        break;
+
+      case StreamOp::WRITE:
+      case StreamOp::WRITES_DONE: {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        write_pending_ = false;
+        write_ok_ = ok;
+        write_cv_.notify_all();
+        break;
       }
-    }
-    // send signal in case the main thread is waiting for response
-    cv_.notify_all();
-    if (request_with_callback != nullptr) {
-      GrpcRequestImpl* request =
-          static_cast<GrpcRequestImpl*>(request_with_callback.get());
-      request->callback_(this, std::move(request_with_callback));
+
+      case StreamOp::READ:
+        // Read fails once the stream ended and all responses are
+        // drained, or the stream broke.
+        if (ok) {
+          if (!exiting_) {
+            ProcessResponse(&response_buffer);
+          }
+          stream_->Read(&response_buffer, (void*)StreamOp::READ);
+        } else {
+          std::lock_guard<std::mutex> lock(write_mutex_);
+          stream_closed_ = true;
+          stream_->Finish(&stream_status_, (void*)StreamOp::FINISH);
+        }
+        break;
+
+      case StreamOp::FINISH:
+        stream_completion_queue_.Shutdown();
+        break;
     }
   }
-  stream_->Finish();
 }
 
 Error
 InferGrpcStreamContext::Create(
     std::unique_ptr<InferContext>* ctx, const std::string& server_url,
-    const std::string& model_name, int64_t model_version, bool verbose)
+    const std::string& model_name, int64_t model_version, bool verbose,
+    size_t chunk_byte_size)
 {
   return Create(
       ctx, 0 /* correlation_id */, server_url, model_name, model_version,
-      verbose);
+      verbose, chunk_byte_size);
 }
 
 Error
 InferGrpcStreamContext::Create(
     std::unique_ptr<InferContext>* ctx, CorrelationID correlation_id,
     const std::string& server_url, const std::string& model_name,
-    int64_t model_version, bool verbose)
+    int64_t model_version, bool verbose, size_t chunk_byte_size)
 {
   InferGrpcStreamContextImpl* ctx_ptr = new InferGrpcStreamContextImpl(
-      server_url, model_name, model_version, correlation_id, verbose);
+      server_url, model_name, model_version, correlation_id, verbose,
+      chunk_byte_size);
   ctx->reset(static_cast<InferContext*>(ctx_ptr));
 
   Error err = ctx_ptr->InitGrpc(server_url);
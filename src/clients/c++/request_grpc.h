@@ -78,6 +78,36 @@ class ServerStatusGrpcContext {
       const std::string& model_name, bool verbose = false);
 };
 
+//==============================================================================
+/// ServerLoadGrpcContext is the GRPC instantiation of
+/// ServerLoadContext.
+///
+class ServerLoadGrpcContext {
+ public:
+  /// Create a context that returns the load of all models on an
+  /// inference server using GRPC protocol.
+  /// \param ctx Returns a new ServerLoadGrpcContext object.
+  /// \param server_url The inference server name and port.
+  /// \param verbose If true generate verbose output when contacting
+  /// the inference server.
+  /// \return Error object indicating success or failure.
+  static Error Create(
+      std::unique_ptr<ServerLoadContext>* ctx, const std::string& server_url,
+      bool verbose = false);
+
+  /// Create a context that returns the load of one model on an
+  /// inference server using GRPC protocol.
+  /// \param ctx Returns a new ServerLoadGrpcContext object.
+  /// \param server_url The inference server name and port.
+  /// \param model_name The name of the model to get the load for.
+  /// \param verbose If true generate verbose output when contacting
+  /// the inference server.
+  /// \return Error object indicating success or failure.
+  static Error Create(
+      std::unique_ptr<ServerLoadContext>* ctx, const std::string& server_url,
+      const std::string& model_name, bool verbose = false);
+};
+
 //==============================================================================
 //// ProfileGrpcContext is the GRPC instantiation of ProfileContext.
 ////
@@ -156,11 +186,15 @@ class InferGrpcStreamContext {
   /// version should be used.
   /// \param verbose If true generate verbose output when contacting
   /// the inference server.
+  /// \param chunk_byte_size If non-zero, each request and response is
+  /// sent as a sequence of messages that each hold at most this many
+  /// bytes of tensor data. This allows tensors larger than the gRPC
+  /// message size limit and bounds the size of each message.
   /// \return Error object indicating success or failure.
   static Error Create(
       std::unique_ptr<InferContext>* ctx, const std::string& server_url,
       const std::string& model_name, int64_t model_version = -1,
-      bool verbose = false);
+      bool verbose = false, size_t chunk_byte_size = 0);
 
   /// Create streaming context that performs inference for a sequence model
   /// using a given correlation ID and the GRPC protocol.
@@ -176,11 +210,15 @@ class InferGrpcStreamContext {
   /// version should be used.
   /// \param verbose If true generate verbose output when contacting
   /// the inference server.
+  /// \param chunk_byte_size If non-zero, each request and response is
+  /// sent as a sequence of messages that each hold at most this many
+  /// bytes of tensor data.
   /// \return Error object indicating success or failure.
   static Error Create(
       std::unique_ptr<InferContext>* ctx, CorrelationID correlation_id,
       const std::string& server_url, const std::string& model_name,
-      int64_t model_version = -1, bool verbose = false);
+      int64_t model_version = -1, bool verbose = false,
+      size_t chunk_byte_size = 0);
 };
 
 }}}  // namespace nvidia::inferenceserver::client
@@ -435,6 +435,174 @@ ServerStatusHttpContext::Create(
 
 //==============================================================================
 
+class ServerLoadHttpContextImpl : public ServerLoadContext {
+ public:
+  ServerLoadHttpContextImpl(
+      const std::string& url, const std::string& model_name, bool verbose);
+
+  Error GetServerLoad(ServerLoadStatus* load) override;
+
+ private:
+  static size_t ResponseHeaderHandler(void*, size_t, size_t, void*);
+  static size_t ResponseHandler(void*, size_t, size_t, void*);
+
+  // URL for load endpoint on inference server.
+  const std::string url_;
+
+  // Enable verbose output
+  const bool verbose_;
+
+  // RequestStatus received in server response
+  RequestStatus request_status_;
+
+  // Serialized ServerLoadStatus response from server.
+  std::string response_;
+};
+
+ServerLoadHttpContextImpl::ServerLoadHttpContextImpl(
+    const std::string& url, const std::string& model_name, bool verbose)
+    : url_(
+          url + "/" + kLoadRESTEndpoint +
+          (model_name.empty() ? "" : "/" + model_name)),
+      verbose_(verbose)
+{
+}
+
+Error
+ServerLoadHttpContextImpl::GetServerLoad(ServerLoadStatus* load)
+{
+  load->Clear();
+  request_status_.Clear();
+  response_.clear();
+
+  if (!curl_global.Status().IsOk()) {
+    return curl_global.Status();
+  }
+
+  CURL* curl = curl_easy_init();
+  if (!curl) {
+    return Error(
+        RequestStatusCode::INTERNAL, "failed to initialize HTTP client");
+  }
+
+  // Request binary representation of the load.
+  std::string full_url = url_ + "?format=binary";
+  curl_easy_setopt(curl, CURLOPT_URL, full_url.c_str());
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+  if (verbose_) {
+    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+  }
+
+  // Response headers handled by ResponseHeaderHandler()
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, ResponseHeaderHandler);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, this);
+
+  // Response data handled by ResponseHandler()
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, ResponseHandler);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
+
+  CURLcode res = curl_easy_perform(curl);
+  if (res != CURLE_OK) {
+    curl_easy_cleanup(curl);
+    return Error(
+        RequestStatusCode::INTERNAL,
+        "HTTP client failed: " + std::string(curl_easy_strerror(res)));
+  }
+
+  // Must use long with curl_easy_getinfo
+  long http_code;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+  curl_easy_cleanup(curl);
+
+  // Should have a request status, if not then create an error status.
+  if (request_status_.code() == RequestStatusCode::INVALID) {
+    request_status_.Clear();
+    request_status_.set_code(RequestStatusCode::INTERNAL);
+    request_status_.set_msg("load request did not return status");
+  }
+
+  // If request has failing HTTP status or the request's explicit
+  // status is not SUCCESS, then signal an error.
+  if ((http_code != 200) ||
+      (request_status_.code() != RequestStatusCode::SUCCESS)) {
+    return Error(request_status_);
+  }
+
+  if (!load->ParseFromString(response_)) {
+    return Error(RequestStatusCode::INTERNAL, "failed to parse server load");
+  }
+
+  if (verbose_) {
+    std::cout << load->DebugString() << std::endl;
+  }
+
+  return Error(request_status_);
+}
+
+size_t
+ServerLoadHttpContextImpl::ResponseHeaderHandler(
+    void* contents, size_t size, size_t nmemb, void* userp)
+{
+  ServerLoadHttpContextImpl* ctx =
+      reinterpret_cast<ServerLoadHttpContextImpl*>(userp);
+
+  char* buf = reinterpret_cast<char*>(contents);
+  size_t byte_size = size * nmemb;
+
+  size_t idx = strlen(kStatusHTTPHeader);
+  if ((idx < byte_size) && !strncasecmp(buf, kStatusHTTPHeader, idx)) {
+    while ((idx < byte_size) && (buf[idx] != ':')) {
+      ++idx;
+    }
+
+    if (idx < byte_size) {
+      std::string hdr(buf + idx + 1, byte_size - idx - 1);
+
+      if (!google::protobuf::TextFormat::ParseFromString(
+              hdr, &ctx->request_status_)) {
+        ctx->request_status_.Clear();
+      }
+    }
+  }
+
+  return byte_size;
+}
+
+size_t
+ServerLoadHttpContextImpl::ResponseHandler(
+    void* contents, size_t size, size_t nmemb, void* userp)
+{
+  ServerLoadHttpContextImpl* ctx =
+      reinterpret_cast<ServerLoadHttpContextImpl*>(userp);
+  uint8_t* buf = reinterpret_cast<uint8_t*>(contents);
+  size_t result_bytes = size * nmemb;
+  std::copy(buf, buf + result_bytes, std::back_inserter(ctx->response_));
+  return result_bytes;
+}
+
+Error
+ServerLoadHttpContext::Create(
+    std::unique_ptr<ServerLoadContext>* ctx, const std::string& server_url,
+    bool verbose)
+{
+  ctx->reset(static_cast<ServerLoadContext*>(
+      new ServerLoadHttpContextImpl(server_url, "", verbose)));
+  return Error::Success;
+}
+
+Error
+ServerLoadHttpContext::Create(
+    std::unique_ptr<ServerLoadContext>* ctx, const std::string& server_url,
+    const std::string& model_name, bool verbose)
+{
+  ctx->reset(static_cast<ServerLoadContext*>(
+      new ServerLoadHttpContextImpl(server_url, model_name, verbose)));
+  return Error::Success;
+}
+
+//==============================================================================
+
 class ProfileHttpContextImpl : public ProfileContext {
  public:
   ProfileHttpContextImpl(
@@ -120,6 +120,36 @@ class ServerStatusHttpContext {
       const std::string& model_name, bool verbose = false);
 };
 
+//==============================================================================
+/// ServerLoadHttpContext is the HTTP instantiation of
+/// ServerLoadContext.
+///
+class ServerLoadHttpContext {
+ public:
+  /// Create a context that returns the load of all models on an
+  /// inference server using HTTP protocol.
+  /// \param ctx Returns a new ServerLoadHttpContext object.
+  /// \param server_url The inference server name and port.
+  /// \param verbose If true generate verbose output when contacting
+  /// the inference server.
+  /// \return Error object indicating success or failure.
+  static Error Create(
+      std::unique_ptr<ServerLoadContext>* ctx, const std::string& server_url,
+      bool verbose = false);
+
+  /// Create a context that returns the load of one model on an
+  /// inference server using HTTP protocol.
+  /// \param ctx Returns a new ServerLoadHttpContext object.
+  /// \param server_url The inference server name and port.
+  /// \param model_name The name of the model to get the load for.
+  /// \param verbose If true generate verbose output when contacting
+  /// the inference server.
+  /// \return Error object indicating success or failure.
+  static Error Create(
+      std::unique_ptr<ServerLoadContext>* ctx, const std::string& server_url,
+      const std::string& model_name, bool verbose = false);
+};
+
 //==============================================================================
 /// ProfileHttpContext is the HTTP instantiation of ProfileContext.
 ///
@@ -0,0 +1,1010 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#define DLL_EXPORTING
+
+#include "src/clients/c++/request_multi.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include "src/clients/c++/request_common.h"
+
+namespace nvidia { namespace inferenceserver { namespace client {
+
+namespace {
+
+// The backoff before a failed server is tried again. The backoff
+// doubles on each consecutive failure up to the maximum.
+constexpr uint64_t kInitialBackoffMs = 500;
+constexpr uint64_t kMaxBackoffMs = 30000;
+
+// Return true if 'err' indicates that the server could not handle
+// the request, as opposed to an error in the request itself.
+bool
+IsServerFailure(const Error& err)
+{
+  return (err.Code() == RequestStatusCode::UNAVAILABLE) ||
+         (err.Code() == RequestStatusCode::INTERNAL);
+}
+
+}  // namespace
+
+//==============================================================================
+
+// An input that forwards the tensor values set on it to the
+// corresponding input of each server context. The values are also
+// recorded so that they can be set on the input of a server context
+// that is created later.
+class MultiInputImpl : public InferContext::Input {
+ public:
+  MultiInputImpl(std::vector<std::shared_ptr<InferContext::Input>>&& inputs)
+      : inputs_(std::move(inputs)), has_shape_(false)
+  {
+  }
+
+  const std::string& Name() const override { return inputs_[0]->Name(); }
+  int64_t ByteSize() const override { return inputs_[0]->ByteSize(); }
+  size_t TotalByteSize() const override { return inputs_[0]->TotalByteSize(); }
+  DataType DType() const override { return inputs_[0]->DType(); }
+  ModelInput::Format Format() const override { return inputs_[0]->Format(); }
+  const DimsList& Dims() const override { return inputs_[0]->Dims(); }
+  const std::vector<int64_t>& Shape() const override
+  {
+    return inputs_[0]->Shape();
+  }
+
+  Error Reset() override;
+  Error SetShape(const std::vector<int64_t>& dims) override;
+  Error SetRaw(const uint8_t* input, size_t input_byte_size) override;
+  Error SetRaw(const std::vector<uint8_t>& input) override;
+  Error SetFromString(const std::vector<std::string>& input) override;
+
+  // Set the recorded values on 'input', which belongs to a newly
+  // created server context, and forward later values to it.
+  Error AddInput(const std::shared_ptr<InferContext::Input>& input);
+
+ private:
+  // A value set on the input since the last Reset(). Raw values are
+  // referenced, as by InferContext inputs, while string values are
+  // copied.
+  struct Value {
+    const uint8_t* raw_;
+    size_t raw_byte_size_;
+    std::vector<std::string> strs_;
+    bool is_string_;
+  };
+
+  std::vector<std::shared_ptr<InferContext::Input>> inputs_;
+  bool has_shape_;
+  std::vector<int64_t> shape_;
+  std::vector<Value> values_;
+};
+
+Error
+MultiInputImpl::Reset()
+{
+  values_.clear();
+  for (const auto& input : inputs_) {
+    Error err = input->Reset();
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  return Error::Success;
+}
+
+Error
+MultiInputImpl::SetShape(const std::vector<int64_t>& dims)
+{
+  has_shape_ = true;
+  shape_ = dims;
+  for (const auto& input : inputs_) {
+    Error err = input->SetShape(dims);
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  return Error::Success;
+}
+
+Error
+MultiInputImpl::SetRaw(const uint8_t* input, size_t input_byte_size)
+{
+  values_.push_back(Value{input, input_byte_size, {}, false});
+  for (const auto& io : inputs_) {
+    Error err = io->SetRaw(input, input_byte_size);
+    if (!err.IsOk()) {
+      values_.clear();
+      return err;
+    }
+  }
+
+  return Error::Success;
+}
+
+Error
+MultiInputImpl::SetRaw(const std::vector<uint8_t>& input)
+{
+  return SetRaw(&input[0], input.size());
+}
+
+Error
+MultiInputImpl::SetFromString(const std::vector<std::string>& input)
+{
+  values_.push_back(Value{nullptr, 0, input, true});
+  for (const auto& io : inputs_) {
+    Error err = io->SetFromString(input);
+    if (!err.IsOk()) {
+      values_.clear();
+      return err;
+    }
+  }
+
+  return Error::Success;
+}
+
+Error
+MultiInputImpl::AddInput(const std::shared_ptr<InferContext::Input>& input)
+{
+  Error err = input->Reset();
+  if (err.IsOk() && has_shape_) {
+    err = input->SetShape(shape_);
+  }
+  for (const auto& value : values_) {
+    if (!err.IsOk()) {
+      break;
+    }
+    err = value.is_string_ ? input->SetFromString(value.strs_)
+                           : input->SetRaw(value.raw_, value.raw_byte_size_);
+  }
+  if (err.IsOk()) {
+    inputs_.push_back(input);
+  }
+
+  return err;
+}
+
+//==============================================================================
+
+class InferMultiContextImpl : public InferContext {
+ public:
+  InferMultiContextImpl(
+      std::vector<InferMultiContext::CreateContextFn>&& create_fns,
+      std::vector<std::unique_ptr<InferContext>>&& server_ctxs,
+      std::vector<std::unique_ptr<ServerLoadContext>>&& load_ctxs,
+      InferMultiContext::Policy policy, uint64_t load_refresh_ms);
+
+  Error Init();
+
+  const std::string& ModelName() const override
+  {
+    return servers_[primary_idx_].ctx_->ModelName();
+  }
+  int64_t ModelVersion() const override
+  {
+    return servers_[primary_idx_].ctx_->ModelVersion();
+  }
+  uint64_t MaxBatchSize() const override
+  {
+    return servers_[primary_idx_].ctx_->MaxBatchSize();
+  }
+  CorrelationID CorrelationId() const override
+  {
+    return servers_[primary_idx_].ctx_->CorrelationId();
+  }
+  const std::vector<std::shared_ptr<Input>>& Inputs() const override
+  {
+    return inputs_;
+  }
+  const std::vector<std::shared_ptr<Output>>& Outputs() const override
+  {
+    return servers_[primary_idx_].ctx_->Outputs();
+  }
+
+  Error GetInput(
+      const std::string& name, std::shared_ptr<Input>* input) const override;
+  Error GetOutput(
+      const std::string& name, std::shared_ptr<Output>* output) const override;
+
+  Error SetRunOptions(const Options& options) override;
+  Error GetStat(Stat* stat) const override;
+
+  Error Run(ResultMap* results) override;
+  Error AsyncRun(std::shared_ptr<Request>* async_request) override;
+  Error AsyncRun(OnCompleteFn callback) override;
+  Error GetAsyncRunResults(
+      ResultMap* results, bool* is_ready,
+      const std::shared_ptr<Request>& async_request, bool wait) override;
+  Error GetReadyAsyncRequest(
+      std::shared_ptr<Request>* async_request, bool* is_ready,
+      bool wait) override;
+
+ private:
+  // A server that requests can be sent to.
+  struct Server {
+    Server(
+        InferMultiContext::CreateContextFn&& create_fn,
+        std::unique_ptr<InferContext>&& ctx,
+        std::unique_ptr<ServerLoadContext>&& load_ctx)
+        : create_fn_(std::move(create_fn)), ctx_(std::move(ctx)),
+          load_ctx_(std::move(load_ctx)), outstanding_cnt_(0),
+          queue_wait_us_(0), failure_cnt_(0)
+    {
+    }
+
+    // The function that creates the context for the server, and the
+    // context, which is null until it is created successfully.
+    InferMultiContext::CreateContextFn create_fn_;
+    std::unique_ptr<InferContext> ctx_;
+    std::unique_ptr<ServerLoadContext> load_ctx_;
+
+    // Number of requests from this context that have been sent to
+    // the server and have not completed.
+    size_t outstanding_cnt_;
+
+    // The most recent estimated queue wait for the model reported by
+    // the server.
+    uint64_t queue_wait_us_;
+
+    // Number of consecutive failed requests and the time before
+    // which the server should not be used because of those failures.
+    size_t failure_cnt_;
+    std::chrono::steady_clock::time_point retry_time_;
+  };
+
+  // An asynchronous request that has been sent to a server. For a
+  // request made with a callback the results are retrieved from the
+  // server when the request completes.
+  struct AsyncRequest {
+    size_t server_idx_;
+    bool completed_;
+    Error err_;
+    ResultMap results_;
+  };
+
+  // Return an error if 'ctx' is not for the same model as the
+  // primary server's context.
+  Error ValidateContext(const InferContext& ctx) const;
+
+  // Apply the run options set on this context to 'ctx'.
+  Error ApplyRunOptions(InferContext* ctx) const;
+
+  // Create the contexts for the servers that don't have one and are
+  // due to be tried again.
+  void ConnectServers();
+
+  // Select the server for the next request and count the request as
+  // outstanding on that server.
+  size_t SelectServer();
+
+  // Send an asynchronous request with a callback to server
+  // 'server_idx'. 'attempt' is the number of earlier attempts of
+  // the request.
+  Error DispatchAsyncRun(
+      size_t server_idx, const OnCompleteFn& callback, size_t attempt);
+
+  // Handle the completion of a request sent by DispatchAsyncRun(),
+  // retrying the request on another server if the server failed.
+  void AsyncRunComplete(
+      size_t server_idx, const OnCompleteFn& callback, size_t attempt,
+      const std::shared_ptr<Request>& request);
+
+  // Return true if a request that failed with 'err' after 'attempt'
+  // earlier attempts should be sent again.
+  bool ShouldRetry(const Error& err, size_t attempt) const;
+
+  // Return true if server 'a' is preferred over server 'b'. Must be
+  // called with 'mu_' held.
+  bool IsPreferred(size_t a, size_t b) const;
+
+  // Take server 'server_idx' out of rotation until after its
+  // backoff. Must be called with 'mu_' held.
+  void Backoff(size_t server_idx);
+
+  // Record the result of a request to server 'server_idx'. Must be
+  // called with 'mu_' held.
+  void RecordResult(size_t server_idx, const Error& err);
+
+  // Get the load from the servers if it has not been refreshed
+  // within the refresh interval.
+  void RefreshLoad();
+
+  std::vector<Server> servers_;
+  std::vector<std::shared_ptr<Input>> inputs_;
+  const InferMultiContext::Policy policy_;
+
+  // The server whose context provides the model information and
+  // outputs. Its context is created when this context is created.
+  size_t primary_idx_;
+
+  // The run options set on this context.
+  bool has_run_options_;
+  OptionsImpl run_options_;
+
+  // Mutex protecting the server bookkeeping, which is updated by the
+  // completion callbacks of asynchronous requests.
+  std::mutex mu_;
+  std::mt19937 rng_;
+  size_t next_server_idx_;
+
+  // For contexts with a correlation ID, the server that handles the
+  // sequence, or 'servers_.size()' if not yet selected.
+  size_t sequence_server_idx_;
+
+  // Asynchronous requests that have not been retrieved by
+  // GetAsyncRunResults().
+  std::unordered_map<Request*, AsyncRequest> async_requests_;
+
+  // Serializes getting the load from the servers.
+  std::mutex load_mu_;
+  const std::chrono::milliseconds load_refresh_interval_;
+  std::chrono::steady_clock::time_point next_load_refresh_;
+};
+
+InferMultiContextImpl::InferMultiContextImpl(
+    std::vector<InferMultiContext::CreateContextFn>&& create_fns,
+    std::vector<std::unique_ptr<InferContext>>&& server_ctxs,
+    std::vector<std::unique_ptr<ServerLoadContext>>&& load_ctxs,
+    InferMultiContext::Policy policy, uint64_t load_refresh_ms)
+    : policy_(policy), has_run_options_(false),
+      rng_(std::random_device()()), next_server_idx_(0),
+      load_refresh_interval_(load_refresh_ms)
+{
+  const size_t server_cnt = std::max(create_fns.size(), server_ctxs.size());
+  for (size_t i = 0; i < server_cnt; ++i) {
+    InferMultiContext::CreateContextFn create_fn;
+    if (i < create_fns.size()) {
+      create_fn = std::move(create_fns[i]);
+    }
+    std::unique_ptr<InferContext> ctx;
+    if (i < server_ctxs.size()) {
+      ctx = std::move(server_ctxs[i]);
+    }
+    std::unique_ptr<ServerLoadContext> load_ctx;
+    if (i < load_ctxs.size()) {
+      load_ctx = std::move(load_ctxs[i]);
+    }
+    servers_.emplace_back(
+        std::move(create_fn), std::move(ctx), std::move(load_ctx));
+  }
+
+  primary_idx_ = servers_.size();
+  sequence_server_idx_ = servers_.size();
+}
+
+Error
+InferMultiContextImpl::Init()
+{
+  // Servers that can't be reached are skipped and their contexts are
+  // created once they are due to be tried again.
+  Error last_err;
+  for (size_t idx = 0; idx < servers_.size(); ++idx) {
+    Server& server = servers_[idx];
+    if (server.ctx_ == nullptr) {
+      Error err = server.create_fn_(&server.ctx_);
+      if (!err.IsOk()) {
+        server.ctx_.reset();
+        Backoff(idx);
+        last_err = err;
+        continue;
+      }
+    }
+
+    if (primary_idx_ == servers_.size()) {
+      primary_idx_ = idx;
+    } else {
+      Error err = ValidateContext(*server.ctx_);
+      if (!err.IsOk()) {
+        return err;
+      }
+    }
+  }
+
+  if (primary_idx_ == servers_.size()) {
+    return last_err;
+  }
+
+  for (const auto& input : servers_[primary_idx_].ctx_->Inputs()) {
+    std::vector<std::shared_ptr<Input>> server_inputs;
+    for (const auto& server : servers_) {
+      if (server.ctx_ == nullptr) {
+        continue;
+      }
+
+      std::shared_ptr<Input> server_input;
+      Error err = server.ctx_->GetInput(input->Name(), &server_input);
+      if (!err.IsOk()) {
+        return err;
+      }
+      server_inputs.push_back(server_input);
+    }
+
+    inputs_.emplace_back(new MultiInputImpl(std::move(server_inputs)));
+  }
+
+  return Error::Success;
+}
+
+Error
+InferMultiContextImpl::ValidateContext(const InferContext& ctx) const
+{
+  if ((ctx.ModelName() != ModelName()) ||
+      (ctx.ModelVersion() != ModelVersion()) ||
+      (ctx.CorrelationId() != CorrelationId())) {
+    return Error(
+        RequestStatusCode::INVALID_ARG,
+        "all contexts must use the same model, version and correlation ID");
+  }
+  if (ctx.MaxBatchSize() != MaxBatchSize()) {
+    return Error(
+        RequestStatusCode::INVALID_ARG,
+        "model '" + ModelName() +
+            "' has different maximum batch size on different servers");
+  }
+
+  return Error::Success;
+}
+
+Error
+InferMultiContextImpl::ApplyRunOptions(InferContext* ctx) const
+{
+  // The outputs in the options may belong to any server context, so
+  // create options that refer to the outputs of 'ctx'.
+  std::unique_ptr<Options> options;
+  Error err = Options::Create(&options);
+  if (!err.IsOk()) {
+    return err;
+  }
+
+  options->SetFlags(run_options_.Flags());
+  options->SetBatchSize(run_options_.BatchSize());
+
+  for (const auto& p : run_options_.Outputs()) {
+    std::shared_ptr<Output> output;
+    err = ctx->GetOutput(p.first->Name(), &output);
+    if (err.IsOk()) {
+      if (p.second.result_format == Result::ResultFormat::RAW) {
+        err = options->AddRawResult(output);
+      } else {
+        err = options->AddClassResult(output, p.second.u64);
+      }
+    }
+    if (!err.IsOk()) {
+      return err;
+    }
+  }
+
+  return ctx->SetRunOptions(*options);
+}
+
+Error
+InferMultiContextImpl::GetInput(
+    const std::string& name, std::shared_ptr<Input>* input) const
+{
+  for (const auto& io : inputs_) {
+    if (io->Name() == name) {
+      *input = io;
+      return Error::Success;
+    }
+  }
+
+  return Error(
+      RequestStatusCode::INVALID_ARG,
+      "unknown input '" + name + "' for '" + ModelName() + "'");
+}
+
+Error
+InferMultiContextImpl::GetOutput(
+    const std::string& name, std::shared_ptr<Output>* output) const
+{
+  return servers_[primary_idx_].ctx_->GetOutput(name, output);
+}
+
+Error
+InferMultiContextImpl::SetRunOptions(const InferContext::Options& boptions)
+{
+  run_options_ = reinterpret_cast<const OptionsImpl&>(boptions);
+  has_run_options_ = true;
+
+  for (auto& server : servers_) {
+    if (server.ctx_ != nullptr) {
+      Error err = ApplyRunOptions(server.ctx_.get());
+      if (!err.IsOk()) {
+        return err;
+      }
+    }
+  }
+
+  return Error::Success;
+}
+
+Error
+InferMultiContextImpl::GetStat(Stat* stat) const
+{
+  *stat = Stat();
+  for (const auto& server : servers_) {
+    if (server.ctx_ == nullptr) {
+      continue;
+    }
+
+    Stat server_stat;
+    Error err = server.ctx_->GetStat(&server_stat);
+    if (!err.IsOk()) {
+      return err;
+    }
+
+    stat->completed_request_count += server_stat.completed_request_count;
+    stat->cumulative_total_request_time_ns +=
+        server_stat.cumulative_total_request_time_ns;
+    stat->cumulative_send_time_ns += server_stat.cumulative_send_time_ns;
+    stat->cumulative_receive_time_ns += server_stat.cumulative_receive_time_ns;
+  }
+
+  return Error::Success;
+}
+
+Error
+InferMultiContextImpl::Run(ResultMap* results)
+{
+  ConnectServers();
+
+  Error err;
+  for (size_t attempt = 0;; ++attempt) {
+    const size_t idx = SelectServer();
+    err = servers_[idx].ctx_->Run(results);
+
+    std::lock_guard<std::mutex> lk(mu_);
+    servers_[idx].outstanding_cnt_--;
+    RecordResult(idx, err);
+    if (!ShouldRetry(err, attempt)) {
+      break;
+    }
+  }
+
+  return err;
+}
+
+Error
+InferMultiContextImpl::AsyncRun(std::shared_ptr<Request>* async_request)
+{
+  ConnectServers();
+
+  const size_t idx = SelectServer();
+  Error err = servers_[idx].ctx_->AsyncRun(async_request);
+
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!err.IsOk()) {
+    servers_[idx].outstanding_cnt_--;
+    RecordResult(idx, err);
+  } else {
+    async_requests_[async_request->get()] =
+        AsyncRequest{idx, false, Error::Success, ResultMap()};
+  }
+
+  return err;
+}
+
+Error
+InferMultiContextImpl::AsyncRun(OnCompleteFn callback)
+{
+  ConnectServers();
+
+  return DispatchAsyncRun(SelectServer(), callback, 0);
+}
+
+Error
+InferMultiContextImpl::DispatchAsyncRun(
+    size_t server_idx, const OnCompleteFn& callback, size_t attempt)
+{
+  Error err = servers_[server_idx].ctx_->AsyncRun(
+      [this, server_idx, callback, attempt](
+          InferContext* ctx, const std::shared_ptr<Request>& request) {
+        AsyncRunComplete(server_idx, callback, attempt, request);
+      });
+
+  if (!err.IsOk()) {
+    std::lock_guard<std::mutex> lk(mu_);
+    servers_[server_idx].outstanding_cnt_--;
+    RecordResult(server_idx, err);
+  }
+
+  return err;
+}
+
+void
+InferMultiContextImpl::AsyncRunComplete(
+    size_t server_idx, const OnCompleteFn& callback, size_t attempt,
+    const std::shared_ptr<Request>& request)
+{
+  // Get the results now so that a request that failed because of
+  // the server can be sent to another server before the caller sees
+  // it.
+  ResultMap results;
+  bool is_ready = false;
+  Error err = servers_[server_idx].ctx_->GetAsyncRunResults(
+      &results, &is_ready, request, false);
+
+  bool retry;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    servers_[server_idx].outstanding_cnt_--;
+    RecordResult(server_idx, err);
+    retry = ShouldRetry(err, attempt);
+  }
+
+  if (retry &&
+      DispatchAsyncRun(SelectServer(), callback, attempt + 1).IsOk()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    async_requests_[request.get()] =
+        AsyncRequest{server_idx, true, err, std::move(results)};
+  }
+
+  callback(this, request);
+}
+
+Error
+InferMultiContextImpl::GetAsyncRunResults(
+    ResultMap* results, bool* is_ready,
+    const std::shared_ptr<Request>& async_request, bool wait)
+{
+  size_t idx;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    const auto itr = async_requests_.find(async_request.get());
+    if (itr == async_requests_.end()) {
+      return Error(
+          RequestStatusCode::INVALID_ARG,
+          "unknown request ID " + std::to_string(async_request->Id()));
+    }
+
+    // The results of a request made with a callback were retrieved
+    // when it completed.
+    if (itr->second.completed_) {
+      Error err = itr->second.err_;
+      results->swap(itr->second.results_);
+      async_requests_.erase(itr);
+      *is_ready = true;
+      return err;
+    }
+
+    idx = itr->second.server_idx_;
+  }
+
+  Error err = servers_[idx].ctx_->GetAsyncRunResults(
+      results, is_ready, async_request, wait);
+
+  if (!err.IsOk() || *is_ready) {
+    std::lock_guard<std::mutex> lk(mu_);
+    const auto itr = async_requests_.find(async_request.get());
+    if (itr != async_requests_.end()) {
+      servers_[idx].outstanding_cnt_--;
+      async_requests_.erase(itr);
+    }
+    RecordResult(idx, err);
+  }
+
+  return err;
+}
+
+Error
+InferMultiContextImpl::GetReadyAsyncRequest(
+    std::shared_ptr<Request>* async_request, bool* is_ready, bool wait)
+{
+  return Error(
+      RequestStatusCode::UNSUPPORTED,
+      "GetReadyAsyncRequest() is not supported by InferMultiContext");
+}
+
+void
+InferMultiContextImpl::ConnectServers()
+{
+  for (size_t idx = 0; idx < servers_.size(); ++idx) {
+    Server& server = servers_[idx];
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if ((server.ctx_ != nullptr) ||
+          (server.retry_time_ > std::chrono::steady_clock::now())) {
+        continue;
+      }
+    }
+
+    // The context is set up like the contexts of the other servers
+    // before any request can be sent to it.
+    std::unique_ptr<InferContext> ctx;
+    Error err = server.create_fn_(&ctx);
+    if (err.IsOk()) {
+      err = ValidateContext(*ctx);
+    }
+    if (err.IsOk() && has_run_options_) {
+      err = ApplyRunOptions(ctx.get());
+    }
+    for (const auto& input : inputs_) {
+      if (!err.IsOk()) {
+        break;
+      }
+
+      std::shared_ptr<Input> server_input;
+      err = ctx->GetInput(input->Name(), &server_input);
+      if (err.IsOk()) {
+        err = std::static_pointer_cast<MultiInputImpl>(input)->AddInput(
+            server_input);
+      }
+    }
+
+    std::lock_guard<std::mutex> lk(mu_);
+    if (err.IsOk()) {
+      server.ctx_ = std::move(ctx);
+    } else {
+      Backoff(idx);
+    }
+  }
+}
+
+size_t
+InferMultiContextImpl::SelectServer()
+{
+  RefreshLoad();
+
+  std::lock_guard<std::mutex> lk(mu_);
+
+  const auto now = std::chrono::steady_clock::now();
+
+  // Servers that are in rotation. If there are none then use the
+  // server that is next due to be tried again. Servers without a
+  // context are never used.
+  std::vector<size_t> candidates;
+  size_t earliest_idx = primary_idx_;
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    const size_t idx = (next_server_idx_ + i) % servers_.size();
+    if (servers_[idx].ctx_ == nullptr) {
+      continue;
+    }
+    if (servers_[idx].retry_time_ <= now) {
+      candidates.push_back(idx);
+    }
+    if (servers_[idx].retry_time_ < servers_[earliest_idx].retry_time_) {
+      earliest_idx = idx;
+    }
+  }
+
+  next_server_idx_ = (next_server_idx_ + 1) % servers_.size();
+
+  size_t selected = earliest_idx;
+  if ((sequence_server_idx_ < servers_.size()) &&
+      (servers_[sequence_server_idx_].retry_time_ <= now)) {
+    selected = sequence_server_idx_;
+  } else if (candidates.size() == 1) {
+    selected = candidates[0];
+  } else if (!candidates.empty()) {
+    if (policy_ == InferMultiContext::POWER_OF_TWO_CHOICES) {
+      std::uniform_int_distribution<size_t> dist(0, candidates.size() - 1);
+      const size_t a = dist(rng_);
+      size_t b = dist(rng_);
+      while (b == a) {
+        b = dist(rng_);
+      }
+      selected =
+          IsPreferred(candidates[b], candidates[a]) ? candidates[b]
+                                                    : candidates[a];
+    } else {
+      // Candidates are in round-robin order starting from
+      // 'next_server_idx_' so that ties are spread across servers.
+      selected = candidates[0];
+      for (const size_t idx : candidates) {
+        if (IsPreferred(idx, selected)) {
+          selected = idx;
+        }
+      }
+    }
+  }
+
+  if (CorrelationId() != 0) {
+    sequence_server_idx_ = selected;
+  }
+
+  servers_[selected].outstanding_cnt_++;
+  return selected;
+}
+
+bool
+InferMultiContextImpl::ShouldRetry(const Error& err, size_t attempt) const
+{
+  // Requests of a sequence are not retried since the sequence state
+  // is kept by the failed server.
+  return IsServerFailure(err) && (CorrelationId() == 0) &&
+         (attempt + 1 < servers_.size());
+}
+
+bool
+InferMultiContextImpl::IsPreferred(size_t a, size_t b) const
+{
+  const Server& sa = servers_[a];
+  const Server& sb = servers_[b];
+  if (sa.outstanding_cnt_ != sb.outstanding_cnt_) {
+    return sa.outstanding_cnt_ < sb.outstanding_cnt_;
+  }
+
+  return sa.queue_wait_us_ < sb.queue_wait_us_;
+}
+
+void
+InferMultiContextImpl::Backoff(size_t server_idx)
+{
+  Server& server = servers_[server_idx];
+  const uint64_t backoff_ms = std::min(
+      kMaxBackoffMs, kInitialBackoffMs
+                         << std::min(server.failure_cnt_, (size_t)16));
+  server.failure_cnt_++;
+  server.retry_time_ =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(backoff_ms);
+  server.queue_wait_us_ = 0;
+}
+
+void
+InferMultiContextImpl::RecordResult(size_t server_idx, const Error& err)
+{
+  if (IsServerFailure(err)) {
+    Backoff(server_idx);
+  } else {
+    servers_[server_idx].failure_cnt_ = 0;
+  }
+}
+
+void
+InferMultiContextImpl::RefreshLoad()
+{
+  if (servers_[0].load_ctx_ == nullptr) {
+    return;
+  }
+
+  // Only one caller refreshes the load, the others use the load
+  // from the previous refresh.
+  std::unique_lock<std::mutex> load_lk(load_mu_, std::try_to_lock);
+  if (!load_lk.owns_lock()) {
+    return;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  if (now < next_load_refresh_) {
+    return;
+  }
+  next_load_refresh_ = now + load_refresh_interval_;
+
+  for (size_t idx = 0; idx < servers_.size(); ++idx) {
+    Server& server = servers_[idx];
+    if (server.load_ctx_ == nullptr) {
+      continue;
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if ((server.ctx_ == nullptr) || (server.retry_time_ > now)) {
+        continue;
+      }
+    }
+
+    ServerLoadStatus load;
+    Error err = server.load_ctx_->GetServerLoad(&load);
+
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!err.IsOk()) {
+      // A server that is not reachable is taken out of rotation, but
+      // a server that does not report load is still used.
+      if (err.Code() == RequestStatusCode::INTERNAL) {
+        RecordResult(idx, err);
+      }
+      continue;
+    }
+
+    const auto itr = load.model_load().find(ModelName());
+    server.queue_wait_us_ = (itr == load.model_load().end())
+                                ? 0
+                                : itr->second.estimated_queue_wait_us();
+  }
+}
+
+namespace {
+
+Error
+CreateMultiContext(
+    std::unique_ptr<InferContext>* ctx,
+    std::vector<InferMultiContext::CreateContextFn>&& create_fns,
+    std::vector<std::unique_ptr<InferContext>>&& server_ctxs,
+    std::vector<std::unique_ptr<ServerLoadContext>>&& load_ctxs,
+    InferMultiContext::Policy policy, uint64_t load_refresh_ms)
+{
+  const size_t server_cnt = std::max(create_fns.size(), server_ctxs.size());
+  if (server_cnt == 0) {
+    return Error(
+        RequestStatusCode::INVALID_ARG,
+        "at least one server context must be provided");
+  }
+  if (!load_ctxs.empty() && (load_ctxs.size() != server_cnt)) {
+    return Error(
+        RequestStatusCode::INVALID_ARG,
+        "a load context must be provided for each server context");
+  }
+
+  InferMultiContextImpl* ctx_ptr = new InferMultiContextImpl(
+      std::move(create_fns), std::move(server_ctxs), std::move(load_ctxs),
+      policy, load_refresh_ms);
+  ctx->reset(static_cast<InferContext*>(ctx_ptr));
+
+  Error err = ctx_ptr->Init();
+  if (!err.IsOk()) {
+    ctx->reset();
+  }
+
+  return err;
+}
+
+}  // namespace
+
+Error
+InferMultiContext::Create(
+    std::unique_ptr<InferContext>* ctx,
+    std::vector<std::unique_ptr<InferContext>>&& server_ctxs, Policy policy)
+{
+  return Create(
+      ctx, std::move(server_ctxs),
+      std::vector<std::unique_ptr<ServerLoadContext>>(), policy, 0);
+}
+
+Error
+InferMultiContext::Create(
+    std::unique_ptr<InferContext>* ctx,
+    std::vector<std::unique_ptr<InferContext>>&& server_ctxs,
+    std::vector<std::unique_ptr<ServerLoadContext>>&& load_ctxs, Policy policy,
+    uint64_t load_refresh_ms)
+{
+  return CreateMultiContext(
+      ctx, std::vector<CreateContextFn>(), std::move(server_ctxs),
+      std::move(load_ctxs), policy, load_refresh_ms);
+}
+
+Error
+InferMultiContext::Create(
+    std::unique_ptr<InferContext>* ctx,
+    std::vector<CreateContextFn>&& create_fns,
+    std::vector<std::unique_ptr<ServerLoadContext>>&& load_ctxs, Policy policy,
+    uint64_t load_refresh_ms)
+{
+  return CreateMultiContext(
+      ctx, std::move(create_fns),
+      std::vector<std::unique_ptr<InferContext>>(), std::move(load_ctxs),
+      policy, load_refresh_ms);
+}
+
+}}}  // namespace nvidia::inferenceserver::client
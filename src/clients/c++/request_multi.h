@@ -0,0 +1,165 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+/// \file
+
+#include "src/clients/c++/request.h"
+
+namespace nvidia { namespace inferenceserver { namespace client {
+
+//==============================================================================
+/// InferMultiContext is an InferContext that spreads inference
+/// requests across several inference servers that serve the same
+/// model. The InferContext for each server is created by a function
+/// given by the caller, using any protocol, or the contexts are
+/// created by the caller and then handed to
+/// InferMultiContext::Create. Each Run() or AsyncRun() is sent to one
+/// of the servers selected using the Policy. For example:
+///
+/// \code
+///   std::vector<InferMultiContext::CreateContextFn> create_fns;
+///   for (const std::string url : {"host0:8000", "host1:8000"}) {
+///     create_fns.emplace_back([url](std::unique_ptr<InferContext>* c) {
+///       return InferHttpContext::Create(c, url, "mnist");
+///     });
+///   }
+///   std::unique_ptr<InferContext> ctx;
+///   InferMultiContext::Create(&ctx, std::move(create_fns), {});
+///   ...
+///   ctx->Run(&results);
+/// \endcode
+///
+/// When given creation functions, a server that can't be reached
+/// when the InferMultiContext is created is skipped and its context
+/// is created, on the next Run() or AsyncRun(), once the server is
+/// due to be tried again as described below. Creating the
+/// InferMultiContext fails only if no server can be reached.
+///
+/// The inputs returned by the InferMultiContext forward the tensor
+/// values set on them to the corresponding input of every server's
+/// context, so input data is set once regardless of the number of
+/// servers. The outputs are those of the context of the first server
+/// that could be reached.
+///
+/// A server whose request fails with an UNAVAILABLE or INTERNAL
+/// error, which includes connection failures, is taken out of
+/// rotation. It is tried again after a backoff that doubles on each
+/// consecutive failure, and returns to normal rotation after a
+/// request to it succeeds. If all servers are out of rotation the
+/// server that is next due to be tried is used. A request made by
+/// Run() or by AsyncRun() with a callback that fails this way is sent
+/// to another server, at most once to each server, and uses the
+/// input values that are set when it is sent again.
+///
+/// If a ServerLoadContext is provided for each server the
+/// InferMultiContext periodically gets the load of the model from
+/// the servers and, among servers with the same number of
+/// outstanding requests, prefers the server with the lowest
+/// estimated queue wait.
+///
+/// For a context with a correlation ID all requests are sent to the
+/// same server, since the sequence state is kept by that server.
+/// Another server is only selected if that server fails.
+///
+/// \note
+///   GetReadyAsyncRequest() is not supported by InferMultiContext.
+///   The thread-safety of the other methods is the same as for
+///   InferContext.
+///
+class InferMultiContext {
+ public:
+  /// The policy used to select the server for each request.
+  enum Policy {
+    /// Send each request to the server with the fewest outstanding
+    /// requests from this context.
+    LEAST_OUTSTANDING = 0,
+
+    /// Send each request to the server with the fewer outstanding
+    /// requests from this context among two servers chosen at random.
+    POWER_OF_TWO_CHOICES = 1
+  };
+
+  /// Function that creates the InferContext for one server.
+  using CreateContextFn =
+      std::function<Error(std::unique_ptr<InferContext>* ctx)>;
+
+  /// Create context that spreads inference requests across servers.
+  ///
+  /// \param ctx Returns a new InferMultiContext object.
+  /// \param server_ctxs The context for each server. All contexts
+  /// must be for the same model and correlation ID. The
+  /// InferMultiContext takes ownership of the contexts.
+  /// \param policy The policy used to select a server for each request.
+  /// \return Error object indicating success or failure.
+  static Error Create(
+      std::unique_ptr<InferContext>* ctx,
+      std::vector<std::unique_ptr<InferContext>>&& server_ctxs,
+      Policy policy = LEAST_OUTSTANDING);
+
+  /// Create context that spreads inference requests across servers
+  /// using the load reported by the servers.
+  ///
+  /// \param ctx Returns a new InferMultiContext object.
+  /// \param server_ctxs The context for each server. All contexts
+  /// must be for the same model and correlation ID. The
+  /// InferMultiContext takes ownership of the contexts.
+  /// \param load_ctxs The context used to get the load of each
+  /// server, in the same order as 'server_ctxs'. The
+  /// InferMultiContext takes ownership of the contexts.
+  /// \param policy The policy used to select a server for each request.
+  /// \param load_refresh_ms The minimum interval, in milliseconds,
+  /// between getting the load from the servers.
+  /// \return Error object indicating success or failure.
+  static Error Create(
+      std::unique_ptr<InferContext>* ctx,
+      std::vector<std::unique_ptr<InferContext>>&& server_ctxs,
+      std::vector<std::unique_ptr<ServerLoadContext>>&& load_ctxs,
+      Policy policy = LEAST_OUTSTANDING, uint64_t load_refresh_ms = 100);
+
+  /// Create context that spreads inference requests across servers,
+  /// creating the context for each server when the server can be
+  /// reached.
+  ///
+  /// \param ctx Returns a new InferMultiContext object.
+  /// \param create_fns The function that creates the context for
+  /// each server. All contexts must be for the same model and
+  /// correlation ID. A function may be called again after it fails.
+  /// \param load_ctxs The context used to get the load of each
+  /// server, in the same order as 'create_fns', or empty to not use
+  /// the load. The InferMultiContext takes ownership of the contexts.
+  /// \param policy The policy used to select a server for each request.
+  /// \param load_refresh_ms The minimum interval, in milliseconds,
+  /// between getting the load from the servers.
+  /// \return Error object indicating success or failure.
+  static Error Create(
+      std::unique_ptr<InferContext>* ctx,
+      std::vector<CreateContextFn>&& create_fns,
+      std::vector<std::unique_ptr<ServerLoadContext>>&& load_ctxs,
+      Policy policy = LEAST_OUTSTANDING, uint64_t load_refresh_ms = 100);
+};
+
+}}}  // namespace nvidia::inferenceserver::client
@@ -183,10 +183,9 @@ AutoFill::Create(
 #ifdef TRTIS_ENABLE_ONNXRUNTIME
   // Check for ONNX model must be done before check for TensorRT plan
   // because TensorRT deserializeCudaEngine() function will cause program
-  // to exit when it tries to deserialize an ONNX model.
-  // However this is not bulletproof as ONNX Runtime does not support
-  // ONNX models with opset < 8, thus under AutoFillOnnx class, there
-  // is additional check on reason of loading failure.
+  // to exit when it tries to deserialize an ONNX model. AutoFillOnnx
+  // only parses the model protobuf so it recognizes ONNX models
+  // regardless of whether ONNX Runtime supports their opset.
   //
   // [TODO] remove additional checking once TensorRT provides
   // an elegent way to handle passing incorrect model format (i.e. ONNX model)
@@ -26,6 +26,7 @@
 
 #include "src/core/backend.h"
 
+#include <algorithm>
 #include <chrono>
 #include "src/core/constants.h"
 #include "src/core/dynamic_batch_scheduler.h"
@@ -33,6 +34,9 @@
 #include "src/core/logging.h"
 #include "src/core/metric_model_reporter.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/model_quantizer.h"
+#include "src/core/object_pool.h"
+#include "src/core/provider.h"
 #include "src/core/sequence_batch_scheduler.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -52,6 +56,20 @@ InferenceBackend::GetInput(
   return Status::Success;
 }
 
+Status
+InferenceBackend::GetInputIndex(const std::string& name, size_t* index) const
+{
+  const auto itr = input_index_map_.find(name);
+  if (itr == input_index_map_.end()) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "unexpected inference input '" + name + "' for model '" + Name() + "'");
+  }
+
+  *index = itr->second;
+  return Status::Success;
+}
+
 Status
 InferenceBackend::GetOutput(
     const std::string& name, const ModelOutput** output) const
@@ -85,8 +103,10 @@ InferenceBackend::SetModelConfig(
       Name(), version_, config_.metric_tags());
 
   // Initialize the input map
-  for (const auto& io : config.input()) {
+  for (int idx = 0; idx < config.input_size(); ++idx) {
+    const ModelInput& io = config.input(idx);
     input_map_.insert(std::make_pair(io.name(), io));
+    input_index_map_.insert(std::make_pair(io.name(), (size_t)idx));
   }
 
   // Initialize the output map and label provider for each output
@@ -123,16 +143,60 @@ InferenceBackend::SetConfiguredScheduler(
 {
   std::unique_ptr<Scheduler> scheduler;
 
+  // Wrap 'OnRun' to track the number of requests being executed and
+  // the recent execution time, which together with the number of
+  // in-flight requests give the load of the model.
+  std::shared_ptr<LoadStats> load_stats = load_stats_;
+  auto OnRunWithLoad = [load_stats, OnRun](
+                           uint32_t runner_idx,
+                           std::vector<Scheduler::Payload>* payloads,
+                           std::function<void(Status)> OnRunComplete) {
+    // Payloads without a request provider, and the padding payloads
+    // that the sequence batcher fills with a NULLInferRequestProvider,
+    // are not real requests and so are not counted as executing.
+    uint64_t request_cnt = 0;
+    for (const auto& payload : *payloads) {
+      const auto& provider = payload.request_provider_;
+      if ((provider != nullptr) &&
+          (dynamic_cast<NULLInferRequestProvider*>(provider.get()) ==
+           nullptr)) {
+        request_cnt++;
+      }
+    }
+
+    load_stats->executing_cnt_ += request_cnt;
+    const auto start = std::chrono::steady_clock::now();
+
+    OnRun(
+        runner_idx, payloads,
+        MakePooledCallback(
+            [load_stats, request_cnt, start, OnRunComplete](Status status) {
+              const uint64_t duration_ns =
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+              const uint64_t prev_ns = load_stats->execution_ns_;
+              load_stats->execution_ns_ =
+                  (prev_ns == 0) ? duration_ns
+                                 : (prev_ns * 7 + duration_ns) / 8;
+              load_stats->executing_cnt_ -= request_cnt;
+
+              OnRunComplete(status);
+            }));
+  };
+
   // If 'sequence_batching' is configured use the SequenceBatchScheduler,
   // otherwise use the default DynamicBatchScheduler.
   if (config_.has_sequence_batching()) {
     RETURN_IF_ERROR(SequenceBatchScheduler::Create(
-        config_, runner_cnt, OnInit, OnRun, &scheduler));
+        config_, runner_cnt, OnInit, OnRunWithLoad, &scheduler));
   } else {
     RETURN_IF_ERROR(DynamicBatchScheduler::Create(
-        config_, runner_cnt, OnInit, OnRun, &scheduler));
+        config_, runner_cnt, OnInit, OnRunWithLoad, &scheduler));
   }
 
+  runner_cnt_ = runner_cnt;
+
   return SetScheduler(std::move(scheduler));
 }
 
@@ -143,8 +207,88 @@ InferenceBackend::Run(
     std::shared_ptr<InferResponseProvider> response_provider,
     std::function<void(Status)> OnCompleteHandleInfer)
 {
+  std::shared_ptr<LoadStats> load_stats = load_stats_;
+  load_stats->inflight_cnt_++;
+
   scheduler_->Enqueue(
-      stats, request_provider, response_provider, OnCompleteHandleInfer);
+      stats, request_provider, response_provider,
+      MakePooledCallback([load_stats, OnCompleteHandleInfer](Status status) {
+        load_stats->inflight_cnt_--;
+        OnCompleteHandleInfer(status);
+      }));
+}
+
+void
+InferenceBackend::GetInstanceStatus(ModelVersionStatus* status)
+{
+  if (scheduler_ != nullptr) {
+    scheduler_->GetInstanceStatus(status);
+  }
+}
+
+void
+InferenceBackend::GetAccuracySettings(ModelVersionStatus* status) const
+{
+  const auto kind = config_.optimization().quantization().kind();
+  if (kind != ModelOptimizationPolicy::Quantization::QUANTIZATION_NONE) {
+    auto& settings = *status->mutable_accuracy_settings();
+    settings["quantization"] = QuantizationKindName(kind);
+
+    std::vector<std::pair<std::string, std::string>> quantization_settings;
+    if (GetQuantizationSettings(
+            kind, config_.platform(), &quantization_settings)
+            .IsOk()) {
+      for (const auto& setting : quantization_settings) {
+        settings["quantization." + setting.first] = setting.second;
+      }
+    }
+  }
+}
+
+Status
+InferenceBackend::ReconfigureScheduler(const ModelConfig& config)
+{
+  if (scheduler_ == nullptr) {
+    return Status(
+        RequestStatusCode::UNAVAILABLE,
+        "model '" + Name() + "' does not have a scheduler");
+  }
+
+  // Keep the configuration reported by Config() in sync with the
+  // scheduler. Only the scheduler settings are copied, the rest of
+  // the configuration is unchanged and may be read concurrently.
+  std::lock_guard<std::mutex> lock(reconfigure_mu_);
+  RETURN_IF_ERROR(scheduler_->Reconfigure(config));
+  CopySchedulerSettings(config, &config_);
+
+  return Status::Success;
+}
+
+void
+InferenceBackend::GetLoadStatus(ModelLoadStatus* status)
+{
+  const uint64_t inflight_cnt = load_stats_->inflight_cnt_;
+  const uint64_t executing_cnt = load_stats_->executing_cnt_;
+  const uint64_t queue_cnt =
+      (inflight_cnt > executing_cnt) ? inflight_cnt - executing_cnt : 0;
+
+  status->set_queue_count(queue_cnt);
+  status->set_inflight_count(inflight_cnt);
+
+  // A queued request must wait for the requests ahead of it to be
+  // executed. Each runner executes up to 'max_batch_size' requests
+  // at a time so estimate the wait as the number of executions
+  // needed to drain the queue times the recent execution time.
+  uint64_t wait_us = 0;
+  const uint64_t execution_ns = load_stats_->execution_ns_;
+  if ((queue_cnt > 0) && (runner_cnt_ > 0) && (execution_ns > 0)) {
+    const uint64_t capacity =
+        std::max(1, config_.max_batch_size()) * (uint64_t)runner_cnt_;
+    const uint64_t executions = (queue_cnt + capacity - 1) / capacity;
+    wait_us = (executions * execution_ns) / 1000;
+  }
+
+  status->set_estimated_queue_wait_us(wait_us);
 }
 
 }}  // namespace nvidia::inferenceserver
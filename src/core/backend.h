@@ -25,6 +25,8 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include "src/core/label_provider.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/scheduler.h"
@@ -41,7 +43,7 @@ class MetricModelReporter;
 //
 class InferenceBackend {
  public:
-  InferenceBackend() = default;
+  InferenceBackend() : load_stats_(new LoadStats()), runner_cnt_(0) {}
   virtual ~InferenceBackend() {}
 
   // Set reference to the inference server.
@@ -65,6 +67,9 @@ class InferenceBackend {
   // Get the model configuration for a named input.
   Status GetInput(const std::string& name, const ModelInput** input) const;
 
+  // Get the index in the model configuration of a named input.
+  Status GetInputIndex(const std::string& name, size_t* index) const;
+
   // Get the model configuration for a named output.
   Status GetOutput(const std::string& name, const ModelOutput** output) const;
 
@@ -83,6 +88,24 @@ class InferenceBackend {
       std::shared_ptr<InferResponseProvider> response_provider,
       std::function<void(Status)> OnCompleteHandleInfer);
 
+  // Add the current scheduling status of the model instances to
+  // 'status'.
+  void GetInstanceStatus(ModelVersionStatus* status);
+
+  // Add the settings applied to the model that can change its
+  // results to 'status'.
+  void GetAccuracySettings(ModelVersionStatus* status) const;
+
+  // Apply the scheduling settings of 'config' to the scheduler of the
+  // model without reloading the model, and to the configuration
+  // returned by Config(). \see Scheduler::Reconfigure().
+  Status ReconfigureScheduler(const ModelConfig& config);
+
+  // Set 'status' to the current load of the model. The estimated
+  // queue wait is only available for backends that use a scheduler
+  // set with SetConfiguredScheduler().
+  void GetLoadStatus(ModelLoadStatus* status);
+
  protected:
   // Set the configuration of the model being served.
   Status SetModelConfig(const std::string& path, const ModelConfig& config);
@@ -101,9 +124,29 @@ class InferenceBackend {
   Scheduler* BackendScheduler() { return scheduler_.get(); }
 
  private:
+  // Counters used to report the load of the model. They are shared
+  // with the completion callbacks of the in-flight requests.
+  struct LoadStats {
+    LoadStats() : inflight_cnt_(0), executing_cnt_(0), execution_ns_(0) {}
+
+    // The number of requests accepted by Run() that have not yet
+    // completed.
+    std::atomic<uint64_t> inflight_cnt_;
+
+    // The number of requests currently being executed by a runner.
+    std::atomic<uint64_t> executing_cnt_;
+
+    // Moving average of the duration of a runner execution.
+    std::atomic<uint64_t> execution_ns_;
+  };
+
   // Configuration of the model that this backend represents.
   ModelConfig config_;
 
+  // Serializes reconfiguration of the scheduler and the matching
+  // update of 'config_'.
+  std::mutex reconfigure_mu_;
+
   // Version of the model that this backend represents.
   int64_t version_;
 
@@ -116,9 +159,18 @@ class InferenceBackend {
   // The scheduler to use for this backend.
   std::unique_ptr<Scheduler> scheduler_;
 
+  // Load of the model and the number of runners executing requests
+  // for the model.
+  std::shared_ptr<LoadStats> load_stats_;
+  uint32_t runner_cnt_;
+
   // Map from input name to the model configuration for that input.
   std::unordered_map<std::string, ModelInput> input_map_;
 
+  // Map from input name to the index of that input in the model
+  // configuration.
+  std::unordered_map<std::string, size_t> input_index_map_;
+
   // Map from output name to the model configuration for that output.
   std::unordered_map<std::string, ModelOutput> output_map_;
 };
@@ -32,11 +32,13 @@ namespace nvidia { namespace inferenceserver {
 constexpr char kInferRequestHTTPHeader[] = "NV-InferRequest";
 constexpr char kInferResponseHTTPHeader[] = "NV-InferResponse";
 constexpr char kStatusHTTPHeader[] = "NV-Status";
+constexpr char kServerTimingHTTPHeader[] = "Server-Timing";
 
 constexpr char kInferRESTEndpoint[] = "api/infer";
 constexpr char kStatusRESTEndpoint[] = "api/status";
 constexpr char kProfileRESTEndpoint[] = "api/profile";
 constexpr char kHealthRESTEndpoint[] = "api/health";
+constexpr char kLoadRESTEndpoint[] = "api/load";
 
 #ifdef TRTIS_ENABLE_TENSORFLOW
 constexpr char kTensorFlowGraphDefPlatform[] = "tensorflow_graphdef";
@@ -73,6 +75,7 @@ constexpr char kCustomFilename[] = "libcustom.so";
 
 constexpr char kEnsemblePlatform[] = "ensemble";
 constexpr char kModelConfigPbTxt[] = "config.pbtxt";
+constexpr char kOptimizedModelDirectory[] = ".optimized";
 
 constexpr char kMetricsLabelModelName[] = "model";
 constexpr char kMetricsLabelModelVersion[] = "version";
@@ -80,6 +83,8 @@ constexpr char kMetricsLabelGpuUuid[] = "gpu_uuid";
 
 constexpr uint64_t NANOS_PER_SECOND = 1000000000;
 constexpr int MAX_GRPC_MESSAGE_SIZE = INT32_MAX;
+constexpr uint64_t DEFAULT_GRPC_CHUNK_SIZE = 1024 * 1024;
+constexpr uint64_t MAX_GRPC_CHUNK_SIZE = 1024 * 1024 * 1024;
 constexpr int SCHEDULER_DEFAULT_NICE = 5;
 constexpr uint64_t SEQUENCE_IDLE_DEFAULT_MICROSECONDS = 1000 * 1000;
 
@@ -0,0 +1,241 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/cpu_cgroup.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <mutex>
+#include <unordered_map>
+#include "src/core/filesystem.h"
+#include "src/core/logging.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+std::mutex cgroup_mu_;
+std::string cgroup_root_;
+
+// The number of joins of each model cgroup that are not yet
+// released, keyed by the cgroup path.
+std::unordered_map<std::string, size_t> cgroup_users_;
+
+std::string
+ModelCgroupPath(const ModelConfig& config)
+{
+  // Prefix the model name so it can't collide with the cgroup
+  // interface files.
+  return JoinPath({cgroup_root_, "model_" + config.name()});
+}
+
+bool
+UsesModelCpuCgroupLocked(const ModelConfig& config)
+{
+  return !cgroup_root_.empty() && config.has_optimization() &&
+         config.optimization().has_cpu();
+}
+
+Status
+WriteCgroupFile(const std::string& path, const std::string& value)
+{
+  int fd = open(path.c_str(), O_WRONLY);
+  if (fd < 0) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to open cgroup file '" + path + "': " + strerror(errno));
+  }
+
+  // The kernel reports invalid values as a failure of the write.
+  const ssize_t written = write(fd, value.c_str(), value.size());
+  const int write_errno = errno;
+  close(fd);
+
+  if (written != (ssize_t)value.size()) {
+    return Status(
+        RequestStatusCode::INTERNAL, "failed to write '" + value +
+                                         "' to cgroup file '" + path +
+                                         "': " + strerror(write_errno));
+  }
+
+  return Status::Success;
+}
+
+}  // namespace
+
+bool
+UsesModelCpuCgroup(const ModelConfig& config)
+{
+  std::lock_guard<std::mutex> lock(cgroup_mu_);
+  return UsesModelCpuCgroupLocked(config);
+}
+
+Status
+InitCpuCgroups(const std::string& root)
+{
+  std::lock_guard<std::mutex> lock(cgroup_mu_);
+
+  if (!root.empty()) {
+    bool exists;
+    RETURN_IF_ERROR(
+        FileExists(JoinPath({root, "cgroup.subtree_control"}), &exists));
+    if (!exists) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "CPU cgroup root '" + root + "' is not a cgroup v2 directory");
+    }
+
+    // Child cgroups can only control CPU if the root delegates it.
+    RETURN_IF_ERROR(
+        WriteCgroupFile(JoinPath({root, "cgroup.subtree_control"}), "+cpu"));
+  }
+
+  cgroup_root_ = root;
+  return Status::Success;
+}
+
+Status
+JoinModelCpuCgroup(const ModelConfig& config)
+{
+  std::lock_guard<std::mutex> lock(cgroup_mu_);
+
+  if (!UsesModelCpuCgroupLocked(config)) {
+    return Status::Success;
+  }
+
+  const auto& cpu = config.optimization().cpu();
+  const std::string path = ModelCgroupPath(config);
+  if ((mkdir(path.c_str(), S_IRWXU | S_IRGRP | S_IXGRP) != 0) &&
+      (errno != EEXIST)) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to create CPU cgroup '" + path + "': " + strerror(errno));
+  }
+
+  // The cgroup holds individual threads of the server process so it
+  // must be threaded. The type can't be changed back, so writing it
+  // again for an existing cgroup is harmless.
+  RETURN_IF_ERROR(WriteCgroupFile(JoinPath({path, "cgroup.type"}), "threaded"));
+
+  // Always write the settings so that changes to the model
+  // configuration take effect when a new version is loaded.
+  const uint64_t weight = (cpu.weight() == 0) ? 100 : cpu.weight();
+  RETURN_IF_ERROR(
+      WriteCgroupFile(JoinPath({path, "cpu.weight"}), std::to_string(weight)));
+
+  const uint64_t period = (cpu.max_period_microseconds() == 0)
+                              ? 100000
+                              : cpu.max_period_microseconds();
+  const std::string quota = (cpu.max_quota_microseconds() == 0)
+                                ? "max"
+                                : std::to_string(cpu.max_quota_microseconds());
+  RETURN_IF_ERROR(WriteCgroupFile(
+      JoinPath({path, "cpu.max"}), quota + " " + std::to_string(period)));
+
+  const pid_t tid = syscall(SYS_gettid);
+  RETURN_IF_ERROR(WriteCgroupFile(
+      JoinPath({path, "cgroup.threads"}), std::to_string(tid)));
+
+  cgroup_users_[path]++;
+
+  LOG_VERBOSE(1) << "thread " << tid << " joined CPU cgroup '" << path
+                 << "' (weight " << weight << ", max " << quota << " "
+                 << period << ")";
+
+  return Status::Success;
+}
+
+Status
+LeaveModelCpuCgroup(const ModelConfig& config)
+{
+  std::lock_guard<std::mutex> lock(cgroup_mu_);
+
+  if (!UsesModelCpuCgroupLocked(config)) {
+    return Status::Success;
+  }
+
+  const pid_t tid = syscall(SYS_gettid);
+  RETURN_IF_ERROR(WriteCgroupFile(
+      JoinPath({cgroup_root_, "cgroup.threads"}), std::to_string(tid)));
+
+  LOG_VERBOSE(1) << "thread " << tid << " left CPU cgroup '"
+                 << ModelCgroupPath(config) << "'";
+
+  return Status::Success;
+}
+
+Status
+LeaveCpuCgroups()
+{
+  std::lock_guard<std::mutex> lock(cgroup_mu_);
+
+  if (cgroup_root_.empty()) {
+    return Status::Success;
+  }
+
+  const pid_t tid = syscall(SYS_gettid);
+  return WriteCgroupFile(
+      JoinPath({cgroup_root_, "cgroup.threads"}), std::to_string(tid));
+}
+
+void
+ReleaseModelCpuCgroup(const ModelConfig& config)
+{
+  std::lock_guard<std::mutex> lock(cgroup_mu_);
+
+  if (!UsesModelCpuCgroupLocked(config)) {
+    return;
+  }
+
+  const std::string path = ModelCgroupPath(config);
+  auto itr = cgroup_users_.find(path);
+  if (itr == cgroup_users_.end()) {
+    return;
+  }
+
+  if (--itr->second > 0) {
+    return;
+  }
+
+  cgroup_users_.erase(itr);
+
+  // A cgroup can only be removed once all of its threads have
+  // exited. If a thread remains the cgroup is left in place and is
+  // used again if the model is loaded again.
+  if (rmdir(path.c_str()) != 0) {
+    LOG_WARNING << "failed to remove CPU cgroup '" << path
+                << "': " << strerror(errno);
+  } else {
+    LOG_VERBOSE(1) << "removed CPU cgroup '" << path << "'";
+  }
+}
+
+}}  // namespace nvidia::inferenceserver
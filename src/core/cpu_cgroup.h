@@ -0,0 +1,82 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <string>
+#include "src/core/model_config.pb.h"
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+/// Set the cgroup v2 directory under which a CPU cgroup is created
+/// for each model that specifies CPU optimization settings. The
+/// directory must be the cgroup containing the server process and
+/// must be delegated to the user running the server.
+/// \param root The cgroup directory. Empty disables CPU cgroups.
+/// \return Error status if the directory is not a cgroup v2 directory.
+Status InitCpuCgroups(const std::string& root);
+
+/// Return true if a model is placed in its own CPU cgroup, that is
+/// if a cgroup root is set and the model configuration specifies CPU
+/// settings. Threads that are shared by all models must not be
+/// created by a thread in such a cgroup, so backends use this to
+/// decide whether a model needs its own framework threads.
+/// \param config The model configuration.
+/// \return True if the model has its own CPU cgroup.
+bool UsesModelCpuCgroup(const ModelConfig& config);
+
+/// Move the calling thread into the CPU cgroup of a model, creating
+/// the cgroup and applying the model's CPU settings as needed. All
+/// threads subsequently created by the calling thread inherit the
+/// cgroup. Each successful join must be paired with a call to
+/// ReleaseModelCpuCgroup() once the threads created for the model
+/// have exited. Does nothing if UsesModelCpuCgroup() is false.
+/// \param config The model configuration.
+/// \return Error status
+Status JoinModelCpuCgroup(const ModelConfig& config);
+
+/// Move the calling thread from the CPU cgroup of a model back to
+/// the cgroup root, so that threads it creates later are not limited
+/// by the model's settings. Does nothing if UsesModelCpuCgroup() is
+/// false.
+/// \param config The model configuration.
+/// \return Error status
+Status LeaveModelCpuCgroup(const ModelConfig& config);
+
+/// Move the calling thread to the cgroup root, out of any model CPU
+/// cgroup. Threads that are shared by all models call this when they
+/// may have been created by a thread in a model's cgroup. Does
+/// nothing if CPU cgroups are disabled.
+/// \return Error status
+Status LeaveCpuCgroups();
+
+/// Release a join of the CPU cgroup of a model. The cgroup is
+/// removed when the last join is released. Does nothing if
+/// UsesModelCpuCgroup() is false.
+/// \param config The model configuration.
+void ReleaseModelCpuCgroup(const ModelConfig& config);
+
+}}  // namespace nvidia::inferenceserver
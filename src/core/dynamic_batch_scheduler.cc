@@ -26,6 +26,8 @@
 
 #include "src/core/dynamic_batch_scheduler.h"
 
+#include <algorithm>
+#include <functional>
 #include <sys/resource.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
@@ -34,16 +36,48 @@
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
+#include "src/core/object_pool.h"
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+uint64_t
+MixHash(uint64_t x)
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+uint64_t
+InputShapesHash(const InferRequestDescriptor& request)
+{
+  uint64_t hash = 0;
+  for (const auto& input : request.inputs_) {
+    const int64_t* dims = input.Dims();
+    for (size_t i = 0; i < input.DimsCount(); ++i) {
+      hash = MixHash(hash ^ (uint64_t)dims[i]);
+    }
+    hash = MixHash(hash ^ input.DimsCount());
+  }
+
+  return hash;
+}
+
+}  // namespace
+
 DynamicBatchScheduler::DynamicBatchScheduler(
     const ModelConfig& config, const uint32_t runner_cnt,
     StandardInitFunc OnInit, StandardRunFunc OnSchedule)
     : OnInit_(OnInit), OnSchedule_(OnSchedule),
       scheduler_thread_cnt_(runner_cnt), idle_scheduler_thread_cnt_(0),
+      idle_scheduler_threads_(runner_cnt, false), runner_cvs_(runner_cnt),
       pending_batch_size_(0), pending_batch_queue_cnt_(0)
 {
   dynamic_batching_enabled_ = config.has_dynamic_batching();
@@ -60,9 +94,16 @@ DynamicBatchScheduler::DynamicBatchScheduler(
     }
   }
 
+  SetDynamicBatchingSettings(config);
+}
+
+void
+DynamicBatchScheduler::SetDynamicBatchingSettings(const ModelConfig& config)
+{
   max_preferred_batch_size_ = 0;
   preferred_batch_sizes_.clear();
   pending_batch_delay_ns_ = 0;
+  shape_affinity_cnt_ = 0;
 
   if (dynamic_batching_enabled_) {
     for (const auto size : config.dynamic_batching().preferred_batch_size()) {
@@ -73,6 +114,7 @@ DynamicBatchScheduler::DynamicBatchScheduler(
 
     pending_batch_delay_ns_ =
         config.dynamic_batching().max_queue_delay_microseconds() * 1000;
+    shape_affinity_cnt_ = config.dynamic_batching().shape_affinity_count();
   }
 }
 
@@ -119,7 +161,7 @@ DynamicBatchScheduler::~DynamicBatchScheduler()
   {
     std::unique_lock<std::mutex> lock(mu_);
     scheduler_threads_exit_.store(true);
-    cv_.notify_all();
+    WakeAllRunners();
   }
 
   for (auto& thd : scheduler_threads_) {
@@ -140,6 +182,7 @@ DynamicBatchScheduler::Enqueue(
   stats->StartQueueTimer(queue_timer.get());
 
   bool wake_runner = false;
+  uint32_t runner_id = 0;
   {
     std::lock_guard<std::mutex> lock(mu_);
     queue_.emplace_back(
@@ -148,14 +191,39 @@ DynamicBatchScheduler::Enqueue(
     // If there are any idle runners then wake one up to service this
     // request. We do the actual wake outside of the lock to avoid
     // having the woken thread immediately block on the lock
-    wake_runner = (idle_scheduler_thread_cnt_ > 0);
+    wake_runner = SelectIdleRunner(&runner_id);
   }
 
   if (wake_runner) {
-    cv_.notify_one();
+    runner_cvs_[runner_id].notify_one();
   }
 }
 
+Status
+DynamicBatchScheduler::Reconfigure(const ModelConfig& config)
+{
+  if (config.has_dynamic_batching() != dynamic_batching_enabled_) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "dynamic batching can't be enabled or disabled without reloading "
+        "model '" +
+            config.name() + "'");
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    SetDynamicBatchingSettings(config);
+  }
+
+  // Wake all the idle scheduler threads so that the pending batch is
+  // reevaluated with the new settings. For example, the pending batch
+  // may now be a preferred size or may have exceeded a shorter queue
+  // delay.
+  WakeAllRunners();
+
+  return Status::Success;
+}
+
 void
 DynamicBatchScheduler::SchedulerThread(
     const uint32_t runner_id, const int nice,
@@ -198,6 +266,7 @@ DynamicBatchScheduler::SchedulerThread(
   while (!scheduler_threads_exit_.load()) {
     std::shared_ptr<std::vector<Scheduler::Payload>> payloads;
     bool wake_thread = false;
+    uint32_t wake_runner_id = 0;
     uint64_t wait_microseconds = 0;
 
     // Hold the lock for as short a time as possible.
@@ -215,8 +284,16 @@ DynamicBatchScheduler::SchedulerThread(
       } else if (dynamic_batching_enabled_) {
         // Use dynamic batching to get request payload(s) to execute.
         wait_microseconds = GetDynamicBatch();
-        if (wait_microseconds == 0) {
-          payloads = std::make_shared<std::vector<Scheduler::Payload>>();
+        if ((wait_microseconds == 0) &&
+            DeferToAffineRunner(runner_id, &wake_runner_id)) {
+          // Leave the pending batch for the preferred runner and wake
+          // only that runner. This thread stays idle until there is
+          // other work.
+          wake_thread = true;
+          wait_microseconds = default_wait_microseconds;
+        } else if (wait_microseconds == 0) {
+          payloads = std::allocate_shared<std::vector<Scheduler::Payload>>(
+              PoolAllocator<std::vector<Scheduler::Payload>>());
           for (size_t idx = 0; idx < pending_batch_queue_cnt_; ++idx) {
             payloads->emplace_back(std::move(queue_.front()));
             queue_.pop_front();
@@ -224,7 +301,7 @@ DynamicBatchScheduler::SchedulerThread(
 
           pending_batch_size_ = 0;
           pending_batch_queue_cnt_ = 0;
-          pending_batch_shapes_.clear();
+          pending_batch_shapes_.inputs_.clear();
 
           // If there are still requests in the queue after removing
           // the pending batch and if there are any idle threads then
@@ -235,31 +312,45 @@ DynamicBatchScheduler::SchedulerThread(
           // handling those requests. We do the actual wake outside of
           // the lock to avoid having the woken thread immediately
           // block on the lock.
-          wake_thread = !queue_.empty() && (idle_scheduler_thread_cnt_ > 0);
+          wake_thread = !queue_.empty() && SelectIdleRunner(&wake_runner_id);
         }
       } else {
         // No batching... execute next request payload
-        payloads = std::make_shared<std::vector<Scheduler::Payload>>();
+        payloads = std::allocate_shared<std::vector<Scheduler::Payload>>(
+            PoolAllocator<std::vector<Scheduler::Payload>>());
         payloads->emplace_back(std::move(queue_.front()));
         queue_.pop_front();
       }
 
       // If no requests are to be handled, wait for notification or
-      // for the specified timeout before checking the queue again.
+      // for the specified timeout before checking the queue again. A
+      // thread woken by SelectIdleRunner() or DeferToAffineRunner()
+      // was already marked as no longer idle.
       if (wait_microseconds > 0) {
         idle_scheduler_thread_cnt_++;
+        idle_scheduler_threads_[runner_id] = true;
         std::chrono::microseconds wait_timeout(wait_microseconds);
-        cv_.wait_for(lock, wait_timeout);
-        idle_scheduler_thread_cnt_--;
+        runner_cvs_[runner_id].wait_for(lock, wait_timeout);
+        if (idle_scheduler_threads_[runner_id]) {
+          ClaimIdleRunner(runner_id);
+        }
       }
     }
 
     if (wake_thread) {
-      cv_.notify_one();
+      runner_cvs_[wake_runner_id].notify_one();
     }
 
     if ((payloads != nullptr) && !payloads->empty()) {
       auto OnCompleteQueuedPayloads = [payloads](Status status) {
+        size_t execution_batch_size = 0;
+        for (const auto& payload : *payloads) {
+          if (payload.request_provider_ != nullptr) {
+            execution_batch_size +=
+                payload.request_provider_->Descriptor().batch_size_;
+          }
+        }
+
         bool found_success = false;
         for (auto& payload : *payloads) {
           Status final_status = status.IsOk() ? payload.status_ : status;
@@ -270,6 +361,7 @@ DynamicBatchScheduler::SchedulerThread(
           if (!found_success && final_status.IsOk() &&
               (payload.stats_ != nullptr)) {
             payload.stats_->SetModelExecutionCount(1);
+            payload.stats_->SetModelExecutionBatchSize(execution_batch_size);
             found_success = true;
           }
 
@@ -279,7 +371,9 @@ DynamicBatchScheduler::SchedulerThread(
         }
       };
 
-      OnSchedule_(runner_id, payloads.get(), OnCompleteQueuedPayloads);
+      OnSchedule_(
+          runner_id, payloads.get(),
+          MakePooledCallback(std::move(OnCompleteQueuedPayloads)));
     }
   }  // end runner loop
 
@@ -288,35 +382,18 @@ DynamicBatchScheduler::SchedulerThread(
 }
 
 void
-DynamicBatchScheduler::InitPendingShape(const InferRequestHeader& request)
+DynamicBatchScheduler::InitPendingShape(const InferRequestDescriptor& request)
 {
-  pending_batch_shapes_.clear();
-
-  for (const auto& input : request.input()) {
-    pending_batch_shapes_.emplace(std::make_pair(input.name(), input.dims()));
-  }
+  pending_batch_shapes_ = request;
 }
 
 bool
 DynamicBatchScheduler::CompareWithPendingShape(
-    const InferRequestHeader& request) const
+    const InferRequestDescriptor& request) const
 {
-  for (const auto& input : request.input()) {
-    const auto itr = pending_batch_shapes_.find(input.name());
-
-    // It should never happen that we don't find the shape for an
-    // input, but if it does just return to be conservative.
-    if (itr == pending_batch_shapes_.end()) {
-      LOG_ERROR << "expected to find shape for input '" << input.name() << "'";
-      return false;
-    }
-
-    if (!CompareDims(itr->second, input.dims())) {
-      return false;
-    }
-  }
-
-  return true;
+  // The inputs of both descriptors are in model configuration order
+  // so the shapes can be compared positionally.
+  return pending_batch_shapes_.SameInputShapes(request);
 }
 
 uint64_t
@@ -337,14 +414,14 @@ DynamicBatchScheduler::GetDynamicBatch()
   size_t search_batch_cnt = pending_batch_queue_cnt_;
   for (auto idx = pending_batch_queue_cnt_; idx < queue_.size(); ++idx) {
     const auto batch_size =
-        queue_[idx].request_provider_->RequestHeader().batch_size();
+        queue_[idx].request_provider_->Descriptor().batch_size_;
 
     // If there is no pending batch, then this request is starting a
     // new batch.
     if (search_batch_cnt == 0) {
       // Get the shape of the new batch that is being started...
       if (need_pending_shape_) {
-        InitPendingShape(queue_[idx].request_provider_->RequestHeader());
+        InitPendingShape(queue_[idx].request_provider_->Descriptor());
       }
     } else {
       // There is a pending batch and adding this request would make
@@ -358,7 +435,7 @@ DynamicBatchScheduler::GetDynamicBatch()
       // this request, so send the pending batch as it is.
       if (need_pending_shape_ &&
           !CompareWithPendingShape(
-              queue_[idx].request_provider_->RequestHeader())) {
+              queue_[idx].request_provider_->Descriptor())) {
         send_now = true;
         break;
       }
@@ -423,4 +500,108 @@ DynamicBatchScheduler::GetDynamicBatch()
   return (pending_batch_delay_ns_ - delay_ns) / 1000;
 }
 
+bool
+DynamicBatchScheduler::ShapeAffinityEnabled() const
+{
+  return need_pending_shape_ && (shape_affinity_cnt_ > 0) &&
+         (shape_affinity_cnt_ < scheduler_thread_cnt_);
+}
+
+std::vector<uint32_t>
+DynamicBatchScheduler::AffineRunners(const uint64_t shape_hash) const
+{
+  // Rank the runners for the shape using rendezvous hashing. Each
+  // shape consistently prefers the same 'shape_affinity_cnt_'
+  // runners.
+  std::vector<std::pair<uint64_t, uint32_t>> ranks;
+  ranks.reserve(scheduler_thread_cnt_);
+  for (uint32_t id = 0; id < scheduler_thread_cnt_; ++id) {
+    ranks.emplace_back(MixHash(shape_hash ^ MixHash(id + 1)), id);
+  }
+
+  const auto preferred_end = ranks.begin() + shape_affinity_cnt_;
+  std::partial_sort(
+      ranks.begin(), preferred_end, ranks.end(),
+      std::greater<std::pair<uint64_t, uint32_t>>());
+
+  std::vector<uint32_t> runners;
+  for (auto itr = ranks.begin(); itr != preferred_end; ++itr) {
+    runners.push_back(itr->second);
+  }
+
+  return runners;
+}
+
+bool
+DynamicBatchScheduler::DeferToAffineRunner(
+    const uint32_t runner_id, uint32_t* affine_runner_id)
+{
+  if (!ShapeAffinityEnabled()) {
+    return false;
+  }
+
+  const std::vector<uint32_t> runners =
+      AffineRunners(InputShapesHash(pending_batch_shapes_));
+  if (std::find(runners.begin(), runners.end(), runner_id) != runners.end()) {
+    return false;
+  }
+
+  // This runner is not preferred for the shape. Defer if a preferred
+  // runner is idle, otherwise overflow the batch to this runner.
+  for (const uint32_t id : runners) {
+    if (idle_scheduler_threads_[id]) {
+      ClaimIdleRunner(id);
+      *affine_runner_id = id;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool
+DynamicBatchScheduler::SelectIdleRunner(uint32_t* runner_id)
+{
+  if (idle_scheduler_thread_cnt_ == 0) {
+    return false;
+  }
+
+  if (ShapeAffinityEnabled() && !queue_.empty()) {
+    const std::vector<uint32_t> runners = AffineRunners(
+        InputShapesHash(queue_.front().request_provider_->Descriptor()));
+    for (const uint32_t id : runners) {
+      if (idle_scheduler_threads_[id]) {
+        ClaimIdleRunner(id);
+        *runner_id = id;
+        return true;
+      }
+    }
+  }
+
+  for (uint32_t id = 0; id < scheduler_thread_cnt_; ++id) {
+    if (idle_scheduler_threads_[id]) {
+      ClaimIdleRunner(id);
+      *runner_id = id;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void
+DynamicBatchScheduler::ClaimIdleRunner(const uint32_t runner_id)
+{
+  idle_scheduler_threads_[runner_id] = false;
+  idle_scheduler_thread_cnt_--;
+}
+
+void
+DynamicBatchScheduler::WakeAllRunners()
+{
+  for (auto& cv : runner_cvs_) {
+    cv.notify_one();
+  }
+}
+
 }}  // namespace nvidia::inferenceserver
@@ -31,8 +31,10 @@
 #include <future>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include "src/core/api.pb.h"
 #include "src/core/model_config.pb.h"
+#include "src/core/provider.h"
 #include "src/core/scheduler.h"
 #include "src/core/status.h"
 
@@ -57,6 +59,9 @@ class DynamicBatchScheduler : public Scheduler {
       const std::shared_ptr<InferResponseProvider>& response_provider,
       std::function<void(Status)> OnComplete) override;
 
+  // \see Scheduler::Reconfigure()
+  Status Reconfigure(const ModelConfig& config) override;
+
  private:
   DynamicBatchScheduler(
       const ModelConfig& config, const uint32_t runner_cnt,
@@ -64,10 +69,43 @@ class DynamicBatchScheduler : public Scheduler {
   void SchedulerThread(
       const uint32_t runner_id, const int nice,
       std::promise<bool>* is_initialized);
-  void InitPendingShape(const InferRequestHeader& request);
-  bool CompareWithPendingShape(const InferRequestHeader& request) const;
+  void InitPendingShape(const InferRequestDescriptor& request);
+  bool CompareWithPendingShape(const InferRequestDescriptor& request) const;
   uint64_t GetDynamicBatch();
 
+  // Return true if shape affinity is in effect.
+  bool ShapeAffinityEnabled() const;
+
+  // Return the runners preferred by 'shape_hash', in order of
+  // preference.
+  std::vector<uint32_t> AffineRunners(const uint64_t shape_hash) const;
+
+  // Return true if runner 'runner_id' should leave the pending batch
+  // for an idle runner that the shape of the batch prefers, and
+  // return that runner in 'affine_runner_id'. The returned runner is
+  // marked as no longer idle. 'mu_' must be held when this function
+  // is called.
+  bool DeferToAffineRunner(
+      const uint32_t runner_id, uint32_t* affine_runner_id);
+
+  // Select an idle runner to service the request at the front of the
+  // queue, preferring a runner that the shape of the request prefers,
+  // and mark it as no longer idle. Return false if no runner is
+  // idle. 'mu_' must be held when this function is called.
+  bool SelectIdleRunner(uint32_t* runner_id);
+
+  // Mark 'runner_id' as no longer idle. 'mu_' must be held when this
+  // function is called.
+  void ClaimIdleRunner(const uint32_t runner_id);
+
+  // Wake all scheduler threads.
+  void WakeAllRunners();
+
+  // Set the dynamic batching settings from 'config'. 'mu_' must be
+  // held when this function is called after the scheduler threads
+  // are started.
+  void SetDynamicBatchingSettings(const ModelConfig& config);
+
   // Function the scheduler will call to initialize a runner.
   const StandardInitFunc OnInit_;
 
@@ -81,12 +119,18 @@ class DynamicBatchScheduler : public Scheduler {
   // The number of scheduler threads currently idle.
   uint32_t idle_scheduler_thread_cnt_;
 
+  // Whether each scheduler thread is currently idle, indexed by
+  // runner id. A thread that is selected to be woken is no longer
+  // idle so that each wake goes to a different thread.
+  std::vector<bool> idle_scheduler_threads_;
+
   // True if dynamic batching is enabled.
   bool dynamic_batching_enabled_;
 
-  // Mutex and condvar protecting the scheduling queue.
+  // Mutex protecting the scheduling queue, and a condvar for each
+  // scheduler thread so that a specific idle thread can be woken.
   std::mutex mu_;
-  std::condition_variable cv_;
+  std::vector<std::condition_variable> runner_cvs_;
 
   // Queue holding inference requests for the model represented by
   // this scheduler.
@@ -98,11 +142,12 @@ class DynamicBatchScheduler : public Scheduler {
   size_t max_preferred_batch_size_;
   std::set<int32_t> preferred_batch_sizes_;
   uint64_t pending_batch_delay_ns_;
+  uint32_t shape_affinity_cnt_;
   size_t pending_batch_size_;
   size_t pending_batch_queue_cnt_;
 
   bool need_pending_shape_;
-  std::unordered_map<std::string, DimsList> pending_batch_shapes_;
+  InferRequestDescriptor pending_batch_shapes_;
 };
 
 }}  // namespace nvidia::inferenceserver
@@ -184,17 +184,20 @@ EnsembleContext::EnsembleContext(
 
   if (ensemble_status_.IsOk()) {
     const auto& request_header = request_provider_->RequestHeader();
+    const InferRequestDescriptor& descriptor = request_provider_->Descriptor();
 
-    batch_size_ = request_header.batch_size();
-    correlation_id_ = request_header.correlation_id();
-    flags_ = request_header.flags();
+    batch_size_ = descriptor.batch_size_;
+    correlation_id_ = descriptor.correlation_id_;
+    flags_ = descriptor.flags_;
 
-    for (const auto& input : request_header.input()) {
+    for (size_t idx = 0; idx < descriptor.inputs_.size(); ++idx) {
+      const auto& input =
+          request_header.input(descriptor.inputs_[idx].request_index_);
       auto it = info_->ensemble_input_to_tensor_.find(input.name());
       if (it != info_->ensemble_input_to_tensor_.end()) {
         auto& tensor_data = tensor_data_[it->second];
         tensor_data.first = input;
-        request_provider_->GetSystemMemory(it->first, &(tensor_data.second));
+        request_provider_->GetSystemMemory(idx, &(tensor_data.second));
       } else {
         ensemble_status_ = Status(
             RequestStatusCode::INVALID_ARG,
@@ -371,7 +374,7 @@ EnsembleContext::GetNextSteps(
 Status
 EnsembleContext::InitStep(size_t step_idx, std::shared_ptr<Step>* step)
 {
-  std::unordered_map<std::string, std::shared_ptr<SystemMemory>> input_map;
+  InferRequestProvider::InputBufferMap input_map;
   InferRequestHeader request_header;
   auto& version_map = handles_[info_->steps_[step_idx].model_name_];
   auto& backend = version_map[info_->steps_[step_idx].model_version_];
@@ -393,9 +396,9 @@ EnsembleContext::InitStep(size_t step_idx, std::shared_ptr<Step>* step)
   step->reset(new Step(step_idx));
   (*step)->backend_ = backend;
   RETURN_IF_ERROR(InferRequestProvider::Create(
-      info_->steps_[step_idx].model_name_,
-      info_->steps_[step_idx].model_version_, request_header, input_map,
-      &((*step)->request_provider_)));
+      *backend, info_->steps_[step_idx].model_name_,
+      info_->steps_[step_idx].model_version_, std::move(request_header),
+      input_map, &((*step)->request_provider_)));
   // Request header is stored in response provider as reference, so use
   // header from request provider as the providers have same lifetime
   RETURN_IF_ERROR(InternalInferResponseProvider::Create(
@@ -30,12 +30,17 @@
 #ifdef TRTIS_ENABLE_GCS
 #include <google/cloud/storage/client.h>
 #endif  // TRTIS_ENABLE_GCS
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/text_format.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <atomic>
 #include <cerrno>
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
 #include "src/core/constants.h"
+#include "src/core/repository_archive.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -57,6 +62,15 @@ class FileSystem {
       const std::string& path, std::string* contents) = 0;
   virtual Status WriteTextFile(
       const std::string& path, const std::string& contents) = 0;
+
+  // By default the file is read into memory.
+  virtual Status ReadFileContents(
+      const std::string& path, FileContents* contents)
+  {
+    contents->mapped_ = nullptr;
+    contents->mapped_byte_size_ = 0;
+    return ReadTextFile(path, &contents->buffer_);
+  }
 };
 
 class LocalFileSystem : public FileSystem {
@@ -520,6 +534,211 @@ GCSFileSystem::WriteTextFile(
 
 #endif  // TRTIS_ENABLE_GCS
 
+//
+// A read-only file system for a mounted repository archive. Paths
+// are served from the archive index without touching the underlying
+// storage.
+//
+class ArchiveFileSystem : public FileSystem {
+ public:
+  ArchiveFileSystem(
+      const std::string& root, std::unique_ptr<RepositoryArchive>&& archive)
+      : root_(root), archive_(std::move(archive))
+  {
+  }
+
+  // Return true if 'path' is within this archive.
+  bool Contains(const std::string& path) const;
+
+  Status FileExists(const std::string& path, bool* exists) override;
+  Status IsDirectory(const std::string& path, bool* is_dir) override;
+  Status FileModificationTime(
+      const std::string& path, int64_t* mtime_ns) override;
+  Status GetDirectoryContents(
+      const std::string& path, std::set<std::string>* contents) override;
+  Status GetDirectorySubdirs(
+      const std::string& path, std::set<std::string>* subdirs) override;
+  Status GetDirectoryFiles(
+      const std::string& path, std::set<std::string>* files) override;
+  Status ReadTextFile(const std::string& path, std::string* contents) override;
+  Status WriteTextFile(
+      const std::string& path, const std::string& contents) override;
+  Status ReadFileContents(
+      const std::string& path, FileContents* contents) override;
+
+ private:
+  // Return the path relative to the root of the archive.
+  std::string RelativePath(const std::string& path) const;
+  Status FindEntry(
+      const std::string& path, const RepositoryArchive::Entry** entry);
+  Status FindContents(
+      const std::string& path, const std::set<std::string>** contents);
+
+  const std::string root_;
+  std::unique_ptr<RepositoryArchive> archive_;
+};
+
+bool
+ArchiveFileSystem::Contains(const std::string& path) const
+{
+  return (path == root_) ||
+         ((path.size() > root_.size()) && (path[root_.size()] == '/') &&
+          !path.compare(0, root_.size(), root_));
+}
+
+std::string
+ArchiveFileSystem::RelativePath(const std::string& path) const
+{
+  return (path.size() > root_.size()) ? path.substr(root_.size() + 1)
+                                      : std::string();
+}
+
+Status
+ArchiveFileSystem::FindEntry(
+    const std::string& path, const RepositoryArchive::Entry** entry)
+{
+  *entry = archive_->Find(RelativePath(path));
+  if (*entry == nullptr) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to find " + path + " in repository archive");
+  }
+
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::FindContents(
+    const std::string& path, const std::set<std::string>** contents)
+{
+  *contents = archive_->Contents(RelativePath(path));
+  if (*contents == nullptr) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to open directory " + path + " in repository archive");
+  }
+
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::FileExists(const std::string& path, bool* exists)
+{
+  *exists = (archive_->Find(RelativePath(path)) != nullptr);
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::IsDirectory(const std::string& path, bool* is_dir)
+{
+  const RepositoryArchive::Entry* entry;
+  RETURN_IF_ERROR(FindEntry(path, &entry));
+  *is_dir = entry->is_dir_;
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::FileModificationTime(
+    const std::string& path, int64_t* mtime_ns)
+{
+  const RepositoryArchive::Entry* entry;
+  RETURN_IF_ERROR(FindEntry(path, &entry));
+  *mtime_ns = entry->mtime_ns_;
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::GetDirectoryContents(
+    const std::string& path, std::set<std::string>* contents)
+{
+  const std::set<std::string>* names;
+  RETURN_IF_ERROR(FindContents(path, &names));
+  contents->insert(names->begin(), names->end());
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::GetDirectorySubdirs(
+    const std::string& path, std::set<std::string>* subdirs)
+{
+  const std::set<std::string>* names;
+  RETURN_IF_ERROR(FindContents(path, &names));
+
+  const std::string rel_path = RelativePath(path);
+  for (const auto& name : *names) {
+    const RepositoryArchive::Entry* entry = archive_->Find(
+        rel_path.empty() ? name : JoinPath({rel_path, name}));
+    if ((entry != nullptr) && entry->is_dir_) {
+      subdirs->insert(name);
+    }
+  }
+
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::GetDirectoryFiles(
+    const std::string& path, std::set<std::string>* files)
+{
+  const std::set<std::string>* names;
+  RETURN_IF_ERROR(FindContents(path, &names));
+
+  const std::string rel_path = RelativePath(path);
+  for (const auto& name : *names) {
+    const RepositoryArchive::Entry* entry = archive_->Find(
+        rel_path.empty() ? name : JoinPath({rel_path, name}));
+    if ((entry != nullptr) && !entry->is_dir_) {
+      files->insert(name);
+    }
+  }
+
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::ReadTextFile(const std::string& path, std::string* contents)
+{
+  FileContents file;
+  RETURN_IF_ERROR(ReadFileContents(path, &file));
+  contents->assign(file.Data(), file.ByteSize());
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::ReadFileContents(
+    const std::string& path, FileContents* contents)
+{
+  const RepositoryArchive::Entry* entry;
+  RETURN_IF_ERROR(FindEntry(path, &entry));
+  if (entry->is_dir_) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to open file for read " + path + ": is a directory");
+  }
+
+  contents->mapped_ = archive_->Data(*entry);
+  contents->mapped_byte_size_ = entry->byte_size_;
+  contents->buffer_.clear();
+  return Status::Success;
+}
+
+Status
+ArchiveFileSystem::WriteTextFile(
+    const std::string& path, const std::string& contents)
+{
+  return Status(
+      RequestStatusCode::INTERNAL,
+      "failed to write " + path + ": repository archive is read-only");
+}
+
+// Mounted repository archives, keyed by the path of the archive.
+// Mounting is rare so 'archive_mounted' lets the common case of no
+// archives skip the lock.
+std::atomic<bool> archive_mounted(false);
+std::mutex archive_mu;
+std::unordered_map<std::string, std::unique_ptr<ArchiveFileSystem>>
+    archive_fs;
+
 Status
 GetFileSystem(const std::string& path, FileSystem** file_system)
 {
@@ -538,6 +757,18 @@ GetFileSystem(const std::string& path, FileSystem** file_system)
     return Status::Success;
 #endif  // TRTIS_ENABLE_GCS
   }
+
+  // Check if the path is within a mounted repository archive.
+  if (archive_mounted) {
+    std::lock_guard<std::mutex> lock(archive_mu);
+    for (const auto& pr : archive_fs) {
+      if (pr.second->Contains(path)) {
+        *file_system = pr.second.get();
+        return Status::Success;
+      }
+    }
+  }
+
   // For now assume all paths are local...
   static LocalFileSystem local_fs;
   *file_system = &local_fs;
@@ -630,6 +861,37 @@ DirName(const std::string& path)
   return path.substr(0, idx);
 }
 
+Status
+IsRepositoryArchive(const std::string& path, bool* is_archive)
+{
+  *is_archive = false;
+
+  // Only local archives are supported.
+  if (!path.empty() && !path.rfind("gs://", 0)) {
+    return Status::Success;
+  }
+
+  return RepositoryArchive::IsArchive(path, is_archive);
+}
+
+Status
+MountRepositoryArchive(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(archive_mu);
+  if (archive_fs.find(path) != archive_fs.end()) {
+    return Status::Success;
+  }
+
+  std::unique_ptr<RepositoryArchive> archive;
+  RETURN_IF_ERROR(RepositoryArchive::Open(path, &archive));
+  archive_fs.emplace(
+      path, std::unique_ptr<ArchiveFileSystem>(
+                new ArchiveFileSystem(path, std::move(archive))));
+  archive_mounted = true;
+
+  return Status::Success;
+}
+
 Status
 FileExists(const std::string& path, bool* exists)
 {
@@ -687,15 +949,22 @@ ReadTextFile(const std::string& path, std::string* contents)
 }
 
 Status
-ReadTextProto(const std::string& path, google::protobuf::Message* msg)
+ReadFileContents(const std::string& path, FileContents* contents)
 {
   FileSystem* fs;
   RETURN_IF_ERROR(GetFileSystem(path, &fs));
+  return fs->ReadFileContents(path, contents);
+}
 
-  std::string contents;
-  RETURN_IF_ERROR(fs->ReadTextFile(path, &contents));
+Status
+ReadTextProto(const std::string& path, google::protobuf::Message* msg)
+{
+  FileContents contents;
+  RETURN_IF_ERROR(ReadFileContents(path, &contents));
 
-  if (!google::protobuf::TextFormat::ParseFromString(contents, msg)) {
+  google::protobuf::io::ArrayInputStream input(
+      contents.Data(), contents.ByteSize());
+  if (!google::protobuf::TextFormat::Parse(&input, msg)) {
     return Status(
         RequestStatusCode::INTERNAL, "failed to read text proto from " + path);
   }
@@ -721,11 +990,11 @@ WriteTextProto(const std::string& path, const google::protobuf::Message& msg)
 Status
 ReadBinaryProto(const std::string& path, google::protobuf::MessageLite* msg)
 {
-  std::string msg_str;
-  RETURN_IF_ERROR(ReadTextFile(path, &msg_str));
+  FileContents contents;
+  RETURN_IF_ERROR(ReadFileContents(path, &contents));
 
   google::protobuf::io::CodedInputStream coded_stream(
-      reinterpret_cast<const uint8_t*>(msg_str.c_str()), msg_str.size());
+      reinterpret_cast<const uint8_t*>(contents.Data()), contents.ByteSize());
   coded_stream.SetTotalBytesLimit(INT_MAX, INT_MAX);
   if (!msg->ParseFromCodedStream(&coded_stream)) {
     return Status(
@@ -51,6 +51,18 @@ std::string BaseName(const std::string& path);
 /// \return all but the last segment of the path.
 std::string DirName(const std::string& path);
 
+/// Is a path a packed model repository archive?
+/// \param path The path to check.
+/// \param is_archive Returns true if path is a repository archive.
+/// \return Error status
+Status IsRepositoryArchive(const std::string& path, bool* is_archive);
+
+/// Mount a packed model repository archive so that the archive path
+/// can be used as a read-only directory by the other functions.
+/// \param path The path of the archive.
+/// \return Error status
+Status MountRepositoryArchive(const std::string& path);
+
 /// Does a file or directory exist?
 /// \param path The path to check for existance.
 /// \param exists Returns true if file/dir exists
@@ -95,6 +107,32 @@ Status GetDirectoryFiles(const std::string& path, std::set<std::string>* files);
 /// \return Error status
 Status ReadTextFile(const std::string& path, std::string* contents);
 
+/// The contents of a file read by ReadFileContents(). The contents of
+/// a file in a mounted repository archive are not copied, they refer
+/// directly to the mapped archive which stays mapped for the life of
+/// the server. Other files are read into 'buffer_'.
+struct FileContents {
+  const char* Data() const
+  {
+    return (mapped_ != nullptr) ? mapped_ : buffer_.data();
+  }
+  size_t ByteSize() const
+  {
+    return (mapped_ != nullptr) ? mapped_byte_size_ : buffer_.size();
+  }
+
+  const char* mapped_ = nullptr;
+  size_t mapped_byte_size_ = 0;
+  std::string buffer_;
+};
+
+/// Read a file, without copying it when it is in a mounted repository
+/// archive.
+/// \param path The path of the file.
+/// \param contents Returns the contents of the file.
+/// \return Error status
+Status ReadFileContents(const std::string& path, FileContents* contents);
+
 /// Write a string to a file.
 /// \param path The path of the file.
 /// \param contents The contents to write to the file.
@@ -0,0 +1,225 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "google/protobuf/io/coded_stream.h"
+#include "grpc++/support/slice.h"
+
+namespace nvidia { namespace inferenceserver {
+
+//
+// Helpers for walking the protobuf encoding of InferRequest and
+// InferResponse messages received as a list of gRPC slices. Used by
+// both the server and the client so that the tensor data can be
+// referenced in place instead of being copied by the protobuf parser.
+//
+
+// Protobuf wire types.
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeFixed64 = 1;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+constexpr uint32_t kWireTypeFixed32 = 5;
+
+// Append the varint encoding of 'value' to 'dst'.
+inline void
+AppendVarint(uint64_t value, std::string* dst)
+{
+  uint8_t buf[10];
+  uint8_t* end =
+      google::protobuf::io::CodedOutputStream::WriteVarint64ToArray(value, buf);
+  dst->append(reinterpret_cast<char*>(buf), end - buf);
+}
+
+// A contiguous range of bytes within one slice.
+struct SliceBlock {
+  size_t slice_idx;
+  size_t offset;
+  size_t byte_size;
+};
+
+//
+// Sequential reader of the bytes in a list of slices. All read
+// functions return false if the slices end before the requested
+// value is complete.
+//
+class SliceReader {
+ public:
+  explicit SliceReader(const std::vector<grpc::Slice>& slices)
+      : slices_(slices), idx_(0), offset_(0)
+  {
+    SkipEmpty();
+  }
+
+  bool Done() const { return idx_ >= slices_.size(); }
+
+  // Read a varint. Return false if the varint is truncated or longer
+  // than 10 bytes.
+  bool ReadVarint(uint64_t* value)
+  {
+    *value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+      if (Done()) {
+        return false;
+      }
+
+      const uint8_t b = slices_[idx_].begin()[offset_];
+      Advance(1);
+      *value |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if ((b & 0x80) == 0) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Copy the next 'byte_size' bytes to the end of 'dst'.
+  bool ReadString(size_t byte_size, std::string* dst)
+  {
+    std::vector<SliceBlock> blocks;
+    if (!ReadBlocks(byte_size, &blocks)) {
+      return false;
+    }
+
+    for (const auto& block : blocks) {
+      dst->append(
+          reinterpret_cast<const char*>(slices_[block.slice_idx].begin()) +
+              block.offset,
+          block.byte_size);
+    }
+
+    return true;
+  }
+
+  // Return the next 'byte_size' bytes as blocks of the slices, in
+  // order, appended to 'blocks'.
+  bool ReadBlocks(size_t byte_size, std::vector<SliceBlock>* blocks)
+  {
+    while (byte_size > 0) {
+      if (Done()) {
+        return false;
+      }
+
+      const size_t cnt = std::min(byte_size, slices_[idx_].size() - offset_);
+      blocks->push_back(SliceBlock{idx_, offset_, cnt});
+      Advance(cnt);
+      byte_size -= cnt;
+    }
+
+    return true;
+  }
+
+ private:
+  void Advance(size_t cnt)
+  {
+    offset_ += cnt;
+    if (offset_ >= slices_[idx_].size()) {
+      idx_++;
+      offset_ = 0;
+      SkipEmpty();
+    }
+  }
+
+  void SkipEmpty()
+  {
+    while ((idx_ < slices_.size()) && (slices_[idx_].size() == 0)) {
+      idx_++;
+    }
+  }
+
+  const std::vector<grpc::Slice>& slices_;
+  size_t idx_;
+  size_t offset_;
+};
+
+// Walk the fields of the message encoded in 'slices'. The value of
+// each length-delimited field numbered 'raw_field_number' is returned
+// in 'raw_fields' as the blocks of the slices that hold it. All other
+// fields are appended, still encoded, to 'fields' so that they can be
+// parsed as a regular protobuf message. Return false if the encoding
+// is malformed or truncated.
+inline bool
+SplitRawFields(
+    const std::vector<grpc::Slice>& slices, uint32_t raw_field_number,
+    std::string* fields, std::vector<std::vector<SliceBlock>>* raw_fields)
+{
+  SliceReader reader(slices);
+  while (!reader.Done()) {
+    uint64_t tag, value;
+    if (!reader.ReadVarint(&tag)) {
+      return false;
+    }
+
+    const uint32_t wire_type = tag & 0x7;
+    const uint64_t field_number = tag >> 3;
+
+    if ((field_number == raw_field_number) &&
+        (wire_type == kWireTypeLengthDelimited)) {
+      raw_fields->emplace_back();
+      if (!reader.ReadVarint(&value) ||
+          !reader.ReadBlocks(value, &raw_fields->back())) {
+        return false;
+      }
+      continue;
+    }
+
+    AppendVarint(tag, fields);
+
+    bool ok;
+    switch (wire_type) {
+      case kWireTypeVarint:
+        ok = reader.ReadVarint(&value);
+        AppendVarint(value, fields);
+        break;
+      case kWireTypeFixed64:
+        ok = reader.ReadString(8, fields);
+        break;
+      case kWireTypeLengthDelimited:
+        ok = reader.ReadVarint(&value);
+        AppendVarint(value, fields);
+        ok = ok && reader.ReadString(value, fields);
+        break;
+      case kWireTypeFixed32:
+        ok = reader.ReadString(4, fields);
+        break;
+      default:
+        ok = false;
+        break;
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}}  // namespace nvidia::inferenceserver
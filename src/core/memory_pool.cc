@@ -0,0 +1,203 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/memory_pool.h"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <cstdint>
+#include "src/core/logging.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// Smallest block handed out by the pool.
+constexpr size_t kMinBlockByteSize = 4096;
+
+// Blocks of at least this size are mapped directly so that they can
+// be backed by huge pages.
+constexpr size_t kHugePageByteSize = 2 * 1024 * 1024;
+
+// Alignment of blocks smaller than kHugePageByteSize.
+constexpr size_t kBlockAlignment = 64;
+
+}  // namespace
+
+HostMemoryPool::HostMemoryPool(size_t max_cached_byte_size, bool use_huge_pages)
+    : max_cached_byte_size_(max_cached_byte_size),
+      use_huge_pages_(use_huge_pages), cached_byte_size_(0)
+{
+}
+
+HostMemoryPool::~HostMemoryPool()
+{
+  for (auto& pr : free_blocks_) {
+    for (void* block : pr.second) {
+      ReleaseBlock(block, pr.first);
+    }
+  }
+
+  if (!allocated_blocks_.empty()) {
+    LOG_ERROR << "host memory pool destroyed with "
+              << allocated_blocks_.size() << " blocks still allocated";
+  }
+}
+
+size_t
+HostMemoryPool::BlockByteSize(size_t byte_size) const
+{
+  if (byte_size >= kHugePageByteSize) {
+    return ((byte_size + kHugePageByteSize - 1) / kHugePageByteSize) *
+           kHugePageByteSize;
+  }
+
+  size_t block_byte_size = kMinBlockByteSize;
+  while (block_byte_size < byte_size) {
+    block_byte_size <<= 1;
+  }
+
+  return block_byte_size;
+}
+
+void*
+HostMemoryPool::AllocateBlock(size_t block_byte_size) const
+{
+  if (block_byte_size < kHugePageByteSize) {
+    void* block = nullptr;
+    if (posix_memalign(&block, kBlockAlignment, block_byte_size) != 0) {
+      return nullptr;
+    }
+    return block;
+  }
+
+  // Over-allocate so that the block can be aligned to a huge page
+  // boundary, then unmap the unused head and tail.
+  const size_t map_byte_size = block_byte_size + kHugePageByteSize;
+  void* map = mmap(
+      nullptr, map_byte_size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) {
+    return nullptr;
+  }
+
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(map);
+  const uintptr_t aligned =
+      (addr + kHugePageByteSize - 1) & ~(uintptr_t)(kHugePageByteSize - 1);
+  const size_t head = aligned - addr;
+  const size_t tail = map_byte_size - head - block_byte_size;
+  if (head > 0) {
+    munmap(map, head);
+  }
+  if (tail > 0) {
+    munmap(reinterpret_cast<void*>(aligned + block_byte_size), tail);
+  }
+
+  void* block = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+  if (use_huge_pages_) {
+    // Only advisory, the block is still usable if huge pages are not
+    // available.
+    madvise(block, block_byte_size, MADV_HUGEPAGE);
+  }
+#endif  // MADV_HUGEPAGE
+
+  return block;
+}
+
+void
+HostMemoryPool::ReleaseBlock(void* block, size_t block_byte_size) const
+{
+  if (block_byte_size < kHugePageByteSize) {
+    free(block);
+  } else {
+    munmap(block, block_byte_size);
+  }
+}
+
+void*
+HostMemoryPool::Allocate(
+    const void* owner, size_t byte_size, size_t* block_byte_size)
+{
+  const size_t bs = BlockByteSize(byte_size);
+  void* block = nullptr;
+
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto itr = free_blocks_.find(bs);
+    if ((itr != free_blocks_.end()) && !itr->second.empty()) {
+      block = itr->second.back();
+      itr->second.pop_back();
+      cached_byte_size_ -= bs;
+      allocated_blocks_.emplace(block, AllocatedBlock{bs, owner});
+    }
+  }
+
+  if (block == nullptr) {
+    block = AllocateBlock(bs);
+    if (block == nullptr) {
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mu_);
+    allocated_blocks_.emplace(block, AllocatedBlock{bs, owner});
+  }
+
+  *block_byte_size = bs;
+  return block;
+}
+
+size_t
+HostMemoryPool::Free(const void* owner, void* block)
+{
+  size_t bs = 0;
+  bool cached = false;
+
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto itr = allocated_blocks_.find(block);
+    if ((itr == allocated_blocks_.end()) || (itr->second.owner_ != owner)) {
+      return 0;
+    }
+
+    bs = itr->second.byte_size_;
+    allocated_blocks_.erase(itr);
+
+    if ((cached_byte_size_ + bs) <= max_cached_byte_size_) {
+      free_blocks_[bs].push_back(block);
+      cached_byte_size_ += bs;
+      cached = true;
+    }
+  }
+
+  if (!cached) {
+    ReleaseBlock(block, bs);
+  }
+
+  return bs;
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,82 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver {
+
+//
+// A pool of host memory blocks that caches freed blocks so that they
+// can be reused by later allocations. Block sizes are rounded up to a
+// power of two, or to a multiple of the huge page size for large
+// blocks, so that freed blocks are likely to match later requests.
+//
+class HostMemoryPool {
+ public:
+  // Create a pool that keeps at most 'max_cached_byte_size' bytes of
+  // freed blocks for reuse. If 'use_huge_pages' is true then large
+  // blocks are advised to be backed by transparent huge pages.
+  HostMemoryPool(size_t max_cached_byte_size, bool use_huge_pages);
+  ~HostMemoryPool();
+
+  // Allocate a block of at least 'byte_size' bytes on behalf of
+  // 'owner'. Return nullptr if the memory cannot be allocated.
+  // 'block_byte_size' returns the actual size of the block.
+  void* Allocate(
+      const void* owner, size_t byte_size, size_t* block_byte_size);
+
+  // Return a block allocated by Allocate to the pool. Return the size
+  // of the block, or 0 if 'block' was not allocated by this pool on
+  // behalf of 'owner', in which case the block is not freed.
+  size_t Free(const void* owner, void* block);
+
+ private:
+  size_t BlockByteSize(size_t byte_size) const;
+  void* AllocateBlock(size_t block_byte_size) const;
+  void ReleaseBlock(void* block, size_t block_byte_size) const;
+
+  const size_t max_cached_byte_size_;
+  const bool use_huge_pages_;
+
+  std::mutex mu_;
+  size_t cached_byte_size_;
+
+  // Freed blocks available for reuse, keyed by block size.
+  std::unordered_map<size_t, std::vector<void*>> free_blocks_;
+
+  // The size and owner of each block that is currently allocated.
+  struct AllocatedBlock {
+    size_t byte_size_;
+    const void* owner_;
+  };
+  std::unordered_map<void*, AllocatedBlock> allocated_blocks_;
+};
+
+}}  // namespace nvidia::inferenceserver
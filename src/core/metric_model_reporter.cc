@@ -113,6 +113,14 @@ MetricModelReporter::MetricInferenceExecutionCount(int gpu_device) const
       gpu_device);
 }
 
+prometheus::Counter&
+MetricModelReporter::MetricInferencePaddingCount(int gpu_device) const
+{
+  return GetCounterMetric(
+      metric_inf_padding_count_, Metrics::FamilyInferencePaddingCount(),
+      gpu_device);
+}
+
 prometheus::Counter&
 MetricModelReporter::MetricInferenceRequestDuration(int gpu_device) const
 {
@@ -155,6 +163,42 @@ MetricModelReporter::MetricInferenceLoadRatio(int gpu_device) const
   return hist;
 }
 
+prometheus::Gauge&
+MetricModelReporter::MetricInferenceScratchMemory(int gpu_device) const
+{
+  const auto itr = metric_inf_scratch_memory_.find(gpu_device);
+  if (itr != metric_inf_scratch_memory_.end()) {
+    return *(itr->second);
+  }
+
+  std::map<std::string, std::string> labels;
+  GetMetricLabels(&labels, gpu_device);
+
+  prometheus::Gauge& gauge =
+      Metrics::FamilyInferenceScratchMemory().Add(labels);
+  metric_inf_scratch_memory_.insert(
+      std::map<int, prometheus::Gauge*>::value_type(gpu_device, &gauge));
+  return gauge;
+}
+
+prometheus::Gauge&
+MetricModelReporter::MetricInferenceRequestMemory(int gpu_device) const
+{
+  const auto itr = metric_inf_request_memory_.find(gpu_device);
+  if (itr != metric_inf_request_memory_.end()) {
+    return *(itr->second);
+  }
+
+  std::map<std::string, std::string> labels;
+  GetMetricLabels(&labels, gpu_device);
+
+  prometheus::Gauge& gauge =
+      Metrics::FamilyInferenceRequestMemory().Add(labels);
+  metric_inf_request_memory_.insert(
+      std::map<int, prometheus::Gauge*>::value_type(gpu_device, &gauge));
+  return gauge;
+}
+
 #endif  // TRTIS_ENABLE_METRICS
 
 }}  // namespace nvidia::inferenceserver
@@ -56,10 +56,13 @@ class MetricModelReporter {
   prometheus::Counter& MetricInferenceFailure(int gpu_device) const;
   prometheus::Counter& MetricInferenceCount(int gpu_device) const;
   prometheus::Counter& MetricInferenceExecutionCount(int gpu_device) const;
+  prometheus::Counter& MetricInferencePaddingCount(int gpu_device) const;
   prometheus::Counter& MetricInferenceRequestDuration(int gpu_device) const;
   prometheus::Counter& MetricInferenceComputeDuration(int gpu_device) const;
   prometheus::Counter& MetricInferenceQueueDuration(int gpu_device) const;
   prometheus::Histogram& MetricInferenceLoadRatio(int gpu_device) const;
+  prometheus::Gauge& MetricInferenceScratchMemory(int gpu_device) const;
+  prometheus::Gauge& MetricInferenceRequestMemory(int gpu_device) const;
 #endif  // TRTIS_ENABLE_METRICS
 
  private:
@@ -79,10 +82,13 @@ class MetricModelReporter {
   mutable std::map<int, prometheus::Counter*> metric_inf_failure_;
   mutable std::map<int, prometheus::Counter*> metric_inf_count_;
   mutable std::map<int, prometheus::Counter*> metric_inf_exec_count_;
+  mutable std::map<int, prometheus::Counter*> metric_inf_padding_count_;
   mutable std::map<int, prometheus::Counter*> metric_inf_request_duration_us_;
   mutable std::map<int, prometheus::Counter*> metric_inf_compute_duration_us_;
   mutable std::map<int, prometheus::Counter*> metric_inf_queue_duration_us_;
   mutable std::map<int, prometheus::Histogram*> metric_inf_load_ratio_;
+  mutable std::map<int, prometheus::Gauge*> metric_inf_scratch_memory_;
+  mutable std::map<int, prometheus::Gauge*> metric_inf_request_memory_;
 #endif  // TRTIS_ENABLE_METRICS
 };
 
@@ -61,6 +61,12 @@ Metrics::Metrics()
                                  .Name("nv_inference_exec_count")
                                  .Help("Number of model executions performed")
                                  .Register(*registry_)),
+      inf_count_padding_family_(
+          prometheus::BuildCounter()
+              .Name("nv_inference_padding_count")
+              .Help("Number of padding inferences performed for idle batch "
+                    "slots")
+              .Register(*registry_)),
       inf_request_duration_us_family_(
           prometheus::BuildCounter()
               .Name("nv_inference_request_duration_us")
@@ -79,6 +85,16 @@ Metrics::Metrics()
       inf_load_ratio_family_(prometheus::BuildHistogram()
                                  .Name("nv_inference_load_ratio")
                                  .Register(*registry_)),
+      inf_scratch_memory_family_(
+          prometheus::BuildGauge()
+              .Name("nv_inference_scratch_memory_bytes")
+              .Help("Scratch memory allocated through the server, in bytes")
+              .Register(*registry_)),
+      inf_request_memory_family_(
+          prometheus::BuildGauge()
+              .Name("nv_inference_request_memory_bytes")
+              .Help("Memory held by in-flight inference requests, in bytes")
+              .Register(*registry_)),
       gpu_utilization_family_(prometheus::BuildGauge()
                                   .Name("nv_gpu_utilization")
                                   .Help("GPU utilization rate [0.0 - 1.0)")
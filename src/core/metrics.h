@@ -78,6 +78,13 @@ class Metrics {
     return GetSingleton()->inf_count_exec_family_;
   }
 
+  // Metric family counting padding inferences performed, where a
+  // padding inference fills an otherwise idle batch slot
+  static prometheus::Family<prometheus::Counter>& FamilyInferencePaddingCount()
+  {
+    return GetSingleton()->inf_count_padding_family_;
+  }
+
   // Metric family of cumulative inference request duration, in
   // microseconds
   static prometheus::Family<prometheus::Counter>&
@@ -107,6 +114,20 @@ class Metrics {
     return GetSingleton()->inf_load_ratio_family_;
   }
 
+  // Metric family of scratch memory allocated by a model from the
+  // server, in bytes
+  static prometheus::Family<prometheus::Gauge>& FamilyInferenceScratchMemory()
+  {
+    return GetSingleton()->inf_scratch_memory_family_;
+  }
+
+  // Metric family of memory held by in-flight inference requests, in
+  // bytes
+  static prometheus::Family<prometheus::Gauge>& FamilyInferenceRequestMemory()
+  {
+    return GetSingleton()->inf_request_memory_family_;
+  }
+
  private:
   Metrics();
   virtual ~Metrics();
@@ -120,10 +141,13 @@ class Metrics {
   prometheus::Family<prometheus::Counter>& inf_failure_family_;
   prometheus::Family<prometheus::Counter>& inf_count_family_;
   prometheus::Family<prometheus::Counter>& inf_count_exec_family_;
+  prometheus::Family<prometheus::Counter>& inf_count_padding_family_;
   prometheus::Family<prometheus::Counter>& inf_request_duration_us_family_;
   prometheus::Family<prometheus::Counter>& inf_compute_duration_us_family_;
   prometheus::Family<prometheus::Counter>& inf_queue_duration_us_family_;
   prometheus::Family<prometheus::Histogram>& inf_load_ratio_family_;
+  prometheus::Family<prometheus::Gauge>& inf_scratch_memory_family_;
+  prometheus::Family<prometheus::Gauge>& inf_request_memory_family_;
   prometheus::Family<prometheus::Gauge>& gpu_utilization_family_;
   prometheus::Family<prometheus::Gauge>& gpu_memory_total_family_;
   prometheus::Family<prometheus::Gauge>& gpu_memory_used_family_;
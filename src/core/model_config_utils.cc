@@ -26,6 +26,8 @@
 
 #include "src/core/model_config_utils.h"
 
+#include <google/protobuf/util/message_differencer.h>
+#include <chrono>
 #include <deque>
 #include <set>
 #include "src/core/autofill.h"
@@ -195,12 +197,17 @@ GetNormalizedModelConfig(
   // Autofill if requested...
   if (autofill) {
     const std::string model_name(BaseName(path));
+    const auto start = std::chrono::steady_clock::now();
     std::unique_ptr<AutoFill> af;
     RETURN_IF_ERROR(AutoFill::Create(
         model_name, backend_config_map, std::string(path), *config, &af));
     RETURN_IF_ERROR(af->Fix(config));
 
-    LOG_VERBOSE(1) << "autofilled config: " << config->DebugString();
+    LOG_VERBOSE(1) << "autofilled config for '" << model_name << "' in "
+                   << std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count()
+                   << " ms: " << config->DebugString();
   }
 
   if (config->platform().empty()) {
@@ -420,6 +427,24 @@ ValidateModelConfig(
     }
   }
 
+  // Load-time quantization is only supported by some backends.
+  if (config.optimization().quantization().kind() !=
+      ModelOptimizationPolicy::Quantization::QUANTIZATION_NONE) {
+    bool supported = false;
+#ifdef TRTIS_ENABLE_ONNXRUNTIME
+    supported |= (config.platform() == kOnnxRuntimeOnnxPlatform);
+#endif  // TRTIS_ENABLE_ONNXRUNTIME
+#ifdef TRTIS_ENABLE_PYTORCH
+    supported |= (config.platform() == kPyTorchLibTorchPlatform);
+#endif  // TRTIS_ENABLE_PYTORCH
+    if (!supported) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "quantization is not supported for platform '" + config.platform() +
+              "' for " + config.name());
+    }
+  }
+
   // If sequence batching is specified make sure the control is
   // specified correctly.
   if (config.has_sequence_batching()) {
@@ -447,6 +472,32 @@ ValidateModelConfig(
         nullptr));
   }
 
+  // If CPU settings are specified make sure they are within the
+  // ranges accepted by the cgroup CPU controller.
+  if (config.has_optimization() && config.optimization().has_cpu()) {
+    const auto& cpu = config.optimization().cpu();
+    if (cpu.weight() > 10000) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "CPU weight must be in the range 1-10000 for " + config.name());
+    }
+    if ((cpu.max_quota_microseconds() != 0) &&
+        (cpu.max_quota_microseconds() < 1000)) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "CPU max quota must be >= 1000 microseconds for " + config.name());
+    }
+    if ((cpu.max_period_microseconds() != 0) &&
+        ((cpu.max_period_microseconds() < 1000) ||
+         (cpu.max_period_microseconds() > 1000000))) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "CPU max period must be in the range 1000-1000000 microseconds "
+          "for " +
+              config.name());
+    }
+  }
+
   // If ensemble scheduling is specified, validate it.
   // Otherwise, must validate platform and instance_group
   if (config.has_ensemble_scheduling()) {
@@ -521,6 +572,27 @@ ValidateModelConfig(
                                              " has unexpected kind KIND_AUTO");
       }
     }
+
+    // Shape affinity must leave at least one instance that a shape
+    // does not prefer, otherwise every instance is preferred by every
+    // shape.
+    if (config.has_dynamic_batching() &&
+        (config.dynamic_batching().shape_affinity_count() > 0)) {
+      uint32_t instance_cnt = 0;
+      for (const auto& group : config.instance_group()) {
+        instance_cnt +=
+            group.count() * ((group.kind() == ModelInstanceGroup::KIND_GPU)
+                                 ? group.gpus().size()
+                                 : 1);
+      }
+      if (config.dynamic_batching().shape_affinity_count() >= instance_cnt) {
+        return Status(
+            RequestStatusCode::INVALID_ARG,
+            "dynamic batching shape affinity count must be < the number of "
+            "model instances (" +
+                std::to_string(instance_cnt) + ") for " + config.name());
+      }
+    }
   }
 
   return Status::Success;
@@ -905,4 +977,48 @@ CheckAllowedModelOutput(
   return Status::Success;
 }
 
+bool
+IsSchedulerOnlyChange(
+    const ModelConfig& old_config, const ModelConfig& new_config)
+{
+  if (google::protobuf::util::MessageDifferencer::Equals(
+          old_config, new_config)) {
+    return false;
+  }
+
+  // Clear the scheduler settings from copies of both configurations,
+  // whatever remains must be the same.
+  ModelConfig old_stripped(old_config);
+  ModelConfig new_stripped(new_config);
+  for (ModelConfig* config : {&old_stripped, &new_stripped}) {
+    if (config->has_dynamic_batching()) {
+      config->mutable_dynamic_batching()->clear_preferred_batch_size();
+      config->mutable_dynamic_batching()->clear_max_queue_delay_microseconds();
+    }
+    if (config->has_sequence_batching()) {
+      config->mutable_sequence_batching()
+          ->clear_max_sequence_idle_microseconds();
+    }
+  }
+
+  return google::protobuf::util::MessageDifferencer::Equals(
+      old_stripped, new_stripped);
+}
+
+void
+CopySchedulerSettings(const ModelConfig& from, ModelConfig* to)
+{
+  if (from.has_dynamic_batching()) {
+    auto dynamic_batching = to->mutable_dynamic_batching();
+    dynamic_batching->mutable_preferred_batch_size()->CopyFrom(
+        from.dynamic_batching().preferred_batch_size());
+    dynamic_batching->set_max_queue_delay_microseconds(
+        from.dynamic_batching().max_queue_delay_microseconds());
+  }
+  if (from.has_sequence_batching()) {
+    to->mutable_sequence_batching()->set_max_sequence_idle_microseconds(
+        from.sequence_batching().max_sequence_idle_microseconds());
+  }
+}
+
 }}  // namespace nvidia::inferenceserver
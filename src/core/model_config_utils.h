@@ -131,4 +131,24 @@ Status ValidateModelOutput(const ModelOutput& io, int32_t max_batch_size);
 Status CheckAllowedModelOutput(
     const ModelOutput& io, const std::set<std::string>& allowed);
 
+/// Check if two configurations of a model differ only in scheduler
+/// settings that can be applied to a running scheduler, so that the
+/// change does not require the model to be reloaded. The settings
+/// are the dynamic batching max_queue_delay_microseconds and
+/// preferred_batch_size, and the sequence batching
+/// max_sequence_idle_microseconds.
+/// \param old_config The current model configuration.
+/// \param new_config The new model configuration.
+/// \return True if the configurations differ, and differ only in the
+/// scheduler settings.
+bool IsSchedulerOnlyChange(
+    const ModelConfig& old_config, const ModelConfig& new_config);
+
+/// Copy the scheduler settings that IsSchedulerOnlyChange() allows to
+/// differ from one configuration to another. No other field of 'to'
+/// is modified.
+/// \param from The configuration to copy the settings from.
+/// \param to The configuration to copy the settings to.
+void CopySchedulerSettings(const ModelConfig& from, ModelConfig* to);
+
 }}  // namespace nvidia::inferenceserver
@@ -0,0 +1,395 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/model_quantizer.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include "src/core/constants.h"
+#include "src/core/filesystem.h"
+#include "src/core/logging.h"
+#include "src/core/sha256.h"
+
+extern char** environ;
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+std::mutex quantizer_mu_;
+std::string quantizer_;
+uint32_t quantizer_timeout_secs_ = 0;
+
+// The digest of the quantizer executable, which identifies the
+// quantizer in the key of saved quantized models.
+std::string quantizer_digest_;
+
+// Find the executable that is run for 'command', searching PATH like
+// posix_spawnp() does if 'command' is not a path.
+Status
+FindExecutable(const std::string& command, std::string* path)
+{
+  if (command.find('/') != std::string::npos) {
+    *path = command;
+    return Status::Success;
+  }
+
+  const char* env_path = getenv("PATH");
+  std::string search((env_path == nullptr) ? "/usr/bin:/bin" : env_path);
+  size_t start = 0;
+  while (start <= search.size()) {
+    size_t end = search.find(':', start);
+    if (end == std::string::npos) {
+      end = search.size();
+    }
+
+    const std::string dir = search.substr(start, end - start);
+    const std::string candidate =
+        JoinPath({dir.empty() ? "." : dir, command});
+    if (access(candidate.c_str(), X_OK) == 0) {
+      *path = candidate;
+      return Status::Success;
+    }
+
+    start = end + 1;
+  }
+
+  return Status(
+      RequestStatusCode::INVALID_ARG,
+      "unable to find model quantizer '" + command + "'");
+}
+
+// Create an empty temporary file and return its path in 'path'.
+Status
+CreateTempFile(std::string* path)
+{
+  const char* tmp_dir = getenv("TMPDIR");
+  *path = JoinPath(
+      {(tmp_dir == nullptr) ? "/tmp" : tmp_dir, "trtis_quantize_XXXXXX"});
+  const int fd = mkstemp(&(*path)[0]);
+  if (fd == -1) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to create temporary file for model quantization: " +
+            std::string(strerror(errno)));
+  }
+
+  close(fd);
+  return Status::Success;
+}
+
+Status
+WriteFile(const std::string& path, const std::string& contents)
+{
+  std::ofstream out(path, std::ios::out | std::ios::binary);
+  out.write(contents.data(), contents.size());
+  out.close();
+  if (!out) {
+    return Status(RequestStatusCode::INTERNAL, "failed to write file " + path);
+  }
+
+  return Status::Success;
+}
+
+// Run the quantizer and wait for it to exit. The quantizer is killed
+// if it does not exit within 'timeout_secs', unless that is zero.
+Status
+RunQuantizer(const std::vector<std::string>& args, const uint32_t timeout_secs)
+{
+  std::vector<char*> argv;
+  for (const auto& arg : args) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid;
+  const int err =
+      posix_spawnp(&pid, argv[0], nullptr, nullptr, &argv[0], environ);
+  if (err != 0) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to run model quantizer '" + args[0] + "': " + strerror(err));
+  }
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(timeout_secs);
+  bool timed_out = false;
+  int wstatus;
+  while (true) {
+    const pid_t res =
+        waitpid(pid, &wstatus, (timeout_secs == 0 || timed_out) ? 0 : WNOHANG);
+    if (res == pid) {
+      break;
+    }
+
+    if (res == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return Status(
+          RequestStatusCode::INTERNAL, "failed to wait for model quantizer '" +
+                                           args[0] + "': " + strerror(errno));
+    }
+
+    if (std::chrono::steady_clock::now() >= deadline) {
+      kill(pid, SIGKILL);
+      timed_out = true;
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  }
+
+  if (timed_out) {
+    return Status(
+        RequestStatusCode::UNAVAILABLE,
+        "model quantizer '" + args[0] + "' timed out after " +
+            std::to_string(timeout_secs) + " seconds for '" + args[3] + "'");
+  }
+
+  if (!WIFEXITED(wstatus) || (WEXITSTATUS(wstatus) != 0)) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "model quantizer '" + args[0] + "' failed for '" + args[3] + "'");
+  }
+
+  return Status::Success;
+}
+
+// Quantize a single model file, using the quantized model saved by a
+// previous load if there is one.
+Status
+QuantizeModel(
+    const std::string& quantizer, const uint32_t timeout_secs,
+    const std::string& quantizer_digest, const ModelConfig& config,
+    const std::string& path, const std::string& filename,
+    std::string* model_data)
+{
+  const auto kind_enum = config.optimization().quantization().kind();
+  const char* kind = QuantizationKindName(kind_enum);
+
+  std::vector<std::pair<std::string, std::string>> settings;
+  RETURN_IF_ERROR(
+      GetQuantizationSettings(kind_enum, config.platform(), &settings));
+
+  // Key the quantized model by the quantizer, its settings and the
+  // model contents so that a stale model is never used.
+  std::vector<std::string> args{quantizer, kind, config.platform()};
+  std::string key = quantizer_digest + "\n" + kind + "\n" + config.platform();
+  for (const auto& setting : settings) {
+    args.push_back(setting.first + "=" + setting.second);
+    key += "\n" + args.back();
+  }
+  key += "\n" + Sha256Hex(*model_data);
+
+  const std::string optimized_dir = JoinPath({path, kOptimizedModelDirectory});
+  const std::string quantized_path = JoinPath(
+      {optimized_dir, filename + "_" + kind + "_" + Sha256Hex(key)});
+
+  bool exists = false;
+  if (FileExists(quantized_path, &exists).IsOk() && exists) {
+    LOG_VERBOSE(1) << "Using saved quantized model " << quantized_path;
+    return ReadTextFile(quantized_path, model_data);
+  }
+
+  // The model is written to a local file for the quantizer since the
+  // model repository may not be local.
+  std::string input_path, output_path;
+  RETURN_IF_ERROR(CreateTempFile(&input_path));
+  Status status = CreateTempFile(&output_path);
+  if (status.IsOk()) {
+    status = WriteFile(input_path, *model_data);
+  }
+  if (status.IsOk()) {
+    LOG_INFO << "Quantizing " << filename << " for " << config.name()
+             << " using " << kind << " quantization";
+    args.insert(args.begin() + 3, {input_path, output_path});
+    status = RunQuantizer(args, timeout_secs);
+  }
+
+  std::string quantized_data;
+  if (status.IsOk()) {
+    status = ReadTextFile(output_path, &quantized_data);
+  }
+
+  unlink(input_path.c_str());
+  unlink(output_path.c_str());
+  RETURN_IF_ERROR(status);
+
+  // Save the quantized model under a temporary name that is then
+  // renamed, so that concurrent loads never see a partial model.
+  const std::string write_path =
+      quantized_path + ".tmp" + std::to_string(getpid());
+  if (((mkdir(
+            optimized_dir.c_str(),
+            S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) == 0) ||
+       (errno == EEXIST)) &&
+      WriteFile(write_path, quantized_data).IsOk() &&
+      (rename(write_path.c_str(), quantized_path.c_str()) == 0)) {
+    LOG_INFO << "Saved quantized model " << quantized_path;
+  } else {
+    unlink(write_path.c_str());
+    LOG_WARNING << "unable to save quantized model for " << config.name()
+                << ", model directory '" << path << "' is not writable";
+  }
+
+  model_data->swap(quantized_data);
+  return Status::Success;
+}
+
+}  // namespace
+
+Status
+InitModelQuantizer(const std::string& quantizer, const uint32_t timeout_secs)
+{
+  std::string digest;
+  if (!quantizer.empty()) {
+    std::string executable, contents;
+    RETURN_IF_ERROR(FindExecutable(quantizer, &executable));
+    RETURN_IF_ERROR(ReadTextFile(executable, &contents));
+    digest = Sha256Hex(contents);
+  }
+
+  std::lock_guard<std::mutex> lock(quantizer_mu_);
+  quantizer_ = quantizer;
+  quantizer_timeout_secs_ = timeout_secs;
+  quantizer_digest_ = digest;
+  return Status::Success;
+}
+
+const char*
+QuantizationKindName(const ModelOptimizationPolicy::Quantization::Kind kind)
+{
+  switch (kind) {
+    case ModelOptimizationPolicy::Quantization::QUANTIZATION_NONE:
+      return "none";
+    case ModelOptimizationPolicy::Quantization::QUANTIZATION_DYNAMIC_INT8:
+      return "dynamic_int8";
+    default:
+      break;
+  }
+
+  return "<invalid>";
+}
+
+Status
+GetQuantizationSettings(
+    const ModelOptimizationPolicy::Quantization::Kind kind,
+    const std::string& platform,
+    std::vector<std::pair<std::string, std::string>>* settings)
+{
+  settings->clear();
+  if (kind == ModelOptimizationPolicy::Quantization::QUANTIZATION_NONE) {
+    return Status::Success;
+  }
+
+  if (kind !=
+      ModelOptimizationPolicy::Quantization::QUANTIZATION_DYNAMIC_INT8) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "unsupported quantization kind " + std::to_string(kind));
+  }
+
+  // Weights are quantized symmetrically to the full signed INT8 range
+  // with one scale per tensor.
+  settings->emplace_back("weight_type", "qint8");
+  settings->emplace_back("per_channel", "false");
+  settings->emplace_back("reduce_range", "false");
+#ifdef TRTIS_ENABLE_ONNXRUNTIME
+  if (platform == kOnnxRuntimeOnnxPlatform) {
+    return Status::Success;
+  }
+#endif  // TRTIS_ENABLE_ONNXRUNTIME
+#ifdef TRTIS_ENABLE_PYTORCH
+  if (platform == kPyTorchLibTorchPlatform) {
+    settings->emplace_back("qconfig", "default_dynamic_qconfig");
+    return Status::Success;
+  }
+#endif  // TRTIS_ENABLE_PYTORCH
+
+  settings->clear();
+  return Status(
+      RequestStatusCode::INVALID_ARG,
+      "quantization is not supported for platform '" + platform + "'");
+}
+
+Status
+QuantizeModels(
+    const ModelConfig& config, const std::string& path,
+    std::unordered_map<std::string, std::string>* models)
+{
+  if (config.optimization().quantization().kind() ==
+      ModelOptimizationPolicy::Quantization::QUANTIZATION_NONE) {
+    return Status::Success;
+  }
+
+  std::string quantizer, quantizer_digest;
+  uint32_t timeout_secs;
+  {
+    std::lock_guard<std::mutex> lock(quantizer_mu_);
+    quantizer = quantizer_;
+    quantizer_digest = quantizer_digest_;
+    timeout_secs = quantizer_timeout_secs_;
+  }
+
+  if (quantizer.empty()) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "unable to load model '" + config.name() +
+            "', quantization requires the server to be started with a "
+            "model quantizer");
+  }
+
+  // Only the files that can be used as the model are quantized.
+  std::set<std::string> model_filenames{config.default_model_filename()};
+  for (const auto& itr : config.cc_model_filenames()) {
+    model_filenames.insert(itr.second);
+  }
+
+  for (const auto& filename : model_filenames) {
+    auto itr = models->find(filename);
+    if (itr != models->end()) {
+      RETURN_IF_ERROR(QuantizeModel(
+          quantizer, timeout_secs, quantizer_digest, config, path, filename,
+          &itr->second));
+    }
+  }
+
+  return Status::Success;
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,87 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "src/core/model_config.pb.h"
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+/// Set the command used to quantize the models that request load-time
+/// quantization. The command is run as '<quantizer> <kind> <platform>
+/// <input path> <output path> <setting>...', where 'kind' is the name
+/// of the quantization kind as returned by QuantizationKindName() and
+/// each 'setting' is a '<name>=<value>' pair as returned by
+/// GetQuantizationSettings(). The command must write the quantized
+/// model to the output path.
+/// \param quantizer The quantizer command. Empty disables load-time
+/// quantization.
+/// \param timeout_secs The time allowed for quantizing one model
+/// file, after which the quantizer is killed. Zero indicates no
+/// timeout.
+/// \return Error status
+Status InitModelQuantizer(
+    const std::string& quantizer, const uint32_t timeout_secs);
+
+/// Get the name of a quantization kind, as used for the quantizer
+/// command and as reported in the model status.
+/// \param kind The quantization kind.
+/// \return The name of the kind.
+const char* QuantizationKindName(
+    const ModelOptimizationPolicy::Quantization::Kind kind);
+
+/// Get the settings that the quantizer must apply for a quantization
+/// kind and platform. The settings are passed to the quantizer, are
+/// part of the key of saved quantized models and are reported in the
+/// model status.
+/// \param kind The quantization kind.
+/// \param platform The platform of the model.
+/// \param settings Returns the settings as (name, value) pairs.
+/// \return Error status
+Status GetQuantizationSettings(
+    const ModelOptimizationPolicy::Quantization::Kind kind,
+    const std::string& platform,
+    std::vector<std::pair<std::string, std::string>>* settings);
+
+/// Replace the model files of a model version with their quantized
+/// models, as requested by the model configuration. A quantized model
+/// is saved in the optimized model directory of the version when
+/// possible and is used by later loads instead of quantizing the
+/// model again. Does nothing if the configuration does not request
+/// quantization.
+/// \param config The model configuration.
+/// \param path The path of the model version directory.
+/// \param models Map from model file name to the contents of the file.
+/// \return Error status
+Status QuantizeModels(
+    const ModelConfig& config, const std::string& path,
+    std::unordered_map<std::string, std::string>* models);
+
+}}  // namespace nvidia::inferenceserver
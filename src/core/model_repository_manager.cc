@@ -33,6 +33,7 @@
 #include <thread>
 #include "src/core/backend.h"
 #include "src/core/constants.h"
+#include "src/core/cpu_cgroup.h"
 #include "src/core/filesystem.h"
 #include "src/core/logging.h"
 #include "src/core/model_config_utils.h"
@@ -67,7 +68,10 @@ void
 BuildBackendConfigMap(
     const std::string& version, const std::string& model_store_path,
     const bool strict_model_config, const float tf_gpu_memory_fraction,
-    const bool tf_allow_soft_placement, BackendConfigMap* backend_configs)
+    const bool tf_allow_soft_placement,
+    const uint64_t custom_memory_pool_cache_byte_size,
+    const bool custom_memory_pool_huge_pages,
+    BackendConfigMap* backend_configs)
 {
 #ifdef TRTIS_ENABLE_TENSORFLOW
   //// Tensorflow GraphDef and SavedModel
@@ -131,6 +135,10 @@ BuildBackendConfigMap(
     auto custom_config = std::make_shared<CustomBackendFactory::Config>();
     custom_config->inference_server_version = version;
     custom_config->model_repository_path = model_store_path;
+    custom_config->thread_pool_thread_cnt = 0;
+    custom_config->memory_pool_cache_byte_size =
+        custom_memory_pool_cache_byte_size;
+    custom_config->memory_pool_huge_pages = custom_memory_pool_huge_pages;
     (*backend_configs)[kCustomPlatform] = custom_config;
   }
 #endif  // TRTIS_ENABLE_CUSTOM
@@ -181,6 +189,12 @@ GetModifiedTime(const std::string& path)
   }
 
   for (const auto& child : contents) {
+    // Optimized models saved by the backends when loading the model
+    // are not a modification of the model.
+    if (child == kOptimizedModelDirectory) {
+      continue;
+    }
+
     const auto full_path = JoinPath({path, child});
     mtime = std::max(mtime, GetModifiedTime(full_path));
   }
@@ -199,6 +213,34 @@ IsModified(const std::string& path, int64_t* last_ns)
   return modified;
 }
 
+// Return the most-recent modified time of the model files in the
+// model directory at 'path', that is everything in the directory
+// except the model configuration file. Also return the names of
+// those files so that a deletion can be detected.
+int64_t
+GetModelFilesModifiedTime(const std::string& path, std::set<std::string>* files)
+{
+  files->clear();
+
+  std::set<std::string> contents;
+  Status status = GetDirectoryContents(path, &contents);
+  if (!status.IsOk()) {
+    LOG_ERROR << "Failed to determine modification time for '" << path
+              << "': " << status.AsString();
+    return 0;
+  }
+
+  int64_t mtime = 0;
+  for (const auto& child : contents) {
+    if (child != kModelConfigPbTxt) {
+      files->insert(child);
+      mtime = std::max(mtime, GetModifiedTime(JoinPath({path, child})));
+    }
+  }
+
+  return mtime;
+}
+
 // Use smart pointer with custom deleter so that model state will be updated
 // to UNAVAILABLE if all smart pointer copies are out of scope
 struct BackendDeleter {
@@ -220,10 +262,12 @@ struct BackendDeleter {
 }  // namespace
 
 struct ModelRepositoryManager::ModelInfo {
-  // [TODO] split modification time into versions' and model's
-  // so that we have more information on whether the model reload
-  // is necessary
   int64_t mtime_nsec_;
+  // The modification time and names of the model files, excluding
+  // the model configuration, so that a change to only the
+  // configuration can be detected.
+  int64_t model_files_mtime_nsec_;
+  std::set<std::string> model_files_;
   ModelConfig model_config_;
   Platform platform_;
 };
@@ -258,6 +302,13 @@ class ModelRepositoryManager::BackendLifeCycle {
   // Get the VersionStateMap representation of the specified model.
   const VersionStateMap GetVersionStates(const std::string& model_name);
 
+  // Apply the scheduler settings of 'model_config' to all versions
+  // of the model without reloading them. Return error if any version
+  // is not ready, in which case the model must be reloaded to apply
+  // the new configuration.
+  Status Reconfigure(
+      const std::string& model_name, const ModelConfig& model_config);
+
  private:
   struct BackendInfo {
     BackendInfo(
@@ -513,6 +564,84 @@ ModelRepositoryManager::BackendLifeCycle::GetInferenceBackend(
   return Status::Success;
 }
 
+Status
+ModelRepositoryManager::BackendLifeCycle::Reconfigure(
+    const std::string& model_name, const ModelConfig& model_config)
+{
+  LOG_VERBOSE(1) << "Reconfigure() '" << model_name << "'";
+  std::lock_guard<std::mutex> map_lock(map_mtx_);
+  auto mit = map_.find(model_name);
+  if ((mit == map_.end()) || mit->second.empty()) {
+    return Status(
+        RequestStatusCode::NOT_FOUND,
+        "model '" + model_name + "' is not found");
+  }
+
+  // Versions that are no longer served are skipped. Versions that are
+  // being loaded or unloaded can't be reconfigured. Check every
+  // version, and keep them locked, before changing any of them so
+  // that all versions end up with the same settings.
+  std::vector<std::unique_lock<std::recursive_mutex>> locks;
+  std::vector<BackendInfo*> ready_infos;
+  for (auto& version_backend : mit->second) {
+    BackendInfo* backend_info = version_backend.second.get();
+    locks.emplace_back(backend_info->mtx_);
+    if (((backend_info->state_ == ModelReadyState::MODEL_UNKNOWN) ||
+         (backend_info->state_ == ModelReadyState::MODEL_UNAVAILABLE)) &&
+        (backend_info->next_action_ == ActionType::NO_ACTION)) {
+      continue;
+    }
+
+    if ((backend_info->state_ != ModelReadyState::MODEL_READY) ||
+        (backend_info->next_action_ != ActionType::NO_ACTION)) {
+      return Status(
+          RequestStatusCode::UNAVAILABLE,
+          "model '" + model_name + "' version " +
+              std::to_string(version_backend.first) +
+              " is not at ready state");
+    }
+
+    ready_infos.push_back(backend_info);
+  }
+
+  if (ready_infos.empty()) {
+    return Status(
+        RequestStatusCode::UNAVAILABLE,
+        "model '" + model_name + "' has no ready version");
+  }
+
+  // If a version can't be reconfigured restore the versions that
+  // already were, so the caller can fall back to reloading the model.
+  std::vector<ModelConfig> previous_configs;
+  for (BackendInfo* backend_info : ready_infos) {
+    previous_configs.push_back(backend_info->backend_->Config());
+  }
+
+  for (size_t idx = 0; idx < ready_infos.size(); ++idx) {
+    Status status =
+        ready_infos[idx]->backend_->ReconfigureScheduler(model_config);
+    if (!status.IsOk()) {
+      for (size_t ridx = 0; ridx < idx; ++ridx) {
+        Status restore_status =
+            ready_infos[ridx]->backend_->ReconfigureScheduler(
+                previous_configs[ridx]);
+        if (!restore_status.IsOk()) {
+          LOG_ERROR << "failed to restore scheduler settings of '"
+                    << model_name << "': " << restore_status.Message();
+        }
+      }
+
+      return status;
+    }
+  }
+
+  for (BackendInfo* backend_info : ready_infos) {
+    backend_info->model_config_ = model_config;
+  }
+
+  return Status::Success;
+}
+
 Status
 ModelRepositoryManager::BackendLifeCycle::AsyncLoad(
     const std::string& model_name, const std::vector<int64_t>& versions,
@@ -664,52 +793,71 @@ ModelRepositoryManager::BackendLifeCycle::CreateInferenceBackend(
     model_config = backend_info->model_config_;
   }
 
+  // Move this thread into the model's CPU cgroup before creating the
+  // backend so that the scheduler and framework threads created
+  // while loading inherit it.
+  Status status = JoinModelCpuCgroup(model_config);
+  const bool joined_cgroup = status.IsOk();
+
   // Create backend
-  Status status;
   std::unique_ptr<InferenceBackend> is;
-  switch (backend_info->platform_) {
+  if (status.IsOk()) {
+    switch (backend_info->platform_) {
 #ifdef TRTIS_ENABLE_TENSORFLOW
-    case Platform::PLATFORM_TENSORFLOW_GRAPHDEF:
-      status =
-          graphdef_factory_->CreateBackend(version_path, model_config, &is);
-      break;
-    case Platform::PLATFORM_TENSORFLOW_SAVEDMODEL:
-      status =
-          savedmodel_factory_->CreateBackend(version_path, model_config, &is);
-      break;
+      case Platform::PLATFORM_TENSORFLOW_GRAPHDEF:
+        status =
+            graphdef_factory_->CreateBackend(version_path, model_config, &is);
+        break;
+      case Platform::PLATFORM_TENSORFLOW_SAVEDMODEL:
+        status = savedmodel_factory_->CreateBackend(
+            version_path, model_config, &is);
+        break;
 #endif  // TRTIS_ENABLE_TENSORFLOW
 #ifdef TRTIS_ENABLE_TENSORRT
-    case Platform::PLATFORM_TENSORRT_PLAN:
-      status = plan_factory_->CreateBackend(version_path, model_config, &is);
-      break;
+      case Platform::PLATFORM_TENSORRT_PLAN:
+        status = plan_factory_->CreateBackend(version_path, model_config, &is);
+        break;
 #endif  // TRTIS_ENABLE_TENSORRT
 #ifdef TRTIS_ENABLE_CAFFE2
-    case Platform::PLATFORM_CAFFE2_NETDEF:
-      status = netdef_factory_->CreateBackend(version_path, model_config, &is);
-      break;
+      case Platform::PLATFORM_CAFFE2_NETDEF:
+        status =
+            netdef_factory_->CreateBackend(version_path, model_config, &is);
+        break;
 #endif  // TRTIS_ENABLE_CAFFE2
 #ifdef TRTIS_ENABLE_ONNXRUNTIME
-    case Platform::PLATFORM_ONNXRUNTIME_ONNX:
-      status = onnx_factory_->CreateBackend(version_path, model_config, &is);
-      break;
+      case Platform::PLATFORM_ONNXRUNTIME_ONNX:
+        status = onnx_factory_->CreateBackend(version_path, model_config, &is);
+        break;
 #endif  // TRTIS_ENABLE_ONNXRUNTIME
 #ifdef TRTIS_ENABLE_PYTORCH
-    case Platform::PLATFORM_PYTORCH_LIBTORCH:
-      status =
-          libtorch_factory_->CreateBackend(version_path, model_config, &is);
-      break;
+      case Platform::PLATFORM_PYTORCH_LIBTORCH:
+        status =
+            libtorch_factory_->CreateBackend(version_path, model_config, &is);
+        break;
 #endif  // TRTIS_ENABLE_PYTORCH
 #ifdef TRTIS_ENABLE_CUSTOM
-    case Platform::PLATFORM_CUSTOM:
-      status = custom_factory_->CreateBackend(version_path, model_config, &is);
-      break;
+      case Platform::PLATFORM_CUSTOM:
+        status =
+            custom_factory_->CreateBackend(version_path, model_config, &is);
+        break;
 #endif  // TRTIS_ENABLE_CUSTOM
-    case Platform::PLATFORM_ENSEMBLE:
-      status =
-          ensemble_factory_->CreateBackend(version_path, model_config, &is);
-      break;
-    default:
-      break;
+      case Platform::PLATFORM_ENSEMBLE:
+        status =
+            ensemble_factory_->CreateBackend(version_path, model_config, &is);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Leave the model's CPU cgroup, this thread may go on to create
+  // the threads that load other models.
+  if (joined_cgroup) {
+    Status leave_status = LeaveModelCpuCgroup(model_config);
+    if (!leave_status.IsOk()) {
+      LOG_ERROR << "failed to leave CPU cgroup of '" << model_name
+                << "': " << leave_status.AsString();
+    }
   }
 
   // Update backend state
@@ -718,6 +866,10 @@ ModelRepositoryManager::BackendLifeCycle::CreateInferenceBackend(
   if (backend_info->backend_ != nullptr) {
     LOG_ERROR << "trying to load model '" << model_name << "' version "
               << version << " while it is being served";
+    if (joined_cgroup) {
+      is.reset();
+      ReleaseModelCpuCgroup(model_config);
+    }
   } else {
     if (status.IsOk()) {
       is->SetInferenceServer(server_);
@@ -727,11 +879,15 @@ ModelRepositoryManager::BackendLifeCycle::CreateInferenceBackend(
       // cause deadlock.
       backend_info->backend_.reset(
           is.release(),
-          BackendDeleter([this, model_name, version, backend_info]() mutable {
+          BackendDeleter([this, model_name, version, model_config,
+                          backend_info]() mutable {
             LOG_VERBOSE(1) << "OnDestroy callback() '" << model_name
                            << "' version " << version;
             LOG_INFO << "successfully unloaded '" << model_name << "' version "
                      << version;
+            // The threads of the backend have exited so its CPU
+            // cgroup can be removed.
+            ReleaseModelCpuCgroup(model_config);
             // Use recursive mutex as this deleter is likely to to be called
             // within BackendLifeCycle class where the same mutex is being hold.
             // However, mutex acquisition is needed here for the case where
@@ -750,6 +906,10 @@ ModelRepositoryManager::BackendLifeCycle::CreateInferenceBackend(
       LOG_ERROR << "failed to load '" << model_name << "' version " << version
                 << ": " << status.AsString();
       backend_info->state_ = ModelReadyState::MODEL_UNAVAILABLE;
+      if (joined_cgroup) {
+        is.reset();
+        ReleaseModelCpuCgroup(model_config);
+      }
     }
   }
 
@@ -777,9 +937,19 @@ ModelRepositoryManager::Create(
     const std::shared_ptr<ServerStatusManager>& status_manager,
     const std::string& repository_path, const bool strict_model_config,
     const float tf_gpu_memory_fraction, const bool tf_allow_soft_placement,
+    const uint64_t custom_memory_pool_cache_byte_size,
+    const bool custom_memory_pool_huge_pages,
     const uint32_t repository_poll_secs, const bool polling_enabled,
     std::unique_ptr<ModelRepositoryManager>* model_repository_manager)
 {
+  // A packed repository archive is mounted so that it can be read as
+  // a directory.
+  bool path_is_archive;
+  RETURN_IF_ERROR(IsRepositoryArchive(repository_path, &path_is_archive));
+  if (path_is_archive) {
+    RETURN_IF_ERROR(MountRepositoryArchive(repository_path));
+  }
+
   // The rest only matters if repository path is valid directory
   bool path_is_dir;
   RETURN_IF_ERROR(IsDirectory(repository_path, &path_is_dir));
@@ -793,7 +963,9 @@ ModelRepositoryManager::Create(
 
   BuildBackendConfigMap(
       server_version, repository_path, strict_model_config,
-      tf_gpu_memory_fraction, tf_allow_soft_placement, &backend_config_map);
+      tf_gpu_memory_fraction, tf_allow_soft_placement,
+      custom_memory_pool_cache_byte_size, custom_memory_pool_huge_pages,
+      &backend_config_map);
 
   std::unique_ptr<BackendLifeCycle> life_cycle;
   RETURN_IF_ERROR(BackendLifeCycle::Create(
@@ -806,12 +978,13 @@ ModelRepositoryManager::Create(
           !strict_model_config, polling_enabled, std::move(life_cycle)));
 
   // Similar to PollAndUpdate(), but simplier
-  std::set<std::string> added, deleted, modified, unmodified;
+  std::set<std::string> added, deleted, modified, reconfigured, unmodified;
   if (polling_enabled) {
-    RETURN_IF_ERROR(
-        local_manager->Poll(&added, &deleted, &modified, &unmodified));
+    RETURN_IF_ERROR(local_manager->Poll(
+        &added, &deleted, &modified, &reconfigured, &unmodified));
   }
-  if (!deleted.empty() || !modified.empty() || !unmodified.empty()) {
+  if (!deleted.empty() || !modified.empty() || !reconfigured.empty() ||
+      !unmodified.empty()) {
     return Status(
         RequestStatusCode::INTERNAL,
         "Unexpected initial state for model repository");
@@ -839,10 +1012,12 @@ ModelRepositoryManager::PollAndUpdate()
   if (!polling_enabled_) {
     return Status(RequestStatusCode::INVALID, "polling is disabled");
   }
-  std::set<std::string> added, deleted, modified, unmodified;
-  RETURN_IF_ERROR(Poll(&added, &deleted, &modified, &unmodified));
+  std::set<std::string> added, deleted, modified, reconfigured, unmodified;
+  RETURN_IF_ERROR(
+      Poll(&added, &deleted, &modified, &reconfigured, &unmodified));
   // Nothing to do if no model adds, deletes or modifies.
-  if (added.empty() && deleted.empty() && modified.empty()) {
+  if (added.empty() && deleted.empty() && modified.empty() &&
+      reconfigured.empty()) {
     return Status::Success;
   }
 
@@ -865,6 +1040,22 @@ ModelRepositoryManager::PollAndUpdate()
     }
   }
 
+  // If only the scheduler settings of a model changed, apply them to
+  // the running model. If that isn't possible, for example because the
+  // model is still loading, fall back to reloading the model.
+  for (const auto& name : reconfigured) {
+    Status status = Reconfigure(name);
+    if (!status.IsOk()) {
+      LOG_VERBOSE(1) << "unable to reconfigure model '" << name
+                     << "', reloading: " << status.Message();
+      status = Update(name, false);
+      if (!status.IsOk()) {
+        LOG_ERROR << "failed to reload model '" << name
+                  << "': " << status.Message();
+      }
+    }
+  }
+
   for (const auto& name : deleted) {
     ModelConfig model_config;
     std::vector<int64_t> versions;
@@ -895,6 +1086,19 @@ ModelRepositoryManager::Update(const std::string& model_name, bool is_added)
   return Status::Success;
 }
 
+Status
+ModelRepositoryManager::Reconfigure(const std::string& model_name)
+{
+  ModelConfig model_config;
+  RETURN_IF_ERROR(GetModelConfig(model_name, &model_config));
+  RETURN_IF_ERROR(
+      backend_life_cycle_->Reconfigure(model_name, model_config));
+  RETURN_IF_ERROR(
+      status_manager_->UpdateConfigForModel(model_name, model_config));
+  LOG_INFO << "reconfigured scheduler: " << model_name;
+  return Status::Success;
+}
+
 Status
 ModelRepositoryManager::LoadUnloadModel(
     const std::string& model_name, ActionType type,
@@ -960,7 +1164,8 @@ ModelRepositoryManager::GetInferenceBackend(
 Status
 ModelRepositoryManager::Poll(
     std::set<std::string>* added, std::set<std::string>* deleted,
-    std::set<std::string>* modified, std::set<std::string>* unmodified)
+    std::set<std::string>* modified, std::set<std::string>* reconfigured,
+    std::set<std::string>* unmodified)
 {
   // Serialize all polling operation...
   std::lock_guard<std::mutex> lock(poll_mu_);
@@ -968,6 +1173,7 @@ ModelRepositoryManager::Poll(
   added->clear();
   deleted->clear();
   modified->clear();
+  reconfigured->clear();
   unmodified->clear();
 
   // We don't modify 'infos_' in place to minimize how long we need to
@@ -987,6 +1193,7 @@ ModelRepositoryManager::Poll(
     // modified since the last time it was polled, then need to
     // (re)load, normalize and validate the configuration.
     bool need_load = false;
+    bool is_modified = false;
     int64_t mtime_ns;
     const auto iitr = infos_.find(child);
     if (iitr == infos_.end()) {
@@ -996,7 +1203,7 @@ ModelRepositoryManager::Poll(
     } else {
       mtime_ns = iitr->second->mtime_nsec_;
       if (IsModified(std::string(full_path), &mtime_ns)) {
-        modified->insert(child);
+        is_modified = true;
         need_load = true;
       } else {
         unmodified->insert(child);
@@ -1024,6 +1231,8 @@ ModelRepositoryManager::Poll(
       model_info.reset(new ModelInfo());
       ModelConfig& model_config = model_info->model_config_;
       model_info->mtime_nsec_ = mtime_ns;
+      model_info->model_files_mtime_nsec_ = GetModelFilesModifiedTime(
+          std::string(full_path), &model_info->model_files_);
 
       // If enabled, try to automatically generate missing parts of
       // the model configuration (autofill) from the model
@@ -1046,14 +1255,30 @@ ModelRepositoryManager::Poll(
                 model_config.name() +
                 "', directory name must equal model name");
       }
+
+      // A modified model whose model files are unchanged and whose
+      // configuration changed only in scheduler settings can be
+      // reconfigured in place instead of being reloaded.
+      if (is_modified) {
+        const ModelInfo& prev_info = *iitr->second;
+        if ((model_info->model_files_mtime_nsec_ ==
+             prev_info.model_files_mtime_nsec_) &&
+            (model_info->model_files_ == prev_info.model_files_) &&
+            IsSchedulerOnlyChange(prev_info.model_config_, model_config)) {
+          reconfigured->insert(child);
+        } else {
+          modified->insert(child);
+        }
+      }
     }
   }
 
-  // Anything in 'infos_' that is not in "added", "modified", or
-  // "unmodified" is deleted.
+  // Anything in 'infos_' that is not in "added", "modified",
+  // "reconfigured" or "unmodified" is deleted.
   for (const auto& pr : infos_) {
     if ((added->find(pr.first) == added->end()) &&
         (modified->find(pr.first) == modified->end()) &&
+        (reconfigured->find(pr.first) == reconfigured->end()) &&
         (unmodified->find(pr.first) == unmodified->end())) {
       deleted->insert(pr.first);
     }
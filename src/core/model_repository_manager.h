@@ -71,6 +71,8 @@ class ModelRepositoryManager {
       const std::shared_ptr<ServerStatusManager>& status_manager,
       const std::string& repository_path, const bool strict_model_config,
       const float tf_gpu_memory_fraction, const bool tf_allow_soft_placement,
+      const uint64_t custom_memory_pool_cache_byte_size,
+      const bool custom_memory_pool_huge_pages,
       const uint32_t repository_poll_secs, const bool polling_enabled,
       std::unique_ptr<ModelRepositoryManager>* model_repository_manager);
 
@@ -138,12 +140,16 @@ class ModelRepositoryManager {
   /// \param deleted The names of the models removed from the repository.
   /// \param modified The names of the models remaining in the
   /// repository that have been changed.
+  /// \param reconfigured The names of the models remaining in the
+  /// repository whose model files are unchanged and whose
+  /// configuration changed only in scheduler settings.
   /// \param unmodified The names of the models remaining in the
   /// repository that have not changed.
   /// \return The error status.
   Status Poll(
       std::set<std::string>* added, std::set<std::string>* deleted,
-      std::set<std::string>* modified, std::set<std::string>* unmodified);
+      std::set<std::string>* modified, std::set<std::string>* reconfigured,
+      std::set<std::string>* unmodified);
 
   /// Update the configuration of newly added / modified model and serve
   /// the model based on its version policy.
@@ -151,6 +157,12 @@ class ModelRepositoryManager {
   /// \param is_added If the model is being added to the model repository.
   Status Update(const std::string& model_name, bool is_added);
 
+  /// Apply the scheduler settings of the current configuration of a
+  /// model to the running model without reloading it.
+  /// \param model_name The name of the model to be reconfigured.
+  /// \return The error status.
+  Status Reconfigure(const std::string& model_name);
+
   /// Get the configuration for a named model.
   /// \param name The model name.
   /// \param model_config Returns the model configuration.
@@ -0,0 +1,319 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver {
+
+//
+// A free list of memory blocks of 'BlockSize' bytes. Blocks released
+// to the pool are kept, up to a limit, and handed out again by later
+// allocations so that objects created for every request reuse the
+// memory of earlier requests instead of going through malloc.
+//
+// Each thread keeps its own free list so that allocating and
+// releasing usually takes no lock. Objects are often created by one
+// thread and released by another, so blocks move between threads
+// through a shared free list in batches of kBatchBlocks.
+//
+template <size_t BlockSize>
+class BlockPool {
+ public:
+  // The number of free blocks kept by each thread, and moved to or
+  // from the shared free list at once.
+  static constexpr size_t kMaxThreadBlocks = 64;
+  static constexpr size_t kBatchBlocks = kMaxThreadBlocks / 2;
+
+  // The number of free blocks kept in the shared free list. Blocks
+  // released beyond this are returned to the system.
+  static constexpr size_t kMaxFreeBlocks = 1024;
+
+  // Return the pool for blocks of 'BlockSize'.
+  static BlockPool& Instance()
+  {
+    // Intentionally leaked so that blocks can still be released while
+    // static and thread-local objects are destroyed at exit.
+    static BlockPool* pool = new BlockPool();
+    return *pool;
+  }
+
+  void* Allocate()
+  {
+    std::vector<void*>* list = LocalFreeList();
+    if (list == nullptr) {
+      return ::operator new(BlockSize);
+    }
+
+    std::vector<void*>& local = *list;
+    if (local.empty()) {
+      std::lock_guard<std::mutex> lk(mu_);
+      const size_t cnt = std::min(kBatchBlocks, free_.size());
+      local.insert(local.end(), free_.end() - cnt, free_.end());
+      free_.resize(free_.size() - cnt);
+    }
+
+    if (!local.empty()) {
+      void* block = local.back();
+      local.pop_back();
+      return block;
+    }
+
+    return ::operator new(BlockSize);
+  }
+
+  void Release(void* block)
+  {
+    std::vector<void*>* list = LocalFreeList();
+    if (list == nullptr) {
+      ::operator delete(block);
+      return;
+    }
+
+    if (list->size() == kMaxThreadBlocks) {
+      MoveToShared(list, kBatchBlocks);
+    }
+
+    list->push_back(block);
+  }
+
+ private:
+  // The free list of the calling thread. Its blocks are moved to the
+  // shared free list when the thread exits.
+  struct ThreadFreeList {
+    ThreadFreeList() { blocks_.reserve(kMaxThreadBlocks); }
+    ~ThreadFreeList()
+    {
+      Instance().MoveToShared(&blocks_, blocks_.size());
+      Exited() = true;
+    }
+
+    std::vector<void*> blocks_;
+  };
+
+  BlockPool() { free_.reserve(kMaxFreeBlocks); }
+
+  // Set once the calling thread's free list is destroyed, after which
+  // blocks released by other thread-local objects bypass the pool.
+  static bool& Exited()
+  {
+    static thread_local bool exited = false;
+    return exited;
+  }
+
+  // Return the free list of the calling thread, or nullptr if the
+  // thread is exiting and its free list was already destroyed.
+  static std::vector<void*>* LocalFreeList()
+  {
+    if (Exited()) {
+      return nullptr;
+    }
+
+    static thread_local ThreadFreeList list;
+    return &list.blocks_;
+  }
+
+  // Move the last 'cnt' blocks of 'blocks' to the shared free list,
+  // returning any that don't fit to the system.
+  void MoveToShared(std::vector<void*>* blocks, size_t cnt)
+  {
+    size_t kept = 0;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      kept = std::min(cnt, kMaxFreeBlocks - free_.size());
+      free_.insert(free_.end(), blocks->end() - kept, blocks->end());
+    }
+
+    blocks->resize(blocks->size() - kept);
+    for (size_t idx = kept; idx < cnt; ++idx) {
+      ::operator delete(blocks->back());
+      blocks->pop_back();
+    }
+  }
+
+  std::mutex mu_;
+  std::vector<void*> free_;
+};
+
+template <size_t BlockSize>
+constexpr size_t BlockPool<BlockSize>::kMaxThreadBlocks;
+template <size_t BlockSize>
+constexpr size_t BlockPool<BlockSize>::kBatchBlocks;
+template <size_t BlockSize>
+constexpr size_t BlockPool<BlockSize>::kMaxFreeBlocks;
+
+//
+// Allocate 'byte_size' bytes for an array. Small arrays are taken
+// from the BlockPool of the smallest size class that holds them so
+// that the buckets and elements of per-request containers are
+// recycled too. Larger arrays are allocated directly.
+//
+inline void*
+PoolAllocateArray(size_t byte_size)
+{
+  if (byte_size <= 64) {
+    return BlockPool<64>::Instance().Allocate();
+  } else if (byte_size <= 256) {
+    return BlockPool<256>::Instance().Allocate();
+  } else if (byte_size <= 1024) {
+    return BlockPool<1024>::Instance().Allocate();
+  }
+
+  return ::operator new(byte_size);
+}
+
+// Release an array allocated by PoolAllocateArray with the same
+// 'byte_size'.
+inline void
+PoolReleaseArray(void* array, size_t byte_size)
+{
+  if (byte_size <= 64) {
+    BlockPool<64>::Instance().Release(array);
+  } else if (byte_size <= 256) {
+    BlockPool<256>::Instance().Release(array);
+  } else if (byte_size <= 1024) {
+    BlockPool<1024>::Instance().Release(array);
+  } else {
+    ::operator delete(array);
+  }
+}
+
+//
+// An allocator that takes objects from the BlockPool for the object
+// size, and small arrays from the BlockPool of their size class. Use
+// with std::allocate_shared to recycle both the object and the
+// shared_ptr control block of objects that are created for every
+// request, and with containers to recycle their elements:
+//
+//   auto stats = std::allocate_shared<ModelInferStats>(
+//       PoolAllocator<ModelInferStats>(), status_manager, model_name);
+//
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>&)
+  {
+  }
+
+  T* allocate(size_t n)
+  {
+    static_assert(
+        alignof(T) <= alignof(std::max_align_t),
+        "PoolAllocator does not support over-aligned types");
+    if (n != 1) {
+      return static_cast<T*>(PoolAllocateArray(n * sizeof(T)));
+    }
+    return static_cast<T*>(BlockPool<sizeof(T)>::Instance().Allocate());
+  }
+
+  void deallocate(T* p, size_t n)
+  {
+    if (n != 1) {
+      PoolReleaseArray(p, n * sizeof(T));
+    } else {
+      BlockPool<sizeof(T)>::Instance().Release(p);
+    }
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>&) const
+  {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>&) const
+  {
+    return false;
+  }
+};
+
+//
+// A deleter for objects constructed in memory from
+// PoolAllocator<T>. Objects with non-public constructors can't be
+// created by std::allocate_shared, so they are constructed in place
+// and owned with this deleter instead:
+//
+//   T* obj = new (PoolAllocator<T>().allocate(1)) T(...);
+//   std::shared_ptr<T> sp(obj, PoolDeleter<T>(), PoolAllocator<T>());
+//
+template <typename T>
+struct PoolDeleter {
+  void operator()(T* p) const
+  {
+    p->~T();
+    PoolAllocator<T>().deallocate(p, 1);
+  }
+};
+
+//
+// A callback that holds a pointer to a function object taken from the
+// pool. std::function stores callbacks this small without
+// allocating, while a function object that captures shared_ptr or
+// std::function values would be allocated every time it is wrapped
+// in a std::function. The callback may be copied but must be called
+// exactly once, which releases the function object.
+//
+template <typename F>
+class PooledCallback {
+ public:
+  explicit PooledCallback(F&& fn)
+      : fn_(new (PoolAllocator<F>().allocate(1)) F(std::move(fn)))
+  {
+  }
+
+  template <typename... Args>
+  void operator()(Args&&... args) const
+  {
+    std::unique_ptr<F, PoolDeleter<F>> fn(fn_);
+    (*fn)(std::forward<Args>(args)...);
+  }
+
+ private:
+  F* fn_;
+};
+
+// Return a PooledCallback for 'fn'.
+template <typename F>
+PooledCallback<F>
+MakePooledCallback(F&& fn)
+{
+  static_assert(
+      !std::is_reference<F>::value, "MakePooledCallback requires an rvalue");
+  return PooledCallback<F>(std::move(fn));
+}
+
+}}  // namespace nvidia::inferenceserver
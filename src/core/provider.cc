@@ -37,25 +37,36 @@ namespace nvidia { namespace inferenceserver {
 //
 // SystemMemoryReference
 //
-SystemMemoryReference::SystemMemoryReference() : SystemMemory() {}
+SystemMemoryReference::SystemMemoryReference()
+    : SystemMemory(), block_count_(0)
+{
+}
 
 const char*
 SystemMemoryReference::BufferAt(size_t idx, size_t* byte_size) const
 {
-  if (idx >= buffer_.size()) {
+  if (idx >= block_count_) {
     *byte_size = 0;
     return nullptr;
   }
-  *byte_size = buffer_[idx].second;
-  return buffer_[idx].first;
+
+  const Block& block = (idx < kInlineBlockCount)
+                           ? inline_buffer_[idx]
+                           : buffer_[idx - kInlineBlockCount];
+  *byte_size = block.second;
+  return block.first;
 }
 
 size_t
 SystemMemoryReference::AddBuffer(const char* buffer, size_t byte_size)
 {
   total_byte_size_ += byte_size;
-  buffer_.emplace_back(std::make_pair(buffer, byte_size));
-  return buffer_.size() - 1;
+  if (block_count_ < kInlineBlockCount) {
+    inline_buffer_[block_count_] = std::make_pair(buffer, byte_size);
+  } else {
+    buffer_.emplace_back(std::make_pair(buffer, byte_size));
+  }
+  return block_count_++;
 }
 
 AllocatedSystemMemory::AllocatedSystemMemory(size_t byte_size) : SystemMemory()
@@ -82,44 +93,151 @@ AllocatedSystemMemory::MutableBuffer()
   return buffer_.get();
 }
 
+//
+// InferRequestDescriptor
+//
+void
+InferRequestDescriptor::Input::SetDims(const DimsList& dims)
+{
+  dims_count_ = dims.size();
+  if (dims_count_ <= kInlineDimsCount) {
+    std::copy(dims.begin(), dims.end(), inline_dims_);
+    dims_.clear();
+  } else {
+    dims_.assign(dims.begin(), dims.end());
+  }
+}
+
+Status
+InferRequestDescriptor::Init(
+    const InferenceBackend& backend, const InferRequestHeader& request_header)
+{
+  const ModelConfig& config = backend.Config();
+
+  batch_size_ = request_header.batch_size();
+  flags_ = request_header.flags();
+  correlation_id_ = request_header.correlation_id();
+
+  // A normalized request header has exactly one entry for each
+  // model input, so every slot is filled unless an input is repeated.
+  inputs_.clear();
+  inputs_.resize(config.input_size());
+  std::vector<bool, PoolAllocator<bool>> seen(config.input_size(), false);
+  for (int ridx = 0; ridx < request_header.input_size(); ++ridx) {
+    const InferRequestHeader::Input& io = request_header.input(ridx);
+
+    size_t cidx;
+    if (!backend.GetInputIndex(io.name(), &cidx).IsOk() || seen[cidx]) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "unexpected or repeated input '" + io.name() + "' for model '" +
+              config.name() + "'");
+    }
+
+    seen[cidx] = true;
+    Input& input = inputs_[cidx];
+    input.request_index_ = ridx;
+    input.batch_byte_size_ = io.batch_byte_size();
+    input.SetDims(io.dims());
+  }
+
+  return Status::Success;
+}
+
+bool
+InferRequestDescriptor::SameInputShapes(
+    const InferRequestDescriptor& other) const
+{
+  if (inputs_.size() != other.inputs_.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    const Input& a = inputs_[i];
+    const Input& b = other.inputs_[i];
+    if ((a.DimsCount() != b.DimsCount()) ||
+        !std::equal(a.Dims(), a.Dims() + a.DimsCount(), b.Dims())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 //
 // InferRequestProvider
 //
 Status
 InferRequestProvider::Create(
-    const std::string& model_name, const int64_t model_version,
-    const InferRequestHeader& request_header,
-    const std::unordered_map<std::string, std::shared_ptr<SystemMemory>>&
-        input_buffer,
+    const InferenceBackend& backend, const std::string& model_name,
+    const int64_t model_version, const InferRequestHeader& request_header,
+    const InputBufferMap& input_buffer,
     std::shared_ptr<InferRequestProvider>* provider)
 {
-  provider->reset(new InferRequestProvider(model_name, model_version));
+  InferRequestHeader header(request_header);
+  return Create(
+      backend, model_name, model_version, std::move(header), input_buffer,
+      provider);
+}
 
-  (*provider)->request_header_ = request_header;
+Status
+InferRequestProvider::Create(
+    const InferenceBackend& backend, const std::string& model_name,
+    const int64_t model_version, InferRequestHeader&& request_header,
+    const InputBufferMap& input_buffer,
+    std::shared_ptr<InferRequestProvider>* provider)
+{
+  PoolAllocator<InferRequestProvider> alloc;
+  provider->reset(
+      new (alloc.allocate(1)) InferRequestProvider(model_name, model_version),
+      PoolDeleter<InferRequestProvider>(), alloc);
+
+  RETURN_IF_ERROR((*provider)->descriptor_.Init(backend, request_header));
 
-  for (const auto& io : request_header.input()) {
-    auto it = input_buffer.find(io.name());
+  const InferRequestDescriptor& descriptor = (*provider)->descriptor_;
+  (*provider)->input_buffer_.resize(descriptor.inputs_.size());
+  for (size_t idx = 0; idx < descriptor.inputs_.size(); ++idx) {
+    const InferRequestDescriptor::Input& input = descriptor.inputs_[idx];
+    const std::string& name = request_header.input(input.request_index_).name();
+    auto it = input_buffer.find(name);
     if (it == input_buffer.end()) {
       return Status(
           RequestStatusCode::INVALID_ARG,
-          "input '" + io.name() + "' is specified in request header but" +
+          "input '" + name + "' is specified in request header but" +
               " not found in memory block mapping for model '" +
               (*provider)->model_name_ + "'");
     }
-    if (io.batch_byte_size() != it->second->TotalByteSize()) {
+    if (input.batch_byte_size_ != it->second->TotalByteSize()) {
       return Status(
           RequestStatusCode::INVALID_ARG,
           "unexpected size " + std::to_string(it->second->TotalByteSize()) +
-              " for input '" + io.name() + "', expecting " +
-              std::to_string(io.batch_byte_size()) + " for model '" +
+              " for input '" + name + "', expecting " +
+              std::to_string(input.batch_byte_size_) + " for model '" +
               (*provider)->model_name_ + "'");
     }
-    (*provider)->input_buffer_[io.name()] = std::make_pair(it->second, 0);
+    (*provider)->input_buffer_[idx] = std::make_pair(it->second, 0);
   }
 
+  // The header messages are heap allocated so swapping them into the
+  // provider takes ownership without copying.
+  (*provider)->request_header_.Swap(&request_header);
+
   return Status::Success;
 }
 
+int
+InferRequestProvider::InputIndex(const std::string& name) const
+{
+  for (size_t idx = 0; idx < descriptor_.inputs_.size(); ++idx) {
+    const size_t ridx = descriptor_.inputs_[idx].request_index_;
+    if (request_header_.input(ridx).name() == name) {
+      return idx;
+    }
+  }
+
+  return -1;
+}
+
 const std::shared_ptr<InferRequestProvider::InputOverrideMap>&
 InferRequestProvider::GetInputOverride() const
 {
@@ -169,46 +287,86 @@ InferRequestProvider::GetNextInputContent(
     return Status::Success;
   }
 
-  if (!GetInputOverrideContent(name, content, content_byte_size)) {
-    const auto& pr = input_buffer_.find(name);
-    if (pr == input_buffer_.end()) {
-      return Status(
-          RequestStatusCode::INTERNAL, "unexpected input '" + name + "'");
-    }
+  if (GetInputOverrideContent(name, content, content_byte_size)) {
+    return Status::Success;
+  }
 
-    auto& input_content = pr->second;
+  const int idx = InputIndex(name);
+  if (idx < 0) {
+    return Status(
+        RequestStatusCode::INTERNAL, "unexpected input '" + name + "'");
+  }
 
-    bool isLastChunk =
-        (input_content.first->BufferAt(
-             input_content.second + 1, content_byte_size) == nullptr);
-    if (!force_contiguous || isLastChunk) {
+  return ReadInputContent(idx, content, content_byte_size, force_contiguous);
+}
+
+Status
+InferRequestProvider::GetNextInputContent(
+    size_t input_idx, const void** content, size_t* content_byte_size,
+    bool force_contiguous)
+{
+  if (*content_byte_size == 0) {
+    *content = nullptr;
+    return Status::Success;
+  }
+
+  if (input_idx >= input_buffer_.size()) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "unexpected input index " + std::to_string(input_idx));
+  }
+
+  // Overrides are keyed by name so only resolve the name when the
+  // request has any.
+  if ((overrides_ != nullptr) &&
+      GetInputOverrideContent(
+          request_header_.input(descriptor_.inputs_[input_idx].request_index_)
+              .name(),
+          content, content_byte_size)) {
+    return Status::Success;
+  }
+
+  return ReadInputContent(
+      input_idx, content, content_byte_size, force_contiguous);
+}
+
+Status
+InferRequestProvider::ReadInputContent(
+    size_t input_idx, const void** content, size_t* content_byte_size,
+    bool force_contiguous)
+{
+  auto& input_content = input_buffer_[input_idx];
+
+  bool isLastChunk =
+      (input_content.first->BufferAt(
+           input_content.second + 1, content_byte_size) == nullptr);
+  if (!force_contiguous || isLastChunk) {
+    *content = input_content.first->BufferAt(
+        input_content.second++, content_byte_size);
+  } else {
+    size_t total_size = 0;
+    size_t start_idx = input_content.second;
+    do {
       *content = input_content.first->BufferAt(
           input_content.second++, content_byte_size);
-    } else {
-      size_t total_size = 0;
-      size_t start_idx = input_content.second;
-      do {
-        *content = input_content.first->BufferAt(
-            input_content.second++, content_byte_size);
-        total_size += *content_byte_size;
-      } while (*content != nullptr);
-
-      contiguous_buffers_.emplace_back();
-      std::vector<char>& buf = contiguous_buffers_.back();
-      buf.reserve(total_size);
-
-      for (size_t i = start_idx; i < input_content.second; i++) {
-        const auto& block = input_content.first->BufferAt(i, content_byte_size);
-        buf.insert(buf.end(), block, block + *content_byte_size);
-      }
+      total_size += *content_byte_size;
+    } while (*content != nullptr);
 
-      if (buf.size() != total_size) {
-        return Status(RequestStatusCode::INTERNAL, "contiguous input failed");
-      }
+    contiguous_buffers_.emplace_back();
+    std::vector<char>& buf = contiguous_buffers_.back();
+    buf.reserve(total_size);
+
+    for (size_t i = start_idx; i < input_content.second; i++) {
+      const auto& block = input_content.first->BufferAt(i, content_byte_size);
+      buf.insert(buf.end(), block, block + *content_byte_size);
+    }
 
-      *content = &(buf[0]);
-      *content_byte_size = total_size;
+    if (buf.size() != total_size) {
+      return Status(RequestStatusCode::INTERNAL, "contiguous input failed");
     }
+
+    *content = &(buf[0]);
+    *content_byte_size = total_size;
   }
 
   return Status::Success;
@@ -218,13 +376,26 @@ Status
 InferRequestProvider::GetSystemMemory(
     const std::string& name, std::shared_ptr<SystemMemory>* input_buffer)
 {
-  auto it = input_buffer_.find(name);
-  if (it == input_buffer_.end()) {
+  const int idx = InputIndex(name);
+  if (idx < 0) {
     return Status(
         RequestStatusCode::INVALID_ARG,
         "input '" + name + "' is not found in the provider");
   }
-  *input_buffer = it->second.first;
+  *input_buffer = input_buffer_[idx].first;
+  return Status::Success;
+}
+
+Status
+InferRequestProvider::GetSystemMemory(
+    size_t input_idx, std::shared_ptr<SystemMemory>* input_buffer)
+{
+  if (input_idx >= input_buffer_.size()) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "unexpected input index " + std::to_string(input_idx));
+  }
+  *input_buffer = input_buffer_[input_idx].first;
   return Status::Success;
 }
 
@@ -262,6 +433,23 @@ NULLInferRequestProvider::GetNextInputContent(
   return Status::Success;
 }
 
+Status
+NULLInferRequestProvider::GetNextInputContent(
+    size_t input_idx, const void** content, size_t* content_byte_size,
+    bool force_contiguous)
+{
+  if (input_idx >= descriptor_.inputs_.size()) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "unexpected input index " + std::to_string(input_idx));
+  }
+
+  return GetNextInputContent(
+      request_header_.input(descriptor_.inputs_[input_idx].request_index_)
+          .name(),
+      content, content_byte_size, force_contiguous);
+}
+
 namespace {
 
 template <typename T>
@@ -360,7 +548,7 @@ InferResponseProvider::CheckAndSetIfBufferedOutput(
   outputs_.emplace_back();
   Output* loutput = &(outputs_.back());
   loutput->name_ = name;
-  loutput->shape_ = content_shape;
+  loutput->shape_.assign(content_shape.begin(), content_shape.end());
   loutput->cls_count_ = 0;
   loutput->ptr_ = nullptr;
   loutput->byte_size_ = content_byte_size;
@@ -548,9 +736,11 @@ InternalInferResponseProvider::Create(
     const std::shared_ptr<LabelProvider>& label_provider,
     std::shared_ptr<InternalInferResponseProvider>* infer_provider)
 {
-  auto provider =
-      new InternalInferResponseProvider(request_header, label_provider);
-  infer_provider->reset(provider);
+  PoolAllocator<InternalInferResponseProvider> alloc;
+  infer_provider->reset(
+      new (alloc.allocate(1))
+          InternalInferResponseProvider(request_header, label_provider),
+      PoolDeleter<InternalInferResponseProvider>(), alloc);
   return Status::Success;
 }
 
@@ -629,12 +819,15 @@ InternalInferResponseProvider::InternalInferResponseProvider(
 Status
 GRPCInferResponseProvider::Create(
     const InferRequestHeader& request_header, InferResponse* response,
+    const RawOutputAllocFn& raw_output_fn,
     const std::shared_ptr<LabelProvider>& label_provider,
     std::shared_ptr<GRPCInferResponseProvider>* infer_provider)
 {
-  GRPCInferResponseProvider* provider =
-      new GRPCInferResponseProvider(request_header, response, label_provider);
-  infer_provider->reset(provider);
+  PoolAllocator<GRPCInferResponseProvider> alloc;
+  infer_provider->reset(
+      new (alloc.allocate(1)) GRPCInferResponseProvider(
+          request_header, response, raw_output_fn, label_provider),
+      PoolDeleter<GRPCInferResponseProvider>(), alloc);
 
   return Status::Success;
 }
@@ -663,11 +856,11 @@ GRPCInferResponseProvider::AllocateOutputBuffer(
   // Must always add a raw output into the list so that the number and
   // order of raw output entries equals the output meta-data. But
   // leave empty if not returning raw result for the output.
-  std::string* raw_output = response_->add_raw_output();
   if (output->ptr_ == nullptr) {
-    raw_output->resize(content_byte_size);
-    *content = static_cast<void*>(&((*raw_output)[0]));
+    *content = raw_output_fn_(content_byte_size);
     output->ptr_ = *content;
+  } else {
+    raw_output_fn_(0);
   }
 
   return Status::Success;
@@ -691,9 +884,11 @@ HTTPInferResponseProvider::Create(
     const std::shared_ptr<LabelProvider>& label_provider,
     std::shared_ptr<HTTPInferResponseProvider>* infer_provider)
 {
-  HTTPInferResponseProvider* provider = new HTTPInferResponseProvider(
-      output_buffer, request_header, label_provider);
-  infer_provider->reset(provider);
+  PoolAllocator<HTTPInferResponseProvider> alloc;
+  infer_provider->reset(
+      new (alloc.allocate(1)) HTTPInferResponseProvider(
+          output_buffer, request_header, label_provider),
+      PoolDeleter<HTTPInferResponseProvider>(), alloc);
 
   return Status::Success;
 }
@@ -770,9 +965,11 @@ DelegatingInferResponseProvider::Create(
     const std::shared_ptr<LabelProvider>& label_provider,
     std::shared_ptr<DelegatingInferResponseProvider>* infer_provider)
 {
-  DelegatingInferResponseProvider* provider =
-      new DelegatingInferResponseProvider(request_header, label_provider);
-  infer_provider->reset(provider);
+  PoolAllocator<DelegatingInferResponseProvider> alloc;
+  infer_provider->reset(
+      new (alloc.allocate(1))
+          DelegatingInferResponseProvider(request_header, label_provider),
+      PoolDeleter<DelegatingInferResponseProvider>(), alloc);
 
   return Status::Success;
 }
@@ -26,9 +26,11 @@
 #pragma once
 
 #include <event2/buffer.h>
+#include <functional>
 #include "src/core/api.pb.h"
 #include "src/core/grpc_service.pb.h"
 #include "src/core/model_config.h"
+#include "src/core/object_pool.h"
 #include "src/core/status.h"
 
 namespace nvidia { namespace inferenceserver {
@@ -71,7 +73,13 @@ class SystemMemoryReference : public SystemMemory {
   size_t AddBuffer(const char* buffer, size_t byte_size);
 
  private:
+  // Most inputs are made of only a few blocks so the first blocks are
+  // stored inline, only inputs with more blocks need to allocate.
+  static constexpr size_t kInlineBlockCount = 4;
+
   using Block = std::pair<const char*, size_t>;
+  size_t block_count_;
+  Block inline_buffer_[kInlineBlockCount];
   std::vector<Block> buffer_;
 };
 
@@ -90,18 +98,82 @@ class AllocatedSystemMemory : public SystemMemory {
   std::unique_ptr<char[]> buffer_;
 };
 
+//
+// A flat description of a normalized inference request. It is built
+// once when the request provider is created so that the schedulers
+// and backends can use it instead of walking the request header.
+//
+struct InferRequestDescriptor {
+  // Inputs with at most this many dimensions have their shape stored
+  // inline.
+  static constexpr size_t kInlineDimsCount = 6;
+
+  struct Input {
+    // The index of the input in the request header.
+    size_t request_index_;
+
+    // The size of the full batch of the input, in bytes.
+    uint64_t batch_byte_size_;
+
+    // The shape of the input, not including the batch dimension.
+    size_t DimsCount() const { return dims_count_; }
+    const int64_t* Dims() const
+    {
+      return (dims_count_ <= kInlineDimsCount) ? inline_dims_ : &dims_[0];
+    }
+    void SetDims(const DimsList& dims);
+
+    size_t dims_count_;
+    int64_t inline_dims_[kInlineDimsCount];
+    std::vector<int64_t> dims_;
+  };
+
+  // Initialize from a 'request_header' that has been normalized for
+  // the model of 'backend'.
+  Status Init(
+      const InferenceBackend& backend,
+      const InferRequestHeader& request_header);
+
+  // Return true if the inputs of 'other' have the same shapes as the
+  // inputs of this request. Both requests must be for the same model.
+  bool SameInputShapes(const InferRequestDescriptor& other) const;
+
+  uint32_t batch_size_;
+  uint32_t flags_;
+  uint64_t correlation_id_;
+
+  // The inputs, indexed by the index of the input in the model
+  // configuration.
+  std::vector<Input, PoolAllocator<Input>> inputs_;
+};
+
 //
 // Provide inference request inputs and meta-data
 //
 class InferRequestProvider {
  public:
+  // Map from input name to the data buffer for that input.
+  using InputBufferMap = std::unordered_map<
+      std::string, std::shared_ptr<SystemMemory>, std::hash<std::string>,
+      std::equal_to<std::string>,
+      PoolAllocator<
+          std::pair<const std::string, std::shared_ptr<SystemMemory>>>>;
+
   // Initialize based on map from input name to data. The 'input_buffer' object
-  // is mapping from input name to data buffer for that input.
+  // is mapping from input name to data buffer for that input. The
+  // request header must be normalized for the model of 'backend'.
   static Status Create(
-      const std::string& model_name, const int64_t model_version,
-      const InferRequestHeader& request_header,
-      const std::unordered_map<std::string, std::shared_ptr<SystemMemory>>&
-          input_buffer,
+      const InferenceBackend& backend, const std::string& model_name,
+      const int64_t model_version, const InferRequestHeader& request_header,
+      const InputBufferMap& input_buffer,
+      std::shared_ptr<InferRequestProvider>* provider);
+
+  // Same as above but takes the content of 'request_header' instead
+  // of copying it. 'request_header' is left unchanged on error.
+  static Status Create(
+      const InferenceBackend& backend, const std::string& model_name,
+      const int64_t model_version, InferRequestHeader&& request_header,
+      const InputBufferMap& input_buffer,
       std::shared_ptr<InferRequestProvider>* provider);
 
   // Return the requested model name.
@@ -116,8 +188,14 @@ class InferRequestProvider {
   // batch-byte-size defined.
   const InferRequestHeader& RequestHeader() const { return request_header_; }
 
+  // Get the flat description of the request header.
+  const InferRequestDescriptor& Descriptor() const { return descriptor_; }
+
   // Get the next contiguous chunk of bytes for the 'name'd
-  // input. Return a pointer to the chunk in 'content'.
+  // input. Backends should use the index-based overload below for
+  // the inputs in the request descriptor and use this one only for
+  // inputs that are known just by name, such as override
+  // inputs. Return a pointer to the chunk in 'content'.
   // 'content_byte_size' acts as both input and output. On input
   // 'content_byte_size' is a hint of the maximum chunk size that
   // should be returned in 'content' and must be non-zero unless no
@@ -131,10 +209,21 @@ class InferRequestProvider {
       const std::string& name, const void** content, size_t* content_byte_size,
       bool force_contiguous);
 
+  // Same as above for the input at 'input_idx' in the request
+  // descriptor, which avoids looking up the input by name.
+  virtual Status GetNextInputContent(
+      size_t input_idx, const void** content, size_t* content_byte_size,
+      bool force_contiguous);
+
   // Retrieve the data buffer of input 'name'.
   Status GetSystemMemory(
       const std::string& name, std::shared_ptr<SystemMemory>* input_buffer);
 
+  // Retrieve the data buffer of the input at 'input_idx' in the
+  // request descriptor.
+  Status GetSystemMemory(
+      size_t input_idx, std::shared_ptr<SystemMemory>* input_buffer);
+
   // Set content for named inputs. If the input already has content,
   // this content will be in-place of existing content.
   struct InputOverride {
@@ -167,6 +256,7 @@ class InferRequestProvider {
   const std::string model_name_;
   const int64_t version_;
   InferRequestHeader request_header_;
+  InferRequestDescriptor descriptor_;
 
   // Input content overrides.
   std::shared_ptr<InputOverrideMap> overrides_;
@@ -181,11 +271,24 @@ class InferRequestProvider {
   // Placeholder for providing buffer as contiguous block.
   std::vector<std::vector<char>> contiguous_buffers_;
 
-  // Map from input name to the content of the input. The content contains
-  // the buffer and index to the next data block for the named input.
-  std::unordered_map<
-      std::string, std::pair<std::shared_ptr<SystemMemory>, size_t>>
+  // The content of each input, indexed in the same way as the inputs
+  // of the descriptor. The content contains the buffer and index to
+  // the next data block for the input.
+  std::vector<
+      std::pair<std::shared_ptr<SystemMemory>, size_t>,
+      PoolAllocator<std::pair<std::shared_ptr<SystemMemory>, size_t>>>
       input_buffer_;
+
+ private:
+  // Return the index in the descriptor of the input 'name', or -1 if
+  // the request has no such input.
+  int InputIndex(const std::string& name) const;
+
+  // Read the next content of the input at 'input_idx' from the
+  // request, ignoring any overrides.
+  Status ReadInputContent(
+      size_t input_idx, const void** content, size_t* content_byte_size,
+      bool force_contiguous);
 };
 
 //
@@ -196,15 +299,21 @@ class InferRequestProvider {
 //
 class NULLInferRequestProvider : public InferRequestProvider {
  public:
-  explicit NULLInferRequestProvider(const InferRequestHeader& request_header)
+  NULLInferRequestProvider(
+      const InferRequestHeader& request_header,
+      const InferRequestDescriptor& descriptor)
       : InferRequestProvider("<NULL>", -1)
   {
     request_header_ = request_header;
+    descriptor_ = descriptor;
   }
 
   Status GetNextInputContent(
       const std::string& name, const void** content, size_t* content_byte_size,
       bool force_contiguous) override;
+  Status GetNextInputContent(
+      size_t input_idx, const void** content, size_t* content_byte_size,
+      bool force_contiguous) override;
 
  private:
   // A buffer of zero bytes that is used commonly as the NULL input.
@@ -283,13 +392,17 @@ class InferResponseProvider {
 
   // Map from output name to the InferRequestHeader output information
   // for that output.
-  std::unordered_map<std::string, const InferRequestHeader::Output*>
+  std::unordered_map<
+      std::string, const InferRequestHeader::Output*, std::hash<std::string>,
+      std::equal_to<std::string>,
+      PoolAllocator<
+          std::pair<const std::string, const InferRequestHeader::Output*>>>
       output_map_;
 
   // Information about each output.
   struct Output {
     std::string name_;
-    std::vector<int64_t> shape_;
+    std::vector<int64_t, PoolAllocator<int64_t>> shape_;
     size_t cls_count_;
     void* ptr_;
     size_t byte_size_;
@@ -299,7 +412,7 @@ class InferResponseProvider {
   };
 
   // Ordered list of outputs as they "added" by AllocateOutputBuffer().
-  std::vector<Output> outputs_;
+  std::vector<Output, PoolAllocator<Output>> outputs_;
 
   // label provider used to generate classification results.
   std::shared_ptr<LabelProvider> label_provider_;
@@ -346,9 +459,18 @@ class InternalInferResponseProvider : public InferResponseProvider {
 //
 class GRPCInferResponseProvider : public InferResponseProvider {
  public:
-  // Initialize based on gRPC request
+  // Function called to allocate the raw output data for each output,
+  // in the order the outputs are added to the response meta-data.
+  // Must return a buffer of 'byte_size' bytes that remains valid
+  // until the response is sent.
+  using RawOutputAllocFn = std::function<void*(size_t byte_size)>;
+
+  // Initialize based on gRPC request. The response meta-data is
+  // written to 'response' and raw output data is allocated with
+  // 'raw_output_fn' so that it can be sent without copying.
   static Status Create(
       const InferRequestHeader& request_header, InferResponse* response,
+      const RawOutputAllocFn& raw_output_fn,
       const std::shared_ptr<LabelProvider>& label_provider,
       std::shared_ptr<GRPCInferResponseProvider>* infer_provider);
 
@@ -361,13 +483,15 @@ class GRPCInferResponseProvider : public InferResponseProvider {
  private:
   GRPCInferResponseProvider(
       const InferRequestHeader& request_header, InferResponse* response,
+      const RawOutputAllocFn& raw_output_fn,
       const std::shared_ptr<LabelProvider>& label_provider)
       : InferResponseProvider(request_header, label_provider),
-        response_(response)
+        response_(response), raw_output_fn_(raw_output_fn)
   {
   }
 
   InferResponse* response_;
+  RawOutputAllocFn raw_output_fn_;
 };
 
 //
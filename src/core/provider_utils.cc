@@ -32,6 +32,7 @@
 #include "src/core/logging.h"
 #include "src/core/model_config.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/object_pool.h"
 
 namespace nvidia { namespace inferenceserver {
 
@@ -179,7 +180,7 @@ Status
 EVBufferToInputMap(
     const std::string& model_name, const InferRequestHeader& request_header,
     evbuffer* input_buffer,
-    std::unordered_map<std::string, std::shared_ptr<SystemMemory>>& input_map)
+    InferRequestProvider::InputBufferMap& input_map)
 {
   // Now need to create 'ref'. Each input has one entry in
   // SystemMemory which gives a list of all the blocks of data for that
@@ -206,7 +207,8 @@ EVBufferToInputMap(
   // Get the byte-size for each input and from that get the blocks
   // holding the data for that input
   for (const auto& io : request_header.input()) {
-    auto memory_ref = std::make_shared<SystemMemoryReference>();
+    auto memory_ref = std::allocate_shared<SystemMemoryReference>(
+        PoolAllocator<SystemMemoryReference>());
     input_map.emplace(std::make_pair(
         io.name(), std::static_pointer_cast<SystemMemory>(memory_ref)));
 
@@ -248,38 +250,35 @@ EVBufferToInputMap(
 Status
 GRPCInferRequestToInputMap(
     const InferRequestHeader& request_header, const InferRequest& request,
-    std::unordered_map<std::string, std::shared_ptr<SystemMemory>>& input_map)
+    const std::vector<std::shared_ptr<SystemMemory>>& raw_inputs,
+    InferRequestProvider::InputBufferMap& input_map)
 {
   // Make sure that the request is providing the same number of raw
   // input tensor data.
-  if (request_header.input_size() != request.raw_input_size()) {
+  if ((size_t)request_header.input_size() != raw_inputs.size()) {
     return Status(
         RequestStatusCode::INVALID_ARG,
         "expected tensor data for " +
             std::to_string(request_header.input_size()) + " inputs but got " +
-            std::to_string(request.raw_input_size()) +
-            " sets of data for model '" + request.model_name() + "'");
+            std::to_string(raw_inputs.size()) + " sets of data for model '" +
+            request.model_name() + "'");
   }
 
   // Verify that the batch-byte-size of each input matches the size of
   // the provided raw tensor data.
   size_t idx = 0;
   for (const auto& io : request_header.input()) {
-    auto memory_ref = std::make_shared<SystemMemoryReference>();
-    input_map.emplace(std::make_pair(
-        io.name(), std::static_pointer_cast<SystemMemory>(memory_ref)));
-
-    if (io.batch_byte_size() != request.raw_input(idx).size()) {
+    const std::shared_ptr<SystemMemory>& raw = raw_inputs[idx++];
+    if (io.batch_byte_size() != raw->TotalByteSize()) {
       return Status(
           RequestStatusCode::INVALID_ARG,
-          "unexpected size " + std::to_string(request.raw_input(idx).size()) +
+          "unexpected size " + std::to_string(raw->TotalByteSize()) +
               " for input '" + io.name() + "', expecting " +
               std::to_string(io.batch_byte_size()) + " for model '" +
               request.model_name() + "'");
     }
 
-    const std::string& raw = request.raw_input(idx++);
-    memory_ref->AddBuffer(raw.c_str(), raw.size());
+    input_map.emplace(std::make_pair(io.name(), raw));
   }
   return Status::Success;
 }
@@ -43,11 +43,15 @@ Status NormalizeRequestHeader(
 Status EVBufferToInputMap(
     const std::string& model_name,
     const InferRequestHeader& normalized_request_header, evbuffer* input_buffer,
-    std::unordered_map<std::string, std::shared_ptr<SystemMemory>>& input_map);
+    InferRequestProvider::InputBufferMap& input_map);
 
+// Map the raw input tensors of a GRPC request to the inputs in the
+// request header. 'raw_inputs' are the tensors in the order they
+// appear in the request's 'raw_input'.
 Status GRPCInferRequestToInputMap(
     const InferRequestHeader& normalized_request_header,
     const InferRequest& request,
-    std::unordered_map<std::string, std::shared_ptr<SystemMemory>>& input_map);
+    const std::vector<std::shared_ptr<SystemMemory>>& raw_inputs,
+    InferRequestProvider::InputBufferMap& input_map);
 
 }}  // namespace nvidia::inferenceserver
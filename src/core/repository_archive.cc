@@ -0,0 +1,336 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/repository_archive.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "src/core/filesystem.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+// The archive header. All integers are stored in host byte order.
+constexpr char kArchiveMagic[8] = {'T', 'R', 'T', 'I', 'S', 'R', 'E', 'P'};
+constexpr uint32_t kArchiveVersion = 1;
+
+struct ArchiveHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t entry_cnt_;
+  uint64_t index_offset_;
+  uint64_t index_byte_size_;
+};
+
+// Each entry of the index is an IndexEntry followed by 'path_len_'
+// bytes of path.
+struct IndexEntry {
+  uint32_t path_len_;
+  uint32_t is_dir_;
+  uint64_t offset_;
+  uint64_t byte_size_;
+  int64_t mtime_ns_;
+};
+
+// File contents are aligned to this boundary.
+constexpr uint64_t kBlobAlignment = 4096;
+
+uint64_t
+AlignedOffset(uint64_t offset)
+{
+  return ((offset + kBlobAlignment - 1) / kBlobAlignment) * kBlobAlignment;
+}
+
+std::string
+ParentPath(const std::string& rel_path)
+{
+  const size_t slash = rel_path.rfind('/');
+  return (slash == std::string::npos) ? std::string()
+                                      : rel_path.substr(0, slash);
+}
+
+std::string
+EntryName(const std::string& rel_path)
+{
+  const size_t slash = rel_path.rfind('/');
+  return (slash == std::string::npos) ? rel_path : rel_path.substr(slash + 1);
+}
+
+// Append every file and directory under 'rel_path' of the repository
+// at 'root' to 'paths', parents before their contents.
+Status
+CollectPaths(
+    const std::string& root, const std::string& rel_path,
+    std::vector<std::pair<std::string, bool>>* paths)
+{
+  const std::string path =
+      rel_path.empty() ? root : JoinPath({root, rel_path});
+
+  std::set<std::string> contents;
+  RETURN_IF_ERROR(GetDirectoryContents(path, &contents));
+  for (const auto& name : contents) {
+    const std::string child =
+        rel_path.empty() ? name : JoinPath({rel_path, name});
+    bool is_dir;
+    RETURN_IF_ERROR(IsDirectory(JoinPath({root, child}), &is_dir));
+    paths->emplace_back(child, is_dir);
+    if (is_dir) {
+      RETURN_IF_ERROR(CollectPaths(root, child, paths));
+    }
+  }
+
+  return Status::Success;
+}
+
+}  // namespace
+
+Status
+RepositoryArchive::IsArchive(const std::string& path, bool* is_archive)
+{
+  *is_archive = false;
+
+  struct stat st;
+  if ((stat(path.c_str(), &st) != 0) || !S_ISREG(st.st_mode)) {
+    return Status::Success;
+  }
+
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  char magic[sizeof(kArchiveMagic)];
+  if (in.read(magic, sizeof(magic))) {
+    *is_archive = (memcmp(magic, kArchiveMagic, sizeof(magic)) == 0);
+  }
+
+  return Status::Success;
+}
+
+Status
+RepositoryArchive::Open(
+    const std::string& path, std::unique_ptr<RepositoryArchive>* archive)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to open repository archive " + path + ": " + strerror(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return Status(
+        RequestStatusCode::INTERNAL,
+        "failed to stat repository archive " + path);
+  }
+
+  std::unique_ptr<RepositoryArchive> local_archive(new RepositoryArchive);
+  if (st.st_size > 0) {
+    void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+      close(fd);
+      return Status(
+          RequestStatusCode::INTERNAL,
+          "failed to map repository archive " + path + ": " + strerror(errno));
+    }
+
+    local_archive->base_ = static_cast<const char*>(base);
+    local_archive->byte_size_ = st.st_size;
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+
+  RETURN_IF_ERROR(local_archive->ParseIndex(path));
+
+  *archive = std::move(local_archive);
+  return Status::Success;
+}
+
+RepositoryArchive::~RepositoryArchive()
+{
+  if (base_ != nullptr) {
+    munmap(const_cast<char*>(base_), byte_size_);
+  }
+}
+
+Status
+RepositoryArchive::ParseIndex(const std::string& path)
+{
+  ArchiveHeader header;
+  if (byte_size_ < sizeof(header)) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "repository archive " + path + " is truncated");
+  }
+
+  memcpy(&header, base_, sizeof(header));
+  if ((memcmp(header.magic_, kArchiveMagic, sizeof(kArchiveMagic)) != 0) ||
+      (header.version_ != kArchiveVersion)) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        path + " is not a supported repository archive");
+  }
+
+  if ((header.index_offset_ > byte_size_) ||
+      (header.index_byte_size_ > (byte_size_ - header.index_offset_))) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "repository archive " + path + " is truncated");
+  }
+
+  // The root directory is implicit.
+  entries_.emplace(std::string(), Entry{true, 0, 0, 0});
+  contents_[std::string()];
+
+  const char* pos = base_ + header.index_offset_;
+  const char* end = pos + header.index_byte_size_;
+  for (uint32_t i = 0; i < header.entry_cnt_; ++i) {
+    IndexEntry ientry;
+    if ((size_t)(end - pos) < sizeof(ientry)) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "repository archive " + path + " has a corrupt index");
+    }
+    memcpy(&ientry, pos, sizeof(ientry));
+    pos += sizeof(ientry);
+
+    if (((size_t)(end - pos) < ientry.path_len_) ||
+        (ientry.offset_ > byte_size_) ||
+        (ientry.byte_size_ > (byte_size_ - ientry.offset_))) {
+      return Status(
+          RequestStatusCode::INVALID_ARG,
+          "repository archive " + path + " has a corrupt index");
+    }
+
+    const std::string rel_path(pos, ientry.path_len_);
+    pos += ientry.path_len_;
+
+    const std::string parent = ParentPath(rel_path);
+    auto pitr = contents_.find(parent);
+    if (rel_path.empty() || (pitr == contents_.end())) {
+      return Status(
+          RequestStatusCode::INVALID_ARG, "repository archive " + path +
+                                              " has unexpected entry '" +
+                                              rel_path + "'");
+    }
+
+    pitr->second.insert(EntryName(rel_path));
+    entries_.emplace(
+        rel_path, Entry{ientry.is_dir_ != 0, ientry.offset_, ientry.byte_size_,
+                        ientry.mtime_ns_});
+    if (ientry.is_dir_ != 0) {
+      contents_[rel_path];
+    }
+  }
+
+  return Status::Success;
+}
+
+const RepositoryArchive::Entry*
+RepositoryArchive::Find(const std::string& rel_path) const
+{
+  const auto itr = entries_.find(rel_path);
+  return (itr == entries_.end()) ? nullptr : &itr->second;
+}
+
+const std::set<std::string>*
+RepositoryArchive::Contents(const std::string& rel_path) const
+{
+  const auto itr = contents_.find(rel_path);
+  return (itr == contents_.end()) ? nullptr : &itr->second;
+}
+
+Status
+RepositoryArchive::Write(
+    const std::string& repository_path, const std::string& archive_path)
+{
+  std::vector<std::pair<std::string, bool>> paths;
+  RETURN_IF_ERROR(CollectPaths(repository_path, std::string(), &paths));
+
+  std::ofstream out(archive_path, std::ios::out | std::ios::binary);
+  if (!out) {
+    return Status(
+        RequestStatusCode::INTERNAL, "failed to open " + archive_path +
+                                         " for write: " + strerror(errno));
+  }
+
+  // Write the file contents, recording where each one is placed,
+  // then the index, and finally the header that locates the index.
+  std::string index;
+  uint64_t offset = kBlobAlignment;
+  for (const auto& pr : paths) {
+    const std::string& rel_path = pr.first;
+    const std::string path = JoinPath({repository_path, rel_path});
+
+    IndexEntry ientry;
+    ientry.path_len_ = rel_path.size();
+    ientry.is_dir_ = pr.second ? 1 : 0;
+    ientry.offset_ = 0;
+    ientry.byte_size_ = 0;
+    RETURN_IF_ERROR(FileModificationTime(path, &ientry.mtime_ns_));
+
+    if (!pr.second) {
+      std::string contents;
+      RETURN_IF_ERROR(ReadTextFile(path, &contents));
+
+      out.seekp(offset);
+      out.write(contents.data(), contents.size());
+      ientry.offset_ = offset;
+      ientry.byte_size_ = contents.size();
+      offset = AlignedOffset(offset + contents.size());
+    }
+
+    index.append(reinterpret_cast<const char*>(&ientry), sizeof(ientry));
+    index.append(rel_path);
+  }
+
+  ArchiveHeader header;
+  memcpy(header.magic_, kArchiveMagic, sizeof(kArchiveMagic));
+  header.version_ = kArchiveVersion;
+  header.entry_cnt_ = paths.size();
+  header.index_offset_ = offset;
+  header.index_byte_size_ = index.size();
+
+  out.seekp(offset);
+  out.write(index.data(), index.size());
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.close();
+
+  if (!out) {
+    return Status(
+        RequestStatusCode::INTERNAL, "failed to write " + archive_path);
+  }
+
+  return Status::Success;
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,92 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+//
+// A model repository packed into a single file. The archive starts
+// with a header, followed by the contents of every file in the
+// repository, each aligned to a page boundary, and ends with an
+// index that records the path, kind, location and modification time
+// of every file and directory. The archive is memory-mapped so that
+// reading the repository needs no per-file metadata I/O.
+//
+class RepositoryArchive {
+ public:
+  // A file or directory in the archive.
+  struct Entry {
+    bool is_dir_;
+    uint64_t offset_;
+    uint64_t byte_size_;
+    int64_t mtime_ns_;
+  };
+
+  // Map the archive at 'path'.
+  static Status Open(
+      const std::string& path, std::unique_ptr<RepositoryArchive>* archive);
+
+  // Return true in 'is_archive' if 'path' is a local file that starts
+  // with the archive header.
+  static Status IsArchive(const std::string& path, bool* is_archive);
+
+  // Pack the model repository at 'repository_path' into a new archive
+  // at 'archive_path'.
+  static Status Write(
+      const std::string& repository_path, const std::string& archive_path);
+
+  ~RepositoryArchive();
+
+  // Return the entry for 'rel_path', a path relative to the root of
+  // the repository, or nullptr if there is no such entry. The root
+  // itself is the empty path.
+  const Entry* Find(const std::string& rel_path) const;
+
+  // Return the names of the entries in directory 'rel_path', or
+  // nullptr if 'rel_path' is not a directory.
+  const std::set<std::string>* Contents(const std::string& rel_path) const;
+
+  // Return the contents of file 'entry'.
+  const char* Data(const Entry& entry) const { return base_ + entry.offset_; }
+
+ private:
+  RepositoryArchive() : base_(nullptr), byte_size_(0) {}
+  Status ParseIndex(const std::string& path);
+
+  const char* base_;
+  size_t byte_size_;
+
+  std::unordered_map<std::string, Entry> entries_;
+  std::unordered_map<std::string, std::set<std::string>> contents_;
+};
+
+}}  // namespace nvidia::inferenceserver
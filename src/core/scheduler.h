@@ -100,6 +100,23 @@ class Scheduler {
       const std::shared_ptr<InferRequestProvider>& request_provider,
       const std::shared_ptr<InferResponseProvider>& response_provider,
       std::function<void(Status)> OnComplete) = 0;
+
+  // Add the current scheduling status of each model instance used by
+  // the scheduler to 'status'. By default nothing is reported.
+  virtual void GetInstanceStatus(ModelVersionStatus* status) {}
+
+  // Apply the scheduling settings of 'config' to the running
+  // scheduler without interrupting the requests already enqueued.
+  // 'config' must differ from the configuration the scheduler was
+  // created with only in scheduler settings, see
+  // IsSchedulerOnlyChange(). By default reconfiguration is not
+  // supported.
+  virtual Status Reconfigure(const ModelConfig& config)
+  {
+    return Status(
+        RequestStatusCode::UNSUPPORTED,
+        "scheduler does not support reconfiguration");
+  }
 };
 
 }}  // namespace nvidia::inferenceserver
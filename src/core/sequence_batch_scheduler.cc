@@ -33,6 +33,7 @@
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/object_pool.h"
 #include "src/core/provider.h"
 #include "src/core/server_status.h"
 
@@ -60,9 +61,13 @@ SequenceBatchScheduler::Create(
   sched->max_sequence_idle_microseconds_ =
       config.sequence_batching().max_sequence_idle_microseconds();
 
+  sched->slot_assignment_ = config.sequence_batching().slot_assignment();
+
   // Get the batch size to allow for each runner. This is at least 1
   // even if the model doesn't support batching.
   size_t batch_size = std::max(1, config.max_batch_size());
+  sched->batch_size_ = batch_size;
+  sched->ready_batch_slots_.resize(runner_cnt);
 
   // Based on the model configuration create input tensors for control
   // signals indicating sequence start, sequence continue, and
@@ -86,7 +91,7 @@ SequenceBatchScheduler::Create(
       sched->batchers_.push_back(sb);
       // All slots in the batch are initially ready for a new sequence.
       for (size_t b = 0; b < batch_size; ++b) {
-        sched->ready_batch_slots_.push(SequenceBatchScheduler::BatchSlot(c, b));
+        sched->ready_batch_slots_[c].insert(b);
       }
     }
   }
@@ -113,7 +118,7 @@ SequenceBatchScheduler::~SequenceBatchScheduler()
 {
   // Signal the reaper thread to exit...
   {
-    std::unique_lock<std::mutex> lock(mu_);
+    std::unique_lock<std::mutex> lock(reaper_mu_);
     reaper_thread_exit_ = true;
   }
 
@@ -234,12 +239,12 @@ SequenceBatchScheduler::Enqueue(
       new ModelInferStats::ScopedTimer());
   stats->StartQueueTimer(queue_timer.get());
 
-  const auto& request_header = request_provider->RequestHeader();
+  const InferRequestDescriptor& descriptor = request_provider->Descriptor();
 
   // For now the request must have batch-size 1 since the sequence
   // batcher does not yet support requests that are statically
   // batched.
-  if (request_header.batch_size() != 1) {
+  if (descriptor.batch_size_ != 1) {
     OnComplete(Status(
         RequestStatusCode::INVALID_ARG,
         "inference request to model '" + request_provider->ModelName() +
@@ -251,7 +256,7 @@ SequenceBatchScheduler::Enqueue(
   // A request must have a correlation ID to be processed correctly by
   // this scheduler. A value of 0 (zero) indicates that the request
   // doesn't have a correlation ID.
-  const CorrelationID correlation_id = request_header.correlation_id();
+  const CorrelationID correlation_id = descriptor.correlation_id_;
   if (correlation_id == 0) {
     OnComplete(Status(
         RequestStatusCode::INVALID_ARG,
@@ -260,25 +265,35 @@ SequenceBatchScheduler::Enqueue(
     return;
   }
 
-  BatchSlot* target = nullptr;
-
   const bool seq_start =
-      ((request_header.flags() & InferRequestHeader::FLAG_SEQUENCE_START) != 0);
+      ((descriptor.flags_ & InferRequestHeader::FLAG_SEQUENCE_START) != 0);
   const bool seq_end =
-      ((request_header.flags() & InferRequestHeader::FLAG_SEQUENCE_END) != 0);
+      ((descriptor.flags_ & InferRequestHeader::FLAG_SEQUENCE_END) != 0);
+
+  // Get the timestamp of this request before acquiring any lock so
+  // that the time spent in the critical section is as short as
+  // possible.
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t now_us = (now.tv_sec * NANOS_PER_SECOND + now.tv_nsec) / 1000;
 
-  std::unique_lock<std::mutex> lock(mu_);
+  // All state for the correlation ID is held in a single shard so
+  // only that shard needs to be locked to find the target of the
+  // request.
+  CorrelationShard& shard = ShardFor(correlation_id);
+  std::unique_lock<std::mutex> shard_lock(shard.mu_);
 
-  auto sb_itr = sequence_to_batchslot_map_.find(correlation_id);
-  auto bl_itr = sequence_to_backlog_map_.find(correlation_id);
+  auto sb_itr = shard.sequence_to_batchslot_map_.find(correlation_id);
+  auto bl_itr = shard.sequence_to_backlog_map_.find(correlation_id);
 
   // If this request is not starting a new sequence its correlation ID
   // should already be known with a target in either a slot or in the
   // backlog. If it doesn't then the sequence wasn't started correctly
   // or there has been a correlation ID conflict. In either case fail
   // this request.
-  if (!seq_start && (sb_itr == sequence_to_batchslot_map_.end()) &&
-      (bl_itr == sequence_to_backlog_map_.end())) {
+  if (!seq_start && (sb_itr == shard.sequence_to_batchslot_map_.end()) &&
+      (bl_itr == shard.sequence_to_backlog_map_.end())) {
+    shard_lock.unlock();
     OnComplete(Status(
         RequestStatusCode::INVALID_ARG,
         "inference request for sequence " + std::to_string(correlation_id) +
@@ -293,12 +308,7 @@ SequenceBatchScheduler::Enqueue(
   // max_sequence_idle_microseconds value is not exceed for any
   // sequence, and if it is it will release the slot (if any)
   // allocated to that sequence.
-  {
-    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    uint64_t now_us = (now.tv_sec * NANOS_PER_SECOND + now.tv_nsec) / 1000;
-    correlation_id_timestamps_[correlation_id] = now_us;
-  }
+  shard.correlation_id_timestamps_[correlation_id] = now_us;
 
   // If this request starts a new sequence but the correlation ID
   // already has an in-progress sequence then that previous sequence
@@ -308,8 +318,8 @@ SequenceBatchScheduler::Enqueue(
   // long as it has a single end. The previous sequence that was not
   // correctly ended will have its existing requests handled and then
   // the new sequence will start.
-  if (seq_start && ((sb_itr != sequence_to_batchslot_map_.end()) ||
-                    (bl_itr != sequence_to_backlog_map_.end()))) {
+  if (seq_start && ((sb_itr != shard.sequence_to_batchslot_map_.end()) ||
+                    (bl_itr != shard.sequence_to_backlog_map_.end()))) {
     LOG_WARNING
         << "sequence " << correlation_id << " for model '"
         << request_provider->ModelName()
@@ -317,12 +327,14 @@ SequenceBatchScheduler::Enqueue(
            "sequence start. Previous sequence will be terminated early.";
   }
 
+  BatchSlot target;
+
   // This request already has an assigned slot...
-  if (sb_itr != sequence_to_batchslot_map_.end()) {
-    target = &sb_itr->second;
+  if (sb_itr != shard.sequence_to_batchslot_map_.end()) {
+    target = sb_itr->second;
   }
   // This request already has a queue in the backlog...
-  else if (bl_itr != sequence_to_backlog_map_.end()) {
+  else if (bl_itr != shard.sequence_to_backlog_map_.end()) {
     LOG_VERBOSE(1)
         << "Enqueuing sequence inference request into backlog for model '"
         << request_provider->ModelName();
@@ -334,95 +346,129 @@ SequenceBatchScheduler::Enqueue(
     // with the same correlation ID it will be collected in another
     // backlog queue.
     if (seq_end) {
-      sequence_to_backlog_map_.erase(bl_itr);
+      shard.sequence_to_backlog_map_.erase(bl_itr);
     }
     return;
   }
   // This request does not have an assigned backlog or slot. By the
   // above checks it must be starting. If there is a free slot
-  // available then assign this sequence to that slot...
-  else if (!ready_batch_slots_.empty()) {
-    target = &sequence_to_batchslot_map_[correlation_id];
-    *target = ready_batch_slots_.top();
-    ready_batch_slots_.pop();
-  }
-  // Last option is to assign this request to the backlog...
+  // available then assign this sequence to that slot, otherwise the
+  // last option is to assign this request to the backlog. The
+  // scheduler lock is held (in addition to the shard lock) only for
+  // this case.
   else {
-    LOG_VERBOSE(1)
-        << "Enqueuing sequence inference request into new backlog for model '"
-        << request_provider->ModelName();
-
-    auto backlog = std::make_shared<std::deque<Scheduler::Payload>>();
-    backlog_queues_.push_back(backlog);
-    backlog->emplace_back(
-        queue_timer, stats, request_provider, response_provider, OnComplete);
-    if (!seq_end) {
-      sequence_to_backlog_map_[correlation_id] = std::move(backlog);
+    std::lock_guard<std::mutex> lock(mu_);
+    if (ClaimReadyBatchSlot(&target)) {
+      if (!seq_end) {
+        shard.sequence_to_batchslot_map_[correlation_id] = target;
+      }
+    } else {
+      LOG_VERBOSE(1) << "Enqueuing sequence inference request into new "
+                        "backlog for model '"
+                     << request_provider->ModelName();
+
+      auto backlog = std::make_shared<std::deque<Scheduler::Payload>>();
+      backlog->emplace_back(
+          queue_timer, stats, request_provider, response_provider, OnComplete);
+      backlog_queues_.emplace_back(correlation_id, backlog);
+      if (!seq_end) {
+        shard.sequence_to_backlog_map_[correlation_id] = std::move(backlog);
+      }
+      return;
     }
-    return;
   }
 
-  // Need to grab the target contents before the erase below since
-  // that can free it.
-  const size_t batcher_idx = target->batcher_idx_;
-  const uint32_t slot = target->slot_;
-
   // At this point the request has been assigned to a slot. If the
   // sequence is ending then stop tracking the correlation.
   if (seq_end) {
-    sequence_to_batchslot_map_.erase(correlation_id);
+    shard.sequence_to_batchslot_map_.erase(correlation_id);
   }
 
   // Enqueue request into batcher and slot.  No need to hold the lock
-  // while enqueuing in a specific batcher.
-  lock.unlock();
+  // while enqueuing in a specific batcher, but the slot must not be
+  // compacted until the request is in the slot's queue.
+  const std::shared_ptr<SequenceBatch>& batcher =
+      batchers_[target.batcher_idx_];
+  batcher->BeginPendingEnqueue(target.slot_);
+  shard_lock.unlock();
 
   LOG_VERBOSE(1) << "Enqueuing sequence inference request for model '"
                  << request_provider->ModelName() << "' into batcher "
-                 << batcher_idx << ", slot " << slot;
+                 << target.batcher_idx_ << ", slot " << target.slot_;
 
-  batchers_[batcher_idx]->Enqueue(
-      slot, correlation_id, queue_timer, stats, request_provider,
+  batcher->Enqueue(
+      target.slot_, correlation_id, queue_timer, stats, request_provider,
       response_provider, OnComplete);
+  batcher->EndPendingEnqueue(target.slot_);
 }
 
 bool
 SequenceBatchScheduler::ReleaseBatchSlot(
     const BatchSlot& batch_slot, std::deque<Scheduler::Payload>* payloads)
 {
-  std::unique_lock<std::mutex> lock(mu_);
+  // If there is a backlogged sequence return it so that it can use
+  // the newly available slot. The shard of the backlogged sequence
+  // must be locked before the scheduler lock, so peek at the backlog
+  // to find the shard and then confirm that the same backlog is still
+  // at the front once both locks are held.
+  while (true) {
+    CorrelationID correlation_id;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+
+      // There is no backlogged sequence so just release the batch
+      // slot. This must be done while holding the lock so that a
+      // sequence can't be added to the backlog after the check but
+      // before the slot is made available.
+      if (backlog_queues_.empty()) {
+        LOG_VERBOSE(1) << "Freeing slot in batcher "
+                       << batch_slot.batcher_idx_ << ", slot "
+                       << batch_slot.slot_;
+        ready_batch_slots_[batch_slot.batcher_idx_].insert(batch_slot.slot_);
+        return true;
+      }
 
-  // If there is a backlogged sequence and it is requested, return it
-  // so that it can use the newly available slot.
-  if (!backlog_queues_.empty()) {
-    auto& backlog = backlog_queues_.front();
-    *payloads = std::move(*backlog);
+      correlation_id = backlog_queues_.front().correlation_id_;
+    }
+
+    CorrelationShard& shard = ShardFor(correlation_id);
+    std::lock_guard<std::mutex> shard_lock(shard.mu_);
+    std::unique_lock<std::mutex> lock(mu_);
+
+    if (backlog_queues_.empty() ||
+        (backlog_queues_.front().correlation_id_ != correlation_id)) {
+      continue;
+    }
+
+    auto backlog = std::move(backlog_queues_.front().queue_);
     backlog_queues_.pop_front();
+    lock.unlock();
+
+    *payloads = std::move(*backlog);
     if (!payloads->empty()) {  // should never be empty...
       const auto& request_provider = payloads->back().request_provider_;
-      const auto& request_header = request_provider->RequestHeader();
-      const CorrelationID correlation_id = request_header.correlation_id();
+      const InferRequestDescriptor& descriptor =
+          request_provider->Descriptor();
 
       // If the last queue entry is not an END request then the entire
       // sequence is not contained in the backlog. In that case must
       // update backlog and batchslot maps so that future requests get
       // directed to the batch slot instead of the backlog.
       const bool seq_end =
-          ((request_header.flags() & InferRequestHeader::FLAG_SEQUENCE_END) !=
-           0);
+          ((descriptor.flags_ & InferRequestHeader::FLAG_SEQUENCE_END) != 0);
       if (!seq_end) {
         // Since the correlation ID is being actively collected in the
         // backlog, there should not be any in-flight sequences with
         // that same correlation ID that have an assigned slot.
-        if (sequence_to_batchslot_map_.find(correlation_id) !=
-            sequence_to_batchslot_map_.end()) {
+        if (shard.sequence_to_batchslot_map_.find(correlation_id) !=
+            shard.sequence_to_batchslot_map_.end()) {
           LOG_ERROR << "internal: backlog sequence " << correlation_id
                     << " conflicts with in-flight sequence for model '"
                     << request_provider->ModelName() << "'";
         }
 
-        sequence_to_backlog_map_.erase(correlation_id);
-        sequence_to_batchslot_map_[correlation_id] = batch_slot;
+        shard.sequence_to_backlog_map_.erase(correlation_id);
+        shard.sequence_to_batchslot_map_[correlation_id] = batch_slot;
       }
 
       LOG_VERBOSE(1) << "Reusing slot in batcher " << batch_slot.batcher_idx_
@@ -431,12 +477,123 @@ SequenceBatchScheduler::ReleaseBatchSlot(
       return false;
     }
   }
+}
+
+bool
+SequenceBatchScheduler::ClaimReadyBatchSlot(BatchSlot* batch_slot)
+{
+  // 'mu_' must be held when this function is called.
+
+  bool found = false;
+  size_t best_batcher_idx = 0;
+  uint32_t best_slot = 0;
+  uint64_t best_load = 0;
+
+  for (size_t b = 0; b < ready_batch_slots_.size(); ++b) {
+    const auto& ready_slots = ready_batch_slots_[b];
+    if (ready_slots.empty()) {
+      continue;
+    }
+
+    const uint32_t slot = *ready_slots.begin();
+
+    // SLOT_ASSIGNMENT_LOWEST: the lowest slot number. Ties go to the
+    // lowest batcher.
+    //
+    // SLOT_ASSIGNMENT_LEAST_LOADED: the number of active slots that
+    // the batcher would have after accepting the sequence plus the
+    // number of requests waiting for or in execution in the
+    // batcher. A slower batcher drains its requests more slowly and
+    // so looks more loaded. Ties go to the lowest slot.
+    uint64_t load = slot;
+    if (slot_assignment_ ==
+        ModelSequenceBatching::SLOT_ASSIGNMENT_LEAST_LOADED) {
+      load = (batch_size_ - ready_slots.size() + 1) +
+             batchers_[b]->InflightCount();
+    }
+
+    if (!found || (load < best_load) ||
+        ((load == best_load) && (slot < best_slot))) {
+      found = true;
+      best_batcher_idx = b;
+      best_slot = slot;
+      best_load = load;
+    }
+  }
+
+  if (found) {
+    ready_batch_slots_[best_batcher_idx].erase(best_slot);
+    *batch_slot = BatchSlot(best_batcher_idx, best_slot);
+  }
 
-  // There is no backlogged sequence so just release the batch slot
-  LOG_VERBOSE(1) << "Freeing slot in batcher " << batch_slot.batcher_idx_
-                 << ", slot " << batch_slot.slot_;
+  return found;
+}
+
+void
+SequenceBatchScheduler::GetInstanceStatus(ModelVersionStatus* status)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+  for (size_t b = 0; b < ready_batch_slots_.size(); ++b) {
+    ModelInstanceStatus* instance_status = status->add_instance_status();
+    instance_status->set_slot_count(batch_size_);
+    instance_status->set_active_slot_count(
+        batch_size_ - ready_batch_slots_[b].size());
+    if (b < batchers_.size()) {
+      instance_status->set_recent_execution_time_ns(
+          batchers_[b]->RecentExecutionNs());
+    }
+  }
+}
+
+Status
+SequenceBatchScheduler::Reconfigure(const ModelConfig& config)
+{
+  {
+    std::lock_guard<std::mutex> lock(reaper_mu_);
+    max_sequence_idle_microseconds_ =
+        config.sequence_batching().max_sequence_idle_microseconds();
+  }
+
+  // Wake the reaper so that it recomputes how long to wait based on
+  // the new idle timeout.
+  reaper_cv_.notify_one();
+
+  return Status::Success;
+}
+
+bool
+SequenceBatchScheduler::RemapBatchSlot(
+    const CorrelationID correlation_id, const BatchSlot& from,
+    const BatchSlot& to)
+{
+  CorrelationShard& shard = ShardFor(correlation_id);
+  std::lock_guard<std::mutex> shard_lock(shard.mu_);
+
+  // The sequence must still own 'from'. It won't if the sequence has
+  // ended or has been reaped, even if its last request is still
+  // queued in the slot.
+  auto sb_itr = shard.sequence_to_batchslot_map_.find(correlation_id);
+  if ((sb_itr == shard.sequence_to_batchslot_map_.end()) ||
+      (sb_itr->second.batcher_idx_ != from.batcher_idx_) ||
+      (sb_itr->second.slot_ != from.slot_)) {
+    return false;
+  }
+
+  // A request that has been directed to 'from' but not yet enqueued
+  // would land in the wrong slot. Holding the shard lock prevents any
+  // new request from being directed to 'from'.
+  if (batchers_[from.batcher_idx_]->HasPendingEnqueue(from.slot_)) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mu_);
+  if (ready_batch_slots_[to.batcher_idx_].erase(to.slot_) == 0) {
+    return false;
+  }
+
+  ready_batch_slots_[from.batcher_idx_].insert(from.slot_);
+  sb_itr->second = to;
 
-  ready_batch_slots_.push(batch_slot);
   return true;
 }
 
@@ -444,22 +601,33 @@ bool
 SequenceBatchScheduler::DelayScheduler(
     const uint32_t batcher_idx, const size_t cnt, const size_t total)
 {
-  std::unique_lock<std::mutex> lock(mu_);
-  queue_request_cnts_[batcher_idx] = cnt;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    queue_request_cnts_[batcher_idx] = cnt;
 
-  size_t seen = 0;
-  for (auto c : queue_request_cnts_) {
-    seen += c;
-  }
+    size_t seen = 0;
+    for (auto c : queue_request_cnts_) {
+      seen += c;
+    }
 
-  if (seen < total) {
-    return true;
+    if (seen < total) {
+      return true;
+    }
   }
 
   if (backlog_delay_cnt_ > 0) {
+    // Backlog queues grow while holding only the shard lock so hold
+    // all shard locks to get a consistent count. This is only used
+    // for debugging/testing so the cost doesn't matter.
+    std::vector<std::unique_lock<std::mutex>> shard_locks;
+    for (auto& shard : shards_) {
+      shard_locks.emplace_back(shard.mu_);
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+
     size_t backlog_seen = 0;
     for (const auto& q : backlog_queues_) {
-      backlog_seen += q->size();
+      backlog_seen += q.queue_->size();
     }
 
     if (backlog_seen < backlog_delay_cnt_) {
@@ -484,83 +652,110 @@ SequenceBatchScheduler::ReaperThread(const int nice)
 
   const uint64_t backlog_idle_wait_microseconds = 50 * 1000;
 
-  while (!reaper_thread_exit_) {
-    std::unique_lock<std::mutex> lock(mu_);
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(reaper_mu_);
+      if (reaper_thread_exit_) {
+        break;
+      }
+    }
 
-    uint64_t wait_microseconds = max_sequence_idle_microseconds_;
+    const uint64_t max_sequence_idle_microseconds =
+        max_sequence_idle_microseconds_;
+    uint64_t wait_microseconds = max_sequence_idle_microseconds;
 
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
     uint64_t now_us = (now.tv_sec * NANOS_PER_SECOND + now.tv_nsec) / 1000;
 
-    for (auto cid_itr = correlation_id_timestamps_.cbegin();
-         cid_itr != correlation_id_timestamps_.cend();) {
-      int64_t remaining_microseconds =
-          (int64_t)max_sequence_idle_microseconds_ - (now_us - cid_itr->second);
-      if (remaining_microseconds > 0) {
-        wait_microseconds =
-            std::min(wait_microseconds, (uint64_t)remaining_microseconds + 1);
-        ++cid_itr;
-        continue;
-      }
-
-      const CorrelationID idle_correlation_id = cid_itr->first;
-      LOG_VERBOSE(1) << "Max sequence idle exceeded for sequence "
-                     << idle_correlation_id;
+    // The slots of idle sequences that must be force-ended. The
+    // force-end is enqueued into the batchers after the shard lock is
+    // released since the batcher lock may be held while a batcher
+    // calls ReleaseBatchSlot (which acquires a shard lock).
+    std::vector<std::pair<CorrelationID, BatchSlot>> force_ends;
+
+    // Visit one shard at a time so that requests for sequences in
+    // other shards are not blocked while the reaper is running.
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> shard_lock(shard.mu_);
+
+      for (auto cid_itr = shard.correlation_id_timestamps_.cbegin();
+           cid_itr != shard.correlation_id_timestamps_.cend();) {
+        int64_t remaining_microseconds =
+            (int64_t)max_sequence_idle_microseconds -
+            (now_us - cid_itr->second);
+        if (remaining_microseconds > 0) {
+          wait_microseconds =
+              std::min(wait_microseconds, (uint64_t)remaining_microseconds + 1);
+          ++cid_itr;
+          continue;
+        }
 
-      auto idle_sb_itr = sequence_to_batchslot_map_.find(idle_correlation_id);
-
-      // If the idle correlation ID has an assigned slot, then release
-      // that assignment so it becomes available for another
-      // sequence. An assignment is released by enqueuing a payload
-      // with null providers and null completion callback. The
-      // scheduler thread will interpret the payload as meaning it
-      // should release the slot but otherwise do nothing with the
-      // payload.
-      if (idle_sb_itr != sequence_to_batchslot_map_.end()) {
-        // Need to grab the contents before the erase below since that
-        // can free it.
-        const size_t batcher_idx = idle_sb_itr->second.batcher_idx_;
-        const uint32_t slot = idle_sb_itr->second.slot_;
-
-        LOG_VERBOSE(1) << "reaper enqueuing force-end in batcher "
-                       << batcher_idx << ", slot " << slot << " for sequence "
+        const CorrelationID idle_correlation_id = cid_itr->first;
+        LOG_VERBOSE(1) << "Max sequence idle exceeded for sequence "
                        << idle_correlation_id;
 
-
-        sequence_to_batchslot_map_.erase(idle_correlation_id);
-
-        std::unique_ptr<ModelInferStats::ScopedTimer> idle_queue_timer;
-        batchers_[batcher_idx]->Enqueue(
-            slot, idle_correlation_id, idle_queue_timer, nullptr, nullptr,
-            nullptr, nullptr);
-        cid_itr = correlation_id_timestamps_.erase(cid_itr);
-      } else {
-        // If the idle correlation ID is in the backlog, then just
-        // need to increase the timeout so that we revisit it again
-        // in the future to check if it is assigned to a slot.
-        auto idle_bl_itr = sequence_to_backlog_map_.find(idle_correlation_id);
-        if (idle_bl_itr != sequence_to_backlog_map_.end()) {
-          LOG_VERBOSE(1) << "reaper found idle sequence in backlog so "
-                            "extending timeout for sequence "
-                         << idle_correlation_id;
-          wait_microseconds =
-              std::min(wait_microseconds, backlog_idle_wait_microseconds);
-          ++cid_itr;
+        auto idle_sb_itr =
+            shard.sequence_to_batchslot_map_.find(idle_correlation_id);
+
+        // If the idle correlation ID has an assigned slot, then
+        // release that assignment so it becomes available for another
+        // sequence. An assignment is released by enqueuing a payload
+        // with null providers and null completion callback. The
+        // scheduler thread will interpret the payload as meaning it
+        // should release the slot but otherwise do nothing with the
+        // payload.
+        if (idle_sb_itr != shard.sequence_to_batchslot_map_.end()) {
+          force_ends.emplace_back(idle_correlation_id, idle_sb_itr->second);
+          shard.sequence_to_batchslot_map_.erase(idle_sb_itr);
+          cid_itr = shard.correlation_id_timestamps_.erase(cid_itr);
         } else {
-          LOG_VERBOSE(1) << "ignoring stale idle for sequence "
-                         << idle_correlation_id;
-          cid_itr = correlation_id_timestamps_.erase(cid_itr);
+          // If the idle correlation ID is in the backlog, then just
+          // need to increase the timeout so that we revisit it again
+          // in the future to check if it is assigned to a slot.
+          auto idle_bl_itr =
+              shard.sequence_to_backlog_map_.find(idle_correlation_id);
+          if (idle_bl_itr != shard.sequence_to_backlog_map_.end()) {
+            LOG_VERBOSE(1) << "reaper found idle sequence in backlog so "
+                              "extending timeout for sequence "
+                           << idle_correlation_id;
+            wait_microseconds =
+                std::min(wait_microseconds, backlog_idle_wait_microseconds);
+            ++cid_itr;
+          } else {
+            LOG_VERBOSE(1) << "ignoring stale idle for sequence "
+                           << idle_correlation_id;
+            cid_itr = shard.correlation_id_timestamps_.erase(cid_itr);
+          }
         }
       }
     }
 
+    for (const auto& force_end : force_ends) {
+      const CorrelationID idle_correlation_id = force_end.first;
+      const size_t batcher_idx = force_end.second.batcher_idx_;
+      const uint32_t slot = force_end.second.slot_;
+
+      LOG_VERBOSE(1) << "reaper enqueuing force-end in batcher " << batcher_idx
+                     << ", slot " << slot << " for sequence "
+                     << idle_correlation_id;
+
+      std::unique_ptr<ModelInferStats::ScopedTimer> idle_queue_timer;
+      batchers_[batcher_idx]->Enqueue(
+          slot, idle_correlation_id, idle_queue_timer, nullptr, nullptr,
+          nullptr, nullptr);
+    }
+
     // Wait until the next idle timeout needs to be checked
     if (wait_microseconds > 0) {
       LOG_VERBOSE(1) << "Sequence-batch reaper sleeping for "
                      << wait_microseconds << "us...";
-      std::chrono::microseconds wait_timeout(wait_microseconds);
-      reaper_cv_.wait_for(lock, wait_timeout);
+      std::unique_lock<std::mutex> lock(reaper_mu_);
+      if (!reaper_thread_exit_ && (max_sequence_idle_microseconds ==
+                                   max_sequence_idle_microseconds_)) {
+        std::chrono::microseconds wait_timeout(wait_microseconds);
+        reaper_cv_.wait_for(lock, wait_timeout);
+      }
     }
   }
 
@@ -583,6 +778,9 @@ SequenceBatchScheduler::SequenceBatch::SequenceBatch(
       batcher_idx_(batcher_idx), scheduler_thread_exit_(false),
       scheduler_idle_(false), queues_(batch_size), max_active_slot_(-1),
       slot_correlation_ids_(batch_size, 0),
+      compact_slots_(config.sequence_batching().compact_batch_slots()),
+      pending_enqueue_cnts_(new std::atomic<uint32_t>[batch_size]()),
+      recent_execution_ns_(0), inflight_cnt_(0),
       start_input_overrides_(start_input_overrides),
       continue_input_overrides_(continue_input_overrides),
       notready_input_overrides_(notready_input_overrides)
@@ -630,10 +828,14 @@ SequenceBatchScheduler::SequenceBatch::Enqueue(
     // request available in one or more slots.
     if ((max_active_slot_ == -1) && (request_provider != nullptr)) {
       null_request_header_ = request_provider->RequestHeader();
+      null_request_descriptor_ = request_provider->Descriptor();
     }
 
     queues_[slot].emplace_back(
         queue_timer, stats, request_provider, response_provider, OnComplete);
+    if (request_provider != nullptr) {
+      inflight_cnt_++;
+    }
 
     slot_correlation_ids_[slot] = correlation_id;
     max_active_slot_ = std::max(max_active_slot_, static_cast<int32_t>(slot));
@@ -649,6 +851,51 @@ SequenceBatchScheduler::SequenceBatch::Enqueue(
   }
 }
 
+void
+SequenceBatchScheduler::SequenceBatch::CompactSlots()
+{
+  // 'mu_' must be held when this function is called.
+
+  // Repeatedly move the sequence in the maximum active slot into the
+  // lowest free slot until there is no free slot below the maximum
+  // active slot. The controlling scheduler has the final say on
+  // whether a move is allowed, if it isn't stop and try again after
+  // the next execution.
+  int32_t free_slot = 0;
+  while (true) {
+    while ((free_slot < max_active_slot_) &&
+           (slot_correlation_ids_[free_slot] != 0)) {
+      free_slot++;
+    }
+    if (free_slot >= max_active_slot_) {
+      break;
+    }
+
+    const uint32_t from = max_active_slot_;
+    const uint32_t to = free_slot;
+    const CorrelationID correlation_id = slot_correlation_ids_[from];
+    if (!base_->RemapBatchSlot(
+            correlation_id, BatchSlot(batcher_idx_, from),
+            BatchSlot(batcher_idx_, to))) {
+      break;
+    }
+
+    LOG_VERBOSE(1) << "Compacting sequence " << correlation_id
+                   << " in batcher " << batcher_idx_ << " from slot " << from
+                   << " to slot " << to;
+
+    queues_[to] = std::move(queues_[from]);
+    queues_[from].clear();
+    slot_correlation_ids_[to] = correlation_id;
+    slot_correlation_ids_[from] = 0;
+
+    while ((max_active_slot_ >= 0) &&
+           (slot_correlation_ids_[max_active_slot_] == 0)) {
+      max_active_slot_--;
+    }
+  }
+}
+
 void
 SequenceBatchScheduler::SequenceBatch::SchedulerThread(
     const int nice, std::promise<bool>* is_initialized)
@@ -690,6 +937,8 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
 
   while (!scheduler_thread_exit_) {
     auto payloads = std::make_shared<std::vector<Scheduler::Payload>>();
+    uint32_t padding_cnt = 0;
+    uint32_t request_cnt = 0;
     uint64_t wait_microseconds = 0;
 
     // Hold the lock for as short a time as possible.
@@ -753,9 +1002,10 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
             // Use null-provider if necessary otherwise the next
             // payload in the queue...
             if (use_null_provider) {
+              padding_cnt++;
               auto null_request_provider =
                   std::make_shared<NULLInferRequestProvider>(
-                      null_request_header_);
+                      null_request_header_, null_request_descriptor_);
               null_request_provider->SetInputOverride(
                   notready_input_overrides_);
 
@@ -766,12 +1016,13 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
             } else {
               Scheduler::Payload& slot_payload = queue.front();
               const auto& request_provider = slot_payload.request_provider_;
-              const auto& request_header = request_provider->RequestHeader();
+              const InferRequestDescriptor& descriptor =
+                  request_provider->Descriptor();
 
               // If this is the first payload in a sequence then send
               // the appropriate sequence start indicator to the
               // backend.
-              if ((request_header.flags() &
+              if ((descriptor.flags_ &
                    InferRequestHeader::FLAG_SEQUENCE_START) != 0) {
                 request_provider->SetInputOverride(start_input_overrides_);
               } else {
@@ -782,11 +1033,12 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
                   slot_payload.queue_timer_, slot_payload.stats_,
                   request_provider, slot_payload.response_provider_,
                   slot_payload.complete_function_);
+              request_cnt++;
 
               queue.pop_front();
 
-              if ((request_header.flags() &
-                   InferRequestHeader::FLAG_SEQUENCE_END) != 0) {
+              if ((descriptor.flags_ & InferRequestHeader::FLAG_SEQUENCE_END) !=
+                  0) {
                 end_of_sequence = true;
               }
             }
@@ -819,6 +1071,18 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
                 if (slot == max_active_slot_) {
                   adjust_max_active_slot = true;
                 }
+              } else if (!queue.empty()) {
+                // The slot is now used by a sequence from the
+                // backlog, whose requests are now in-flight in this
+                // batcher.
+                for (const auto& backlog_payload : queue) {
+                  if (backlog_payload.request_provider_ != nullptr) {
+                    inflight_cnt_++;
+                  }
+                }
+                const auto& next_provider = queue.front().request_provider_;
+                slot_correlation_ids_[slot] =
+                    next_provider->Descriptor().correlation_id_;
               }
             }
           }
@@ -834,6 +1098,12 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
         }
       }
 
+      // Move sequences into free slots so that the next execution
+      // needs as little padding as possible.
+      if (compact_slots_ && (delay_cnt == 0)) {
+        CompactSlots();
+      }
+
       // If no requests are to be handled, wait for notification or
       // for the specified timeout before checking the queues again.
       if (wait_microseconds > 0) {
@@ -845,7 +1115,7 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
     }
 
     if ((payloads != nullptr) && !payloads->empty()) {
-      auto OnCompleteQueuedPayloads = [payloads](Status status) {
+      auto OnCompleteQueuedPayloads = [payloads, padding_cnt](Status status) {
         // Payloads that don't have a completion function don't have
         // anywhere to report their errors. Those errors could have
         // caused other payloads to have issues (due to mis-alignment
@@ -862,17 +1132,30 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
           }
         }
 
+        // Padding payloads have no stats and are not counted in the
+        // batch size of the execution.
+        size_t execution_batch_size = 0;
+        for (const auto& payload : *payloads) {
+          if ((payload.stats_ != nullptr) &&
+              (payload.request_provider_ != nullptr)) {
+            execution_batch_size +=
+                payload.request_provider_->Descriptor().batch_size_;
+          }
+        }
+
         // Complete each payload by calling the competion function.
         bool found_success = false;
         for (auto& payload : *payloads) {
           const Status& final_status = status.IsOk() ? payload.status_ : status;
 
           // All the payloads executed together, so count 1 execution
-          // in the first successful payload. Other payloads stay at 0
-          // executions.
+          // (and the padding of that execution) in the first
+          // successful payload. Other payloads stay at 0 executions.
           if (!found_success && final_status.IsOk() &&
               (payload.stats_ != nullptr)) {
             payload.stats_->SetModelExecutionCount(1);
+            payload.stats_->SetModelExecutionBatchSize(execution_batch_size);
+            payload.stats_->SetModelPaddingCount(padding_cnt);
             found_success = true;
           }
 
@@ -882,8 +1165,29 @@ SequenceBatchScheduler::SequenceBatch::SchedulerThread(
         }
       };
 
-      // Run the backend...
-      OnSchedule_(batcher_idx_, payloads.get(), OnCompleteQueuedPayloads);
+      // Run the backend and track the execution time, which is
+      // reported in the instance status.
+      struct timespec start;
+      clock_gettime(CLOCK_MONOTONIC, &start);
+
+      OnSchedule_(
+          batcher_idx_, payloads.get(),
+          MakePooledCallback(std::move(OnCompleteQueuedPayloads)));
+
+      struct timespec end;
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      const uint64_t start_ns = start.tv_sec * NANOS_PER_SECOND + start.tv_nsec;
+      const uint64_t end_ns = end.tv_sec * NANOS_PER_SECOND + end.tv_nsec;
+      const uint64_t execution_ns = (start_ns > end_ns) ? 0 : end_ns - start_ns;
+      const uint64_t recent_ns = recent_execution_ns_;
+      const uint64_t update_ns = (recent_ns == 0)
+                                     ? execution_ns
+                                     : (recent_ns * 7 + execution_ns) / 8;
+      recent_execution_ns_ = std::max((uint64_t)1, update_ns);
+
+      // The backend runs synchronously so the requests have finished
+      // executing once OnSchedule_ returns.
+      inflight_cnt_ -= request_cnt;
     }
   }  // end runner loop
 
@@ -31,7 +31,7 @@
 #include <deque>
 #include <future>
 #include <mutex>
-#include <queue>
+#include <set>
 #include <thread>
 #include <unordered_map>
 #include "src/core/model_config.h"
@@ -77,6 +77,22 @@ class SequenceBatchScheduler : public Scheduler {
   bool ReleaseBatchSlot(
       const BatchSlot& batch_slot, std::deque<Scheduler::Payload>* payloads);
 
+  // Report the active slots and recent execution time of each
+  // SequenceBatch.
+  void GetInstanceStatus(ModelVersionStatus* status) override;
+
+  // \see Scheduler::Reconfigure()
+  Status Reconfigure(const ModelConfig& config) override;
+
+  // Move the sequence with 'correlation_id' from batch slot 'from' to
+  // the free batch slot 'to', and make 'from' available for a new
+  // sequence. Return false (and leave the slots unchanged) if the
+  // sequence no longer owns 'from', if a request for the sequence is
+  // in the process of being enqueued, or if 'to' is no longer free.
+  bool RemapBatchSlot(
+      const CorrelationID correlation_id, const BatchSlot& from,
+      const BatchSlot& to);
+
   // For debugging/testing, batcher reports how many waiting requests
   // and returns true if the batcher should continue waiting.
   bool DelayScheduler(
@@ -85,6 +101,11 @@ class SequenceBatchScheduler : public Scheduler {
  private:
   void ReaperThread(const int nice);
 
+  // Select and claim a free batch slot for a new sequence based on
+  // the slot assignment policy. Return false if there is no free
+  // slot. 'mu_' must be held when this function is called.
+  bool ClaimReadyBatchSlot(BatchSlot* batch_slot);
+
   Status CreateControlTensors(
       const ModelConfig& config,
       std::shared_ptr<InferRequestProvider::InputOverrideMap>*
@@ -121,9 +142,42 @@ class SequenceBatchScheduler : public Scheduler {
         const std::shared_ptr<InferResponseProvider>& response_provider,
         std::function<void(Status)> OnComplete);
 
+    // Show that a request is about to be enqueued into 'slot'. Must
+    // be balanced by a call to EndPendingEnqueue after the request
+    // has been enqueued. A slot with a pending enqueue is never
+    // compacted.
+    void BeginPendingEnqueue(const uint32_t slot)
+    {
+      if (compact_slots_) {
+        pending_enqueue_cnts_[slot]++;
+      }
+    }
+    void EndPendingEnqueue(const uint32_t slot)
+    {
+      if (compact_slots_) {
+        pending_enqueue_cnts_[slot]--;
+      }
+    }
+    bool HasPendingEnqueue(const uint32_t slot) const
+    {
+      return pending_enqueue_cnts_[slot] != 0;
+    }
+
+    // Moving average of the duration of recent executions of this
+    // batcher, in nanoseconds. Zero if there have been no executions.
+    uint64_t RecentExecutionNs() const { return recent_execution_ns_; }
+
+    // The number of requests enqueued in this batcher that have not
+    // finished executing, including the ones executing now.
+    uint32_t InflightCount() const { return inflight_cnt_; }
+
    private:
     void SchedulerThread(const int nice, std::promise<bool>* is_initialized);
 
+    // Move active sequences from the highest slots into free lower
+    // slots. 'mu_' must be held when this function is called.
+    void CompactSlots();
+
     // Function the scheduler will call to initialize a runner.
     const StandardInitFunc OnInit_;
 
@@ -149,6 +203,7 @@ class SequenceBatchScheduler : public Scheduler {
     // an inference is issuing and there is no request available in a
     // slot.
     InferRequestHeader null_request_header_;
+    InferRequestDescriptor null_request_descriptor_;
 
     // Queues holding inference requests. There are 'batch_size'
     // queues, one for each batch slot where requests assigned to that
@@ -164,6 +219,21 @@ class SequenceBatchScheduler : public Scheduler {
     // requests pending at the moment.
     std::vector<CorrelationID> slot_correlation_ids_;
 
+    // True if active sequences should be compacted into the lowest
+    // free slots.
+    const bool compact_slots_;
+
+    // For each slot, the number of requests that have been assigned
+    // to the slot by the controlling scheduler but that have not yet
+    // been enqueued.
+    std::unique_ptr<std::atomic<uint32_t>[]> pending_enqueue_cnts_;
+
+    // See RecentExecutionNs().
+    std::atomic<uint64_t> recent_execution_ns_;
+
+    // See InflightCount().
+    std::atomic<uint32_t> inflight_cnt_;
+
     // The control values, delivered as input tensors, that should be
     // used when starting a sequence, continuing a sequence, and
     // showing that a sequence has not input available.
@@ -176,50 +246,88 @@ class SequenceBatchScheduler : public Scheduler {
   };
 
  private:
-  struct BatchSlotCompare {
-    bool operator()(const BatchSlot& a, const BatchSlot& b) const
+  // Map from a request's correlation ID to the BatchSlot assigned to
+  // that correlation ID.
+  using BatchSlotMap = std::unordered_map<CorrelationID, BatchSlot>;
+
+  // Map from a request's correlation ID to the backlog queue
+  // collecting requests for that correlation ID.
+  using BacklogMap = std::unordered_map<
+      CorrelationID, std::shared_ptr<std::deque<Scheduler::Payload>>>;
+
+  // The per-correlation-ID state. Sequences are spread across
+  // 'kCorrelationShardCount' shards by correlation ID so that
+  // requests for different sequences don't contend on a single
+  // lock. When both a shard's 'mu_' and the scheduler's 'mu_' are
+  // needed the shard lock must be acquired first.
+  struct CorrelationShard {
+    std::mutex mu_;
+
+    // Map from correlation ID to the assigned batch slot, for
+    // sequences in this shard.
+    BatchSlotMap sequence_to_batchslot_map_;
+
+    // Map from correlation ID to backlog queue, for sequences in this
+    // shard.
+    BacklogMap sequence_to_backlog_map_;
+
+    // For each correlation ID the most recently seen timestamp, in
+    // microseconds, for a request using that correlation ID.
+    std::unordered_map<CorrelationID, uint64_t> correlation_id_timestamps_;
+  };
+
+  static constexpr size_t kCorrelationShardCount = 32;
+
+  // Get the shard that holds the state for a correlation ID.
+  CorrelationShard& ShardFor(const CorrelationID correlation_id)
+  {
+    return shards_[correlation_id % kCorrelationShardCount];
+  }
+
+  // A backlogged sequence and the correlation ID it belongs to.
+  struct BacklogQueue {
+    BacklogQueue(
+        CorrelationID c,
+        const std::shared_ptr<std::deque<Scheduler::Payload>>& q)
+        : correlation_id_(c), queue_(q)
     {
-      return a.slot_ > b.slot_;
     }
+    CorrelationID correlation_id_;
+    std::shared_ptr<std::deque<Scheduler::Payload>> queue_;
   };
 
   // The max_sequence_idle_microseconds value for this scheduler.
-  uint64_t max_sequence_idle_microseconds_;
+  std::atomic<uint64_t> max_sequence_idle_microseconds_;
 
-  // Mutex
+  // Mutex protecting 'backlog_queues_', 'ready_batch_slots_' and the
+  // debugging/testing counters.
   std::mutex mu_;
 
   // The reaper thread
   std::unique_ptr<std::thread> reaper_thread_;
+  std::mutex reaper_mu_;
   std::condition_variable reaper_cv_;
   bool reaper_thread_exit_;
 
   // The SequenceBatchs being managed by this scheduler.
   std::vector<std::shared_ptr<SequenceBatch>> batchers_;
 
-  // Map from a request's correlation ID to the BatchSlot assigned to
-  // that correlation ID.
-  using BatchSlotMap = std::unordered_map<CorrelationID, BatchSlot>;
-  BatchSlotMap sequence_to_batchslot_map_;
-
-  // Map from a request's correlation ID to the backlog queue
-  // collecting requests for that correlation ID.
-  using BacklogMap = std::unordered_map<
-      CorrelationID, std::shared_ptr<std::deque<Scheduler::Payload>>>;
-  BacklogMap sequence_to_backlog_map_;
+  // The correlation ID shards.
+  CorrelationShard shards_[kCorrelationShardCount];
 
   // The ordered backlog of sequences waiting for a free slot.
-  std::deque<std::shared_ptr<std::deque<Scheduler::Payload>>> backlog_queues_;
+  std::deque<BacklogQueue> backlog_queues_;
+
+  // The policy for assigning a free batch slot to a new sequence.
+  ModelSequenceBatching::SlotAssignment slot_assignment_;
 
-  // The batch/slot locations ready to accept a new sequence. Ordered
-  // from lowest slot-number to highest so that all batches grow at
-  // the same rate and attempt to remain as small as possible.
-  std::priority_queue<BatchSlot, std::vector<BatchSlot>, BatchSlotCompare>
-      ready_batch_slots_;
+  // The number of slots in each batcher.
+  size_t batch_size_;
 
-  // For each correlation ID the most recently seen timestamp, in
-  // microseconds, for a request using that correlation ID.
-  std::unordered_map<CorrelationID, uint64_t> correlation_id_timestamps_;
+  // For each batcher, the slots ready to accept a new sequence.
+  // Ordered from lowest slot-number to highest so that batches
+  // attempt to remain as small as possible.
+  std::vector<std::set<uint32_t>> ready_batch_slots_;
 
   // Used for debugging/testing.
   size_t backlog_delay_cnt_;
@@ -39,11 +39,15 @@
 #include "src/core/api.pb.h"
 #include "src/core/backend.h"
 #include "src/core/constants.h"
+#include "src/core/cpu_cgroup.h"
 #include "src/core/logging.h"
+#include "src/core/metric_model_reporter.h"
 #include "src/core/model_config.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/model_config_utils.h"
+#include "src/core/model_quantizer.h"
 #include "src/core/model_repository_manager.h"
+#include "src/core/object_pool.h"
 #include "src/core/profile.h"
 #include "src/core/provider.h"
 #include "src/core/request_status.h"
@@ -69,6 +73,91 @@ class ScopedAtomicIncrement {
   std::atomic<uint64_t>& counter_;
 };
 
+// Return the bytes of tensor memory held by a request with
+// 'request_header' while it is in flight: its inputs plus the outputs
+// it requests. Outputs with a variable-size dimension are not counted
+// since their size is not known until the model produces them.
+uint64_t
+RequestMemoryByteSize(
+    const InferenceBackend& backend, const InferRequestHeader& request_header)
+{
+  uint64_t byte_size = 0;
+  for (const auto& input : request_header.input()) {
+    byte_size += input.batch_byte_size();
+  }
+
+  const int batch_size = (backend.Config().max_batch_size() > 0)
+                             ? request_header.batch_size()
+                             : 0;
+  for (const auto& io : request_header.output()) {
+    const ModelOutput* output;
+    if (backend.GetOutput(io.name(), &output).IsOk()) {
+      const int64_t output_byte_size =
+          GetByteSize(batch_size, output->data_type(), output->dims());
+      if (output_byte_size > 0) {
+        byte_size += output_byte_size;
+      }
+    }
+  }
+
+  return byte_size;
+}
+
+// Add 'byte_size' to 'counter' unless that would make it exceed
+// 'limit'. A 'limit' of 0 indicates no limit. Return true if
+// 'byte_size' was added.
+bool
+ReserveMemory(
+    std::atomic<uint64_t>& counter, const uint64_t limit,
+    const uint64_t byte_size)
+{
+  if (limit == 0) {
+    counter += byte_size;
+    return true;
+  }
+
+  uint64_t current = counter;
+  do {
+    if ((byte_size > limit) || (current > (limit - byte_size))) {
+      return false;
+    }
+  } while (!counter.compare_exchange_weak(current, current + byte_size));
+
+  return true;
+}
+
+// The state held by an inference request while it is in flight. It
+// holds 'backend_' so that the model can't be unloaded while the
+// request is in flight.
+struct InflightInfer {
+  InflightInfer(
+      std::atomic<uint64_t>& inflight_counter,
+      InferenceServer::MemoryReservation&& memory,
+      const std::shared_ptr<InferenceBackend>& backend,
+      RequestStatus* request_status, const uint64_t request_id,
+      const std::shared_ptr<InferRequestProvider>& request_provider,
+      const std::shared_ptr<InferResponseProvider>& response_provider,
+      const std::shared_ptr<ModelInferStats>& infer_stats,
+      std::function<void()>&& OnCompleteInferRPC)
+      : inflight_(inflight_counter), memory_(std::move(memory)),
+        backend_(backend), request_status_(request_status),
+        request_id_(request_id), request_provider_(request_provider),
+        response_provider_(response_provider), infer_stats_(infer_stats),
+        OnCompleteInferRPC_(std::move(OnCompleteInferRPC))
+  {
+  }
+
+  ScopedAtomicIncrement inflight_;
+  InferenceServer::MemoryReservation memory_;
+  std::shared_ptr<InferenceBackend> backend_;
+  RequestStatus* request_status_;
+  const uint64_t request_id_;
+  std::shared_ptr<InferRequestProvider> request_provider_;
+  std::shared_ptr<InferResponseProvider> response_provider_;
+  std::shared_ptr<ModelInferStats> infer_stats_;
+  std::function<void()> OnCompleteInferRPC_;
+};
+
 }  // namespace
 
 //
@@ -89,14 +178,20 @@ InferenceServer::InferenceServer()
   id_ = "inference:0";
   strict_model_config_ = true;
   strict_readiness_ = true;
+  readiness_max_queue_wait_us_ = 0;
+  inflight_memory_limit_ = 0;
   profiling_enabled_ = false;
   exit_timeout_secs_ = 30;
   repository_poll_secs_ = 15;
+  model_quantizer_timeout_secs_ = 600;
+  custom_memory_pool_cache_byte_size_ = 0;
+  custom_memory_pool_huge_pages_ = false;
 
   tf_soft_placement_enabled_ = true;
   tf_gpu_memory_fraction_ = 0.0;
 
   inflight_request_counter_ = 0;
+  inflight_memory_byte_size_ = 0;
 
   status_manager_.reset(new ServerStatusManager(version_));
 }
@@ -125,11 +220,27 @@ InferenceServer::Init()
     return false;
   }
 
+  // Must be set before any models are loaded.
+  status = InitCpuCgroups(cpu_cgroup_root_);
+  if (!status.IsOk()) {
+    LOG_ERROR << status.Message();
+    ready_state_ = ServerReadyState::SERVER_FAILED_TO_INITIALIZE;
+    return false;
+  }
+
+  status = InitModelQuantizer(model_quantizer_, model_quantizer_timeout_secs_);
+  if (!status.IsOk()) {
+    LOG_ERROR << status.Message();
+    ready_state_ = ServerReadyState::SERVER_FAILED_TO_INITIALIZE;
+    return false;
+  }
+
   // Create the global manager for the repository. For now, all models are
   // eagerly loaded below when the manager is created.
   status = ModelRepositoryManager::Create(
       this, version_, status_manager_, model_store_path_, strict_model_config_,
       tf_gpu_memory_fraction_, tf_soft_placement_enabled_,
+      custom_memory_pool_cache_byte_size_, custom_memory_pool_huge_pages_,
       repository_poll_secs_, true /* polling */, &model_repository_manager_);
   if (!status.IsOk()) {
     LOG_ERROR << status.Message();
@@ -270,6 +381,25 @@ InferenceServer::HandleHealth(
       }
     }
 
+    // Optionally report not ready when the server is overloaded, so
+    // that load balancers stop sending it new requests until its
+    // queues drain.
+    if (*health && (readiness_max_queue_wait_us_ > 0)) {
+      ServerLoadStatus load_status;
+      Status status = GetLoadStatus(&load_status, std::string());
+
+      *health = status.IsOk();
+      if (*health) {
+        for (const auto& ml : load_status.model_load()) {
+          if (ml.second.estimated_queue_wait_us() >
+              readiness_max_queue_wait_us_) {
+            *health = false;
+            break;
+          }
+        }
+      }
+    }
+
     RequestStatusFactory::Create(
         request_status, request_id, id_, RequestStatusCode::SUCCESS);
   } else {
@@ -310,6 +440,74 @@ InferenceServer::HandleProfile(
   }
 }
 
+InferenceServer::MemoryReservation::MemoryReservation(
+    MemoryReservation&& other)
+    : counter_(other.counter_), byte_size_(other.byte_size_),
+      metric_reporter_(std::move(other.metric_reporter_))
+{
+  other.counter_ = nullptr;
+}
+
+InferenceServer::MemoryReservation&
+InferenceServer::MemoryReservation::operator=(MemoryReservation&& other)
+{
+  if (this != &other) {
+    Release();
+    counter_ = other.counter_;
+    byte_size_ = other.byte_size_;
+    metric_reporter_ = std::move(other.metric_reporter_);
+    other.counter_ = nullptr;
+  }
+
+  return *this;
+}
+
+InferenceServer::MemoryReservation::~MemoryReservation()
+{
+  Release();
+}
+
+void
+InferenceServer::MemoryReservation::Release()
+{
+  if (counter_ != nullptr) {
+    *counter_ -= byte_size_;
+#ifdef TRTIS_ENABLE_METRICS
+    metric_reporter_->MetricInferenceRequestMemory(-1 /* gpu_device */)
+        .Decrement(byte_size_);
+#endif  // TRTIS_ENABLE_METRICS
+    counter_ = nullptr;
+    metric_reporter_.reset();
+  }
+}
+
+Status
+InferenceServer::ReserveInferMemory(
+    const InferenceBackend& backend, const InferRequestHeader& request_header,
+    MemoryReservation* reservation)
+{
+  const uint64_t byte_size = RequestMemoryByteSize(backend, request_header);
+  if (!ReserveMemory(
+          inflight_memory_byte_size_, inflight_memory_limit_, byte_size)) {
+    return Status(
+        RequestStatusCode::UNAVAILABLE,
+        "in-flight memory budget exceeded, request for '" + backend.Name() +
+            "' requires " + std::to_string(byte_size) + " bytes");
+  }
+
+  reservation->Release();
+  reservation->counter_ = &inflight_memory_byte_size_;
+  reservation->byte_size_ = byte_size;
+  reservation->metric_reporter_ = backend.MetricReporter();
+#ifdef TRTIS_ENABLE_METRICS
+  reservation->metric_reporter_
+      ->MetricInferenceRequestMemory(-1 /* gpu_device */)
+      .Increment(byte_size);
+#endif  // TRTIS_ENABLE_METRICS
+
+  return Status::Success;
+}
+
 void
 InferenceServer::HandleInfer(
     RequestStatus* request_status,
@@ -318,6 +516,20 @@ InferenceServer::HandleInfer(
     std::shared_ptr<InferResponseProvider> response_provider,
     std::shared_ptr<ModelInferStats> infer_stats,
     std::function<void()> OnCompleteInferRPC)
+{
+  HandleInfer(
+      request_status, backend, request_provider, response_provider,
+      infer_stats, MemoryReservation(), std::move(OnCompleteInferRPC));
+}
+
+void
+InferenceServer::HandleInfer(
+    RequestStatus* request_status,
+    const std::shared_ptr<InferenceBackend>& backend,
+    std::shared_ptr<InferRequestProvider> request_provider,
+    std::shared_ptr<InferResponseProvider> response_provider,
+    std::shared_ptr<ModelInferStats> infer_stats, MemoryReservation&& memory,
+    std::function<void()> OnCompleteInferRPC)
 {
   if (ready_state_ != ServerReadyState::SERVER_READY) {
     RequestStatusFactory::Create(
@@ -327,29 +539,62 @@ InferenceServer::HandleInfer(
     return;
   }
 
-  std::shared_ptr<ScopedAtomicIncrement> inflight(
-      new ScopedAtomicIncrement(inflight_request_counter_));
-  const uint64_t request_id = NextRequestId();
+  // Frontends that can reserve the request's memory before receiving
+  // its inputs have already done so, otherwise reserve it now.
+  if (!memory.IsReserved()) {
+    Status status = ReserveInferMemory(
+        *backend, request_provider->RequestHeader(), &memory);
+    if (!status.IsOk()) {
+      infer_stats->SetFailed(true);
+      RequestStatusFactory::Create(request_status, 0, id_, status);
+      OnCompleteInferRPC();
+      return;
+    }
+  }
 
-  // Need to capture 'backend' to keep it alive... it goes away when
-  // it goes out of scope which can cause the model to be unloaded,
-  // and we don't want that to happen when a request is in flight.
-  auto OnCompleteHandleInfer = [this, OnCompleteInferRPC, backend,
-                                response_provider, request_status, request_id,
-                                infer_stats, inflight](Status status) mutable {
+  // The state is captured by pointer so that the completion function
+  // fits in std::function without allocating. The backend calls the
+  // completion function exactly once, which releases the state.
+  PoolAllocator<InflightInfer> alloc;
+  InflightInfer* state = new (alloc.allocate(1)) InflightInfer(
+      inflight_request_counter_, std::move(memory), backend, request_status,
+      NextRequestId(), request_provider, response_provider, infer_stats,
+      std::move(OnCompleteInferRPC));
+
+  auto OnCompleteHandleInfer = [this, state](Status status) {
+    std::unique_ptr<InflightInfer, PoolDeleter<InflightInfer>> owned(state);
     if (status.IsOk()) {
-      status = response_provider->FinalizeResponse(*backend);
-      if (status.IsOk()) {
-        RequestStatusFactory::Create(request_status, request_id, id_, status);
-        OnCompleteInferRPC();
-        return;
+      status = state->response_provider_->FinalizeResponse(*state->backend_);
+      if (status.IsOk() &&
+          ((state->request_provider_->RequestHeader().flags() &
+            InferRequestHeader::FLAG_REPORT_TIMING) != 0)) {
+        const ModelInferStats& stats = *state->infer_stats_;
+        InferResponseHeader::Timing* timing =
+            state->response_provider_->MutableResponseHeader()
+                ->mutable_timing();
+        timing->set_request_time_ns(stats.ElapsedRequestDuration());
+        timing->set_queue_time_ns(stats.QueueDuration());
+        timing->set_compute_time_ns(stats.ComputeDuration());
       }
     }
 
-    // Report only stats that are relevant for a failed inference run.
-    infer_stats->SetFailed(true);
-    LOG_VERBOSE(1) << "Infer failed: " << status.Message();
-    RequestStatusFactory::Create(request_status, request_id, id_, status);
+    if (!status.IsOk()) {
+      // Report only stats that are relevant for a failed inference run.
+      state->infer_stats_->SetFailed(true);
+      LOG_VERBOSE(1) << "Infer failed: " << status.Message();
+    }
+
+    RequestStatusFactory::Create(
+        state->request_status_, state->request_id_, id_, status);
+
+    // Release the state before signalling completion. Otherwise a
+    // caller that stops the server as soon as the request completes
+    // still sees it in flight, and may leave the state holding the
+    // last reference to the backend, which then gets destroyed on its
+    // own scheduler thread.
+    std::function<void()> OnCompleteInferRPC =
+        std::move(state->OnCompleteInferRPC_);
+    owned.reset();
     OnCompleteInferRPC();
   };
 
@@ -389,6 +634,77 @@ InferenceServer::HandleStatus(
   }
 }
 
+void
+InferenceServer::HandleLoad(
+    RequestStatus* request_status, ServerLoadStatus* load_status,
+    const std::string& model_name)
+{
+  if (ready_state_ == ServerReadyState::SERVER_EXITING) {
+    RequestStatusFactory::Create(
+        request_status, 0, id_, RequestStatusCode::UNAVAILABLE,
+        "Server exiting");
+    return;
+  }
+
+  ScopedAtomicIncrement inflight(inflight_request_counter_);
+  const uint64_t request_id = NextRequestId();
+
+  RequestStatusFactory::Create(
+      request_status, request_id, id_, GetLoadStatus(load_status, model_name));
+}
+
+Status
+InferenceServer::GetLoadStatus(
+    ServerLoadStatus* load_status, const std::string& model_name)
+{
+  load_status->Clear();
+  load_status->set_id(id_);
+
+  const ModelRepositoryManager::ModelStateMap states =
+      model_repository_manager_->GetLiveBackendStates();
+  if (!model_name.empty() && (states.find(model_name) == states.end())) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "no load available for unknown model '" + model_name + "'");
+  }
+
+  // The load of a model is the sum of the load of its ready
+  // versions. The versions do not share a queue so the estimated
+  // wait is the largest wait of any version.
+  for (const auto& ms : states) {
+    if (!model_name.empty() && (ms.first != model_name)) {
+      continue;
+    }
+
+    ModelLoadStatus& model_load =
+        (*load_status->mutable_model_load())[ms.first];
+    for (const auto& vs : ms.second) {
+      if (vs.second != ModelReadyState::MODEL_READY) {
+        continue;
+      }
+
+      std::shared_ptr<InferenceBackend> backend;
+      if (!model_repository_manager_
+               ->GetInferenceBackend(ms.first, vs.first, &backend)
+               .IsOk()) {
+        continue;
+      }
+
+      ModelLoadStatus version_load;
+      backend->GetLoadStatus(&version_load);
+      model_load.set_queue_count(
+          model_load.queue_count() + version_load.queue_count());
+      model_load.set_inflight_count(
+          model_load.inflight_count() + version_load.inflight_count());
+      model_load.set_estimated_queue_wait_us(std::max(
+          model_load.estimated_queue_wait_us(),
+          version_load.estimated_queue_wait_us()));
+    }
+  }
+
+  return Status::Success;
+}
+
 uint64_t
 InferenceServer::UptimeNs() const
 {
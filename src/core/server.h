@@ -33,6 +33,7 @@
 #include <unordered_map>
 
 #include "src/core/api.pb.h"
+#include "src/core/constants.h"
 #include "src/core/model_config.pb.h"
 #include "src/core/provider.h"
 #include "src/core/request_status.pb.h"
@@ -68,8 +69,58 @@ class InferenceServer {
   // Run profile 'cmd' for profiling all the all GPU devices
   void HandleProfile(RequestStatus* request_status, const std::string& cmd);
 
+  // A reservation of in-flight request memory. The memory is
+  // returned to the server's budget when the reservation is
+  // destroyed.
+  class MemoryReservation {
+   public:
+    MemoryReservation() = default;
+    MemoryReservation(MemoryReservation&& other);
+    MemoryReservation& operator=(MemoryReservation&& other);
+    ~MemoryReservation();
+
+    // Return true if memory is reserved, even if zero bytes.
+    bool IsReserved() const { return counter_ != nullptr; }
+
+   private:
+    friend class InferenceServer;
+    DISALLOW_COPY_AND_ASSIGN(MemoryReservation);
+
+    void Release();
+
+    std::atomic<uint64_t>* counter_ = nullptr;
+    uint64_t byte_size_ = 0;
+    std::shared_ptr<MetricModelReporter> metric_reporter_;
+  };
+
+  // Reserve the memory held while in flight by a request for
+  // 'backend' with 'request_header', which must be normalized. Only
+  // the header is needed so frontends can reserve before receiving
+  // the request's input tensors. Return UNAVAILABLE if the memory
+  // would exceed the budget. Over-budget requests are rejected
+  // instead of waiting for memory, since a waiting request would
+  // hold its connection and frontend resources without bound and
+  // clients can retry or go to another server when they see
+  // UNAVAILABLE.
+  Status ReserveInferMemory(
+      const InferenceBackend& backend, const InferRequestHeader& request_header,
+      MemoryReservation* reservation);
+
   // Perform inference on the given input for specified model and
   // update RequestStatus object with the status of the inference.
+  // 'memory' is held until the inference completes. If it doesn't
+  // hold a reservation the memory is reserved from the request
+  // header of 'request_provider'.
+  void HandleInfer(
+      RequestStatus* request_status,
+      const std::shared_ptr<InferenceBackend>& backend,
+      std::shared_ptr<InferRequestProvider> request_provider,
+      std::shared_ptr<InferResponseProvider> response_provider,
+      std::shared_ptr<ModelInferStats> infer_stats,
+      MemoryReservation&& memory, std::function<void()> OnCompleteInferRPC);
+
+  // Same as above but always reserves the memory from the request
+  // header of 'request_provider'.
   void HandleInfer(
       RequestStatus* request_status,
       const std::shared_ptr<InferenceBackend>& backend,
@@ -85,6 +136,13 @@ class InferenceServer {
       RequestStatus* request_status, ServerStatus* server_status,
       const std::string& model_name);
 
+  // Update the RequestStatus object and ServerLoadStatus object with
+  // the load of the model. If 'model_name' is empty, update with the
+  // load of all ready models.
+  void HandleLoad(
+      RequestStatus* request_status, ServerLoadStatus* load_status,
+      const std::string& model_name);
+
   // Return the ready state for the server.
   ServerReadyState ReadyState() const { return ready_state_; }
 
@@ -107,6 +165,69 @@ class InferenceServer {
   bool StrictReadinessEnabled() const { return strict_readiness_; }
   void SetStrictReadinessEnabled(bool e) { strict_readiness_ = e; }
 
+  // Get / set the maximum estimated queue wait, in microseconds, of
+  // any model for the server to be considered ready. A value of 0
+  // indicates that the queue wait does not affect readiness.
+  uint64_t ReadinessMaxQueueWaitMicroseconds() const
+  {
+    return readiness_max_queue_wait_us_;
+  }
+  void SetReadinessMaxQueueWaitMicroseconds(uint64_t us)
+  {
+    readiness_max_queue_wait_us_ = us;
+  }
+
+  // Get / set the maximum total size, in bytes, of the input and
+  // output tensors held by in-flight inference requests. A request
+  // that would exceed this budget is rejected, see
+  // ReserveInferMemory(). A value of 0 indicates no limit.
+  uint64_t InflightMemoryByteSize() const { return inflight_memory_limit_; }
+  void SetInflightMemoryByteSize(uint64_t b) { inflight_memory_limit_ = b; }
+
+  // Get / set the cgroup v2 directory under which per-model CPU
+  // cgroups are created. Empty indicates no CPU cgroups.
+  const std::string& CpuCgroupRoot() const { return cpu_cgroup_root_; }
+  void SetCpuCgroupRoot(const std::string& r) { cpu_cgroup_root_ = r; }
+
+  // Get / set the command used to quantize models that request
+  // load-time quantization. Empty indicates no quantizer.
+  const std::string& ModelQuantizer() const { return model_quantizer_; }
+  void SetModelQuantizer(const std::string& q) { model_quantizer_ = q; }
+
+  // Get / set the time allowed for quantizing one model file, in
+  // seconds. A value of zero indicates no timeout.
+  uint32_t ModelQuantizerTimeoutSeconds() const
+  {
+    return model_quantizer_timeout_secs_;
+  }
+  void SetModelQuantizerTimeoutSeconds(int32_t s)
+  {
+    model_quantizer_timeout_secs_ = std::max(0, s);
+  }
+
+  // Get / set the maximum total size, in bytes, of freed custom
+  // backend memory blocks that are cached for reuse. A value of 0
+  // indicates no caching.
+  uint64_t CustomMemoryPoolCacheByteSize() const
+  {
+    return custom_memory_pool_cache_byte_size_;
+  }
+  void SetCustomMemoryPoolCacheByteSize(uint64_t b)
+  {
+    custom_memory_pool_cache_byte_size_ = b;
+  }
+
+  // Get / set whether large custom backend memory blocks are advised
+  // to use transparent huge pages.
+  bool CustomMemoryPoolHugePages() const
+  {
+    return custom_memory_pool_huge_pages_;
+  }
+  void SetCustomMemoryPoolHugePages(bool e)
+  {
+    custom_memory_pool_huge_pages_ = e;
+  }
+
   // Get / set profiling enable.
   bool ProfilingEnabled() const { return profiling_enabled_; }
   void SetProfilingEnabled(bool e) { profiling_enabled_ = e; }
@@ -153,6 +274,11 @@ class InferenceServer {
   // Return the uptime of the server in nanoseconds.
   uint64_t UptimeNs() const;
 
+  // Get the load of 'model_name', or of all ready models if
+  // 'model_name' is empty.
+  Status GetLoadStatus(
+      ServerLoadStatus* load_status, const std::string& model_name);
+
   // Return the next request ID for this server.
   uint64_t NextRequestId() { return next_request_id_++; }
 
@@ -163,10 +289,18 @@ class InferenceServer {
   std::string model_store_path_;
   bool strict_model_config_;
   bool strict_readiness_;
+  uint64_t readiness_max_queue_wait_us_;
+  uint64_t inflight_memory_limit_;
   bool profiling_enabled_;
   uint32_t repository_poll_secs_;
   uint32_t exit_timeout_secs_;
 
+  std::string cpu_cgroup_root_;
+  std::string model_quantizer_;
+  uint32_t model_quantizer_timeout_secs_;
+  uint64_t custom_memory_pool_cache_byte_size_;
+  bool custom_memory_pool_huge_pages_;
+
   bool tf_soft_placement_enabled_;
   float tf_gpu_memory_fraction_;
 
@@ -180,6 +314,9 @@ class InferenceServer {
   // for all in-flight requests to complete before exiting.
   std::atomic<uint64_t> inflight_request_counter_;
 
+  // Bytes of tensor memory held by in-flight requests.
+  std::atomic<uint64_t> inflight_memory_byte_size_;
+
   std::shared_ptr<ServerStatusManager> status_manager_;
   std::unique_ptr<ModelRepositoryManager> model_repository_manager_;
 };
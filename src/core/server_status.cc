@@ -27,6 +27,7 @@
 #include "src/core/server_status.h"
 
 #include <time.h>
+#include "src/core/backend.h"
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/metric_model_reporter.h"
@@ -59,6 +60,19 @@ SetModelVersionReadyState(
       model_repository_manager->GetVersionStates(model_name);
   for (const auto& version_and_state : versions_and_states) {
     mvs[version_and_state.first].set_ready_state(version_and_state.second);
+
+    // Ready versions also report the current status of their model
+    // instances.
+    if (version_and_state.second == ModelReadyState::MODEL_READY) {
+      std::shared_ptr<InferenceBackend> backend;
+      if (model_repository_manager
+              ->GetInferenceBackend(
+                  model_name, version_and_state.first, &backend)
+              .IsOk()) {
+        backend->GetInstanceStatus(&mvs[version_and_state.first]);
+        backend->GetAccuracySettings(&mvs[version_and_state.first]);
+      }
+    }
   }
 }
 
@@ -237,8 +251,9 @@ ServerStatusManager::UpdateFailedInferStats(
 void
 ServerStatusManager::UpdateSuccessInferStats(
     const std::string& model_name, const int64_t model_version,
-    size_t batch_size, uint32_t execution_cnt, uint64_t request_duration_ns,
-    uint64_t queue_duration_ns, uint64_t compute_duration_ns)
+    size_t batch_size, uint32_t execution_cnt, size_t execution_batch_size,
+    uint64_t request_duration_ns, uint64_t queue_duration_ns,
+    uint64_t compute_duration_ns)
 {
   std::lock_guard<std::mutex> lock(mu_);
 
@@ -255,13 +270,16 @@ ServerStatusManager::UpdateSuccessInferStats(
     auto mvs_itr = mvs.find(model_version);
     InferRequestStats* new_stats = nullptr;
     InferRequestStats* existing_stats = nullptr;
+    ModelVersionStatus* version_status_ptr = nullptr;
     if (mvs_itr == mvs.end()) {
       ModelVersionStatus& version_status = mvs[model_version];
       version_status.set_model_inference_count(batch_size);
       version_status.set_model_execution_count(execution_cnt);
       new_stats = &((*version_status.mutable_infer_stats())[batch_size]);
+      version_status_ptr = &version_status;
     } else {
       ModelVersionStatus& version_status = mvs_itr->second;
+      version_status_ptr = &version_status;
       version_status.set_model_inference_count(
           version_status.model_inference_count() + batch_size);
       version_status.set_model_execution_count(
@@ -276,6 +294,11 @@ ServerStatusManager::UpdateSuccessInferStats(
       }
     }
 
+    if ((execution_cnt > 0) && (execution_batch_size > 0)) {
+      auto& ebs = *version_status_ptr->mutable_execution_batch_stats();
+      ebs[execution_batch_size] += execution_cnt;
+    }
+
     if (new_stats != nullptr) {
       new_stats->mutable_success()->set_count(1);
       new_stats->mutable_success()->set_total_time_ns(request_duration_ns);
@@ -374,6 +397,7 @@ ModelInferStats::~ModelInferStats()
   } else {
     status_manager_->UpdateSuccessInferStats(
         model_name_, model_version, batch_size_, execution_count_,
+        (execution_batch_size_ != 0) ? execution_batch_size_ : batch_size_,
         request_duration_ns_, queue_duration_ns_, compute_duration_ns_);
 
 #ifdef TRTIS_ENABLE_METRICS
@@ -385,6 +409,10 @@ ModelInferStats::~ModelInferStats()
         metric_reporter_->MetricInferenceExecutionCount(gpu_device_)
             .Increment(execution_count_);
       }
+      if (padding_count_ > 0) {
+        metric_reporter_->MetricInferencePaddingCount(gpu_device_)
+            .Increment(padding_count_);
+      }
 
       metric_reporter_->MetricInferenceRequestDuration(gpu_device_)
           .Increment(request_duration_ns_ / 1000);
@@ -406,7 +434,8 @@ struct timespec
 ModelInferStats::StartRequestTimer(ScopedTimer* timer) const
 {
   timer->duration_ptr_ = &request_duration_ns_;
-  return timer->Start();
+  request_start_ = timer->Start();
+  return request_start_;
 }
 
 struct timespec
@@ -423,4 +452,20 @@ ModelInferStats::StartComputeTimer(ScopedTimer* timer) const
   return timer->Start();
 }
 
+uint64_t
+ModelInferStats::ElapsedRequestDuration() const
+{
+  if (request_start_.tv_sec == 0) {
+    return 0;
+  }
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  uint64_t start_ns =
+      request_start_.tv_sec * NANOS_PER_SECOND + request_start_.tv_nsec;
+  uint64_t now_ns = now.tv_sec * NANOS_PER_SECOND + now.tv_nsec;
+  return (start_ns > now_ns) ? 0 : now_ns - start_ns;
+}
+
 }}  // namespace nvidia::inferenceserver
@@ -105,9 +105,12 @@ class ModelInferStats {
       const std::string& model_name)
       : status_manager_(status_manager), model_name_(model_name),
         requested_model_version_(-1), batch_size_(0), gpu_device_(-1),
-        failed_(false), execution_count_(0), request_duration_ns_(0),
-        queue_duration_ns_(0), compute_duration_ns_(0)
+        failed_(false), execution_count_(0), execution_batch_size_(0),
+        padding_count_(0), request_duration_ns_(0), queue_duration_ns_(0),
+        compute_duration_ns_(0)
   {
+    request_start_.tv_sec = 0;
+    request_start_.tv_nsec = 0;
   }
 
   // Report collected statistics.
@@ -138,6 +141,17 @@ class ModelInferStats {
   // the batched requests will count the execution).
   void SetModelExecutionCount(uint32_t count) { execution_count_ = count; }
 
+  // Set the batch size of the model execution(s) counted by this
+  // request, if it differs from the batch size of the request (for
+  // example when requests are dynamically batched).
+  void SetModelExecutionBatchSize(size_t bs) { execution_batch_size_ = bs; }
+
+  // Set the number of padding inferences that were performed in the
+  // model execution(s) counted by this request. A padding inference
+  // fills a batch slot that has no request (for example an idle slot
+  // of the sequence batcher) and so produces no useful output.
+  void SetModelPaddingCount(uint32_t count) { padding_count_ = count; }
+
   // Get a ScopedTimer that measures entire inference request-response
   // duration. The lifetime of 'timer' must not exceed the
   // lifetime of 'this' object.
@@ -153,6 +167,15 @@ class ModelInferStats {
   // lifetime of 'this' object.
   struct timespec StartComputeTimer(ScopedTimer* timer) const;
 
+  // The time elapsed since the request timer was started, or 0 if the
+  // request timer has not been started.
+  uint64_t ElapsedRequestDuration() const;
+
+  // The queue and compute durations. Only complete once the
+  // corresponding timers are stopped.
+  uint64_t QueueDuration() const { return queue_duration_ns_; }
+  uint64_t ComputeDuration() const { return compute_duration_ns_; }
+
  private:
   std::shared_ptr<ServerStatusManager> status_manager_;
   std::shared_ptr<MetricModelReporter> metric_reporter_;
@@ -163,6 +186,9 @@ class ModelInferStats {
   bool failed_;
 
   uint32_t execution_count_;
+  size_t execution_batch_size_;
+  uint32_t padding_count_;
+  mutable struct timespec request_start_;
   mutable uint64_t request_duration_ns_;
   mutable uint64_t queue_duration_ns_;
   mutable uint64_t compute_duration_ns_;
@@ -206,8 +232,9 @@ class ServerStatusManager {
   // Add durations to Infer stats for a successful inference request.
   void UpdateSuccessInferStats(
       const std::string& model_name, const int64_t model_version,
-      size_t batch_size, uint32_t execution_cnt, uint64_t request_duration_ns,
-      uint64_t queue_duration_ns, uint64_t compute_duration_ns);
+      size_t batch_size, uint32_t execution_cnt, size_t execution_batch_size,
+      uint64_t request_duration_ns, uint64_t queue_duration_ns,
+      uint64_t compute_duration_ns);
 
  private:
   mutable std::mutex mu_;
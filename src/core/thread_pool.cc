@@ -0,0 +1,187 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/core/thread_pool.h"
+
+#include <sched.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "src/core/object_pool.h"
+
+namespace nvidia { namespace inferenceserver {
+
+ThreadPool::ThreadPool(size_t thread_cnt, std::function<void()> thread_init)
+    : thread_cnt_((thread_cnt == 0) ? AvailableCpuCount() : thread_cnt),
+      thread_init_(std::move(thread_init)), exiting_(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    exiting_ = true;
+  }
+
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t
+ThreadPool::AvailableCpuCount()
+{
+  // Respect any affinity mask (e.g. from taskset or a cpuset) rather
+  // than counting every CPU in the system.
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if (sched_getaffinity(0, sizeof(cpuset), &cpuset) == 0) {
+    const int cnt = CPU_COUNT(&cpuset);
+    if (cnt > 0) {
+      return cnt;
+    }
+  }
+
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void
+ThreadPool::StartWorkers()
+{
+  std::call_once(start_flag_, [this] {
+    workers_.reserve(thread_cnt_);
+    for (size_t i = 0; i < thread_cnt_; ++i) {
+      workers_.emplace_back(&ThreadPool::WorkerThread, this);
+    }
+  });
+}
+
+void
+ThreadPool::Submit(std::function<void()>&& task)
+{
+  StartWorkers();
+
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    tasks_.emplace_back(std::move(task));
+  }
+
+  cv_.notify_one();
+}
+
+void
+ThreadPool::ParallelFor(
+    size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn)
+{
+  grain = std::max((size_t)1, grain);
+  const size_t range_cnt = (count + grain - 1) / grain;
+  if (range_cnt == 0) {
+    return;
+  }
+
+  if (range_cnt == 1) {
+    fn(0, count);
+    return;
+  }
+
+  // Ranges are claimed from a shared counter by the calling thread
+  // and by helper tasks. A helper that starts after every range has
+  // been claimed does nothing, so the caller only ever waits for
+  // ranges that are already running and a nested ParallelFor can't
+  // deadlock. The state is shared because helpers may run after
+  // this call returns.
+  struct State {
+    std::atomic<size_t> next_range_{0};
+    size_t completed_ranges_ = 0;
+    std::mutex mu_;
+    std::condition_variable cv_;
+  };
+
+  auto state = std::allocate_shared<State>(PoolAllocator<State>());
+  auto run_ranges = [state, count, grain, range_cnt, &fn]() {
+    size_t completed = 0;
+    while (true) {
+      const size_t range = state->next_range_++;
+      if (range >= range_cnt) {
+        break;
+      }
+
+      const size_t begin = range * grain;
+      fn(begin, std::min(count, begin + grain));
+      completed++;
+    }
+
+    if (completed > 0) {
+      std::lock_guard<std::mutex> lock(state->mu_);
+      state->completed_ranges_ += completed;
+      if (state->completed_ranges_ == range_cnt) {
+        state->cv_.notify_all();
+      }
+    }
+  };
+
+  // 'fn' is only referenced while a range is running, and all ranges
+  // complete before this function returns.
+  const size_t helper_cnt = std::min(range_cnt - 1, ThreadCount());
+  for (size_t i = 0; i < helper_cnt; ++i) {
+    Submit(run_ranges);
+  }
+
+  run_ranges();
+
+  std::unique_lock<std::mutex> lock(state->mu_);
+  state->cv_.wait(lock, [&state, range_cnt] {
+    return state->completed_ranges_ == range_cnt;
+  });
+}
+
+void
+ThreadPool::WorkerThread()
+{
+  if (thread_init_ != nullptr) {
+    thread_init_();
+  }
+
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      cv_.wait(lock, [this] { return exiting_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+  }
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,89 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nvidia { namespace inferenceserver {
+
+//
+// A fixed-size pool of worker threads that runs submitted tasks in
+// FIFO order.
+//
+class ThreadPool {
+ public:
+  // Create a pool with 'thread_cnt' worker threads. If 'thread_cnt'
+  // is 0 create one thread for each CPU available to the process.
+  // The worker threads are not started until the first task is
+  // submitted, and each calls 'thread_init', if given, before running
+  // any task.
+  explicit ThreadPool(
+      size_t thread_cnt, std::function<void()> thread_init = nullptr);
+
+  // Wait for all submitted tasks to complete and then stop the
+  // worker threads.
+  ~ThreadPool();
+
+  // Return the number of CPUs the process is allowed to run on.
+  static size_t AvailableCpuCount();
+
+  // The number of worker threads.
+  size_t ThreadCount() const { return thread_cnt_; }
+
+  // Run 'task' on one of the worker threads.
+  void Submit(std::function<void()>&& task);
+
+  // Call 'fn' on consecutive ranges [begin, end) that together cover
+  // [0, count). Each range holds at least 'grain' indices, except
+  // possibly the last. The calling thread runs ranges too and
+  // returns once every range is complete, so ParallelFor can be
+  // called from within a task running on the pool.
+  void ParallelFor(
+      size_t count, size_t grain,
+      const std::function<void(size_t, size_t)>& fn);
+
+ private:
+  void StartWorkers();
+  void WorkerThread();
+
+  const size_t thread_cnt_;
+  const std::function<void()> thread_init_;
+  std::once_flag start_flag_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool exiting_;
+
+  std::vector<std::thread> workers_;
+};
+
+}}  // namespace nvidia::inferenceserver
@@ -142,8 +142,7 @@ class TrtServerRequestProvider {
   const std::string& ModelName() const { return model_name_; }
   int64_t ModelVersion() const { return model_version_; }
   ni::InferRequestHeader* InferRequestHeader() const;
-  const std::unordered_map<std::string, std::shared_ptr<ni::SystemMemory>>&
-  InputMap() const;
+  const ni::InferRequestProvider::InputBufferMap& InputMap() const;
 
   void SetInputData(const char* input_name, const void* base, size_t byte_size);
 
@@ -151,7 +150,7 @@ class TrtServerRequestProvider {
   const std::string model_name_;
   const int64_t model_version_;
   std::shared_ptr<ni::InferRequestHeader> request_header_;
-  std::unordered_map<std::string, std::shared_ptr<ni::SystemMemory>> input_map_;
+  ni::InferRequestProvider::InputBufferMap input_map_;
 };
 
 TrtServerRequestProvider::TrtServerRequestProvider(
@@ -168,7 +167,7 @@ TrtServerRequestProvider::InferRequestHeader() const
   return request_header_.get();
 }
 
-const std::unordered_map<std::string, std::shared_ptr<ni::SystemMemory>>&
+const ni::InferRequestProvider::InputBufferMap&
 TrtServerRequestProvider::InputMap() const
 {
   return input_map_;
@@ -563,8 +562,8 @@ TRTSERVER_ServerInferAsync(
 
   std::shared_ptr<ni::InferRequestProvider> infer_request_provider;
   RETURN_IF_STATUS_ERROR(ni::InferRequestProvider::Create(
-      lprovider->ModelName(), lprovider->ModelVersion(), *request_header,
-      lprovider->InputMap(), &infer_request_provider));
+      *backend, lprovider->ModelName(), lprovider->ModelVersion(),
+      *request_header, lprovider->InputMap(), &infer_request_provider));
 
   std::shared_ptr<ni::DelegatingInferResponseProvider> infer_response_provider;
   RETURN_IF_STATUS_ERROR(ni::DelegatingInferResponseProvider::Create(
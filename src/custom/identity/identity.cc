@@ -144,82 +144,87 @@ Context::Execute(
     const uint32_t payload_cnt, CustomPayload* payloads,
     CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn)
 {
-  for (uint32_t pidx = 0; pidx < payload_cnt; ++pidx) {
-    CustomPayload& payload = payloads[pidx];
-
-    for (uint32_t output_idx = 0; output_idx < payload.output_cnt;
-         ++output_idx) {
-      if (payload.error_code != 0) {
-        break;
-      }
-
-      const char* output_cname = payload.required_output_names[output_idx];
-      const auto itr = copy_map_.find(output_cname);
-      if (itr == copy_map_.end()) {
-        payload.error_code = kRequestOutput;
-        break;
-      }
-
-      const std::string& input_name = itr->second.input_name_;
-      const DataType datatype = itr->second.datatype_;
-
-      std::vector<int64_t> shape;
-      if (model_config_.max_batch_size() != 0) {
-        shape.push_back(payload.batch_size);
-      }
-      for (uint32_t input_idx = 0; input_idx < payload.input_cnt; ++input_idx) {
-        if (!strcmp(payload.input_names[input_idx], input_name.c_str())) {
-          shape.insert(
-              shape.end(), payload.input_shape_dims[input_idx],
-              payload.input_shape_dims[input_idx] +
-                  payload.input_shape_dim_cnts[input_idx]);
+  // Each payload is copied independently so spread the payloads
+  // across the server thread pool.
+  ParallelFor(payload_cnt, 1, [&](size_t begin, size_t end) {
+    for (size_t pidx = begin; pidx < end; ++pidx) {
+      CustomPayload& payload = payloads[pidx];
+
+      for (uint32_t output_idx = 0; output_idx < payload.output_cnt;
+           ++output_idx) {
+        if (payload.error_code != 0) {
           break;
         }
-      }
-
-      const int64_t batchn_byte_size = GetByteSize(datatype, shape);
-      if (batchn_byte_size < 0) {
-        payload.error_code = kOutputBuffer;
-        break;
-      }
 
-      void* obuffer;
-      if (!output_fn(
-              payload.output_context, output_cname, shape.size(), &shape[0],
-              batchn_byte_size, &obuffer)) {
-        payload.error_code = kOutputBuffer;
-        break;
-      }
+        const char* output_cname = payload.required_output_names[output_idx];
+        const auto itr = copy_map_.find(output_cname);
+        if (itr == copy_map_.end()) {
+          payload.error_code = kRequestOutput;
+          break;
+        }
 
-      // If no error but the 'obuffer' is returned as nullptr, then
-      // skip writing this output.
-      if (obuffer == nullptr) {
-        continue;
-      }
+        const std::string& input_name = itr->second.input_name_;
+        const DataType datatype = itr->second.datatype_;
 
-      char* output_buffer = reinterpret_cast<char*>(obuffer);
+        std::vector<int64_t> shape;
+        if (model_config_.max_batch_size() != 0) {
+          shape.push_back(payload.batch_size);
+        }
+        for (uint32_t input_idx = 0; input_idx < payload.input_cnt;
+             ++input_idx) {
+          if (!strcmp(payload.input_names[input_idx], input_name.c_str())) {
+            shape.insert(
+                shape.end(), payload.input_shape_dims[input_idx],
+                payload.input_shape_dims[input_idx] +
+                    payload.input_shape_dim_cnts[input_idx]);
+            break;
+          }
+        }
 
-      uint64_t total_byte_size = 0;
-      while (true) {
-        const void* content;
-        uint64_t content_byte_size = 128 * 1024;
-        if (!input_fn(
-                payload.input_context, input_name.c_str(), &content,
-                &content_byte_size)) {
-          payload.error_code = kInputContents;
+        const int64_t batchn_byte_size = GetByteSize(datatype, shape);
+        if (batchn_byte_size < 0) {
+          payload.error_code = kOutputBuffer;
           break;
         }
 
-        // If 'content' returns nullptr we have all the input.
-        if (content == nullptr) {
+        void* obuffer;
+        if (!output_fn(
+                payload.output_context, output_cname, shape.size(), &shape[0],
+                batchn_byte_size, &obuffer)) {
+          payload.error_code = kOutputBuffer;
           break;
         }
 
-        memcpy(output_buffer + total_byte_size, content, content_byte_size);
-        total_byte_size += content_byte_size;
+        // If no error but the 'obuffer' is returned as nullptr, then
+        // skip writing this output.
+        if (obuffer == nullptr) {
+          continue;
+        }
+
+        char* output_buffer = reinterpret_cast<char*>(obuffer);
+
+        uint64_t total_byte_size = 0;
+        while (true) {
+          const void* content;
+          uint64_t content_byte_size = 128 * 1024;
+          if (!input_fn(
+                  payload.input_context, input_name.c_str(), &content,
+                  &content_byte_size)) {
+            payload.error_code = kInputContents;
+            break;
+          }
+
+          // If 'content' returns nullptr we have all the input.
+          if (content == nullptr) {
+            break;
+          }
+
+          memcpy(output_buffer + total_byte_size, content, content_byte_size);
+          total_byte_size += content_byte_size;
+        }
       }
     }
-  }
+  });
 
   return ErrorCodes::Success;
 }
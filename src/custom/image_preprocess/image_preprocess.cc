@@ -63,7 +63,9 @@ enum ScaleType { NONE = 0, VGG = 1, INCEPTION = 2 };
 // Context object. All state must be kept in this object.
 class Context {
  public:
-  Context(const std::string& instance_name, const ModelConfig& config);
+  Context(
+      const std::string& instance_name, const ModelConfig& config,
+      const CustomInitializeData* data);
 
   // Initialize the context. Validate that the model configuration,
   // etc. is something that we can handle.
@@ -84,6 +86,20 @@ class Context {
 
   bool ParseType(const DataType& dtype, int* type1, int* type3);
 
+  // The images of a batch that are preprocessed by one call to
+  // PreprocessRange.
+  struct PreprocessTask {
+    Context* context_;
+    const std::vector<std::vector<char>>* input_;
+    char* obuffer_;
+    size_t image_byte_size_;
+    std::vector<int> errors_;
+  };
+
+  // Preprocess the images [begin, end) of a PreprocessTask. Used as
+  // the CustomRangeTaskFn_t given to the server thread pool.
+  static void PreprocessRange(void* task_context, size_t begin, size_t end);
+
   // The name of this instance of the backend.
   const std::string instance_name_;
 
@@ -101,12 +117,23 @@ class Context {
 
   // The data type of preprocessed image
   DataType output_type_;
+
+  // The server thread pool and the callback to run a parallel loop
+  // on it.
+  void* thread_pool_;
+  CustomParallelForFn_t parallel_for_fn_;
 };
 
 Context::Context(
-    const std::string& instance_name, const ModelConfig& model_config)
-    : instance_name_(instance_name), model_config_(model_config)
+    const std::string& instance_name, const ModelConfig& model_config,
+    const CustomInitializeData* data)
+    : instance_name_(instance_name), model_config_(model_config),
+      thread_pool_(nullptr), parallel_for_fn_(nullptr)
 {
+  if (CUSTOM_INITDATA_HAS_FIELD(data, parallel_for_fn)) {
+    thread_pool_ = data->thread_pool;
+    parallel_for_fn_ = data->parallel_for_fn;
+  }
 }
 
 int
@@ -204,24 +231,28 @@ Context::Execute(
     }
 
     // If no error but the 'obuffer' is returned as nullptr, then
-    // skip writing this output.
+    // skip writing this output. Every preprocessed image has the same
+    // size so the images are independent and are decoded in parallel
+    // on the server thread pool.
     if (obuffer != nullptr) {
-      size_t byte_used = 0;
-      for (const auto& data : input) {
-        cv::Mat img = imdecode(cv::Mat(data), 1);
-        if (img.empty()) {
-          payloads[idx].error_code = kOpenCV;
-          break;
-        }
-
-        size_t image_byte_size;
+      PreprocessTask task;
+      task.context_ = this;
+      task.input_ = &input;
+      task.obuffer_ = reinterpret_cast<char*>(obuffer);
+      task.image_byte_size_ = GetByteSize(output_type_, output_shape_);
+      task.errors_.resize(input.size(), kSuccess);
+
+      if ((thread_pool_ == nullptr) || (parallel_for_fn_ == nullptr) ||
+          !parallel_for_fn_(
+              thread_pool_, input.size(), 1, PreprocessRange, &task)) {
+        PreprocessRange(&task, 0, input.size());
+      }
 
-        err = Preprocess(img, (char*)obuffer + byte_used, &image_byte_size);
-        if (err != kSuccess) {
-          payloads[idx].error_code = err;
+      for (const int image_err : task.errors_) {
+        if (image_err != kSuccess) {
+          payloads[idx].error_code = image_err;
           break;
         }
-        byte_used += image_byte_size;
       }
     }
   }
@@ -229,6 +260,28 @@ Context::Execute(
   return kSuccess;
 }
 
+void
+Context::PreprocessRange(void* task_context, size_t begin, size_t end)
+{
+  PreprocessTask* task = static_cast<PreprocessTask*>(task_context);
+  for (size_t i = begin; i < end; ++i) {
+    cv::Mat img = imdecode(cv::Mat((*task->input_)[i]), 1);
+    if (img.empty()) {
+      task->errors_[i] = kOpenCV;
+      continue;
+    }
+
+    char* data = task->obuffer_ + (i * task->image_byte_size_);
+    size_t image_byte_size;
+    int err = task->context_->Preprocess(img, data, &image_byte_size);
+    if ((err == kSuccess) && (image_byte_size != task->image_byte_size_)) {
+      err = kOpenCV;
+    }
+
+    task->errors_[i] = err;
+  }
+}
+
 int
 Context::GetInputTensor(
     CustomGetNextInputFn_t input_fn, void* input_context, const char* name,
@@ -468,7 +521,7 @@ CustomInitialize(const CustomInitializeData* data, void** custom_context)
   // Create the context and validate that the model configuration is
   // something that we can handle.
   Context* context =
-      new Context(std::string(data->instance_name), model_config);
+      new Context(std::string(data->instance_name), model_config, data);
   int err = context->Init();
   if (err != kSuccess) {
     return err;
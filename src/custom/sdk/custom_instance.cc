@@ -26,6 +26,8 @@
 
 #include "custom_instance.h"
 
+#include <stdlib.h>
+
 namespace nvidia { namespace inferenceserver { namespace custom {
 
 CustomInstance::CustomInstance(
@@ -36,6 +38,77 @@ CustomInstance::CustomInstance(
 {
 }
 
+void
+CustomInstance::SetServerCallbacks(const CustomInitializeData* data)
+{
+  // Callbacks that the server doesn't provide are left unset so that
+  // the helpers fall back to running serially and using malloc.
+  if (CUSTOM_INITDATA_HAS_FIELD(data, parallel_for_fn)) {
+    thread_pool_ = data->thread_pool;
+    parallel_for_fn_ = data->parallel_for_fn;
+  }
+  if (CUSTOM_INITDATA_HAS_FIELD(data, free_fn)) {
+    allocator_ = data->allocator;
+    alloc_fn_ = data->alloc_fn;
+    free_fn_ = data->free_fn;
+  }
+}
+
+namespace {
+
+void
+RunRange(void* task_context, size_t begin, size_t end)
+{
+  const auto* fn =
+      static_cast<const std::function<void(size_t, size_t)>*>(task_context);
+  (*fn)(begin, end);
+}
+
+}  // namespace
+
+void
+CustomInstance::ParallelFor(
+    size_t count, size_t grain,
+    const std::function<void(size_t, size_t)>& fn) const
+{
+  if ((thread_pool_ == nullptr) || (parallel_for_fn_ == nullptr)) {
+    fn(0, count);
+    return;
+  }
+
+  void* task_context = const_cast<std::function<void(size_t, size_t)>*>(&fn);
+  if (!parallel_for_fn_(thread_pool_, count, grain, RunRange, task_context)) {
+    fn(0, count);
+  }
+}
+
+void*
+CustomInstance::Allocate(size_t byte_size) const
+{
+  if ((allocator_ == nullptr) || (alloc_fn_ == nullptr) ||
+      (free_fn_ == nullptr)) {
+    return malloc(byte_size);
+  }
+
+  void* buffer = nullptr;
+  if (!alloc_fn_(allocator_, byte_size, &buffer)) {
+    return nullptr;
+  }
+
+  return buffer;
+}
+
+void
+CustomInstance::Free(void* buffer) const
+{
+  if ((allocator_ == nullptr) || (alloc_fn_ == nullptr) ||
+      (free_fn_ == nullptr)) {
+    free(buffer);
+  } else {
+    free_fn_(allocator_, buffer);
+  }
+}
+
 /////////////
 
 extern "C" {
@@ -65,6 +138,7 @@ CustomInitialize(const CustomInitializeData* data, void** custom_instance)
     return ErrorCodes::CreationFailure;
   }
 
+  instance->SetServerCallbacks(data);
   *custom_instance = static_cast<void*>(instance);
 
   return ErrorCodes::Success;
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -82,6 +83,13 @@ class CustomInstance {
     return errors_.ErrorString(error);
   }
 
+  /// Use the server thread pool and allocator described by 'data'
+  /// for ParallelFor, Allocate and Free. Called by CustomInitialize
+  /// after the instance is created.
+  ///
+  /// \param data The initialization data given by the server.
+  void SetServerCallbacks(const CustomInitializeData* data);
+
  protected:
   /// Base constructor for CustomInstance
   ///
@@ -102,6 +110,32 @@ class CustomInstance {
     return errors_.RegisterError(error_message);
   }
 
+  /// Call 'fn' on ranges of [0, 'count') in parallel using the
+  /// server thread pool. If the server did not provide a thread pool
+  /// 'fn' is called once for the whole range on the calling thread.
+  ///
+  /// \param count The number of indices.
+  /// \param grain The number of indices in each range.
+  /// \param fn The function to call with the first and one past the
+  /// last index of each range.
+  void ParallelFor(
+      size_t count, size_t grain,
+      const std::function<void(size_t, size_t)>& fn) const;
+
+  /// Allocate scratch memory from the server allocator, or with
+  /// malloc if the server did not provide an allocator. Memory
+  /// allocated by the server is reused across executions and is
+  /// reported as memory used by the model.
+  ///
+  /// \param byte_size The size of the memory, in bytes.
+  /// \return The memory, or nullptr if it cannot be allocated.
+  void* Allocate(size_t byte_size) const;
+
+  /// Free memory returned by Allocate.
+  ///
+  /// \param buffer The memory to free.
+  void Free(void* buffer) const;
+
   /// The name of this backend instance
   const std::string instance_name_;
 
@@ -115,6 +149,17 @@ class CustomInstance {
  private:
   /// Error code manager.
   ErrorCodes errors_{};
+
+  /// The server thread pool and the callback to run a parallel loop
+  /// on it, or nullptr if the server did not provide them.
+  void* thread_pool_ = nullptr;
+  CustomParallelForFn_t parallel_for_fn_ = nullptr;
+
+  /// The server allocator and the callbacks to use it, or nullptr if
+  /// the server did not provide them.
+  void* allocator_ = nullptr;
+  CustomAllocFn_t alloc_fn_ = nullptr;
+  CustomFreeFn_t free_fn_ = nullptr;
 };
 
 }}}  // namespace nvidia::inferenceserver::custom
@@ -117,10 +117,16 @@ Context::Context(
     : instance_name_(instance_name), model_config_(model_config),
       gpu_device_(gpu_device), execute_delay_ms_(0)
 {
+  // "execute_delay_ms.<instance name>" overrides "execute_delay_ms"
+  // so that instances of the model can run at different speeds.
   if (model_config_.parameters_size() > 0) {
-    const auto itr = model_config_.parameters().find("execute_delay_ms");
-    if (itr != model_config_.parameters().end()) {
-      execute_delay_ms_ = std::stoi(itr->second.string_value());
+    for (const std::string& key :
+         {std::string("execute_delay_ms"),
+          "execute_delay_ms." + instance_name_}) {
+      const auto itr = model_config_.parameters().find(key);
+      if (itr != model_config_.parameters().end()) {
+        execute_delay_ms_ = std::stoi(itr->second.string_value());
+      }
     }
   }
 
@@ -29,6 +29,7 @@
 #include <memory>
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "src/nvrpc/Interfaces.h"
 
@@ -99,6 +100,13 @@ class BidirectionalStreamingLifeCycle : public IContextLifeCycle {
   uintptr_t GetExecutionContext() final override;
   void CompleteExecution(uintptr_t execution_context) final override;
 
+  // Complete the execution by writing 'responses', in order and
+  // without interleaving any other response, instead of the
+  // execution's own response. If 'responses' is empty nothing is
+  // written for the execution.
+  void CompleteExecution(
+      uintptr_t execution_context, std::vector<ResponseType>&& responses);
+
   void FinishResponse() final override;
   void CancelResponse() final override;
 
@@ -378,6 +386,56 @@ BidirectionalStreamingLifeCycle<Request, Response>::CompleteExecution(
   }
 }
 
+template <class Request, class Response>
+void
+BidirectionalStreamingLifeCycle<Request, Response>::CompleteExecution(
+    uintptr_t execution_context, std::vector<ResponseType>&& responses)
+{
+  bool should_write = false;
+  bool should_cancel = false;
+  bool should_finish = false;
+  {
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    auto it = live_contexts.find(execution_context);
+    if (it != live_contexts.end()) {
+      should_write = m_WriteBackQueue.empty() && !responses.empty();
+      for (auto& response : responses) {
+        std::shared_ptr<ExecutionContextType> response_context(
+            new ExecutionContextType);
+        std::swap(response_context->m_Response, response);
+        m_WriteBackQueue.push(std::move(response_context));
+      }
+      live_contexts.erase(execution_context);
+
+      // With nothing to write the stream must be finished here if
+      // this was the last outstanding request.
+      should_finish =
+          m_WriteBackQueue.empty() && live_contexts.empty() &&
+          (m_NextState == &BidirectionalStreamingLifeCycle<
+                              RequestType, ResponseType>::StateResponseDone);
+    } else {
+      // Unexpected behavior, cancel the stream
+      should_cancel = true;
+    }
+
+    // Check if the stream should have been cancelled but need to wait for RPCs
+    if (m_NextState == &BidirectionalStreamingLifeCycle<
+                           RequestType, ResponseType>::StateFinishedDone) {
+      should_cancel = true;
+    }
+  }
+  if (should_cancel) {
+    CancelResponse();
+  } else if (should_finish) {
+    FinishResponse();
+  }
+  if (should_write) {
+    m_ReaderWriter->Write(
+        m_WriteBackQueue.front()->m_Response,
+        m_WriteStateContext.IContext::Tag());
+  }
+}
+
 template <class Request, class Response>
 void
 BidirectionalStreamingLifeCycle<Request, Response>::FinishResponse()
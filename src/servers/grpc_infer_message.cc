@@ -0,0 +1,305 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "src/servers/grpc_infer_message.h"
+
+#include <algorithm>
+#include <deque>
+#include "google/protobuf/io/coded_stream.h"
+#include "grpc/slice.h"
+#include "src/core/grpc_wire.h"
+
+namespace nvidia { namespace inferenceserver {
+
+namespace {
+
+//
+// A tensor that references data in a set of gRPC slices.
+//
+class SliceSystemMemory : public SystemMemory {
+ public:
+  SliceSystemMemory() : last_slice_idx_(0) {}
+
+  //\see SystemMemory::BufferAt()
+  const char* BufferAt(size_t idx, size_t* byte_size) const override
+  {
+    if (idx >= blocks_.size()) {
+      *byte_size = 0;
+      return nullptr;
+    }
+
+    *byte_size = blocks_[idx].second;
+    return blocks_[idx].first;
+  }
+
+  // Add 'byte_size' bytes at 'offset' in 'slice' to the end of the
+  // tensor. 'slice_idx' identifies the slice within the request so
+  // that a slice is only referenced once.
+  void AddBlock(
+      size_t slice_idx, const grpc::Slice& slice, size_t offset,
+      size_t byte_size)
+  {
+    // Small slices hold their data inline so the data must be
+    // referenced from this object's copy of the slice.
+    if (slices_.empty() || (slice_idx != last_slice_idx_)) {
+      slices_.push_back(slice);
+      last_slice_idx_ = slice_idx;
+    }
+
+    blocks_.emplace_back(
+        reinterpret_cast<const char*>(slices_.back().begin()) + offset,
+        byte_size);
+    total_byte_size_ += byte_size;
+  }
+
+ private:
+  // Use deque so that existing slices are not moved by push_back().
+  std::deque<grpc::Slice> slices_;
+  size_t last_slice_idx_;
+  std::vector<std::pair<const char*, size_t>> blocks_;
+};
+
+//
+// A tensor assembled from the tensor data received in the messages
+// of a chunked request. Each chunk is referenced, not copied.
+//
+class ChunkedSystemMemory : public SystemMemoryReference {
+ public:
+  void AddChunk(const std::shared_ptr<SystemMemory>& chunk)
+  {
+    size_t byte_size;
+    for (size_t idx = 0;; ++idx) {
+      const char* buffer = chunk->BufferAt(idx, &byte_size);
+      if (buffer == nullptr) {
+        break;
+      }
+      AddBuffer(buffer, byte_size);
+    }
+
+    chunks_.push_back(chunk);
+  }
+
+ private:
+  std::vector<std::shared_ptr<SystemMemory>> chunks_;
+};
+
+// Parse an InferRequest from 'buffer' into 'request', except for the
+// raw inputs which are returned in 'raw_inputs' referencing the
+// slices of 'buffer'.
+bool
+ParseRequest(
+    grpc::ByteBuffer* buffer, InferRequest* request,
+    std::vector<std::shared_ptr<SystemMemory>>* raw_inputs)
+{
+  std::vector<grpc::Slice> slices;
+  if (!buffer->Dump(&slices).ok()) {
+    return false;
+  }
+
+  // The raw inputs are referenced in place and all other fields are
+  // collected and parsed as a regular protobuf message.
+  std::string fields;
+  std::vector<std::vector<SliceBlock>> raw_fields;
+  if (!SplitRawFields(
+          slices, InferRequest::kRawInputFieldNumber, &fields, &raw_fields)) {
+    return false;
+  }
+
+  for (const auto& blocks : raw_fields) {
+    auto memory = std::make_shared<SliceSystemMemory>();
+    for (const auto& block : blocks) {
+      memory->AddBlock(
+          block.slice_idx, slices[block.slice_idx], block.offset,
+          block.byte_size);
+    }
+    raw_inputs->emplace_back(std::move(memory));
+  }
+
+  return request->ParseFromString(fields);
+}
+
+}  // namespace
+
+Status
+GRPCInferRequest::Parse(grpc::ByteBuffer* buffer)
+{
+  request_.Clear();
+  raw_inputs_.clear();
+
+  if (!ParseRequest(buffer, &request_, &raw_inputs_)) {
+    raw_inputs_.clear();
+    return Status(
+        RequestStatusCode::INVALID_ARG, "failed to parse inference request");
+  }
+
+  return Status::Success;
+}
+
+Status
+GRPCInferRequest::ParseChunk(grpc::ByteBuffer* buffer, bool* last)
+{
+  *last = false;
+
+  InferRequest chunk_request;
+  std::vector<std::shared_ptr<SystemMemory>> chunk_inputs;
+  if (!ParseRequest(buffer, &chunk_request, &chunk_inputs)) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "failed to parse inference request chunk");
+  }
+
+  const InferChunk chunk = chunk_request.chunk();
+  *last = chunk.last();
+
+  // The first message holds the request, the raw input data of every
+  // message is appended to the inputs.
+  if (!chunked_) {
+    chunked_ = true;
+    request_.Swap(&chunk_request);
+    raw_inputs_.clear();
+    for (int i = 0; i < request_.meta_data().input_size(); ++i) {
+      raw_inputs_.emplace_back(std::make_shared<ChunkedSystemMemory>());
+    }
+  }
+
+  if ((chunk.tensor_index() + chunk_inputs.size()) > raw_inputs_.size()) {
+    return Status(
+        RequestStatusCode::INVALID_ARG,
+        "unexpected chunk for input " +
+            std::to_string(chunk.tensor_index() + chunk_inputs.size() - 1) +
+            ", request has " + std::to_string(raw_inputs_.size()) +
+            " inputs");
+  }
+
+  size_t idx = chunk.tensor_index();
+  for (const auto& chunk_input : chunk_inputs) {
+    std::static_pointer_cast<ChunkedSystemMemory>(raw_inputs_[idx++])
+        ->AddChunk(chunk_input);
+  }
+
+  return Status::Success;
+}
+
+void*
+GRPCInferResponse::AddRawOutput(size_t byte_size)
+{
+  // Always use a refcounted slice, a small slice allocated by
+  // grpc_slice_malloc() holds its data inline and so the data would
+  // move when the slice is copied.
+  grpc_slice slice = grpc_slice_malloc_large(byte_size);
+  void* content = GRPC_SLICE_START_PTR(slice);
+  raw_output_.emplace_back(slice, grpc::Slice::STEAL_REF);
+  return content;
+}
+
+size_t
+GRPCInferResponse::ByteSizeLong() const
+{
+  size_t byte_size = response_.ByteSizeLong();
+  for (const auto& raw : raw_output_) {
+    byte_size +=
+        google::protobuf::io::CodedOutputStream::VarintSize32(
+            (InferResponse::kRawOutputFieldNumber << 3) |
+            kWireTypeLengthDelimited) +
+        google::protobuf::io::CodedOutputStream::VarintSize64(raw.size()) +
+        raw.size();
+  }
+
+  return byte_size;
+}
+
+void
+GRPCInferResponse::Serialize(grpc::ByteBuffer* buffer) const
+{
+  // The response fields are serialized normally, each raw output is
+  // then appended as a tag and length followed by the slice holding
+  // the output data. The slices are shared with the returned
+  // 'buffer', not copied.
+  std::vector<grpc::Slice> slices;
+  slices.reserve(1 + (2 * raw_output_.size()));
+
+  std::string fields;
+  response_.SerializeToString(&fields);
+  slices.emplace_back(fields.data(), fields.size());
+
+  for (const auto& raw : raw_output_) {
+    std::string prefix;
+    AppendVarint(
+        (InferResponse::kRawOutputFieldNumber << 3) | kWireTypeLengthDelimited,
+        &prefix);
+    AppendVarint(raw.size(), &prefix);
+    slices.emplace_back(prefix.data(), prefix.size());
+    if (raw.size() > 0) {
+      slices.push_back(raw);
+    }
+  }
+
+  grpc::ByteBuffer serialized(&slices[0], slices.size());
+  buffer->Swap(&serialized);
+}
+
+void
+GRPCInferResponse::SerializeChunks(
+    size_t chunk_byte_size, std::vector<grpc::ByteBuffer>* buffers) const
+{
+  buffers->clear();
+  chunk_byte_size = std::max(chunk_byte_size, (size_t)1);
+
+  // Each chunk of raw output is sent as a message holding only the
+  // chunk position followed by a sub-slice of the output.
+  for (size_t idx = 0; idx < raw_output_.size(); ++idx) {
+    const grpc::Slice& raw = raw_output_[idx];
+    for (size_t offset = 0; offset < raw.size(); offset += chunk_byte_size) {
+      const size_t byte_size = std::min(chunk_byte_size, raw.size() - offset);
+
+      InferResponse chunk_response;
+      chunk_response.mutable_chunk()->set_tensor_index(idx);
+
+      std::string fields;
+      chunk_response.SerializeToString(&fields);
+      AppendVarint(
+          (InferResponse::kRawOutputFieldNumber << 3) |
+              kWireTypeLengthDelimited,
+          &fields);
+      AppendVarint(byte_size, &fields);
+
+      grpc::Slice slices[2] = {grpc::Slice(fields.data(), fields.size()),
+                               raw.sub(offset, offset + byte_size)};
+      buffers->emplace_back(slices, 2);
+    }
+  }
+
+  // The last message holds the rest of the response.
+  InferResponse last_response = response_;
+  last_response.mutable_chunk()->set_last(true);
+
+  std::string fields;
+  last_response.SerializeToString(&fields);
+  grpc::Slice slice(fields.data(), fields.size());
+  buffers->emplace_back(&slice, 1);
+}
+
+}}  // namespace nvidia::inferenceserver
@@ -0,0 +1,111 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "grpc++/support/byte_buffer.h"
+#include "grpc++/support/slice.h"
+#include "src/core/grpc_service.pb.h"
+#include "src/core/provider.h"
+#include "src/core/status.h"
+
+namespace nvidia { namespace inferenceserver {
+
+//
+// An inference request received as a gRPC ByteBuffer. Everything
+// except the raw input tensors is parsed into an InferRequest. The
+// raw input tensors are not copied, instead they reference the
+// received slices.
+//
+class GRPCInferRequest {
+ public:
+  // Parse the request from 'buffer'.
+  Status Parse(grpc::ByteBuffer* buffer);
+
+  // Parse the next message of a chunked request from 'buffer'. The
+  // first message initializes the request and the raw input data of
+  // every message is appended to the raw input tensors of the
+  // request. Return true in 'last' if 'buffer' holds the last message
+  // of the request. A message that can't be parsed is not the last
+  // message, the request continues until a message marked last is
+  // received so that the stream stays in sync with the client.
+  Status ParseChunk(grpc::ByteBuffer* buffer, bool* last);
+
+  // The request. 'raw_input' is always empty, use RawInputs() to
+  // access the raw input tensors.
+  const InferRequest& Request() const { return request_; }
+
+  // The raw input tensors, in the order they appear in the
+  // request. Each holds a reference to the slices it uses so it
+  // remains valid after this object is destroyed.
+  const std::vector<std::shared_ptr<SystemMemory>>& RawInputs() const
+  {
+    return raw_inputs_;
+  }
+
+ private:
+  InferRequest request_;
+  std::vector<std::shared_ptr<SystemMemory>> raw_inputs_;
+  bool chunked_ = false;
+};
+
+//
+// An inference response sent as a gRPC ByteBuffer. The raw output
+// tensors are allocated as gRPC slices that are handed to gRPC
+// without copying.
+//
+class GRPCInferResponse {
+ public:
+  // The response. Raw output tensors must be added with
+  // AddRawOutput() and not to the response's 'raw_output'.
+  InferResponse* MutableResponse() { return &response_; }
+
+  // Allocate 'byte_size' bytes for the next raw output tensor and
+  // return a pointer to them.
+  void* AddRawOutput(size_t byte_size);
+
+  // Remove all raw output tensors.
+  void ClearRawOutput() { raw_output_.clear(); }
+
+  // The serialized size of the response.
+  size_t ByteSizeLong() const;
+
+  // Serialize the response into 'buffer'.
+  void Serialize(grpc::ByteBuffer* buffer) const;
+
+  // Serialize the response as the messages of a chunked response,
+  // each holding at most 'chunk_byte_size' bytes of raw output. The
+  // chunks share the raw output slices, they are not copied.
+  void SerializeChunks(
+      size_t chunk_byte_size, std::vector<grpc::ByteBuffer>* buffers) const;
+
+ private:
+  InferResponse response_;
+  std::vector<grpc::Slice> raw_output_;
+};
+
+}}  // namespace nvidia::inferenceserver
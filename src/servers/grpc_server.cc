@@ -32,12 +32,14 @@
 #include "grpc++/server.h"
 #include "grpc++/server_builder.h"
 #include "grpc++/server_context.h"
+#include "grpc++/support/byte_buffer.h"
 #include "grpc++/support/status.h"
 #include "grpc/grpc.h"
 #include "src/core/backend.h"
 #include "src/core/constants.h"
 #include "src/core/grpc_service.grpc.pb.h"
 #include "src/core/logging.h"
+#include "src/core/object_pool.h"
 #include "src/core/provider_utils.h"
 #include "src/core/request_status.h"
 #include "src/core/server.h"
@@ -46,6 +48,7 @@
 #include "src/nvrpc/Resources.h"
 #include "src/nvrpc/Service.h"
 #include "src/nvrpc/ThreadPool.h"
+#include "src/servers/grpc_infer_message.h"
 
 using nvrpc::BaseContext;
 using nvrpc::BidirectionalStreamingLifeCycle;
@@ -104,102 +107,246 @@ class StatusContext final
 
 template <class LifeCycle>
 class InferBaseContext : public BaseContext<LifeCycle, AsyncResources> {
+ protected:
+  // Send 'grpc_response', the response to 'request', and complete
+  // the execution.
+  virtual void SendResponse(
+      uintptr_t execution_context, const InferRequest& request,
+      const std::shared_ptr<GRPCInferResponse>& grpc_response,
+      grpc::ByteBuffer& response_buffer)
+  {
+    InferResponse* response = grpc_response->MutableResponse();
+    RequestStatus* request_status = response->mutable_request_status();
+    if (grpc_response->ByteSizeLong() > INT_MAX) {
+      request_status->set_code(RequestStatusCode::INVALID_ARG);
+      request_status->set_msg(
+          "Response has byte size " +
+          std::to_string(grpc_response->ByteSizeLong()) +
+          " which exceed gRPC's byte size limit " + std::to_string(INT_MAX) +
+          ".");
+    }
+
+    // If the response is an error then clear the meta-data and raw
+    // output as they may be partially or un-initialized.
+    if (request_status->code() != RequestStatusCode::SUCCESS) {
+      response->mutable_meta_data()->Clear();
+      grpc_response->ClearRawOutput();
+    }
+
+    response->mutable_meta_data()->set_id(request.meta_data().id());
+    grpc_response->Serialize(&response_buffer);
+    this->CompleteExecution(execution_context);
+  }
+
+  // Perform inference for 'grpc_request'. 'status' is the result of
+  // parsing the request.
+  void ExecuteInfer(
+      const std::shared_ptr<GRPCInferRequest>& grpc_request, Status status,
+      grpc::ByteBuffer& response_buffer)
+  {
+    auto server = this->GetResources()->GetServer();
+    auto grpc_response = std::make_shared<GRPCInferResponse>();
+    const InferRequest& request = grpc_request->Request();
+
+    auto infer_stats = std::allocate_shared<ModelInferStats>(
+        PoolAllocator<ModelInferStats>(), server->StatusManager(),
+        request.model_name());
+    auto timer = std::allocate_shared<ModelInferStats::ScopedTimer>(
+        PoolAllocator<ModelInferStats::ScopedTimer>());
+    infer_stats->StartRequestTimer(timer.get());
+    infer_stats->SetRequestedVersion(request.model_version());
+
+    if (status.IsOk()) {
+      status = InferHelper(
+          server, infer_stats, timer, grpc_request, grpc_response,
+          response_buffer);
+    }
+
+    if (!status.IsOk()) {
+      LOG_VERBOSE(1) << "Infer failed: " << status.Message();
+      infer_stats->SetFailed(true);
+      RequestStatusFactory::Create(
+          grpc_response->MutableResponse()->mutable_request_status(),
+          0 /* request_id */, server->Id(), status);
+      SendResponse(
+          this->GetExecutionContext(), request, grpc_response,
+          response_buffer);
+    }
+  }
+
+ private:
   // Helper function that utilizes RETURN_IF_ERROR to avoid nested 'if'
   Status InferHelper(
       InferenceServer* server, std::shared_ptr<ModelInferStats>& infer_stats,
       std::shared_ptr<ModelInferStats::ScopedTimer>& timer,
-      InferRequest& request, InferResponse& response)
+      const std::shared_ptr<GRPCInferRequest>& grpc_request,
+      const std::shared_ptr<GRPCInferResponse>& grpc_response,
+      grpc::ByteBuffer& response_buffer)
   {
+    const InferRequest& request = grpc_request->Request();
+    InferResponse& response = *grpc_response->MutableResponse();
+
     std::shared_ptr<InferenceBackend> backend = nullptr;
     RETURN_IF_ERROR(server->GetInferenceBackend(
         request.model_name(), request.model_version(), &backend));
     infer_stats->SetMetricReporter(backend->MetricReporter());
 
-    std::unordered_map<std::string, std::shared_ptr<SystemMemory>> input_map;
+    InferRequestProvider::InputBufferMap input_map;
     InferRequestHeader request_header = request.meta_data();
     RETURN_IF_ERROR(NormalizeRequestHeader(*backend, request_header));
+
+    // gRPC has already received the whole request, but reserving
+    // before the inputs are mapped and the outputs are allocated
+    // releases an over-budget request right away.
+    InferenceServer::MemoryReservation memory;
     RETURN_IF_ERROR(
-        GRPCInferRequestToInputMap(request_header, request, input_map));
+        server->ReserveInferMemory(*backend, request_header, &memory));
+
+    RETURN_IF_ERROR(GRPCInferRequestToInputMap(
+        request_header, request, grpc_request->RawInputs(), input_map));
 
     std::shared_ptr<InferRequestProvider> request_provider;
     std::shared_ptr<GRPCInferResponseProvider> response_provider;
     RETURN_IF_ERROR(InferRequestProvider::Create(
-        request.model_name(), request.model_version(), request_header,
-        input_map, &request_provider));
-    infer_stats->SetBatchSize(request_header.batch_size());
-
+        *backend, request.model_name(), request.model_version(),
+        std::move(request_header), input_map, &request_provider));
+    infer_stats->SetBatchSize(request_provider->RequestHeader().batch_size());
+
+    // Raw outputs are written directly into the slices that are sent
+    // in the response. The response outlives the response provider
+    // since it is held until the response is sent, so it is captured
+    // by pointer which keeps the function from allocating.
+    GRPCInferResponse* raw_response = grpc_response.get();
     RETURN_IF_ERROR(GRPCInferResponseProvider::Create(
-        request.meta_data(), &response, backend->GetLabelProvider(),
-        &response_provider));
+        request.meta_data(), &response,
+        [raw_response](size_t byte_size) {
+          return raw_response->AddRawOutput(byte_size);
+        },
+        backend->GetLabelProvider(), &response_provider));
 
     RequestStatus* request_status = response.mutable_request_status();
-    uint64_t id = request.meta_data().id();
     uintptr_t execution_context = this->GetExecutionContext();
     server->HandleInfer(
         request_status, backend, request_provider, response_provider,
-        infer_stats,
-        [this, execution_context, id, request_status, &response, infer_stats,
-         timer]() mutable {
-          if (response.ByteSizeLong() > INT_MAX) {
-            request_status->set_code(RequestStatusCode::INVALID_ARG);
-            request_status->set_msg(
-                "Response has byte size " +
-                std::to_string(response.ByteSizeLong()) +
-                " which exceed gRPC's byte size limit " +
-                std::to_string(INT_MAX) + ".");
-          }
-          // If the response is an error then clear the meta-data
-          // and raw output as they may be partially or
-          // un-initialized.
-          if (request_status->code() != RequestStatusCode::SUCCESS) {
-            response.mutable_meta_data()->Clear();
-            response.mutable_raw_output()->Clear();
-          }
-
-          response.mutable_meta_data()->set_id(id);
-          this->CompleteExecution(execution_context);
+        infer_stats, std::move(memory),
+        [this, execution_context, grpc_request, grpc_response,
+         &response_buffer, infer_stats, timer]() mutable {
+          SendResponse(
+              execution_context, grpc_request->Request(), grpc_response,
+              response_buffer);
           timer.reset();
         });
 
     return Status::Success;
   }
 
-  void ExecuteRPC(InferRequest& request, InferResponse& response) final override
+  void ExecuteRPC(
+      grpc::ByteBuffer& request_buffer,
+      grpc::ByteBuffer& response_buffer) override
   {
-    auto server = this->GetResources()->GetServer();
-    auto infer_stats = std::make_shared<ModelInferStats>(
-        server->StatusManager(), request.model_name());
-    auto timer = std::make_shared<ModelInferStats::ScopedTimer>();
-    infer_stats->StartRequestTimer(timer.get());
-    infer_stats->SetRequestedVersion(request.model_version());
-
-    Status status = InferHelper(server, infer_stats, timer, request, response);
-
-    if (!status.IsOk()) {
-      LOG_VERBOSE(1) << "Infer failed: " << status.Message();
-      infer_stats->SetFailed(true);
-      RequestStatusFactory::Create(
-          response.mutable_request_status(), 0 /* request_id */, server->Id(),
-          status);
-
-      // If the response is an error then clear the meta-data and raw
-      // output as they may be partially or un-initialized.
-      response.mutable_meta_data()->Clear();
-      response.mutable_raw_output()->Clear();
-
-      response.mutable_meta_data()->set_id(request.meta_data().id());
-      this->CompleteExecution(this->GetExecutionContext());
-    }
+    // The request is parsed here instead of by gRPC so that the raw
+    // inputs can reference the received slices instead of being
+    // copied.
+    auto grpc_request = std::make_shared<GRPCInferRequest>();
+    Status status = grpc_request->Parse(&request_buffer);
+    ExecuteInfer(grpc_request, status, response_buffer);
   }
 };
 
+// The inference RPCs use raw ByteBuffer messages and are
+// (de)serialized by GRPCInferRequest and GRPCInferResponse. All
+// other RPCs use the generated protobuf messages.
+struct InferenceGRPCService {
+  using AsyncService = GRPCService::WithAsyncMethod_Status<
+      GRPCService::WithAsyncMethod_Profile<GRPCService::WithAsyncMethod_Health<
+          GRPCService::WithAsyncMethod_Load<GRPCService::WithRawMethod_Infer<
+              GRPCService::WithRawMethod_StreamInfer<GRPCService::Service>>>>>>;
+};
+
 class InferContext final
-    : public InferBaseContext<LifeCycleUnary<InferRequest, InferResponse>> {
+    : public InferBaseContext<
+          LifeCycleUnary<grpc::ByteBuffer, grpc::ByteBuffer>> {
 };
 
 class StreamInferContext final
     : public InferBaseContext<
-          BidirectionalStreamingLifeCycle<InferRequest, InferResponse>> {
+          BidirectionalStreamingLifeCycle<grpc::ByteBuffer, grpc::ByteBuffer>> {
+  // Requests that set 'chunk' are received as a sequence of messages
+  // that are collected into 'chunked_request_' until the last one
+  // arrives. The messages of a stream are executed one at a time, in
+  // order, so no locking is needed.
+  void ExecuteRPC(
+      grpc::ByteBuffer& request_buffer,
+      grpc::ByteBuffer& response_buffer) final override
+  {
+    if (chunked_request_ == nullptr) {
+      auto grpc_request = std::make_shared<GRPCInferRequest>();
+      Status status = grpc_request->Parse(&request_buffer);
+      if (!status.IsOk() || !grpc_request->Request().has_chunk()) {
+        ExecuteInfer(grpc_request, status, response_buffer);
+        return;
+      }
+
+      // The first message of a chunked request is parsed again below
+      // so that its raw inputs are collected like those of the later
+      // messages.
+      chunked_request_ = std::make_shared<GRPCInferRequest>();
+      chunked_status_ = Status::Success;
+    }
+
+    bool last;
+    Status status = chunked_request_->ParseChunk(&request_buffer, &last);
+    if (chunked_status_.IsOk()) {
+      chunked_status_ = status;
+    }
+
+    // Nothing is sent until the last message of the request arrives.
+    if (!last) {
+      CompleteExecution(
+          GetExecutionContext(), std::vector<grpc::ByteBuffer>());
+      return;
+    }
+
+    std::shared_ptr<GRPCInferRequest> grpc_request;
+    grpc_request.swap(chunked_request_);
+    ExecuteInfer(grpc_request, chunked_status_, response_buffer);
+  }
+
+  void SendResponse(
+      uintptr_t execution_context, const InferRequest& request,
+      const std::shared_ptr<GRPCInferResponse>& grpc_response,
+      grpc::ByteBuffer& response_buffer) final override
+  {
+    if (!request.has_chunk()) {
+      InferBaseContext::SendResponse(
+          execution_context, request, grpc_response, response_buffer);
+      return;
+    }
+
+    // If the response is an error then clear the meta-data and raw
+    // output as they may be partially or un-initialized.
+    InferResponse* response = grpc_response->MutableResponse();
+    if (response->request_status().code() != RequestStatusCode::SUCCESS) {
+      response->mutable_meta_data()->Clear();
+      grpc_response->ClearRawOutput();
+    }
+
+    response->mutable_meta_data()->set_id(request.meta_data().id());
+
+    uint64_t chunk_byte_size = request.chunk().max_byte_size();
+    if ((chunk_byte_size == 0) || (chunk_byte_size > MAX_GRPC_CHUNK_SIZE)) {
+      chunk_byte_size = DEFAULT_GRPC_CHUNK_SIZE;
+    }
+
+    std::vector<grpc::ByteBuffer> buffers;
+    grpc_response->SerializeChunks(chunk_byte_size, &buffers);
+    CompleteExecution(execution_context, std::move(buffers));
+  }
+
+  void OnContextReset() final override { chunked_request_.reset(); }
+
+  std::shared_ptr<GRPCInferRequest> chunked_request_;
+  Status chunked_status_;
 };
 
 class ProfileContext final
@@ -242,6 +389,23 @@ class HealthContext final
         });
   }
 };
+
+class LoadContext final
+    : public Context<LoadRequest, LoadResponse, AsyncResources> {
+  void ExecuteRPC(LoadRequest& request, LoadResponse& response) final override
+  {
+    uintptr_t execution_context = this->GetExecutionContext();
+    GetResources()->GetMgmtThreadPool().enqueue(
+        [this, execution_context, &request, &response] {
+          RequestStatus* request_status = response.mutable_request_status();
+          ServerLoadStatus* load_status = response.mutable_load_status();
+
+          GetResources()->GetServer()->HandleLoad(
+              request_status, load_status, request.model_name());
+          this->CompleteExecution(execution_context);
+        });
+  }
+};
 }  // namespace
 
 GRPCServer::GRPCServer(
@@ -273,28 +437,33 @@ GRPCServer::Create(
   (*grpc_server)->GetBuilder().SetMaxMessageSize(MAX_GRPC_MESSAGE_SIZE);
 
   LOG_INFO << "Register TensorRT GRPCService";
-  auto inferenceService = (*grpc_server)->RegisterAsyncService<GRPCService>();
+  auto inferenceService =
+      (*grpc_server)->RegisterAsyncService<InferenceGRPCService>();
 
   LOG_INFO << "Register Infer RPC";
   (*grpc_server)->rpcInfer_ = inferenceService->RegisterRPC<InferContext>(
-      &GRPCService::AsyncService::RequestInfer);
+      &InferenceGRPCService::AsyncService::RequestInfer);
 
   LOG_INFO << "Register StreamInfer RPC";
   (*grpc_server)->rpcStreamInfer_ =
       inferenceService->RegisterRPC<StreamInferContext>(
-          &GRPCService::AsyncService::RequestStreamInfer);
+          &InferenceGRPCService::AsyncService::RequestStreamInfer);
 
   LOG_INFO << "Register Status RPC";
   (*grpc_server)->rpcStatus_ = inferenceService->RegisterRPC<StatusContext>(
-      &GRPCService::AsyncService::RequestStatus);
+      &InferenceGRPCService::AsyncService::RequestStatus);
 
   LOG_INFO << "Register Profile RPC";
   (*grpc_server)->rpcProfile_ = inferenceService->RegisterRPC<ProfileContext>(
-      &GRPCService::AsyncService::RequestProfile);
+      &InferenceGRPCService::AsyncService::RequestProfile);
 
   LOG_INFO << "Register Health RPC";
   (*grpc_server)->rpcHealth_ = inferenceService->RegisterRPC<HealthContext>(
-      &GRPCService::AsyncService::RequestHealth);
+      &InferenceGRPCService::AsyncService::RequestHealth);
+
+  LOG_INFO << "Register Load RPC";
+  (*grpc_server)->rpcLoad_ = inferenceService->RegisterRPC<LoadContext>(
+      &InferenceGRPCService::AsyncService::RequestLoad);
 
   return Status::Success;
 }
@@ -315,6 +484,7 @@ GRPCServer::Start()
     executor->RegisterContexts(rpcStatus_, g_Resources, 1);
     executor->RegisterContexts(rpcHealth_, g_Resources, 1);
     executor->RegisterContexts(rpcProfile_, g_Resources, 1);
+    executor->RegisterContexts(rpcLoad_, g_Resources, 1);
 
     AsyncRun();
     return Status::Success;
@@ -31,16 +31,33 @@
 #include <google/protobuf/text_format.h>
 #include <re2/re2.h>
 #include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
 #include "src/core/backend.h"
 #include "src/core/constants.h"
 #include "src/core/logging.h"
 #include "src/core/metrics.h"
+#include "src/core/object_pool.h"
 #include "src/core/provider_utils.h"
 #include "src/core/request_status.h"
 #include "src/core/server.h"
 
 namespace nvidia { namespace inferenceserver {
 
+namespace {
+
+// Convert 'fn' to the generic hook type taken by evhtp, which calls
+// it with the arguments of the hook it is set for.
+template <typename F>
+evhtp_hook
+ToEvhtpHook(F fn)
+{
+  return reinterpret_cast<evhtp_hook>(reinterpret_cast<void (*)()>(fn));
+}
+
+}  // namespace
+
 // Generic HTTP server using evhtp
 class HTTPServerImpl : public HTTPServer {
  public:
@@ -52,6 +69,9 @@ class HTTPServerImpl : public HTTPServer {
   virtual ~HTTPServerImpl() { Stop(); }
 
   static void Dispatch(evhtp_request_t* req, void* arg);
+  static evhtp_res NewConnection(evhtp_connection_t* conn, void* arg);
+  static evhtp_res DispatchHeaders(
+      evhtp_request_t* req, evhtp_headers_t* headers, void* arg);
 
   Status Start() override;
   Status Stop() override;
@@ -59,6 +79,12 @@ class HTTPServerImpl : public HTTPServer {
  protected:
   virtual void Handle(evhtp_request_t* req) = 0;
 
+  // Called once the headers of 'req' are received, before its body.
+  virtual evhtp_res HandleHeaders(evhtp_request_t* req)
+  {
+    return EVHTP_RES_OK;
+  }
+
   static void StopCallback(int sock, short events, void* arg);
 
   int32_t port_;
@@ -78,6 +104,7 @@ HTTPServerImpl::Start()
     evbase_ = event_base_new();
     htp_ = evhtp_new(evbase_, NULL);
     evhtp_set_gencb(htp_, HTTPServerImpl::Dispatch, this);
+    evhtp_set_post_accept_cb(htp_, HTTPServerImpl::NewConnection, this);
     evhtp_use_threads_wexit(htp_, NULL, NULL, thread_cnt_, NULL);
     evhtp_bind_socket(htp_, "0.0.0.0", port_, 1024);
     // Set listening event for breaking event loop
@@ -124,6 +151,22 @@ HTTPServerImpl::Dispatch(evhtp_request_t* req, void* arg)
   (static_cast<HTTPServerImpl*>(arg))->Handle(req);
 }
 
+evhtp_res
+HTTPServerImpl::NewConnection(evhtp_connection_t* conn, void* arg)
+{
+  evhtp_connection_set_hook(
+      conn, evhtp_hook_on_headers,
+      ToEvhtpHook(HTTPServerImpl::DispatchHeaders), arg);
+  return EVHTP_RES_OK;
+}
+
+evhtp_res
+HTTPServerImpl::DispatchHeaders(
+    evhtp_request_t* req, evhtp_headers_t* headers, void* arg)
+{
+  return (static_cast<HTTPServerImpl*>(arg))->HandleHeaders(req);
+}
+
 #ifdef TRTIS_ENABLE_METRICS
 
 // Handle HTTP requests to obtain prometheus metrics
@@ -173,7 +216,7 @@ class HTTPAPIServer : public HTTPServerImpl {
       const int32_t port, const int thread_cnt)
       : HTTPServerImpl(port, thread_cnt), server_(server),
         endpoint_names_(endpoints),
-        api_regex_(R"(/api/(health|profile|infer|status)(.*))"),
+        api_regex_(R"(/api/(health|profile|infer|status|load)(.*))"),
         health_regex_(R"(/(live|ready))"),
         infer_regex_(R"(/([^/]+)(?:/(\d+))?)"), status_regex_(R"(/(.*))")
   {
@@ -208,21 +251,42 @@ class HTTPAPIServer : public HTTPServerImpl {
     std::shared_ptr<ModelInferStats::ScopedTimer> timer_;
   };
 
+  // The result of reserving the memory of an inference request when
+  // its headers are received, held until the request is handled.
+  struct PendingInfer {
+    Status status_;
+    InferenceServer::MemoryReservation memory_;
+  };
+
   void Handle(evhtp_request_t* req) override;
+  evhtp_res HandleHeaders(evhtp_request_t* req) override;
+
+  // Reserve the memory of the inference request 'req' from its
+  // header. Requests whose header is invalid are not reserved and
+  // fail when they are handled.
+  Status ReserveInferMemory(
+      evhtp_request_t* req, InferenceServer::MemoryReservation* memory);
+  static evhtp_res DiscardBody(
+      evhtp_request_t* req, evbuffer* buf, void* arg);
+  static evhtp_res ReleasePendingInfer(evhtp_request_t* req, void* arg);
 
   void HandleHealth(evhtp_request_t* req, const std::string& health_uri);
   void HandleProfile(evhtp_request_t* req, const std::string& profile_uri);
   void HandleInfer(evhtp_request_t* req, const std::string& infer_uri);
   void HandleStatus(evhtp_request_t* req, const std::string& status_uri);
+  void HandleLoad(evhtp_request_t* req, const std::string& load_uri);
 
   // Helper function that utilizes RETURN_IF_ERROR to avoid nested 'if'
   Status InferHelper(
       std::shared_ptr<ModelInferStats>& infer_stats,
       std::shared_ptr<ModelInferStats::ScopedTimer>& timer,
       const std::string& model_name, int64_t model_version,
-      InferRequestHeader& request_header, evhtp_request_t* req);
+      InferRequestHeader& request_header,
+      InferenceServer::MemoryReservation&& memory, evhtp_request_t* req);
 
-  void FinishInferResponse(const std::shared_ptr<InferRequest>& req);
+  // Send the response for 'req' and release it. Called exactly once
+  // for every request passed to InferenceServer::HandleInfer.
+  void FinishInferResponse(InferRequest* req);
   static void OKReplyCallback(evthr_t* thr, void* arg, void* shared);
   static void BADReplyCallback(evthr_t* thr, void* arg, void* shared);
 
@@ -233,6 +297,9 @@ class HTTPAPIServer : public HTTPServerImpl {
   re2::RE2 health_regex_;
   re2::RE2 infer_regex_;
   re2::RE2 status_regex_;
+
+  std::mutex pending_mu_;
+  std::unordered_map<evhtp_request_t*, PendingInfer> pending_infers_;
 };
 
 void
@@ -272,6 +339,13 @@ HTTPAPIServer::Handle(evhtp_request_t* req)
       HandleInfer(req, rest);
       return;
     }
+    // load
+    if (endpoint == "load" &&
+        (std::find(endpoint_names_.begin(), endpoint_names_.end(), "load") !=
+         endpoint_names_.end())) {
+      HandleLoad(req, rest);
+      return;
+    }
   }
 
   LOG_VERBOSE(1) << "HTTP error: " << req->method << " " << req->uri->path->full
@@ -279,6 +353,102 @@ HTTPAPIServer::Handle(evhtp_request_t* req)
   evhtp_send_reply(req, EVHTP_RES_BADREQ);
 }
 
+evhtp_res
+HTTPAPIServer::HandleHeaders(evhtp_request_t* req)
+{
+  // Only inference requests need to be checked before their body is
+  // received, and only when the server has a memory budget.
+  if ((server_->InflightMemoryByteSize() == 0) ||
+      (req->method != htp_method_POST)) {
+    return EVHTP_RES_OK;
+  }
+
+  std::string endpoint, rest;
+  if (!RE2::FullMatch(
+          std::string(req->uri->path->full), api_regex_, &endpoint, &rest) ||
+      (endpoint != "infer")) {
+    return EVHTP_RES_OK;
+  }
+
+  PendingInfer pending;
+  pending.status_ = ReserveInferMemory(req, &pending.memory_);
+  if (!pending.status_.IsOk()) {
+    // The request is rejected once it is complete, drop its body as
+    // it arrives instead of buffering it.
+    evhtp_request_set_hook(
+        req, evhtp_hook_on_read,
+        ToEvhtpHook(HTTPAPIServer::DiscardBody), nullptr);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(pending_mu_);
+    pending_infers_[req] = std::move(pending);
+  }
+
+  // Release the reservation if the request is freed without being
+  // handled, for example because the client disconnects.
+  evhtp_request_set_hook(
+      req, evhtp_hook_on_request_fini,
+      ToEvhtpHook(HTTPAPIServer::ReleasePendingInfer), this);
+
+  return EVHTP_RES_OK;
+}
+
+Status
+HTTPAPIServer::ReserveInferMemory(
+    evhtp_request_t* req, InferenceServer::MemoryReservation* memory)
+{
+  std::string endpoint, infer_uri;
+  RE2::FullMatch(
+      std::string(req->uri->path->full), api_regex_, &endpoint, &infer_uri);
+
+  std::string model_name, model_version_str;
+  if (!RE2::FullMatch(
+          infer_uri, infer_regex_, &model_name, &model_version_str)) {
+    return Status::Success;
+  }
+
+  int64_t model_version = -1;
+  if (!model_version_str.empty()) {
+    model_version = std::atoll(model_version_str.c_str());
+  }
+
+  const char* infer_request_header =
+      evhtp_kv_find(req->headers_in, kInferRequestHTTPHeader);
+  if (infer_request_header == nullptr) {
+    return Status::Success;
+  }
+
+  InferRequestHeader request_header;
+  google::protobuf::TextFormat::ParseFromString(
+      infer_request_header, &request_header);
+
+  std::shared_ptr<InferenceBackend> backend = nullptr;
+  if (!server_->GetInferenceBackend(model_name, model_version, &backend)
+           .IsOk() ||
+      !NormalizeRequestHeader(*backend, request_header).IsOk()) {
+    return Status::Success;
+  }
+
+  return server_->ReserveInferMemory(*backend, request_header, memory);
+}
+
+evhtp_res
+HTTPAPIServer::DiscardBody(evhtp_request_t* req, evbuffer* buf, void* arg)
+{
+  evbuffer_drain(buf, evbuffer_get_length(buf));
+  return EVHTP_RES_OK;
+}
+
+evhtp_res
+HTTPAPIServer::ReleasePendingInfer(evhtp_request_t* req, void* arg)
+{
+  HTTPAPIServer* server = static_cast<HTTPAPIServer*>(arg);
+  std::lock_guard<std::mutex> lock(server->pending_mu_);
+  server->pending_infers_.erase(req);
+  return EVHTP_RES_OK;
+}
+
 void
 HTTPAPIServer::HandleHealth(evhtp_request_t* req, const std::string& health_uri)
 {
@@ -369,9 +539,10 @@ HTTPAPIServer::HandleInfer(evhtp_request_t* req, const std::string& infer_uri)
     model_version = std::atoll(model_version_str.c_str());
   }
 
-  auto infer_stats =
-      std::make_shared<ModelInferStats>(server_->StatusManager(), model_name);
-  auto timer = std::make_shared<ModelInferStats::ScopedTimer>();
+  auto infer_stats = std::allocate_shared<ModelInferStats>(
+      PoolAllocator<ModelInferStats>(), server_->StatusManager(), model_name);
+  auto timer = std::allocate_shared<ModelInferStats::ScopedTimer>(
+      PoolAllocator<ModelInferStats::ScopedTimer>());
   infer_stats->StartRequestTimer(timer.get());
   infer_stats->SetRequestedVersion(model_version);
 
@@ -382,8 +553,23 @@ HTTPAPIServer::HandleInfer(evhtp_request_t* req, const std::string& infer_uri)
   google::protobuf::TextFormat::ParseFromString(
       infer_request_header, &request_header);
 
-  Status status = InferHelper(
-      infer_stats, timer, model_name, model_version, request_header, req);
+  // Take the memory reserved when the headers were received, if any.
+  PendingInfer pending;
+  {
+    std::lock_guard<std::mutex> lock(pending_mu_);
+    auto itr = pending_infers_.find(req);
+    if (itr != pending_infers_.end()) {
+      pending = std::move(itr->second);
+      pending_infers_.erase(itr);
+    }
+  }
+
+  Status status = pending.status_;
+  if (status.IsOk()) {
+    status = InferHelper(
+        infer_stats, timer, model_name, model_version, request_header,
+        std::move(pending.memory_), req);
+  }
 
   if (!status.IsOk()) {
     RequestStatus request_status;
@@ -474,26 +660,84 @@ HTTPAPIServer::HandleStatus(evhtp_request_t* req, const std::string& status_uri)
                : EVHTP_RES_BADREQ);
 }
 
+void
+HTTPAPIServer::HandleLoad(evhtp_request_t* req, const std::string& load_uri)
+{
+  if (req->method != htp_method_GET) {
+    evhtp_send_reply(req, EVHTP_RES_METHNALLOWED);
+    return;
+  }
+
+  std::string model_name;
+  if (!load_uri.empty()) {
+    if (!RE2::FullMatch(load_uri, status_regex_, &model_name)) {
+      evhtp_send_reply(req, EVHTP_RES_BADREQ);
+      return;
+    }
+  }
+
+  RequestStatus request_status;
+  ServerLoadStatus load_status;
+  server_->HandleLoad(&request_status, &load_status, model_name);
+
+  // If got load successfully then send it...
+  if (request_status.code() == RequestStatusCode::SUCCESS) {
+    std::string format;
+    const char* format_c_str = evhtp_kv_find(req->uri->query, "format");
+    if (format_c_str != NULL) {
+      format = std::string(format_c_str);
+    } else {
+      format = "text";
+    }
+
+    std::string load_status_str;
+    if (format == "binary") {
+      load_status.SerializeToString(&load_status_str);
+      evbuffer_add(
+          req->buffer_out, load_status_str.c_str(), load_status_str.size());
+      evhtp_headers_add_header(
+          req->headers_out,
+          evhtp_header_new("Content-Type", "application/octet-stream", 1, 1));
+    } else {
+      load_status_str = load_status.DebugString();
+      evbuffer_add(
+          req->buffer_out, load_status_str.c_str(), load_status_str.size());
+    }
+  }
+
+  evhtp_headers_add_header(
+      req->headers_out,
+      evhtp_header_new(
+          kStatusHTTPHeader, request_status.ShortDebugString().c_str(), 1, 1));
+
+  evhtp_send_reply(
+      req, (request_status.code() == RequestStatusCode::SUCCESS)
+               ? EVHTP_RES_OK
+               : EVHTP_RES_BADREQ);
+}
+
 Status
 HTTPAPIServer::InferHelper(
     std::shared_ptr<ModelInferStats>& infer_stats,
     std::shared_ptr<ModelInferStats::ScopedTimer>& timer,
     const std::string& model_name, int64_t model_version,
-    InferRequestHeader& request_header, evhtp_request_t* req)
+    InferRequestHeader& request_header,
+    InferenceServer::MemoryReservation&& memory, evhtp_request_t* req)
 {
   std::shared_ptr<InferenceBackend> backend = nullptr;
   RETURN_IF_ERROR(
       server_->GetInferenceBackend(model_name, model_version, &backend));
   infer_stats->SetMetricReporter(backend->MetricReporter());
 
-  std::unordered_map<std::string, std::shared_ptr<SystemMemory>> input_map;
+  InferRequestProvider::InputBufferMap input_map;
   RETURN_IF_ERROR(NormalizeRequestHeader(*backend, request_header));
   RETURN_IF_ERROR(EVBufferToInputMap(
       model_name, request_header, req->buffer_in, input_map));
 
   std::shared_ptr<InferRequestProvider> request_provider;
   RETURN_IF_ERROR(InferRequestProvider::Create(
-      model_name, model_version, request_header, input_map, &request_provider));
+      *backend, model_name, model_version, std::move(request_header),
+      input_map, &request_provider));
   infer_stats->SetBatchSize(request_provider->RequestHeader().batch_size());
 
   std::shared_ptr<HTTPInferResponseProvider> response_provider;
@@ -501,13 +745,16 @@ HTTPAPIServer::InferHelper(
       req->buffer_out, *backend, request_provider->RequestHeader(),
       backend->GetLabelProvider(), &response_provider));
 
-  std::shared_ptr<InferRequest> request(new InferRequest(
-      req, request_header.id(), request_provider, response_provider,
-      infer_stats, timer));
+  // The request is owned by the completion function, which captures
+  // it by pointer so that the function doesn't need to allocate.
+  InferRequest* request = new (PoolAllocator<InferRequest>().allocate(1))
+      InferRequest(
+          req, request_provider->RequestHeader().id(), request_provider,
+          response_provider, infer_stats, timer);
   server_->HandleInfer(
       &(request->request_status_), backend, request->request_provider_,
-      request->response_provider_, infer_stats,
-      [this, request]() mutable { this->FinishInferResponse(request); });
+      request->response_provider_, infer_stats, std::move(memory),
+      [this, request]() { this->FinishInferResponse(request); });
 
   return Status::Success;
 }
@@ -529,8 +776,9 @@ HTTPAPIServer::BADReplyCallback(evthr_t* thr, void* arg, void* shared)
 }
 
 void
-HTTPAPIServer::FinishInferResponse(const std::shared_ptr<InferRequest>& req)
+HTTPAPIServer::FinishInferResponse(InferRequest* req)
 {
+  std::unique_ptr<InferRequest, PoolDeleter<InferRequest>> owned_req(req);
   if (req->FinalizeResponse() == EVHTP_RES_OK) {
     evthr_defer(req->thread_, OKReplyCallback, req->req_);
   } else {
@@ -606,6 +854,23 @@ HTTPAPIServer::InferRequest::FinalizeResponse()
       req_->headers_out,
       evhtp_header_new("Content-Type", "application/octet-stream", 1, 1));
 
+  // Also report the server-side timing, if requested, in the standard
+  // Server-Timing format (durations in milliseconds) so that it can be
+  // read without parsing the response header.
+  if (response_header->has_timing()) {
+    const InferResponseHeader::Timing& timing = response_header->timing();
+    char server_timing[128];
+    snprintf(
+        server_timing, sizeof(server_timing),
+        "request;dur=%.3f, queue;dur=%.3f, compute;dur=%.3f",
+        timing.request_time_ns() / 1000000.0,
+        timing.queue_time_ns() / 1000000.0,
+        timing.compute_time_ns() / 1000000.0);
+    evhtp_headers_add_header(
+        req_->headers_out,
+        evhtp_header_new(kServerTimingHTTPHeader, server_timing, 1, 1));
+  }
+
   return (request_status_.code() == RequestStatusCode::SUCCESS)
              ? EVHTP_RES_OK
              : EVHTP_RES_BADREQ;
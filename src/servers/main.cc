@@ -90,7 +90,7 @@ int32_t metrics_port_ = -1;
 
 // endpoint names for http/gRPC
 std::vector<std::string> endpoint_names = {"status", "health", "profile",
-                                           "infer"};
+                                           "infer", "load"};
 
 // Should GPU metrics be reported.
 bool allow_gpu_metrics_ = false;
@@ -116,6 +116,8 @@ enum OptionId {
   OPTION_EXIT_ON_ERROR,
   OPTION_STRICT_MODEL_CONFIG,
   OPTION_STRICT_READINESS,
+  OPTION_READINESS_MAX_QUEUE_WAIT_US,
+  OPTION_INFLIGHT_MEMORY_BYTE_SIZE,
   OPTION_ALLOW_PROFILING,
   OPTION_ALLOW_GRPC,
   OPTION_ALLOW_HTTP,
@@ -131,6 +133,11 @@ enum OptionId {
   OPTION_ALLOW_POLL_REPO,
   OPTION_POLL_REPO_SECS,
   OPTION_EXIT_TIMEOUT_SECS,
+  OPTION_CPU_CGROUP_ROOT,
+  OPTION_MODEL_QUANTIZER,
+  OPTION_MODEL_QUANTIZER_TIMEOUT_SECS,
+  OPTION_CUSTOM_MEMORY_POOL_CACHE_BYTE_SIZE,
+  OPTION_CUSTOM_MEMORY_POOL_HUGE_PAGES,
   OPTION_TF_ALLOW_SOFT_PLACEMENT,
   OPTION_TF_GPU_MEMORY_FRACTION,
 };
@@ -175,6 +182,14 @@ std::vector<Option> options_{
      "is responsive and all models are available. If false "
      "/api/health/ready endpoint indicates ready if server is responsive "
      "even if some/all models are unavailable."},
+    {OPTION_READINESS_MAX_QUEUE_WAIT_US, "readiness-max-queue-wait-us",
+     "If non-zero /api/health/ready endpoint indicates not ready if the "
+     "estimated queue wait of any model, as reported by the /api/load "
+     "endpoint, exceeds this value in microseconds."},
+    {OPTION_INFLIGHT_MEMORY_BYTE_SIZE, "inflight-memory-byte-size",
+     "If non-zero, the maximum total size, in bytes, of the input and "
+     "output tensors of all in-flight inference requests. A request that "
+     "would exceed this limit is rejected."},
     {OPTION_ALLOW_PROFILING, "allow-profiling", "Allow server profiling."},
     {OPTION_ALLOW_GRPC, "allow-grpc",
      "Allow the server to listen for GRPC requests."},
@@ -190,7 +205,8 @@ std::vector<Option> options_{
     {OPTION_HTTP_PORT, "http-port",
      "The port for the server to listen on for HTTP requests."},
     {OPTION_HTTP_HEALTH_PORT, "http-health-port",
-     "The port for the server to listen on for HTTP Health requests."},
+     "The port for the server to listen on for HTTP Health and Load "
+     "requests."},
     {OPTION_METRICS_PORT, "metrics-port",
      "The port reporting prometheus metrics."},
     {OPTION_GRPC_INFER_THREAD_COUNT, "grpc-infer-thread-count",
@@ -211,6 +227,29 @@ std::vector<Option> options_{
      "Timeout (in seconds) when exiting to wait for in-flight inferences to "
      "finish. After the timeout expires the server exits even if inferences "
      "are still in flight."},
+    {OPTION_CPU_CGROUP_ROOT, "cpu-cgroup-root",
+     "The cgroup v2 directory containing the server process. If specified "
+     "a threaded cgroup is created in this directory for each model that "
+     "specifies CPU optimization settings and the model's threads are "
+     "placed in that cgroup."},
+    {OPTION_MODEL_QUANTIZER, "model-quantizer",
+     "The command used to quantize models that request load-time "
+     "quantization in their optimization policy. The command is run as "
+     "'<quantizer> <kind> <platform> <input path> <output path> "
+     "<setting>...' where each setting is a '<name>=<value>' pair."},
+    {OPTION_MODEL_QUANTIZER_TIMEOUT_SECS, "model-quantizer-timeout-secs",
+     "Timeout (in seconds) for quantizing one model file. After the timeout "
+     "expires the quantizer is killed and the model fails to load. A value "
+     "of zero indicates no timeout."},
+    {OPTION_CUSTOM_MEMORY_POOL_CACHE_BYTE_SIZE,
+     "custom-memory-pool-cache-byte-size",
+     "The maximum total size, in bytes, of the memory blocks freed by "
+     "custom backends that are kept for reuse by later allocations. The "
+     "default value 0 indicates that freed blocks are returned to the "
+     "system immediately."},
+    {OPTION_CUSTOM_MEMORY_POOL_HUGE_PAGES, "custom-memory-pool-huge-pages",
+     "Advise that large memory blocks allocated by custom backends be "
+     "backed by transparent huge pages."},
     {OPTION_TF_ALLOW_SOFT_PLACEMENT, "tf-allow-soft-placement",
      "Instruct TensorFlow to use CPU implementation of an operation when "
      "a GPU implementation is not available."},
@@ -416,6 +455,12 @@ ParseIntOption(const std::string arg)
   return std::stoi(arg);
 }
 
+int64_t
+ParseInt64Option(const std::string arg)
+{
+  return std::stoll(arg);
+}
+
 float
 ParseFloatOption(const std::string arg)
 {
@@ -429,11 +474,21 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
   std::string model_store_path(server->ModelStorePath());
   bool strict_model_config = server->StrictModelConfigEnabled();
   bool strict_readiness = server->StrictReadinessEnabled();
+  int64_t readiness_max_queue_wait_us =
+      server->ReadinessMaxQueueWaitMicroseconds();
+  int64_t inflight_memory_byte_size = server->InflightMemoryByteSize();
   bool allow_profiling = server->ProfilingEnabled();
   bool tf_allow_soft_placement = server->TensorFlowSoftPlacementEnabled();
   float tf_gpu_memory_fraction = server->TensorFlowGPUMemoryFraction();
   int32_t exit_timeout_secs = server->ExitTimeoutSeconds();
   int32_t repository_poll_secs = server->RepositoryPollSeconds();
+  std::string cpu_cgroup_root(server->CpuCgroupRoot());
+  std::string model_quantizer(server->ModelQuantizer());
+  int32_t model_quantizer_timeout_secs =
+      server->ModelQuantizerTimeoutSeconds();
+  int64_t custom_memory_pool_cache_byte_size =
+      server->CustomMemoryPoolCacheByteSize();
+  bool custom_memory_pool_huge_pages = server->CustomMemoryPoolHugePages();
 
   bool exit_on_error = exit_on_failed_init_;
 
@@ -497,6 +552,12 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
       case OPTION_STRICT_READINESS:
         strict_readiness = ParseBoolOption(optarg);
         break;
+      case OPTION_READINESS_MAX_QUEUE_WAIT_US:
+        readiness_max_queue_wait_us = ParseInt64Option(optarg);
+        break;
+      case OPTION_INFLIGHT_MEMORY_BYTE_SIZE:
+        inflight_memory_byte_size = ParseInt64Option(optarg);
+        break;
 
       case OPTION_ALLOW_PROFILING:
         allow_profiling = ParseBoolOption(optarg);
@@ -546,6 +607,21 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
       case OPTION_EXIT_TIMEOUT_SECS:
         exit_timeout_secs = ParseIntOption(optarg);
         break;
+      case OPTION_CPU_CGROUP_ROOT:
+        cpu_cgroup_root = optarg;
+        break;
+      case OPTION_MODEL_QUANTIZER:
+        model_quantizer = optarg;
+        break;
+      case OPTION_MODEL_QUANTIZER_TIMEOUT_SECS:
+        model_quantizer_timeout_secs = ParseIntOption(optarg);
+        break;
+      case OPTION_CUSTOM_MEMORY_POOL_CACHE_BYTE_SIZE:
+        custom_memory_pool_cache_byte_size = ParseInt64Option(optarg);
+        break;
+      case OPTION_CUSTOM_MEMORY_POOL_HUGE_PAGES:
+        custom_memory_pool_huge_pages = ParseBoolOption(optarg);
+        break;
 
       case OPTION_TF_ALLOW_SOFT_PLACEMENT:
         tf_allow_soft_placement = ParseBoolOption(optarg);
@@ -582,7 +658,8 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
   http_health_port_ = http_health_port;
 
   metrics_port_ = allow_metrics_ ? metrics_port : -1;
-  http_ports_ = {http_port_, http_health_port_, http_port_, http_port_};
+  http_ports_ = {http_port_, http_health_port_, http_port_, http_port_,
+                 http_port_};
 
   // Check if HTTP, GRPC and metrics port clash
   if (CheckPortCollision())
@@ -597,8 +674,18 @@ Parse(nvidia::inferenceserver::InferenceServer* server, int argc, char** argv)
   server->SetModelStorePath(model_store_path);
   server->SetStrictModelConfigEnabled(strict_model_config);
   server->SetStrictReadinessEnabled(strict_readiness);
+  server->SetReadinessMaxQueueWaitMicroseconds(
+      std::max((int64_t)0, readiness_max_queue_wait_us));
+  server->SetInflightMemoryByteSize(
+      std::max((int64_t)0, inflight_memory_byte_size));
   server->SetProfilingEnabled(allow_profiling);
   server->SetExitTimeoutSeconds(exit_timeout_secs);
+  server->SetCpuCgroupRoot(cpu_cgroup_root);
+  server->SetModelQuantizer(model_quantizer);
+  server->SetModelQuantizerTimeoutSeconds(model_quantizer_timeout_secs);
+  server->SetCustomMemoryPoolCacheByteSize(
+      std::max((int64_t)0, custom_memory_pool_cache_byte_size));
+  server->SetCustomMemoryPoolHugePages(custom_memory_pool_huge_pages);
 
   server->SetRepositoryPollSeconds(
       (allow_poll_model_repository) ? std::max(0, repository_poll_secs) : 0);
@@ -0,0 +1,82 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <iostream>
+#include <string>
+#include "src/core/filesystem.h"
+#include "src/core/repository_archive.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+void
+Usage(char** argv, const std::string& msg = std::string())
+{
+  if (!msg.empty()) {
+    std::cerr << "error: " << msg << std::endl;
+  }
+
+  std::cerr << "Usage: " << argv[0]
+            << " <model repository path> <archive path>" << std::endl;
+
+  exit(1);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  if (argc != 3) {
+    Usage(argv);
+  }
+
+  const std::string repository_path(argv[1]);
+  const std::string archive_path(argv[2]);
+
+  bool is_dir = false;
+  ni::Status status = ni::IsDirectory(repository_path, &is_dir);
+  if (!status.IsOk() || !is_dir) {
+    Usage(argv, repository_path + " is not a directory");
+  }
+
+  status = ni::RepositoryArchive::Write(repository_path, archive_path);
+  if (!status.IsOk()) {
+    std::cerr << "error: " << status.AsString() << std::endl;
+    return 1;
+  }
+
+  // Read the archive back to make sure it is usable.
+  std::unique_ptr<ni::RepositoryArchive> archive;
+  status = ni::RepositoryArchive::Open(archive_path, &archive);
+  if (!status.IsOk()) {
+    std::cerr << "error: " << status.AsString() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
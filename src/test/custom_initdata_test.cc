@@ -0,0 +1,280 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Tests of the CustomInitializeData versioning in
+// src/backends/custom/custom.h. A custom backend built with the SDK
+// is initialized the way an older server initializes it, with a
+// CustomInitializeData that ends after 'server_parameters', and the
+// way the current server does. Exits with a non-zero status if any
+// test fails.
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "src/backends/custom/custom.h"
+#include "src/custom/sdk/custom_instance.h"
+
+namespace ni = nvidia::inferenceserver;
+namespace nic = nvidia::inferenceserver::custom;
+
+namespace {
+
+int failures = 0;
+
+#define EXPECT(X)                                                   \
+  do {                                                              \
+    if (!(X)) {                                                     \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": expected " #X \
+                << std::endl;                                       \
+      failures++;                                                   \
+    }                                                               \
+  } while (false)
+
+// The layout of CustomInitializeData provided by servers that predate
+// 'struct_size'.
+typedef struct {
+  const char* instance_name;
+  const char* serialized_model_config;
+  size_t serialized_model_config_size;
+  int gpu_device_id;
+  size_t server_parameter_cnt;
+  const char** server_parameters;
+} OldCustomInitializeData;
+
+static_assert(
+    offsetof(CustomInitializeData, struct_size) ==
+        sizeof(OldCustomInitializeData),
+    "CustomInitializeData must start with the old layout");
+
+// Calls of the server callbacks.
+size_t parallel_for_calls = 0;
+size_t alloc_calls = 0;
+size_t free_calls = 0;
+
+bool
+ParallelForFn(
+    void* thread_pool, size_t count, size_t grain, CustomRangeTaskFn_t task_fn,
+    void* task_context)
+{
+  parallel_for_calls++;
+  task_fn(task_context, 0, count);
+  return true;
+}
+
+bool
+AllocFn(void* allocator, uint64_t byte_size, void** buffer)
+{
+  alloc_calls++;
+  *buffer = malloc(byte_size);
+  return true;
+}
+
+bool
+FreeFn(void* allocator, void* buffer)
+{
+  free_calls++;
+  free(buffer);
+  return true;
+}
+
+// A custom backend that uses the server callbacks, through the SDK
+// helpers, when it executes.
+class TestInstance : public nic::CustomInstance {
+ public:
+  TestInstance(
+      const std::string& instance_name, const ni::ModelConfig& model_config,
+      int gpu_device)
+      : CustomInstance(instance_name, model_config, gpu_device)
+  {
+  }
+
+  int Execute(
+      const uint32_t payload_cnt, CustomPayload* payloads,
+      CustomGetNextInputFn_t input_fn, CustomGetOutputFn_t output_fn) override
+  {
+    size_t cnt = 0;
+    ParallelFor(
+        16, 4, [&cnt](size_t begin, size_t end) { cnt += end - begin; });
+    if (cnt != 16) {
+      return nic::ErrorCodes::Unknown;
+    }
+
+    void* buffer = Allocate(64);
+    if (buffer == nullptr) {
+      return nic::ErrorCodes::Unknown;
+    }
+    Free(buffer);
+
+    return nic::ErrorCodes::Success;
+  }
+};
+
+// Initialize, execute and finalize the custom backend with 'data'.
+void
+RunBackend(const CustomInitializeData* data)
+{
+  parallel_for_calls = 0;
+  alloc_calls = 0;
+  free_calls = 0;
+
+  void* custom_context = nullptr;
+  EXPECT(CustomInitialize(data, &custom_context) == 0);
+  EXPECT(custom_context != nullptr);
+  if (custom_context != nullptr) {
+    EXPECT(CustomExecute(custom_context, 0, nullptr, nullptr, nullptr) == 0);
+    EXPECT(CustomFinalize(custom_context) == 0);
+  }
+}
+
+const char* server_parameters[CUSTOM_SERVER_PARAMETER_CNT] = {
+    "1.0.0", "/models", "1"};
+
+// A server that predates 'struct_size' provides the old layout. The
+// memory after it is not part of the structure, so fill it with
+// values that would look valid if the backend read it. The backend
+// must not use them.
+void
+TestOldLayout()
+{
+  CustomInitializeData storage;
+  storage.struct_size = sizeof(CustomInitializeData);
+  storage.thread_pool = &storage;
+  storage.thread_pool_thread_cnt = 4;
+  storage.submit_task_fn = nullptr;
+  storage.parallel_for_fn = ParallelForFn;
+  storage.allocator = &storage;
+  storage.alloc_fn = AllocFn;
+  storage.free_fn = FreeFn;
+
+  OldCustomInitializeData old_data;
+  old_data.instance_name = "old_layout";
+  old_data.serialized_model_config = "";
+  old_data.serialized_model_config_size = 0;
+  old_data.gpu_device_id = CUSTOM_NO_GPU_DEVICE;
+  old_data.server_parameter_cnt = 2;
+  old_data.server_parameters = server_parameters;
+  memcpy(&storage, &old_data, sizeof(old_data));
+
+  EXPECT(!CUSTOM_INITDATA_HAS_FIELD(&storage, struct_size));
+  EXPECT(!CUSTOM_INITDATA_HAS_FIELD(&storage, parallel_for_fn));
+  EXPECT(!CUSTOM_INITDATA_HAS_FIELD(&storage, free_fn));
+
+  RunBackend(&storage);
+  EXPECT(parallel_for_calls == 0);
+  EXPECT(alloc_calls == 0);
+  EXPECT(free_calls == 0);
+}
+
+// The current server provides every field and the backend uses the
+// server callbacks.
+void
+TestCurrentLayout()
+{
+  CustomInitializeData data;
+  data.instance_name = "current_layout";
+  data.serialized_model_config = "";
+  data.serialized_model_config_size = 0;
+  data.gpu_device_id = CUSTOM_NO_GPU_DEVICE;
+  data.server_parameter_cnt = CUSTOM_SERVER_PARAMETER_CNT;
+  data.server_parameters = server_parameters;
+  data.struct_size = sizeof(data);
+  data.thread_pool = &data;
+  data.thread_pool_thread_cnt = 4;
+  data.submit_task_fn = nullptr;
+  data.parallel_for_fn = ParallelForFn;
+  data.allocator = &data;
+  data.alloc_fn = AllocFn;
+  data.free_fn = FreeFn;
+
+  EXPECT(CUSTOM_INITDATA_HAS_FIELD(&data, parallel_for_fn));
+  EXPECT(CUSTOM_INITDATA_HAS_FIELD(&data, free_fn));
+
+  RunBackend(&data);
+  EXPECT(parallel_for_calls == 1);
+  EXPECT(alloc_calls == 1);
+  EXPECT(free_calls == 1);
+}
+
+// A server that provides 'struct_size' but predates the allocator
+// fields.
+void
+TestPartialLayout()
+{
+  CustomInitializeData data;
+  data.instance_name = "partial_layout";
+  data.serialized_model_config = "";
+  data.serialized_model_config_size = 0;
+  data.gpu_device_id = CUSTOM_NO_GPU_DEVICE;
+  data.server_parameter_cnt = CUSTOM_SERVER_PARAMETER_CNT;
+  data.server_parameters = server_parameters;
+  data.struct_size = offsetof(CustomInitializeData, allocator);
+  data.thread_pool = &data;
+  data.thread_pool_thread_cnt = 4;
+  data.submit_task_fn = nullptr;
+  data.parallel_for_fn = ParallelForFn;
+  data.allocator = &data;
+  data.alloc_fn = AllocFn;
+  data.free_fn = FreeFn;
+
+  RunBackend(&data);
+  EXPECT(parallel_for_calls == 1);
+  EXPECT(alloc_calls == 0);
+  EXPECT(free_calls == 0);
+}
+
+}  // namespace
+
+namespace nvidia { namespace inferenceserver { namespace custom {
+
+int
+CustomInstance::Create(
+    CustomInstance** instance, const std::string& name,
+    const ModelConfig& model_config, int gpu_device,
+    const CustomInitializeData* data)
+{
+  *instance = new TestInstance(name, model_config, gpu_device);
+  return ErrorCodes::Success;
+}
+
+}}}  // namespace nvidia::inferenceserver::custom
+
+int
+main(int argc, char** argv)
+{
+  TestOldLayout();
+  TestCurrentLayout();
+  TestPartialLayout();
+
+  if (failures != 0) {
+    std::cerr << failures << " failures" << std::endl;
+    return 1;
+  }
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,284 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Tests of the protobuf wire helpers in src/core/grpc_wire.h that the
+// server and client use to parse InferRequest and InferResponse
+// messages without copying the tensor data. Exits with a non-zero
+// status if any test fails.
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/wire_format_lite.h"
+#include "src/core/grpc_service.pb.h"
+#include "src/core/grpc_wire.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+int failures = 0;
+
+#define EXPECT(X)                                                   \
+  do {                                                              \
+    if (!(X)) {                                                     \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": expected " #X \
+                << std::endl;                                       \
+      failures++;                                                   \
+    }                                                               \
+  } while (false)
+
+// Split 'bytes' into slices of at most 'slice_size' bytes, with an
+// empty slice between each so that SliceReader must skip them.
+std::vector<grpc::Slice>
+MakeSlices(const std::string& bytes, size_t slice_size)
+{
+  std::vector<grpc::Slice> slices;
+  for (size_t offset = 0; offset < bytes.size(); offset += slice_size) {
+    const size_t cnt = std::min(slice_size, bytes.size() - offset);
+    slices.emplace_back(bytes.data() + offset, cnt);
+    slices.emplace_back();
+  }
+
+  return slices;
+}
+
+// Return the bytes referenced by 'blocks'.
+std::string
+Gather(
+    const std::vector<grpc::Slice>& slices,
+    const std::vector<ni::SliceBlock>& blocks)
+{
+  std::string bytes;
+  for (const auto& block : blocks) {
+    EXPECT(block.slice_idx < slices.size());
+    EXPECT(block.offset + block.byte_size <= slices[block.slice_idx].size());
+    bytes.append(
+        reinterpret_cast<const char*>(slices[block.slice_idx].begin()) +
+            block.offset,
+        block.byte_size);
+  }
+
+  return bytes;
+}
+
+ni::InferRequest
+MakeRequest()
+{
+  ni::InferRequest request;
+  request.set_model_name("simple");
+  request.set_model_version(-1);
+  request.mutable_meta_data()->set_batch_size(1);
+  request.mutable_meta_data()->add_input()->set_name("INPUT0");
+  request.mutable_meta_data()->add_input()->set_name("INPUT1");
+  request.add_raw_input(std::string(300, 'a'));
+  request.add_raw_input(std::string());
+  request.add_raw_input(std::string(5, 'b'));
+  request.mutable_chunk()->set_max_byte_size(1234);
+  return request;
+}
+
+void
+TestAppendVarint()
+{
+  const uint64_t values[] = {0,          1,          127,       128,
+                             300,        16383,      16384,     0xffffffff,
+                             1ull << 35, 1ull << 63, ~0ull};
+  for (const uint64_t value : values) {
+    std::string encoded;
+    ni::AppendVarint(value, &encoded);
+
+    std::string expected;
+    {
+      google::protobuf::io::StringOutputStream raw(&expected);
+      google::protobuf::io::CodedOutputStream coded(&raw);
+      coded.WriteVarint64(value);
+    }
+    EXPECT(encoded == expected);
+
+    for (size_t slice_size = 1; slice_size <= encoded.size(); ++slice_size) {
+      std::vector<grpc::Slice> slices = MakeSlices(encoded, slice_size);
+      ni::SliceReader reader(slices);
+      uint64_t decoded;
+      EXPECT(reader.ReadVarint(&decoded));
+      EXPECT(decoded == value);
+      EXPECT(reader.Done());
+    }
+  }
+}
+
+void
+TestSplitRawFields()
+{
+  const ni::InferRequest request = MakeRequest();
+  std::string bytes;
+  EXPECT(request.SerializeToString(&bytes));
+
+  // Every slicing of the message must give the same result.
+  for (size_t slice_size = 1; slice_size <= bytes.size(); ++slice_size) {
+    std::vector<grpc::Slice> slices = MakeSlices(bytes, slice_size);
+    std::string fields;
+    std::vector<std::vector<ni::SliceBlock>> raw_fields;
+    EXPECT(ni::SplitRawFields(
+        slices, ni::InferRequest::kRawInputFieldNumber, &fields,
+        &raw_fields));
+
+    ni::InferRequest parsed;
+    EXPECT(parsed.ParseFromString(fields));
+    EXPECT(parsed.raw_input_size() == 0);
+    EXPECT(raw_fields.size() == (size_t)request.raw_input_size());
+    for (size_t i = 0; i < raw_fields.size(); ++i) {
+      EXPECT(Gather(slices, raw_fields[i]) == request.raw_input(i));
+      parsed.add_raw_input(Gather(slices, raw_fields[i]));
+    }
+
+    EXPECT(parsed.SerializeAsString() == bytes);
+  }
+
+  // An empty message is valid.
+  std::vector<grpc::Slice> empty(3);
+  std::string fields;
+  std::vector<std::vector<ni::SliceBlock>> raw_fields;
+  EXPECT(ni::SplitRawFields(
+      empty, ni::InferRequest::kRawInputFieldNumber, &fields, &raw_fields));
+  EXPECT(fields.empty() && raw_fields.empty());
+}
+
+// Return the offsets in 'bytes' where a top-level field starts, plus
+// the end of the message.
+std::vector<size_t>
+FieldBoundaries(const std::string& bytes)
+{
+  std::vector<size_t> boundaries;
+  google::protobuf::io::CodedInputStream input(
+      reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+  while (true) {
+    boundaries.push_back(input.CurrentPosition());
+    const uint32_t tag = input.ReadTag();
+    if ((tag == 0) ||
+        !google::protobuf::internal::WireFormatLite::SkipField(&input, tag)) {
+      break;
+    }
+  }
+
+  return boundaries;
+}
+
+void
+TestTruncated()
+{
+  std::string bytes;
+  EXPECT(MakeRequest().SerializeToString(&bytes));
+  const std::vector<size_t> boundaries = FieldBoundaries(bytes);
+
+  // A message cut inside a field must be rejected, one cut between
+  // fields is a shorter but valid message.
+  for (size_t len = 0; len < bytes.size(); ++len) {
+    const bool at_boundary =
+        std::find(boundaries.begin(), boundaries.end(), len) !=
+        boundaries.end();
+    for (size_t slice_size : {size_t(1), size_t(7), bytes.size()}) {
+      std::vector<grpc::Slice> slices =
+          MakeSlices(bytes.substr(0, len), slice_size);
+      std::string fields;
+      std::vector<std::vector<ni::SliceBlock>> raw_fields;
+      EXPECT(
+          ni::SplitRawFields(
+              slices, ni::InferRequest::kRawInputFieldNumber, &fields,
+              &raw_fields) == at_boundary);
+    }
+  }
+}
+
+bool
+Split(const std::string& bytes)
+{
+  std::vector<grpc::Slice> slices = MakeSlices(bytes, 1);
+  std::string fields;
+  std::vector<std::vector<ni::SliceBlock>> raw_fields;
+  return ni::SplitRawFields(
+      slices, ni::InferRequest::kRawInputFieldNumber, &fields, &raw_fields);
+}
+
+void
+TestMalformed()
+{
+  // Varint longer than 10 bytes.
+  EXPECT(!Split(std::string(11, '\xff') + '\x01'));
+
+  // Tag of a varint field whose value is longer than 10 bytes.
+  EXPECT(!Split(std::string("\x10") + std::string(11, '\x80') + '\x01'));
+
+  // Deprecated group and invalid wire types.
+  for (const char wire_type : {3, 4, 6, 7}) {
+    EXPECT(!Split(std::string(1, (1 << 3) | wire_type) + "\x00\x00\x00\x00"));
+  }
+
+  // Length-delimited fields longer than the message, for both a raw
+  // and a regular field.
+  const char raw_tag = (ni::InferRequest::kRawInputFieldNumber << 3) |
+                       ni::kWireTypeLengthDelimited;
+  EXPECT(!Split(std::string(1, raw_tag) + "\x05" + "abcd"));
+  EXPECT(!Split(std::string("\x0a\x05") + "abcd"));
+  EXPECT(!Split(std::string(1, raw_tag) + "\xff\xff\xff\xff\x0f" + "abcd"));
+
+  // Fixed-size fields longer than the message.
+  EXPECT(!Split(std::string("\x09") + "1234567"));
+  EXPECT(!Split(std::string("\x0d") + "123"));
+
+  // A raw field number with the wrong wire type is not a raw field,
+  // it is passed through for the protobuf parser to handle.
+  const std::string wrong_raw =
+      std::string(1, ni::InferRequest::kRawInputFieldNumber << 3) + "\x01";
+  std::vector<grpc::Slice> slices = MakeSlices(wrong_raw, 1);
+  std::string fields;
+  std::vector<std::vector<ni::SliceBlock>> raw_fields;
+  EXPECT(ni::SplitRawFields(
+      slices, ni::InferRequest::kRawInputFieldNumber, &fields, &raw_fields));
+  EXPECT(raw_fields.empty());
+  EXPECT(fields == wrong_raw);
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  TestAppendVarint();
+  TestSplitRawFields();
+  TestTruncated();
+  TestMalformed();
+
+  if (failures != 0) {
+    std::cerr << failures << " failures" << std::endl;
+    return 1;
+  }
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,269 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Counts the calls to the global operator new made for each inference
+// request that goes through InferenceServer::HandleInfer once the
+// server is warm. The request is built the way the frontends build
+// it, except that the request header is parsed (copied) before
+// counting starts. Exits with a non-zero status if a request makes
+// more allocations than expected.
+//
+// Usage: infer_alloc_test <model repository> <model name>
+//
+// The model must be the custom_int32_int32_int32 model of the QA
+// model repository.
+
+#include <unistd.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include "src/core/backend.h"
+#include "src/core/object_pool.h"
+#include "src/core/provider.h"
+#include "src/core/provider_utils.h"
+#include "src/core/request_status.h"
+#include "src/core/server.h"
+#include "src/core/server_status.h"
+
+namespace ni = nvidia::inferenceserver;
+
+namespace {
+
+// The allocations that remain for each request. None of them are made
+// for the objects that the server creates to track the request:
+//
+//   - 16 for the response header and the request status, which are
+//     protobuf messages and strings that are heap allocated since
+//     the server doesn't use protobuf arenas.
+//   - 4 for the output buffers of the two outputs and the shapes that
+//     the custom backend passes for them.
+//   - 6 made by the custom model library itself.
+//   - 2 for the copies of the model name kept by the request provider
+//     and the request statistics.
+//   - 1 for the queue timer of the request in the scheduler.
+//   - 1 for the vector of payloads that are executed together.
+//
+// The queue of the scheduler also grows now and then, so the average
+// is slightly above 30.
+constexpr double kMaxAllocationsPerRequest = 31;
+
+constexpr size_t kWarmupRequests = 1000;
+constexpr size_t kCountedRequests = 1000;
+
+// Calls to the global operator new are counted while 'counting' is
+// set.
+std::atomic<bool> counting(false);
+std::atomic<size_t> allocations(0);
+
+// Signals the completion of a request.
+struct Completion {
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool done_;
+};
+
+int32_t input_data[16];
+
+ni::Status
+RunRequest(
+    ni::InferenceServer* server,
+    const std::shared_ptr<ni::InferenceBackend>& backend,
+    const std::string& model_name, const ni::InferRequestHeader& header,
+    const bool count)
+{
+  // The header is copied as if a frontend parsed it from the request.
+  ni::InferRequestHeader request_header(header);
+  ni::RequestStatus request_status;
+  Completion completion;
+  completion.done_ = false;
+
+  counting = count;
+
+  auto infer_stats = std::allocate_shared<ni::ModelInferStats>(
+      ni::PoolAllocator<ni::ModelInferStats>(), server->StatusManager(),
+      model_name);
+  auto timer = std::allocate_shared<ni::ModelInferStats::ScopedTimer>(
+      ni::PoolAllocator<ni::ModelInferStats::ScopedTimer>());
+  infer_stats->StartRequestTimer(timer.get());
+  infer_stats->SetRequestedVersion(-1);
+  infer_stats->SetMetricReporter(backend->MetricReporter());
+  infer_stats->SetBatchSize(request_header.batch_size());
+
+  ni::InferRequestProvider::InputBufferMap input_map;
+  for (const auto& input : request_header.input()) {
+    auto memory = std::allocate_shared<ni::SystemMemoryReference>(
+        ni::PoolAllocator<ni::SystemMemoryReference>());
+    memory->AddBuffer(
+        reinterpret_cast<const char*>(input_data), sizeof(input_data));
+    input_map.emplace(input.name(), memory);
+  }
+
+  std::shared_ptr<ni::InferRequestProvider> request_provider;
+  ni::Status status = ni::InferRequestProvider::Create(
+      *backend, model_name, -1, std::move(request_header), input_map,
+      &request_provider);
+  if (!status.IsOk()) {
+    counting = false;
+    return status;
+  }
+
+  std::shared_ptr<ni::DelegatingInferResponseProvider> response_provider;
+  status = ni::DelegatingInferResponseProvider::Create(
+      request_provider->RequestHeader(), backend->GetLabelProvider(),
+      &response_provider);
+  if (!status.IsOk()) {
+    counting = false;
+    return status;
+  }
+
+  Completion* completed = &completion;
+  server->HandleInfer(
+      &request_status, backend, request_provider, response_provider,
+      infer_stats, [completed]() {
+        counting = false;
+        std::lock_guard<std::mutex> lk(completed->mu_);
+        completed->done_ = true;
+        completed->cv_.notify_one();
+      });
+
+  std::unique_lock<std::mutex> lk(completion.mu_);
+  completion.cv_.wait(lk, [&completion] { return completion.done_; });
+
+  if (request_status.code() != ni::RequestStatusCode::SUCCESS) {
+    return ni::Status(request_status.code(), request_status.msg());
+  }
+
+  return ni::Status::Success;
+}
+
+}  // namespace
+
+// Replace the global operator new and delete to count allocations.
+// They are not inlined so that the compiler doesn't pair the free()
+// below with the new-expressions it is inlined into.
+__attribute__((noinline)) void*
+operator new(size_t size)
+{
+  if (counting) {
+    allocations++;
+  }
+
+  void* ptr = std::malloc((size == 0) ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return ptr;
+}
+
+__attribute__((noinline)) void
+operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <model repository> <model name>"
+              << std::endl;
+    return 1;
+  }
+
+  const std::string model_name(argv[2]);
+
+  ni::InferenceServer server;
+  server.SetModelStorePath(argv[1]);
+  if (!server.Init()) {
+    std::cerr << "failed to initialize server" << std::endl;
+    return 1;
+  }
+
+  // Wait for the model to be loaded.
+  std::shared_ptr<ni::InferenceBackend> backend;
+  ni::Status status;
+  for (size_t retry = 0; retry < 100; ++retry) {
+    status = server.GetInferenceBackend(model_name, -1, &backend);
+    if (status.IsOk()) {
+      break;
+    }
+    usleep(100 * 1000);
+  }
+  if (!status.IsOk()) {
+    std::cerr << status.AsString() << std::endl;
+    return 1;
+  }
+
+  ni::InferRequestHeader header;
+  header.set_batch_size(1);
+  for (const auto& input : backend->Config().input()) {
+    header.add_input()->set_name(input.name());
+  }
+  for (const auto& output : backend->Config().output()) {
+    header.add_output()->set_name(output.name());
+  }
+  status = ni::NormalizeRequestHeader(*backend, header);
+  if (!status.IsOk()) {
+    std::cerr << status.AsString() << std::endl;
+    return 1;
+  }
+
+  for (size_t idx = 0; idx < kWarmupRequests + kCountedRequests; ++idx) {
+    if (idx == kWarmupRequests) {
+      allocations = 0;
+    }
+
+    status = RunRequest(
+        &server, backend, model_name, header, (idx >= kWarmupRequests));
+    if (!status.IsOk()) {
+      std::cerr << status.AsString() << std::endl;
+      return 1;
+    }
+  }
+
+  const double allocations_per_request =
+      static_cast<double>(allocations) / kCountedRequests;
+  std::cout << "allocations per request: " << allocations_per_request
+            << std::endl;
+
+  backend.reset();
+  server.Stop();
+
+  if (allocations_per_request > kMaxAllocationsPerRequest) {
+    std::cerr << "expected at most " << kMaxAllocationsPerRequest
+              << " allocations per request" << std::endl;
+    return 1;
+  }
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,92 @@
+#!/usr/bin/python
+
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Model quantizer for the inference server's --model-quantizer
+# option. Quantizes ONNX models with ONNX Runtime dynamic quantization
+# and TorchScript models with PyTorch dynamic quantization.
+#
+# Usage: quantize_model.py <kind> <platform> <input path> <output path>
+#            <setting>...
+#
+# Each setting is a <name>=<value> pair given by the server. The
+# quantizer fails for settings it can't apply so that a saved model
+# never differs from the settings the server reports.
+
+import sys
+
+
+def quantize_onnx(input_path, output_path, settings):
+    from onnxruntime.quantization import quantize_dynamic, QuantType
+    quantize_dynamic(input_path, output_path,
+                     weight_type=QuantType.QInt8,
+                     per_channel=settings.pop('per_channel') == 'true',
+                     reduce_range=settings.pop('reduce_range') == 'true')
+
+
+def quantize_libtorch(input_path, output_path, settings):
+    import torch
+    from torch.quantization import (default_dynamic_qconfig,
+                                    per_channel_dynamic_qconfig,
+                                    quantize_dynamic_jit)
+    if settings.pop('reduce_range') != 'false':
+        sys.exit("reduce_range is not supported for pytorch_libtorch")
+    if settings.pop('qconfig') != 'default_dynamic_qconfig':
+        sys.exit("unsupported qconfig")
+    qconfig = (per_channel_dynamic_qconfig
+               if settings.pop('per_channel') == 'true'
+               else default_dynamic_qconfig)
+    model = torch.jit.load(input_path, map_location='cpu')
+    model.eval()
+    model = quantize_dynamic_jit(model, {'': qconfig})
+    torch.jit.save(model, output_path)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 5:
+        sys.exit("usage: {} <kind> <platform> <input path> <output path> "
+                 "<setting>...".format(sys.argv[0]))
+
+    kind, platform, input_path, output_path = sys.argv[1:5]
+    settings = dict(arg.split('=', 1) for arg in sys.argv[5:])
+    if kind != 'dynamic_int8':
+        sys.exit("unsupported quantization kind '{}'".format(kind))
+    if settings.pop('weight_type', None) != 'qint8':
+        sys.exit("unsupported weight type")
+
+    try:
+        if platform == 'onnxruntime_onnx':
+            quantize_onnx(input_path, output_path, settings)
+        elif platform == 'pytorch_libtorch':
+            quantize_libtorch(input_path, output_path, settings)
+        else:
+            sys.exit("unsupported platform '{}'".format(platform))
+    except KeyError as e:
+        sys.exit("missing setting {}".format(e))
+
+    if settings:
+        sys.exit("unsupported settings {}".format(sorted(settings)))